@@ -55,6 +55,20 @@ namespace Luth::Component
                 * rotation
                 * glm::scale(glm::mat4(1.0f), m_Scale);
         }
+
+        // Inverse of GetTransform for translation * rotation * scale matrices (no shear)
+        void SetTransform(const glm::mat4& matrix) {
+            m_Position = glm::vec3(matrix[3]);
+
+            glm::mat3 basis(matrix);
+            m_Scale = { glm::length(basis[0]), glm::length(basis[1]), glm::length(basis[2]) };
+            if (glm::determinant(basis) < 0.0f) m_Scale.x = -m_Scale.x;   // Mirrored
+
+            for (int i = 0; i < 3; ++i) {
+                if (m_Scale[i] != 0.0f) basis[i] /= m_Scale[i];
+            }
+            m_Rotation = glm::degrees(glm::eulerAngles(glm::quat_cast(basis)));
+        }
     };
 
     struct WorldTransform {
@@ -135,6 +149,23 @@ namespace Luth::Component
         UUID MaterialUUID;
         bool isSkinned;
 
+        i32 ForcedLod = -1;     // -1: pick by projected size
+        u32 CurrentLod = 0;     // Last selected level, for hysteresis
+
+        // Skinned: this frame's bone palette (upload ring range), set by the AnimationSystem
+        u32 BonesBuffer = 0;
+        u32 BonesOffset = 0;
+        u32 BonesSize = 0;
+
+        // Animation::CpuSkinning: this frame's skinned vertices instead (upload ring range)
+        u32 SkinnedBuffer = 0;
+        u32 SkinnedOffset = 0;
+        u32 SkinnedSize = 0;
+
+        // GLUploadRing frame the ranges above were written in. Older ranges point at reused
+        // ring memory (the Animation was removed or skipped), the mesh then draws in bind pose
+        u64 SkinningFrame = 0;
+
         // Tmp state for ImGui
         std::string modelNamePreview;
         std::string materialNamePreview;
@@ -145,6 +176,15 @@ namespace Luth::Component
         Animation(UUID uuid) : ModelUUID(uuid) {}
         UUID ModelUUID;
 		i32 AnimationIndex = 0;
+        bool CpuSkinning = false;   // Skin on workers every frame and draw the result, see SkinnedVertexCache
+    };
+
+    // Plays a baked vertex animation on this entity's MeshRenderer. Opaque and cutout
+    // meshes are batched and drawn instanced, the clip is baked on first use.
+    struct BakedAnimation {
+        i32 AnimationIndex = 0;
+        f32 TimeOffset = 0.0f;  // Seconds
+        f32 Speed = 1.0f;
     };
 
     struct DirectionalLight {
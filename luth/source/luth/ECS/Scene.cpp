@@ -1,11 +1,22 @@
 #include "luthpch.h"
 #include "luth/ECS/Scene.h"
 #include "luth/ECS/Components.h"
+#include "luth/renderer/CpuSkinning.h"
 
 namespace Luth
 {
+    namespace
+    {
+        // Entity destroyed or its Animation removed, drop the skinned vertices
+        void OnAnimationDestroyed(entt::registry&, entt::entity entity)
+        {
+            SkinnedVertexCache::Remove(entity);
+        }
+    }
+
     Scene::Scene()
     {
+        m_Registry.on_destroy<Animation>().connect<&OnAnimationDestroyed>();
         LH_CORE_INFO("Created new scene");
     }
 
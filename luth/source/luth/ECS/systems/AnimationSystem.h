@@ -4,13 +4,13 @@
 #include "luth/ECS/System.h"
 #include "luth/ECS/components.h"
 #include "luth/renderer/SkinnedModel.h"
+#include "luth/renderer/CpuSkinning.h"
 #include "luth/renderer/SkeletonRenderer.h"
+#include "luth/renderer/openGL/GLUploadRing.h"
 #include "luth/resources/FileSystem.h"
 #include "luth/resources/ResourceDB.h"
 #include "luth/resources/libraries/ModelLibrary.h"
 
-#define MAX_BONES 512
-
 namespace Luth
 {
     class AnimationSystem : public System
@@ -19,12 +19,6 @@ namespace Luth
         AnimationSystem()
         {
             m_SkeletonRenderer = SkeletonRenderer::Create();
-
-            glGenBuffers(1, &m_BonesUBO);
-            glBindBuffer(GL_UNIFORM_BUFFER, m_BonesUBO);
-            glBufferData(GL_UNIFORM_BUFFER, MAX_BONES * sizeof(Mat4), nullptr, GL_DYNAMIC_DRAW);
-            glBindBufferBase(GL_UNIFORM_BUFFER, 2, m_BonesUBO);
-            glBindBuffer(GL_UNIFORM_BUFFER, 0);
         }
 
         void Update(entt::registry& registry) override
@@ -37,9 +31,13 @@ namespace Luth
 
                 std::vector<Mat4> boneTransforms = skinned->GetFinalTransforms();
 
-                glBindBuffer(GL_UNIFORM_BUFFER, m_BonesUBO);
-                glBufferSubData(GL_UNIFORM_BUFFER, 0, boneTransforms.size() * sizeof(Mat4), boneTransforms.data());
-                glBindBuffer(GL_UNIFORM_BUFFER, 0);
+                SkinnedVertexCache::SetPalette(entity, anim.ModelUUID, boneTransforms);
+
+                // Own slice per skeleton, sized to the whole block the shaders declare
+                const UploadAllocation palette = GLUploadRing::Allocate(MAX_BONES * sizeof(Mat4));
+                const size_t boneCount = std::min<size_t>(boneTransforms.size(), MAX_BONES);
+                std::memcpy(palette.Data, boneTransforms.data(), boneCount * sizeof(Mat4));
+                AssignPalette(registry, entity, entity, anim, palette);
 
                 if (m_DrawSkeletons) {
                     m_SkeletonRenderer->Update(*skinned);
@@ -49,7 +47,46 @@ namespace Luth
         }
 
     private:
-        u32 m_BonesUBO;
+        // The skinned meshes sit on descendants of the Animation entity
+        void AssignPalette(entt::registry& registry, entt::entity entity, entt::entity animEntity,
+                           const Animation& anim, const UploadAllocation& palette)
+        {
+            if (auto* meshRend = registry.try_get<MeshRenderer>(entity)) {
+                meshRend->BonesBuffer = palette.Buffer;
+                meshRend->BonesOffset = palette.Offset;
+                meshRend->BonesSize = palette.Size;
+                meshRend->SkinnedBuffer = meshRend->SkinnedOffset = meshRend->SkinnedSize = 0;
+                meshRend->SkinningFrame = GLUploadRing::GetFrame();
+
+                if (anim.CpuSkinning && meshRend->isSkinned && meshRend->ModelUUID == anim.ModelUUID) {
+                    if (const SkinnedMeshCache* skinned = SkinnedVertexCache::Get(animEntity, meshRend->MeshIndex))
+                        UploadSkinned(*meshRend, *skinned);
+                }
+            }
+            if (auto* children = registry.try_get<Children>(entity))
+                for (entt::entity child : children->m_Children)
+                    AssignPalette(registry, child, animEntity, anim, palette);
+        }
+
+        // Matches SkinnedVertex in LuthSkinnedVertices.glslh
+        void UploadSkinned(MeshRenderer& meshRend, const SkinnedMeshCache& skinned)
+        {
+            const size_t count = skinned.Positions.size();
+            if (count == 0) return;
+
+            const UploadAllocation stream = GLUploadRing::Allocate(count * 3 * sizeof(Vec4));
+            Vec4* out = static_cast<Vec4*>(stream.Data);
+            for (size_t i = 0; i < count; ++i) {
+                out[i * 3 + 0] = Vec4(skinned.Positions[i], 1.0f);
+                out[i * 3 + 1] = Vec4(skinned.Normals[i], 0.0f);
+                out[i * 3 + 2] = Vec4(skinned.Tangents[i], 0.0f);
+            }
+
+            meshRend.SkinnedBuffer = stream.Buffer;
+            meshRend.SkinnedOffset = stream.Offset;
+            meshRend.SkinnedSize = stream.Size;
+        }
+
         bool m_DrawSkeletons = false;
         std::unique_ptr<SkeletonRenderer> m_SkeletonRenderer;
     };
@@ -5,7 +5,9 @@
 #include "luth/renderer/pipeline/passes/LightingPass.h"
 #include "luth/renderer/pipeline/passes/TransparentPass.h"
 #include "luth/renderer/pipeline/passes/PostProcessPass.h"
+#include "luth/renderer/openGL/GLUploadRing.h"
 #include "luth/resources/libraries/MaterialLibrary.h"
+#include "luth/resources/libraries/ModelLibrary.h"
 #include "luth/editor/Editor.h"
 #include "luth/editor/panels/ScenePanel.h"
 
@@ -13,21 +15,25 @@
 
 namespace Luth
 {
-    RenderingSystem::RenderingSystem(u32 viewportWidth, u32 viewportHeight)
+    // Relative band around each LOD threshold, so objects near it don't flicker between levels
+    constexpr f32 k_LodHysteresis = 0.1f;
+
+    // SSBO bindings of the clustered point lights (LuthLights.glslh, LuthClusters.glslh)
+    constexpr u32 k_PointLightBinding = 6;
+    constexpr u32 k_ClusterRangeBinding = 7;
+    constexpr u32 k_ClusterIndexBinding = 8;
+
+    namespace
     {
-        // UBO setup
-        glGenBuffers(1, &m_TransformUBO);
-        glBindBuffer(GL_UNIFORM_BUFFER, m_TransformUBO);
-        glBufferData(GL_UNIFORM_BUFFER, sizeof(TransformUBO), nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_TransformUBO);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-
-        glGenBuffers(1, &m_LightsUBO);
-        glBindBuffer(GL_UNIFORM_BUFFER, m_LightsUBO);
-        glBufferData(GL_UNIFORM_BUFFER, sizeof(LightsUBO), nullptr, GL_DYNAMIC_DRAW);
-        glBindBufferBase(GL_UNIFORM_BUFFER, 1, m_LightsUBO);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        void UploadStorage(u32 binding, const void* data, size_t bytes)
+        {
+            GLUploadRing::Bind(GL_SHADER_STORAGE_BUFFER, binding, GLUploadRing::Upload(data, bytes));
+        }
+    }
 
+    RenderingSystem::RenderingSystem(u32 viewportWidth, u32 viewportHeight)
+        : m_ViewportWidth(viewportWidth), m_ViewportHeight(viewportHeight)
+    {
         // Register the deferred pipeline
         RenderPipeline deferredPipeline;
         deferredPipeline.AddPass<GeometryPass>();
@@ -45,23 +51,28 @@ namespace Luth
     {
         if (!m_ActivePipeline) return;
 
-        // Collect opaque / transparent
-        auto [opaque, transparent] = CollectCommands(registry);
-
         // Update camera / UBOs
         auto cam = Editor::GetPanel<ScenePanel>()->GetEditorCamera();
         m_CameraPos = cam.GetPosition();
+        m_View = cam.GetViewMatrix();
+        m_Projection = cam.GetProjectionMatrix();
+        UpdateRenderScale();
         UpdateTransformUBO(cam.GetViewMatrix(), cam.GetProjectionMatrix(), Mat4(1.0f));
         UpdateLightsUBO(registry);
+        UpdateLightClusters();
 
-        // Build context and render
-        RenderContext ctx{ m_ActivePipeline, registry, m_CameraPos, opaque, transparent,
-                            (u32)m_ViewProj[0][0], (u32)m_ViewProj[1][1] };
+        // Build context, collect opaque / transparent / baked and render
+        RenderContext ctx{ .pipeline = m_ActivePipeline, .registry = registry, .cameraPos = m_CameraPos,
+                           .view = m_View, .projection = m_Projection,
+                           .width = m_ViewportWidth, .height = m_ViewportHeight };
+        CollectCommands(registry, ctx);
         m_ActivePipeline->RenderAll(ctx);
     }
 
     void RenderingSystem::Resize(u32 width, u32 height)
     {
+        m_ViewportWidth = width;
+        m_ViewportHeight = height;
         if (m_ActivePipeline)
             m_ActivePipeline->ResizeAll(width, height);
     }
@@ -92,10 +103,10 @@ namespace Luth
         return m_ActiveName;
     }
 
-    std::pair<std::vector<RenderCommand>, std::vector<RenderCommand>>
-        RenderingSystem::CollectCommands(entt::registry& registry)
+    void RenderingSystem::CollectCommands(entt::registry& registry, RenderContext& ctx)
     {
-        std::vector<RenderCommand> opaque, transparent;
+        auto& opaque = ctx.opaque;
+        auto& transparent = ctx.transparent;
 
         auto view = registry.view<WorldTransform, MeshRenderer>();
         for (auto [entity, transform, meshRend] : view.each()) {
@@ -106,12 +117,18 @@ namespace Luth
                 .entity = entity,
                 .transform = &transform,
                 .meshRend = &meshRend,
-                .distance = 0.0f
+                .distance = 0.0f,
+                .lod = SelectLod(transform, meshRend),
+                // A mirroring transform flips the winding, those draws stay two-sided
+                .singleSided = material->IsSingleSided() && glm::determinant(Mat3(transform.matrix)) > 0.0f
             };
 
             if (material->GetRenderMode() == RendererAPI::RenderMode::Opaque ||
                 material->GetRenderMode() == RendererAPI::RenderMode::Cutout) {
-                opaque.push_back(cmd);
+                // Nearest first in the depth pre-pass
+                cmd.distance = glm::distance(m_CameraPos, Vec3(transform.matrix[3]));
+                if (registry.all_of<BakedAnimation>(entity)) ctx.baked.push_back(cmd);
+                else if (CullClusters(transform, meshRend, cmd, ctx)) opaque.push_back(cmd);
             }
             else {
                 // TODO: Calculate actual distance from camera
@@ -126,16 +143,87 @@ namespace Luth
         // Sort transparent objects back-to-front
         std::sort(transparent.begin(), transparent.end(),
             [](const auto& a, const auto& b) { return a.distance > b.distance; });
+    }
+
+    u32 RenderingSystem::SelectLod(const WorldTransform& transform, MeshRenderer& meshRend) const
+    {
+        auto model = ModelLibrary::Get(meshRend.ModelUUID);
+        if (!model || meshRend.MeshIndex >= model->GetMeshes().size()) return 0;
+
+        const auto& lods = model->GetMeshes()[meshRend.MeshIndex]->GetLods();
+        const u32 lodCount = static_cast<u32>(lods.size());
+        if (lodCount <= 1) return 0;
+        if (meshRend.ForcedLod >= 0) return std::min(static_cast<u32>(meshRend.ForcedLod), lodCount - 1);
+
+        // Projected bounding sphere height, as a fraction of the viewport height
+        const MeshData& data = model->GetMeshesData()[meshRend.MeshIndex];
+        const Mat4& m = transform.matrix;
+        const Vec3 center = Vec3(m * Vec4(data.BoundsCenter, 1.0f));
+        const f32 scale = std::max({ glm::length(Vec3(m[0])), glm::length(Vec3(m[1])), glm::length(Vec3(m[2])) });
+        const f32 radius = data.BoundsRadius * scale;
+
+        f32 screenSize = radius * m_Projection[1][1];
+        if (m_Projection[3][3] == 0.0f) { // Perspective
+            const f32 distance = glm::distance(center, m_CameraPos);
+            screenSize = distance > radius ? screenSize / distance : FLOAT_MAX;
+        }
+
+        u32 lod = std::min(meshRend.CurrentLod, lodCount - 1);
+        while (lod + 1 < lodCount && screenSize < lods[lod + 1].ScreenSize * (1.0f - k_LodHysteresis)) ++lod;
+        while (lod > 0 && screenSize > lods[lod].ScreenSize * (1.0f + k_LodHysteresis)) --lod;
+
+        meshRend.CurrentLod = lod;
+        return lod;
+    }
+
+    bool RenderingSystem::CullClusters(const WorldTransform& transform, const MeshRenderer& meshRend,
+                                       RenderCommand& cmd, RenderContext& ctx)
+    {
+        if (cmd.lod != 0 || meshRend.isSkinned) return true;
+
+        auto model = ModelLibrary::Get(meshRend.ModelUUID);
+        if (!model || meshRend.MeshIndex >= model->GetMeshes().size()) return true;
+
+        const auto& meshlets = model->GetMeshes()[meshRend.MeshIndex]->GetMeshlets();
+        if (meshlets.empty()) return true;
+
+        const bool orthographic = m_Projection[3][3] == 1.0f;
+        const Vec3 forward = -Vec3(m_View[0][2], m_View[1][2], m_View[2][2]);
+        const MeshletCullView view = MeshletCuller::MakeView(m_Projection * m_View, transform.matrix,
+            m_CameraPos, forward, orthographic, cmd.singleSided);
+
+        cmd.firstRange = static_cast<u32>(ctx.clusterRanges.size());
+        const u32 kept = MeshletCuller::Cull(meshlets, view, ctx.clusterRanges);
+        cmd.rangeCount = static_cast<u32>(ctx.clusterRanges.size()) - cmd.firstRange;
 
-        return { opaque, transparent };
+        // Nothing culled: a single plain draw of the LOD
+        if (kept == meshlets.size()) {
+            ctx.clusterRanges.resize(cmd.firstRange);
+            cmd.rangeCount = 0;
+        }
+        return kept > 0;
+    }
+
+    void RenderingSystem::UpdateRenderScale()
+    {
+        // GPU cost of the passes when there is a timer, the whole frame otherwise
+        const PassProfiler& profiler = m_ActivePipeline->GetProfiler();
+        const f32 gpuMs = profiler.IsEnabled() && profiler.HasGpuTimer() ? profiler.GetGpuFrameTime() : 0.0f;
+        const f32 frameMs = gpuMs > 0.0f ? gpuMs : Time::UnscaledDeltaTime() * 1000.0f;
+
+        m_ActivePipeline->SetRenderScale(m_DynamicResolution.Update(frameMs));
+
+        const RenderGraph& graph = m_ActivePipeline->GetGraph();
+        m_RenderWidth = graph.ScaleExtent(m_ViewportWidth);
+        m_RenderHeight = graph.ScaleExtent(m_ViewportHeight);
     }
 
     void RenderingSystem::UpdateTransformUBO(const Mat4& view, const Mat4& proj, const Mat4& model)
     {
         TransformUBO data{ view, proj, model };
-        glBindBuffer(GL_UNIFORM_BUFFER, m_TransformUBO);
-        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(data), &data);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        data.renderScale = { static_cast<f32>(m_RenderWidth) / std::max(m_ViewportWidth, 1u),
+                             static_cast<f32>(m_RenderHeight) / std::max(m_ViewportHeight, 1u), 0.0f, 0.0f };
+        GLUploadRing::Bind(GL_UNIFORM_BUFFER, 0, GLUploadRing::Upload(data));
     }
 
     void RenderingSystem::UpdateLightsUBO(entt::registry& registry)
@@ -147,7 +235,11 @@ namespace Luth
         // Process directional lights
         auto dirLightsView = registry.view<DirectionalLight, Transform>();
         for (auto [entity, dirLight, transform] : dirLightsView.each()) {
-            if (ubo.dirLightCount >= MAX_DIR_LIGHTS) break;
+            if (ubo.dirLightCount >= MAX_DIR_LIGHTS) {
+                if (!m_DirLightWarned) LH_CORE_WARN("More than {0} directional lights, the rest are ignored", MAX_DIR_LIGHTS);
+                m_DirLightWarned = true;
+                break;
+            }
 
             ubo.dirLights[ubo.dirLightCount] = {
                 .color = dirLight.Color,
@@ -158,23 +250,38 @@ namespace Luth
             ubo.dirLightCount++;
         }
 
-        // Process point lights with their transforms
+        // Process point lights with their transforms, unbounded: shading only reads each cluster's list
+        m_PointLights.clear();
+        m_ClusterLights.clear();
         auto pointLightsView = registry.view<PointLight, Transform>();
         for (auto [entity, pointLight, transform] : pointLightsView.each()) {
-            if (ubo.pointLightCount >= MAX_POINT_LIGHTS) break;
-
-            ubo.pointLights[ubo.pointLightCount] = {
+            m_PointLights.push_back({
                 .color = pointLight.Color,
                 .intensity = pointLight.Intensity,
                 .position = transform.m_Position,
                 .range = pointLight.Range
-            };
-            ubo.pointLightCount++;
+            });
+            m_ClusterLights.push_back({ transform.m_Position, pointLight.Range });
         }
+        ubo.pointLightCount = static_cast<int>(m_PointLights.size());
+
+        m_Clusters.SetProjection(m_Projection);
+        ubo.clusterGrid = { LightClusters::k_TilesX, LightClusters::k_TilesY, LightClusters::k_Slices, 0 };
+        ubo.clusterParams = { m_Clusters.GetSliceScale(), m_Clusters.GetSliceBias(), m_Clusters.IsOrthographic() ? 1.0f : 0.0f, 0.0f };
+        ubo.clusterScreen = { static_cast<f32>(LightClusters::k_TilesX) / std::max(m_RenderWidth, 1u),
+                              static_cast<f32>(LightClusters::k_TilesY) / std::max(m_RenderHeight, 1u), 0.0f, 0.0f };
+
+        GLUploadRing::Bind(GL_UNIFORM_BUFFER, 1, GLUploadRing::Upload(ubo));
+    }
+
+    void RenderingSystem::UpdateLightClusters()
+    {
+        m_Clusters.Build(m_View, m_ClusterLights.data(), static_cast<u32>(m_ClusterLights.size()));
 
-        // Update GPU buffer
-        glBindBuffer(GL_UNIFORM_BUFFER, m_LightsUBO);
-        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightsUBO), &ubo);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        const auto& ranges = m_Clusters.GetRanges();
+        const auto& indices = m_Clusters.GetIndices();
+        UploadStorage(k_PointLightBinding, m_PointLights.data(), m_PointLights.size() * sizeof(PointLightUBO));
+        UploadStorage(k_ClusterRangeBinding, ranges.data(), ranges.size() * sizeof(ClusterRange));
+        UploadStorage(k_ClusterIndexBinding, indices.data(), indices.size() * sizeof(u32));
     }
 }
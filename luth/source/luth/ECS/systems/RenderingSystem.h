@@ -3,12 +3,22 @@
 #include "luth/ECS/System.h"
 #include "luth/renderer/pipeline/RenderPipeline.h"
 #include "luth/renderer/pipeline/RenderPass.h"
+#include "luth/renderer/LightClusters.h"
+#include "luth/renderer/DynamicResolution.h"
 
 #include <entt/entt.hpp>
 #include <unordered_map>
 
 namespace Luth
 {
+    // std430 element of the point light SSBO
+    struct PointLightUBO {
+        alignas(16) Vec3 color;
+        float intensity;
+        alignas(16) Vec3 position;
+        float range;
+    };
+
     class RenderingSystem : public System
     {
     public:
@@ -25,25 +35,41 @@ namespace Luth
         const std::string& GetActiveTechniqueName() const;
         RenderPipeline* GetActivePipeline() const { return m_ActivePipeline; }
 
+        DynamicResolution& GetDynamicResolution() { return m_DynamicResolution; }
+
     private:
-        std::pair<std::vector<RenderCommand>, std::vector<RenderCommand>>
-            CollectCommands(entt::registry& registry);
+        void CollectCommands(entt::registry& registry, RenderContext& ctx);
+        u32 SelectLod(const WorldTransform& transform, MeshRenderer& meshRend) const;
+        bool CullClusters(const WorldTransform& transform, const MeshRenderer& meshRend,
+                          RenderCommand& cmd, RenderContext& ctx);
+        void UpdateRenderScale();
         void UpdateTransformUBO(const Mat4& view, const Mat4& proj, const Mat4& model);
         void UpdateLightsUBO(entt::registry& registry);
+        void UpdateLightClusters();
 
         // map of ready-to-go pipelines
         std::unordered_map<std::string, RenderPipeline> m_Pipelines;
         RenderPipeline* m_ActivePipeline = nullptr;
         std::string m_ActiveName;
 
-        // UBOs, camera, etc.
-        u32   m_TransformUBO, m_LightsUBO;
+        // Camera, viewport. The UBOs and SSBOs are streamed through the GLUploadRing
+        u32   m_ViewportWidth, m_ViewportHeight;
+        u32   m_RenderWidth = 0, m_RenderHeight = 0;     // Drawn part of the scaled targets
         Vec3  m_CameraPos;
+        Mat4  m_View;
+        Mat4  m_Projection;
         Mat4  m_ViewProj;
+
+        // Point lights and their per-cluster lists (SSBOs 6, 7, 8, see LuthClusters.glslh)
+        LightClusters m_Clusters;
+        std::vector<ClusterLight> m_ClusterLights;
+        std::vector<PointLightUBO> m_PointLights;
+        bool   m_DirLightWarned = false;
+
+        DynamicResolution m_DynamicResolution;
     };
 
     #define MAX_DIR_LIGHTS 4
-    #define MAX_POINT_LIGHTS 16
 
     struct DirLightUBO {
         alignas(16) Vec3 color;
@@ -52,28 +78,27 @@ namespace Luth
         float padding;
     };
 
-    struct PointLightUBO {
-        alignas(16) Vec3 color;
-        float intensity;
-        alignas(16) Vec3 position;
-        float range;
-    };
-
     struct LightsUBO {
         int dirLightCount = 0;
         DirLightUBO dirLights[MAX_DIR_LIGHTS];
 
-        int pointLightCount = 0;
-        PointLightUBO pointLights[MAX_POINT_LIGHTS];
+        int pointLightCount = 0;                // Point lights themselves live in SSBO 6
+        alignas(16) glm::uvec4 clusterGrid;     // Tiles x, y, depth slices
+        Vec4 clusterParams;                     // Slice scale, slice bias, orthographic
+        Vec4 clusterScreen;                     // Tiles per pixel x, y
     };
 
     struct TransformUBO {
         glm::mat4 view;
         glm::mat4 projection;
         glm::mat4 model;
+        glm::mat4 invView;          // For rebuilding positions from depth
+        glm::mat4 invProjection;
+        Vec4 renderScale = Vec4(1.0f);  // xy: drawn part of the scaled targets (RenderGraph)
 
-        TransformUBO() : view(1.0f), projection(1.0f), model(1.0f) {}
+        TransformUBO() : view(1.0f), projection(1.0f), model(1.0f), invView(1.0f), invProjection(1.0f) {}
 		TransformUBO(Mat4 view, Mat4 projection, Mat4 model)
-			: view(view), projection(projection), model(model) {}
+			: view(view), projection(projection), model(model),
+			  invView(glm::inverse(view)), invProjection(glm::inverse(projection)) {}
     };
 }
@@ -58,6 +58,7 @@ namespace Luth
 
             if (!m_Window->IsMinimized())
             {
+                Renderer::BeginFrame();
                 Systems::Update<TransformSystem>();
                 Systems::Update<AnimationSystem>();
                 Systems::Update<RenderingSystem>();
@@ -8,6 +8,7 @@
 #include <functional>
 #include <future>
 #include <memory>
+#include <algorithm>
 
 namespace Luth
 {
@@ -58,6 +59,45 @@ namespace Luth
             condition.wait(lock, [this] { return pendingTasks == 0; });
         }
 
+        // Splits [0, count) into chunks of at least 'grain' items, runs them
+        // as jobs and blocks until they finish. The calling thread takes the
+        // last chunk itself. fn(begin, end) must be safe to run concurrently.
+        template<class F>
+        void ParallelFor(size_t count, size_t grain, F&& fn)
+        {
+            if (count == 0) return;
+
+            grain = std::max<size_t>(grain, 1);
+            const size_t maxJobs = workers.size() + 1;
+            const size_t jobs = std::min(maxJobs, (count + grain - 1) / grain);
+            if (jobs <= 1) {
+                fn(size_t(0), count);
+                return;
+            }
+
+            const size_t chunk = (count + jobs - 1) / jobs;
+            std::vector<std::future<void>> futures;
+            futures.reserve(jobs - 1);
+
+            size_t begin = 0;
+            for (size_t j = 0; j + 1 < jobs && begin < count; ++j, begin += chunk) {
+                const size_t end = std::min(begin + chunk, count);
+                futures.push_back(Submit([&fn, begin, end] { fn(begin, end); }));
+            }
+            if (begin < count)
+                fn(begin, count);
+
+            for (auto& f : futures)
+                f.get();
+        }
+
+        // Engine-wide worker pool, leaves one hardware thread to the main loop
+        static ThreadPool& Get()
+        {
+            static ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+            return pool;
+        }
+
     private:
         void WorkLoop()
         {
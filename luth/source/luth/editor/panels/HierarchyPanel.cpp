@@ -342,31 +342,46 @@ namespace Luth
                 switch (assetType) {
                     case ResourceType::Model: {
                         std::shared_ptr<Model> model = ModelLibrary::Get(assetUuid);
-                        auto parent = m_Context->CreateEntity(model->GetName());
-                        parent.AddComponent<Children>();
-
-                        if (model->IsSkinned()) parent.AddComponent<Animation>(assetUuid);
-
-                        auto materials = model->GetMaterials();
-
-                        int meshIndex = 0;
-                        for (const auto& mesh : model->GetMeshesData()) {
-                            auto child = m_Context->CreateEntity(mesh.Name);
-
-                            child.AddComponent<Parent>();
-                            child.SetParent(parent);
-                            parent.GetChildren().push_back(child);
-
-                            auto& meshRend = child.AddComponent<MeshRenderer>();
-                            meshRend.modelNamePreview = model->GetName();
-                            meshRend.ModelUUID = assetUuid;
-                            meshRend.MeshIndex = meshIndex;
-							meshRend.isSkinned = model->IsSkinned();
-                            if (!model->GetMaterials().empty() && meshIndex < materials.size()) {
-                                meshRend.MaterialUUID = materials[meshIndex];
-                                meshRend.materialNamePreview = MaterialLibrary::Get(meshRend.MaterialUUID)->GetName();
+                        const auto& nodes = model->GetNodes();
+                        const auto& meshesData = model->GetMeshesData();
+                        const auto& materials = model->GetMaterials();
+
+                        // One entity per node, all referencing the model's shared meshes
+                        std::vector<Entity> nodeEntities;
+                        nodeEntities.reserve(nodes.size());
+                        for (const auto& node : nodes) {
+                            const bool isRoot = node.Parent < 0;
+                            auto entity = m_Context->CreateEntity(isRoot ? model->GetName() : node.Name);
+                            entity.GetComponent<Transform>().SetTransform(node.LocalTransform);
+
+                            if (isRoot) {
+                                entity.AddComponent<Children>();
+                                if (model->IsSkinned()) entity.AddComponent<Animation>(assetUuid);
+                            }
+                            else {
+                                entity.SetParent(nodeEntities[node.Parent]);
+                            }
+                            nodeEntities.push_back(entity);
+
+                            // A single mesh goes on the node itself, several get a child each
+                            for (u32 meshIndex : node.MeshIndices) {
+                                auto target = entity;
+                                if (isRoot || node.MeshIndices.size() > 1) {
+                                    target = m_Context->CreateEntity(meshesData[meshIndex].Name);
+                                    target.SetParent(entity);
+                                }
+
+                                auto& meshRend = target.AddComponent<MeshRenderer>();
+                                meshRend.modelNamePreview = model->GetName();
+                                meshRend.ModelUUID = assetUuid;
+                                meshRend.MeshIndex = meshIndex;
+                                meshRend.isSkinned = model->IsSkinned();
+                                if (meshIndex < materials.size() && materials[meshIndex]) {
+                                    meshRend.MaterialUUID = materials[meshIndex];
+                                    if (auto material = MaterialLibrary::Get(meshRend.MaterialUUID))
+                                        meshRend.materialNamePreview = material->GetName();
+                                }
                             }
-                            meshIndex++;
                         }
                         break;
                     }
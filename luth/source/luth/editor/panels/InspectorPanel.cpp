@@ -5,6 +5,7 @@
 #include "luth/resources/ResourceDB.h"
 #include "luth/resources/libraries/MaterialLibrary.h"
 #include "luth/resources/libraries/ModelLibrary.h"
+#include "luth/resources/libraries/VertexAnimationLibrary.h"
 #include "luth/utils/ImGuiUtils.h"
 #include "luth/utils/LuthIcons.h"
 
@@ -227,6 +228,18 @@ namespace Luth
                 ImGui::SameLine();
                 ImGui::SetNextItemWidth(20);
                 ImGui::DragInt("##MeshIndex", reinterpret_cast<int*>(&meshRenderer.MeshIndex), 1.0f, 0, meshCount - 1);
+
+                // LOD override, -1 lets the renderer pick by projected size
+                if (meshRenderer.MeshIndex < meshCount) {
+                    const i32 lodCount = (i32)model->GetMeshes()[meshRenderer.MeshIndex]->GetLodCount();
+                    if (lodCount > 1) {
+                        ImGui::Text("LOD %u", meshRenderer.CurrentLod);
+                        ImGui::SameLine();
+                        ImGui::SetNextItemWidth(80);
+                        ImGui::SliderInt("##ForcedLod", &meshRenderer.ForcedLod, -1, lodCount - 1,
+                            meshRenderer.ForcedLod < 0 ? "Auto" : "%d");
+                    }
+                }
             }
 
             // Material Selection
@@ -256,6 +269,15 @@ namespace Luth
         DrawComponent<Animation>("Animation", m_SelectedEntity, [](Entity entity, Animation& animation) {
 			// TODO: Implement animation component properties
 			ImGui::SliderInt("##Animation Index", &animation.AnimationIndex, 0, 20, "Index: %d", ImGuiSliderFlags_AlwaysClamp);
+            ImGui::Checkbox("CPU Skinning", &animation.CpuSkinning);
+        });
+
+        DrawComponent<BakedAnimation>("Baked Animation", m_SelectedEntity, [](Entity entity, BakedAnimation& baked) {
+            ImGui::SliderInt("##Baked Index", &baked.AnimationIndex, 0, 20, "Index: %d", ImGuiSliderFlags_AlwaysClamp);
+            ImGui::Text("Time Offset"); ImGui::SameLine();
+            ImGui::DragFloat("##Time Offset", &baked.TimeOffset, 0.01f, 0.0f, 1000.0f);
+            ImGui::Text("Speed"); ImGui::SameLine();
+            ImGui::DragFloat("##Speed", &baked.Speed, 0.01f, 0.0f, 10.0f);
         });
 
         DrawComponent<DirectionalLight>("Directional Light", m_SelectedEntity, [](Entity entity, DirectionalLight& dirLight) {
@@ -305,6 +327,11 @@ namespace Luth
                 m_SelectedEntity.AddOrReplaceComponent<PointLight>();
                 ImGui::CloseCurrentPopup();
             }
+            if (m_SelectedEntity.HasComponent<MeshRenderer>() && !m_SelectedEntity.HasComponent<BakedAnimation>()
+                && ImGui::MenuItem("Baked Animation")) {
+                m_SelectedEntity.AddOrReplaceComponent<BakedAnimation>();
+                ImGui::CloseCurrentPopup();
+            }
             // Add more components here as needed
         });
     }
@@ -373,6 +400,12 @@ namespace Luth
                 ImGui::TableSetColumnIndex(1);
                 ImGui::Text("%d", info.TotalMeshCount);
 
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::Text("Nodes");
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%d (%d mesh instances)", info.NodeCount, info.MeshInstanceCount);
+
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
                 ImGui::Text("Vertices");
@@ -404,11 +437,12 @@ namespace Luth
 
         // Meshes section
         if (ImGui::CollapsingHeader("Meshes")) {
-            if (ImGui::BeginTable("MeshesTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+            if (ImGui::BeginTable("MeshesTable", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
                 ImGui::TableSetupColumn("Name");
                 ImGui::TableSetupColumn("Vertices");
                 ImGui::TableSetupColumn("Indices");
                 ImGui::TableSetupColumn("Material");
+                ImGui::TableSetupColumn("Stride");
                 ImGui::TableHeadersRow();
 
                 for (const auto& mesh : info.Meshes) {
@@ -421,6 +455,48 @@ namespace Luth
                     ImGui::Text("%d", mesh.IndexCount);
                     ImGui::TableNextColumn();
                     ImGui::Text("%d", mesh.MaterialIndex);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d B", mesh.VertexStride);
+                }
+
+                ImGui::EndTable();
+            }
+        }
+        ImGui::Dummy({ 0, 4 });
+
+        // Vertex cache / overdraw statistics
+        if (ImGui::CollapsingHeader("Mesh Optimization")) {
+            if (ImGui::SmallButton("Analyze")) model.AnalyzeMeshes();
+
+            if (ImGui::BeginTable("OptimizationTable", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                ImGui::TableSetupColumn("Name");
+                ImGui::TableSetupColumn("Indices");
+                ImGui::TableSetupColumn("ACMR");
+                ImGui::TableSetupColumn("ATVR");
+                ImGui::TableSetupColumn("Overdraw");
+                ImGui::TableSetupColumn("LOD Triangles");
+                ImGui::TableSetupColumn("Meshlets");
+                ImGui::TableHeadersRow();
+
+                for (const auto& mesh : info.Meshes) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%s", mesh.Name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%d-bit", mesh.IndexSize * 8);
+                    for (f32 stat : { mesh.Stats.ACMR, mesh.Stats.ATVR, mesh.Stats.Overdraw }) {
+                        ImGui::TableNextColumn();
+                        if (mesh.Stats.Valid) ImGui::Text("%.3f", stat);
+                        else ImGui::TextDisabled("-");
+                    }
+                    ImGui::TableNextColumn();
+                    std::string lods;
+                    for (u32 count : mesh.LodIndexCounts)
+                        lods += (lods.empty() ? "" : " / ") + std::to_string(count / 3);
+                    ImGui::Text("%s", lods.c_str());
+                    ImGui::TableNextColumn();
+                    if (mesh.MeshletCount > 0) ImGui::Text("%u", mesh.MeshletCount);
+                    else ImGui::TextDisabled("-");
                 }
 
                 ImGui::EndTable();
@@ -477,13 +553,15 @@ namespace Luth
             if (ImGui::CollapsingHeader("Animations")) {
                 ImGui::Text("Total Animations: %d", info.AnimationCount);
 
-                if (ImGui::BeginTable("AnimationsTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                if (ImGui::BeginTable("AnimationsTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
                     ImGui::TableSetupColumn("Name");
                     ImGui::TableSetupColumn("Duration");
                     ImGui::TableSetupColumn("TPS");
+                    ImGui::TableSetupColumn("Vertex Anim");
                     ImGui::TableHeadersRow();
 
-                    for (const auto& anim : info.Animations) {
+                    for (i32 i = 0; i < (i32)info.Animations.size(); ++i) {
+                        const auto& anim = info.Animations[i];
                         ImGui::TableNextRow();
                         ImGui::TableNextColumn();
                         ImGui::Text("%s", anim.Name.c_str());
@@ -491,6 +569,12 @@ namespace Luth
                         ImGui::Text("%.2f", anim.Duration);
                         ImGui::TableNextColumn();
                         ImGui::Text("%.2f", anim.TicksPerSecond);
+                        ImGui::TableNextColumn();
+                        ImGui::PushID(i);
+                        if (ImGui::SmallButton("Bake")) {
+                            VertexAnimationLibrary::Bake(model.GetUUID(), i);
+                        }
+                        ImGui::PopID();
                     }
 
                     ImGui::EndTable();
@@ -541,6 +625,12 @@ namespace Luth
             ResourceDB::SetDirty(material.GetUUID());
         }
 
+        bool twoSided = material.IsTwoSided();
+        if (ImGui::Checkbox("Two Sided", &twoSided)) {
+            material.SetTwoSided(twoSided);
+            ResourceDB::SetDirty(material.GetUUID());
+        }
+
         if (material.GetRenderMode() == RendererAPI::RenderMode::Cutout) {
             float cutoff = material.GetAlphaCutoff();
             ImGui::Text("Alpha Cutoff"); ImGui::SameLine();
@@ -4,6 +4,8 @@
 #include "luth/ECS/Systems.h"
 #include "luth/ECS/Systems/RenderingSystem.h"
 #include "luth/utils/LuthIcons.h"
+#include "luth/renderer/openGL/GLState.h"
+#include "luth/resources/FileSystem.h"
 
 namespace Luth
 {
@@ -17,8 +19,7 @@ namespace Luth
         m_RS = Systems::GetSystem<RenderingSystem>();
         if (m_RS) {
             auto* p = m_RS->GetActivePipeline();
-            //m_SelectedAttachment = p->GetFinalColorAttachment();
-            m_SelectedAttachment = p->GetPass<PostProcessPass>()->GetGBuffer()->GetColorAttachmentID(0);
+            m_SelectedAttachment = p->GetFinalColorAttachment();
         }
     }
 
@@ -26,6 +27,14 @@ namespace Luth
     {
         if (!m_RS) return;
 
+        // The frame is rendered for the selected view, passes it doesn't need are culled.
+        // Graph textures change on resize and recompiles, look it up every frame
+        if (auto* pipeline = m_RS->GetActivePipeline()) {
+            pipeline->SetOutput(m_SelectedMode);
+            m_SelectedAttachment = pipeline->GetAttachmentByName(m_SelectedMode);
+            m_SelectedUVScale = pipeline->GetAttachmentUVScale(m_SelectedMode);
+        }
+
         ImGui::PushFont(Editor::GetFASolid());
         std::string render = ICON_FA_FILM + std::string("  Render");
         ImGui::Begin(render.c_str());
@@ -51,6 +60,9 @@ namespace Luth
                 DrawGroup(title, modes);
                 ImGui::Dummy({ 0, 4 });
             }
+            DrawGraphStats();
+            ImGui::Dummy({ 0, 4 });
+            DrawStateStats();
         }
         else {
             // Post process ==========================
@@ -58,8 +70,34 @@ namespace Luth
             auto g_SSAOPass = p->GetPass<SSAOPass>();
             auto g_PostProcessPass = p->GetPass<PostProcessPass>();
 
+            // Timings
+            if (ImGui::CollapsingHeader("Timings", ImGuiTreeNodeFlags_DefaultOpen)) {
+                DrawPassTimings();
+            }
+
+            // Dynamic resolution
+            if (ImGui::CollapsingHeader("Dynamic Resolution", ImGuiTreeNodeFlags_DefaultOpen)) {
+                DrawDynamicResolution();
+            }
+
+            // Depth pre-pass
+            if (ImGui::CollapsingHeader("Depth Pre-pass", ImGuiTreeNodeFlags_DefaultOpen)) {
+                DrawDepthPrepass();
+            }
+
             // SSAO
             if (ImGui::CollapsingHeader("SSAO", ImGuiTreeNodeFlags_DefaultOpen)) {
+                const char* qualities[] = { "Low", "Medium", "High", "Ultra" };
+                int quality = static_cast<int>(g_SSAOPass->GetQuality());
+                if (ImGui::Combo("Quality", &quality, qualities, IM_ARRAYSIZE(qualities))) {
+                    g_SSAOPass->SetQuality(static_cast<SSAOQuality>(quality));
+                }
+
+                bool temporal = g_SSAOPass->IsTemporal();
+                if (ImGui::Checkbox("Temporal", &temporal)) {
+                    g_SSAOPass->SetTemporal(temporal);
+                }
+
                 float ssaoRadius = g_SSAOPass->GetRadius();
                 if (ImGui::SliderFloat("Radius", &ssaoRadius, 0.0f, 10.0f)) {
                     g_SSAOPass->SetRadius(ssaoRadius);
@@ -88,9 +126,14 @@ namespace Luth
                     g_PostProcessPass->SetBloomStrength(bloomStrength);
                 }
 
-                int bloomPasses = g_PostProcessPass->GetBloomPasses();
-                if (ImGui::SliderInt("Passes", &bloomPasses, 1, 10)) {
-                    g_PostProcessPass->SetBloomPasses(bloomPasses);
+                int bloomMips = g_PostProcessPass->GetBloomMips();
+                if (ImGui::SliderInt("Mips", &bloomMips, 1, 10)) {
+                    g_PostProcessPass->SetBloomMips(bloomMips);
+                }
+
+                float bloomRadius = g_PostProcessPass->GetBloomRadius();
+                if (ImGui::SliderFloat("Radius", &bloomRadius, 0.5f, 3.0f)) {
+                    g_PostProcessPass->SetBloomRadius(bloomRadius);
                 }
             }
 
@@ -211,7 +254,10 @@ namespace Luth
 
             if (ImGui::Button(mode, ImVec2(120, 0))) {
                 m_SelectedMode = mode;
+                if (auto* geometry = pipeline->GetPass<GeometryPass>())
+                    geometry->SetDebugOutputs(GeometryPass::IsDebugView(m_SelectedMode));
                 m_SelectedAttachment = pipeline->GetAttachmentByName(m_SelectedMode);
+                m_SelectedUVScale = pipeline->GetAttachmentUVScale(m_SelectedMode);
             }
 
             if (isSelected)
@@ -219,6 +265,142 @@ namespace Luth
         }
     }
 
+    void RenderPanel::DrawGraphStats()
+    {
+        auto* pipeline = m_RS->GetActivePipeline();
+        if (!pipeline) return;
+
+        const auto& graph = pipeline->GetGraph();
+        const auto& stats = graph.GetStats();
+        constexpr float MB = 1.0f / (1024.0f * 1024.0f);
+
+        ImGui::TextUnformatted("RENDER GRAPH");
+        ImGui::Spacing();
+        ImGui::Text("Passes: %u run, %u culled", stats.Passes - stats.Culled, stats.Culled);
+        for (const auto& name : graph.GetCulledPasses())
+            ImGui::BulletText("%s", name.c_str());
+        ImGui::Text("Textures: %u in %u allocations", stats.Textures, stats.PhysicalTextures);
+        ImGui::Text("Memory: %.1f MB (%.1f MB unaliased)", stats.AllocatedBytes * MB, stats.RequestedBytes * MB);
+    }
+
+    void RenderPanel::DrawStateStats()
+    {
+        if (Renderer::GetAPI() != RendererAPI::API::OpenGL) return;
+
+        const auto& stats = GLState::GetStats();
+        const u32 total = stats.Issued + stats.Elided;
+
+        ImGui::TextUnformatted("GL STATE");
+        ImGui::Spacing();
+        ImGui::Text("Calls: %u issued, %u elided (%.0f%%)", stats.Issued, stats.Elided,
+                    total ? 100.0f * stats.Elided / total : 0.0f);
+    }
+
+    void RenderPanel::DrawPassTimings()
+    {
+        auto* pipeline = m_RS->GetActivePipeline();
+        if (!pipeline) return;
+
+        auto& profiler = pipeline->GetProfiler();
+        bool enabled = profiler.IsEnabled();
+        if (ImGui::Checkbox("Profile Passes", &enabled)) {
+            profiler.SetEnabled(enabled);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export Trace")) {
+            profiler.ExportTrace(FileSystem::LogPath() / "RenderTrace.json");
+        }
+        if (!enabled) return;
+        if (!profiler.HasGpuTimer()) ImGui::TextUnformatted("No GPU timer, CPU times only");
+
+        // Milliseconds over the last frames: average, 95th percentile
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+        if (!ImGui::BeginTable("PassTimings", 5, flags)) return;
+
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("GPU");
+        ImGui::TableSetupColumn("GPU p95");
+        ImGui::TableSetupColumn("CPU");
+        ImGui::TableSetupColumn("CPU p95");
+        ImGui::TableHeadersRow();
+
+        f32 gpuTotal = 0.0f, cpuTotal = 0.0f;
+        for (const auto& pass : profiler.GetStats()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(pass.Name.c_str());
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", pass.Gpu.Average);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", pass.Gpu.P95);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", pass.Cpu.Average);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", pass.Cpu.P95);
+            gpuTotal += pass.Gpu.Average;
+            cpuTotal += pass.Cpu.Average;
+        }
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn(); ImGui::TextUnformatted("Total");
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", gpuTotal);
+        ImGui::TableNextColumn();
+        ImGui::TableNextColumn(); ImGui::Text("%.3f", cpuTotal);
+        ImGui::EndTable();
+    }
+
+    void RenderPanel::DrawDynamicResolution()
+    {
+        auto& dynamicResolution = m_RS->GetDynamicResolution();
+        auto& settings = dynamicResolution.GetSettings();
+
+        ImGui::Checkbox("Enabled", &settings.Enabled);
+        ImGui::SliderFloat("Target (ms)", &settings.TargetMs, 4.0f, 50.0f, "%.1f");
+        ImGui::SliderFloat("Min Scale", &settings.MinScale, 0.25f, 1.0f, "%.2f");
+        // Also the fixed scale while disabled
+        ImGui::SliderFloat("Max Scale", &settings.MaxScale, 0.25f, 1.0f, "%.2f");
+        settings.MinScale = std::min(settings.MinScale, settings.MaxScale);
+
+        ImGui::Text("Scale: %.2f (%.0f%% of the pixels)", dynamicResolution.GetScale(),
+                    dynamicResolution.GetScale() * dynamicResolution.GetScale() * 100.0f);
+        ImGui::Text("Frame: %.2f ms", dynamicResolution.GetFrameTime());
+    }
+
+    void RenderPanel::DrawDepthPrepass()
+    {
+        auto* pipeline = m_RS->GetActivePipeline();
+        auto* geometry = pipeline ? pipeline->GetPass<GeometryPass>() : nullptr;
+        if (!geometry) return;
+
+        const char* modes[] = { "Off", "On", "Auto" };
+        int mode = static_cast<int>(geometry->GetDepthPrepass());
+        if (ImGui::Combo("Mode", &mode, modes, IM_ARRAYSIZE(modes))) {
+            geometry->SetDepthPrepass(static_cast<GeometryPass::DepthPrepass>(mode));
+        }
+
+        float threshold = geometry->GetOverdrawThreshold();
+        if (ImGui::SliderFloat("Overdraw Threshold", &threshold, 1.0f, 8.0f, "%.1f")) {
+            geometry->SetOverdrawThreshold(threshold);
+        }
+
+        const bool active = geometry->IsDepthPrepassActive();
+        ImGui::Text("Overdraw: %.2f, pre-pass %s", geometry->GetOverdraw(), active ? "on" : "off");
+
+        // A/B: flip the pre-pass, each side's time is kept once the profiler window only holds it
+        if (ImGui::Button("A/B Toggle")) {
+            geometry->SetDepthPrepass(active ? GeometryPass::DepthPrepass::Off : GeometryPass::DepthPrepass::On);
+        }
+
+        const auto& profiler = pipeline->GetProfiler();
+        if (!profiler.IsEnabled() || !profiler.HasGpuTimer()) {
+            ImGui::TextUnformatted("Needs pass profiling with a GPU timer");
+            return;
+        }
+
+        if (geometry->GetPrepassFrames() > PassProfiler::k_WindowSize + PassProfiler::k_FramesInFlight) {
+            for (const auto& pass : profiler.GetStats()) {
+                if (pass.Name == geometry->GetName()) m_GeometryTimes[active ? 1 : 0] = pass.Gpu.Median;
+            }
+        }
+
+        ImGui::Text("Geometry GPU: off %.3f ms, on %.3f ms", m_GeometryTimes[0], m_GeometryTimes[1]);
+    }
+
     void RenderPanel::ApplyRenderingSettings()
     {
         //glPolygonMode(GL_FRONT_AND_BACK, m_Wireframe ? GL_LINE : GL_FILL);
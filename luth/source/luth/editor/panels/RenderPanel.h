@@ -18,26 +18,34 @@ namespace Luth
         void OnRender() override;
 
         u32 GetSelectedAttachment() const { return m_SelectedAttachment; }
+        Vec2 GetSelectedUVScale() const { return m_SelectedUVScale; }
 
     private:
         // group definitions
         const std::vector<std::pair<const char*, std::vector<const char*>>> m_Groups = {
           { "RENDER",
-            { "Final", "No Post-Processing" }},
+            { "Final", "HDR" }},
           { "ANIMATION",
             { "Bones", "Bones Influence" } },
           { "MATERIAL CHANNELS",
             { "Base Color", "Metalness", "Roughness", "Normal Map", "Emission", "Specular F0", "Translucency", "Ambient Oclusion", "Opacity" }},
           { "GEOMETRY",
-            { "Position", "Normal", "MRAO", "ET", "SSAO", "Wireframe" } }
+            { "Position", "Normal", "MRAO", "SSAO", "Wireframe" } }
         };
 
         void DrawGroup(const char* title, const std::vector<const char*>& modes);
+        void DrawGraphStats();
+        void DrawStateStats();
+        void DrawPassTimings();
+        void DrawDynamicResolution();
+        void DrawDepthPrepass();
         void ApplyRenderingSettings();
         
         std::shared_ptr<RenderingSystem> m_RS;
         std::string m_SelectedMode;
         u32 m_SelectedAttachment = 0;
+        Vec2 m_SelectedUVScale = Vec2(1.0f);
+        f32 m_GeometryTimes[2] = {};    // Geometry pass GPU median, pre-pass off / on
 
         u32 m_SelectedTab = 0; // 0 for Model Viewer, 1 for Post Processing
     };
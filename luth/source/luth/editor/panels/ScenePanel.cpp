@@ -50,7 +50,10 @@ namespace Luth
             if (auto technique = m_RenderingSystem->GetActivePipeline()) {
                 i32 textureID = Editor::GetPanel<RenderPanel>()->GetSelectedAttachment();
                 if (textureID == -1) textureID = (i32)technique->GetFinalColorAttachment();
-                ImGui::Image(textureID, ToImVec2(m_ViewportSize), { 0, 1 }, { 1, 0 });
+
+                // Views before the upscale only fill part of their texture
+                const Vec2 uvScale = Editor::GetPanel<RenderPanel>()->GetSelectedUVScale();
+                ImGui::Image(textureID, ToImVec2(m_ViewportSize), { 0, uvScale.y }, { uvScale.x, 0 });
             }
 
             // Interaction states
@@ -27,13 +27,17 @@ namespace Luth
             case ShaderDataType::Float4:  return 4 * 4;
             case ShaderDataType::Mat3:    return 4 * 3 * 3;
             case ShaderDataType::Mat4:    return 4 * 4 * 4;
+            case ShaderDataType::UByte4:  return 1 * 4;
+            case ShaderDataType::UShort4: return 2 * 4;
+            case ShaderDataType::Short2:  return 2 * 2;
+            case ShaderDataType::Half2:   return 2 * 2;
             default:
                 LH_CORE_ASSERT(false, "Unknown ShaderDataType!");
                 return 0;
         }
     }
 
-    static VkFormat ShaderDataTypeToVkFormat(ShaderDataType type)
+    static VkFormat ShaderDataTypeToVkFormat(ShaderDataType type, bool normalized)
     {
         switch (type) {
             case ShaderDataType::Float:   return VK_FORMAT_R32_SFLOAT;
@@ -45,15 +49,19 @@ namespace Luth
             case ShaderDataType::Int3:    return VK_FORMAT_R32G32B32_SINT;
             case ShaderDataType::Int4:    return VK_FORMAT_R32G32B32A32_SINT;
             case ShaderDataType::Bool:    return VK_FORMAT_R8_UINT;
+            case ShaderDataType::UByte4:  return normalized ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_UINT;
+            case ShaderDataType::UShort4: return normalized ? VK_FORMAT_R16G16B16A16_UNORM : VK_FORMAT_R16G16B16A16_UINT;
+            case ShaderDataType::Short2:  return normalized ? VK_FORMAT_R16G16_SNORM : VK_FORMAT_R16G16_SINT;
+            case ShaderDataType::Half2:   return VK_FORMAT_R16G16_SFLOAT;
             default:
                 LH_CORE_ASSERT(false, "Unknown ShaderDataType!");
                 return VK_FORMAT_UNDEFINED;
         }
     }
 
-    BufferElement::BufferElement(ShaderDataType type, const std::string& name, bool normalized)
+    BufferElement::BufferElement(ShaderDataType type, const std::string& name, bool normalized, int32_t location)
         : Name(name), Type(type), Size(ShaderDataTypeSize(type)),
-        Offset(0), Normalized(normalized) {}
+        Offset(0), Normalized(normalized), Location(location) {}
 
     uint32_t BufferElement::GetComponentCount() const
     {
@@ -70,12 +78,31 @@ namespace Luth
             case ShaderDataType::Float4:  return 4;
             case ShaderDataType::Mat3:    return 3 * 3;
             case ShaderDataType::Mat4:    return 4 * 4;
+            case ShaderDataType::UByte4:  return 4;
+            case ShaderDataType::UShort4: return 4;
+            case ShaderDataType::Short2:  return 2;
+            case ShaderDataType::Half2:   return 2;
             default:
                 LH_CORE_ASSERT(false, "Unknown ShaderDataType!");
                 return 0;
         }
     }
 
+    bool BufferElement::IsInteger() const
+    {
+        switch (Type)
+        {
+            case ShaderDataType::Int:
+            case ShaderDataType::Int2:
+            case ShaderDataType::Int3:
+            case ShaderDataType::Int4:    return true;
+            case ShaderDataType::UByte4:
+            case ShaderDataType::UShort4:
+            case ShaderDataType::Short2:  return !Normalized;
+            default:                      return false;
+        }
+    }
+
     // Buffer Layout
     BufferLayout::BufferLayout(std::initializer_list<BufferElement> elements)
         : m_Elements(elements) {
@@ -85,11 +112,15 @@ namespace Luth
     void BufferLayout::CalculateOffsetsAndStride()
     {
         uint32_t offset = 0;
+        int32_t location = 0;
         m_Stride = 0;
         for (auto& element : m_Elements) {
             element.Offset = offset;
             offset += element.Size;
             m_Stride += element.Size;
+
+            if (element.Location < 0) element.Location = location;
+            location = element.Location + 1;
         }
     }
 
@@ -109,13 +140,12 @@ namespace Luth
     std::vector<VkVertexInputAttributeDescription> BufferLayout::GetAttributeDescriptions() const
     {
         std::vector<VkVertexInputAttributeDescription> descriptions;
-        uint32_t location = 0;
 
         for (const auto& element : m_Elements) {
             VkVertexInputAttributeDescription attributeDescription{};
             attributeDescription.binding = 0;
-            attributeDescription.location = location++;
-            attributeDescription.format = ShaderDataTypeToVkFormat(element.Type);
+            attributeDescription.location = static_cast<uint32_t>(element.Location);
+            attributeDescription.format = ShaderDataTypeToVkFormat(element.Type, element.Normalized);
             attributeDescription.offset = element.Offset;
 
             descriptions.push_back(attributeDescription);
@@ -190,7 +220,7 @@ namespace Luth
         switch (Renderer::GetAPI())
         {
             case RendererAPI::API::OpenGL:
-                return std::make_shared<GLIndexBuffer>(indices, count);
+                return std::make_shared<GLIndexBuffer>(indices, count, IndexType::UInt32);
 
             case RendererAPI::API::Vulkan:
             {
@@ -211,4 +241,24 @@ namespace Luth
                 return nullptr;
         }
     }
+
+    std::shared_ptr<IndexBuffer> IndexBuffer::Create(const uint16_t* indices, uint32_t count)
+    {
+        switch (Renderer::GetAPI())
+        {
+            case RendererAPI::API::OpenGL:
+                return std::make_shared<GLIndexBuffer>(indices, count, IndexType::UInt16);
+
+            case RendererAPI::API::Vulkan:
+            {
+                // The Vulkan path always binds VK_INDEX_TYPE_UINT32
+                std::vector<uint32_t> widened(indices, indices + count);
+                return Create(widened.data(), count);
+            }
+
+            default:
+                LH_CORE_ASSERT(false, "Unknown RendererAPI!");
+                return nullptr;
+        }
+    }
 }
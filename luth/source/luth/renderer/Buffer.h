@@ -16,7 +16,10 @@ namespace Luth
         Bool,
         Int, Int2, Int3, Int4,
         Float, Float2, Float3, Float4,
-        Mat3, Mat4
+        Mat3, Mat4,
+        UByte4, UShort4,    // Integer, or unorm when BufferElement::Normalized
+        Short2,             // Integer, or snorm when BufferElement::Normalized
+        Half2
     };
 
     struct BufferElement
@@ -26,11 +29,14 @@ namespace Luth
         uint32_t Size;
         uint32_t Offset;
         bool Normalized;
+        int32_t Location;   // Shader attribute location, -1 follows the previous element
 
         BufferElement() = default;
-        BufferElement(ShaderDataType type, const std::string& name, bool normalized = false);
+        BufferElement(ShaderDataType type, const std::string& name, bool normalized = false, int32_t location = -1);
 
         uint32_t GetComponentCount() const;
+        // True when the shader reads the attribute as an integer (ivec/uvec)
+        bool IsInteger() const;
     };
 
     class BufferLayout
@@ -68,6 +74,8 @@ namespace Luth
         static std::shared_ptr<VertexBuffer> Create(const void* data, uint32_t size);
     };
 
+    enum class IndexType { UInt16, UInt32 };
+
     class IndexBuffer
     {
     public:
@@ -76,7 +84,9 @@ namespace Luth
         virtual void Bind() const = 0;
         virtual void Unbind() const = 0;
         virtual uint32_t GetCount() const = 0;
+        virtual IndexType GetIndexType() const = 0;
 
         static std::shared_ptr<IndexBuffer> Create(const uint32_t* indices, uint32_t count);
+        static std::shared_ptr<IndexBuffer> Create(const uint16_t* indices, uint32_t count);
     };
 }
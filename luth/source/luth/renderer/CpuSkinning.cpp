@@ -0,0 +1,324 @@
+#include "luthpch.h"
+#include "luth/renderer/CpuSkinning.h"
+#include "luth/renderer/SkinnedModel.h"
+#include "luth/resources/libraries/ModelLibrary.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define LH_SKINNING_X64 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define LH_TARGET_AVX2
+    #else
+        #define LH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#else
+    #define LH_SKINNING_X64 0
+#endif
+
+namespace Luth
+{
+    namespace
+    {
+        constexpr size_t k_SkinningGrain = 2048;
+
+        constexpr f32 k_WeightScale = 1.0f / 65535.0f;
+
+        // Drops influences the palette cannot resolve, returns false if none remain
+        inline bool GatherInfluences(const VertexBoneData& b, u32 paletteSize, u32 ids[4], f32 weights[4])
+        {
+            bool any = false;
+            for (int i = 0; i < 4; ++i) {
+                const bool valid = b.BoneIDs[i] < paletteSize && b.Weights[i] > 0;
+                ids[i] = valid ? b.BoneIDs[i] : 0u;
+                weights[i] = valid ? b.Weights[i] * k_WeightScale : 0.0f;
+                any |= valid;
+            }
+            return any;
+        }
+
+        inline Vec3 SafeNormalize(const Vec3& v)
+        {
+            const f32 len2 = glm::dot(v, v);
+            return len2 > 0.0f ? v * (1.0f / std::sqrt(len2)) : v;
+        }
+
+        inline void GrowBounds(const Vec3& p, Vec3& bmin, Vec3& bmax)
+        {
+            bmin = glm::min(bmin, p);
+            bmax = glm::max(bmax, p);
+        }
+    }
+
+    // ============================================================================
+    //                                  SCALAR
+    // ============================================================================
+
+    void CpuSkinning::SkinScalar(const Vertex* vertices, const VertexBoneData* bones, size_t begin, size_t end,
+                                 const Mat4* palette, u32 paletteSize,
+                                 Vec3* outPositions, Vec3* outNormals, Vec3* outTangents,
+                                 Vec3& boundsMin, Vec3& boundsMax)
+    {
+        u32 ids[4];
+        f32 weights[4];
+
+        for (size_t i = begin; i < end; ++i) {
+            const Vertex& v = vertices[i];
+
+            Mat4 skin(1.0f);
+            if (GatherInfluences(bones[i], paletteSize, ids, weights)) {
+                skin  = palette[ids[0]] * weights[0];
+                skin += palette[ids[1]] * weights[1];
+                skin += palette[ids[2]] * weights[2];
+                skin += palette[ids[3]] * weights[3];
+            }
+
+            const Mat3 rotation(skin);
+            const Vec3 position = Vec3(skin * Vec4(v.Position, 1.0f));
+
+            outPositions[i] = position;
+            outNormals[i]   = SafeNormalize(rotation * v.Normal);
+            outTangents[i]  = SafeNormalize(rotation * v.Tangent);
+            GrowBounds(position, boundsMin, boundsMax);
+        }
+    }
+
+    // ============================================================================
+    //                                   SIMD
+    // ============================================================================
+
+#if LH_SKINNING_X64
+    namespace
+    {
+        LH_TARGET_AVX2 inline void StoreVec3(__m128 v, Vec3& out)
+        {
+            alignas(16) f32 tmp[4];
+            _mm_store_ps(tmp, v);
+            out = Vec3(tmp[0], tmp[1], tmp[2]);
+        }
+
+        LH_TARGET_AVX2 inline __m128 Normalize3(__m128 v)
+        {
+            const __m128 len2 = _mm_dp_ps(v, v, 0x7F);
+            const __m128 mask = _mm_cmpgt_ps(len2, _mm_setzero_ps());
+            const __m128 n = _mm_div_ps(v, _mm_sqrt_ps(len2));
+            return _mm_blendv_ps(v, n, mask);
+        }
+    }
+
+    LH_TARGET_AVX2
+    void CpuSkinning::SkinSIMD(const Vertex* vertices, const VertexBoneData* bones, size_t begin, size_t end,
+                               const Mat4* palette, u32 paletteSize,
+                               Vec3* outPositions, Vec3* outNormals, Vec3* outTangents,
+                               Vec3& boundsMin, Vec3& boundsMax)
+    {
+        static const Mat4 s_Identity(1.0f);
+
+        __m128 bmin = _mm_setr_ps(boundsMin.x, boundsMin.y, boundsMin.z, 0.0f);
+        __m128 bmax = _mm_setr_ps(boundsMax.x, boundsMax.y, boundsMax.z, 0.0f);
+
+        u32 ids[4];
+        f32 weights[4];
+
+        for (size_t i = begin; i < end; ++i) {
+            const Vertex& v = vertices[i];
+
+            // Blend the 4x4 bone matrices, two columns per 256-bit lane pair
+            __m256 lo, hi;
+            if (GatherInfluences(bones[i], paletteSize, ids, weights)) {
+                const f32* m0 = glm::value_ptr(palette[ids[0]]);
+                const f32* m1 = glm::value_ptr(palette[ids[1]]);
+                const f32* m2 = glm::value_ptr(palette[ids[2]]);
+                const f32* m3 = glm::value_ptr(palette[ids[3]]);
+
+                const __m256 w0 = _mm256_set1_ps(weights[0]);
+                const __m256 w1 = _mm256_set1_ps(weights[1]);
+                const __m256 w2 = _mm256_set1_ps(weights[2]);
+                const __m256 w3 = _mm256_set1_ps(weights[3]);
+
+                lo = _mm256_mul_ps(w0, _mm256_loadu_ps(m0));
+                hi = _mm256_mul_ps(w0, _mm256_loadu_ps(m0 + 8));
+                lo = _mm256_fmadd_ps(w1, _mm256_loadu_ps(m1), lo);
+                hi = _mm256_fmadd_ps(w1, _mm256_loadu_ps(m1 + 8), hi);
+                lo = _mm256_fmadd_ps(w2, _mm256_loadu_ps(m2), lo);
+                hi = _mm256_fmadd_ps(w2, _mm256_loadu_ps(m2 + 8), hi);
+                lo = _mm256_fmadd_ps(w3, _mm256_loadu_ps(m3), lo);
+                hi = _mm256_fmadd_ps(w3, _mm256_loadu_ps(m3 + 8), hi);
+            }
+            else {
+                lo = _mm256_loadu_ps(glm::value_ptr(s_Identity));
+                hi = _mm256_loadu_ps(glm::value_ptr(s_Identity) + 8);
+            }
+
+            const __m128 c0 = _mm256_castps256_ps128(lo);
+            const __m128 c1 = _mm256_extractf128_ps(lo, 1);
+            const __m128 c2 = _mm256_castps256_ps128(hi);
+            const __m128 c3 = _mm256_extractf128_ps(hi, 1);
+
+            // Position (w = 1)
+            __m128 p = _mm_fmadd_ps(c0, _mm_set1_ps(v.Position.x), c3);
+            p = _mm_fmadd_ps(c1, _mm_set1_ps(v.Position.y), p);
+            p = _mm_fmadd_ps(c2, _mm_set1_ps(v.Position.z), p);
+
+            // Normal / tangent (upper 3x3 only)
+            __m128 n = _mm_mul_ps(c0, _mm_set1_ps(v.Normal.x));
+            n = _mm_fmadd_ps(c1, _mm_set1_ps(v.Normal.y), n);
+            n = _mm_fmadd_ps(c2, _mm_set1_ps(v.Normal.z), n);
+
+            __m128 t = _mm_mul_ps(c0, _mm_set1_ps(v.Tangent.x));
+            t = _mm_fmadd_ps(c1, _mm_set1_ps(v.Tangent.y), t);
+            t = _mm_fmadd_ps(c2, _mm_set1_ps(v.Tangent.z), t);
+
+            StoreVec3(p, outPositions[i]);
+            StoreVec3(Normalize3(n), outNormals[i]);
+            StoreVec3(Normalize3(t), outTangents[i]);
+
+            bmin = _mm_min_ps(bmin, p);
+            bmax = _mm_max_ps(bmax, p);
+        }
+
+        StoreVec3(bmin, boundsMin);
+        StoreVec3(bmax, boundsMax);
+    }
+
+    bool CpuSkinning::HasSIMD()
+    {
+        static const bool s_Supported = [] {
+        #if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+
+            __cpuid(info, 1);
+            const bool fma     = (info[2] & (1 << 12)) != 0;
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx     = (info[2] & (1 << 28)) != 0;
+            if (!fma || !osxsave || !avx) return false;
+
+            // OS must preserve YMM state
+            if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+        #else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        #endif
+        }();
+        return s_Supported;
+    }
+#else
+    void CpuSkinning::SkinSIMD(const Vertex* vertices, const VertexBoneData* bones, size_t begin, size_t end,
+                               const Mat4* palette, u32 paletteSize,
+                               Vec3* outPositions, Vec3* outNormals, Vec3* outTangents,
+                               Vec3& boundsMin, Vec3& boundsMax)
+    {
+        SkinScalar(vertices, bones, begin, end, palette, paletteSize,
+                   outPositions, outNormals, outTangents, boundsMin, boundsMax);
+    }
+
+    bool CpuSkinning::HasSIMD() { return false; }
+#endif
+
+    // ============================================================================
+    //                                 DISPATCH
+    // ============================================================================
+
+    void CpuSkinning::Skin(const std::vector<Vertex>& vertices, const std::vector<VertexBoneData>& bones,
+                           const std::vector<Mat4>& palette, SkinnedMeshCache& out, bool forceScalar)
+    {
+        LH_CORE_ASSERT(vertices.size() == bones.size(), "Vertex and bone streams differ in size!");
+        const size_t count = vertices.size();
+        out.Positions.resize(count);
+        out.Normals.resize(count);
+        out.Tangents.resize(count);
+        out.BoundsMin = Vec3(FLOAT_MAX);
+        out.BoundsMax = Vec3(-FLOAT_MAX);
+
+        if (count == 0) {
+            out.BoundsMin = out.BoundsMax = Vec3(0.0f);
+            return;
+        }
+
+        const bool simd = !forceScalar && HasSIMD();
+        const u32 paletteSize = static_cast<u32>(palette.size());
+        std::mutex boundsMutex;
+
+        ThreadPool::Get().ParallelFor(count, k_SkinningGrain, [&](size_t begin, size_t end) {
+            Vec3 bmin(FLOAT_MAX), bmax(-FLOAT_MAX);
+            if (simd) {
+                SkinSIMD(vertices.data(), bones.data(), begin, end, palette.data(), paletteSize,
+                         out.Positions.data(), out.Normals.data(), out.Tangents.data(), bmin, bmax);
+            }
+            else {
+                SkinScalar(vertices.data(), bones.data(), begin, end, palette.data(), paletteSize,
+                           out.Positions.data(), out.Normals.data(), out.Tangents.data(), bmin, bmax);
+            }
+
+            std::lock_guard lock(boundsMutex);
+            out.BoundsMin = glm::min(out.BoundsMin, bmin);
+            out.BoundsMax = glm::max(out.BoundsMax, bmax);
+        });
+    }
+
+    // ============================================================================
+    //                               VERTEX CACHE
+    // ============================================================================
+
+    void SkinnedVertexCache::SetPalette(entt::entity entity, const UUID& modelUUID, const std::vector<Mat4>& palette)
+    {
+        std::lock_guard lock(s_Mutex);
+        Entry& entry = s_Entries[entity];
+        if (entry.ModelUUID != modelUUID) {
+            entry.ModelUUID = modelUUID;
+            entry.Meshes.clear();
+        }
+        entry.Palette = palette;
+        entry.Version++;
+    }
+
+    const SkinnedMeshCache* SkinnedVertexCache::Get(entt::entity entity, u32 meshIndex)
+    {
+        std::lock_guard lock(s_Mutex);
+        auto it = s_Entries.find(entity);
+        if (it == s_Entries.end()) return nullptr;
+        return SkinMesh(it->second, meshIndex);
+    }
+
+    void SkinnedVertexCache::Remove(entt::entity entity)
+    {
+        std::lock_guard lock(s_Mutex);
+        s_Entries.erase(entity);
+    }
+
+    void SkinnedVertexCache::RemoveModel(const UUID& modelUUID)
+    {
+        std::lock_guard lock(s_Mutex);
+        std::erase_if(s_Entries, [&](const auto& entry) { return entry.second.ModelUUID == modelUUID; });
+    }
+
+    void SkinnedVertexCache::Clear()
+    {
+        std::lock_guard lock(s_Mutex);
+        s_Entries.clear();
+    }
+
+    const SkinnedMeshCache* SkinnedVertexCache::SkinMesh(Entry& entry, u32 meshIndex)
+    {
+        auto skinned = std::dynamic_pointer_cast<SkinnedModel>(ModelLibrary::Get(entry.ModelUUID));
+        if (!skinned || meshIndex >= skinned->GetSkinnedMeshCount()) return nullptr;
+
+        if (entry.Meshes.size() < skinned->GetSkinnedMeshCount())
+            entry.Meshes.resize(skinned->GetSkinnedMeshCount());
+
+        SkinnedMeshCache& mesh = entry.Meshes[meshIndex];
+        if (mesh.Version != entry.Version) {
+            CpuSkinning::Skin(skinned->GetMeshesData()[meshIndex].Vertices,
+                              skinned->GetBoneData(meshIndex), entry.Palette, mesh);
+            mesh.Version = entry.Version;
+        }
+        return &mesh;
+    }
+}
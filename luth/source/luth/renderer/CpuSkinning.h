@@ -0,0 +1,83 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/core/UUID.h"
+
+#include <entt/entt.hpp>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Luth
+{
+    struct Vertex;
+    struct VertexBoneData;
+
+    // Skinned vertex streams of a single submesh, in model space
+    struct SkinnedMeshCache {
+        std::vector<Vec3> Positions;
+        std::vector<Vec3> Normals;
+        std::vector<Vec3> Tangents;
+        Vec3 BoundsMin = Vec3(0.0f);
+        Vec3 BoundsMax = Vec3(0.0f);
+        u64 Version = 0;
+    };
+
+    namespace CpuSkinning
+    {
+        // Skins vertices [begin, end) into the output arrays (indexed from 'begin').
+        // Bounds are grown, not reset. Mirrors the skinning in LuthDeferredGeo.glsl,
+        // except that vertices without valid influences keep their bind pose.
+
+        // Scalar reference path
+        void SkinScalar(const Vertex* vertices, const VertexBoneData* bones, size_t begin, size_t end,
+                        const Mat4* palette, u32 paletteSize,
+                        Vec3* outPositions, Vec3* outNormals, Vec3* outTangents,
+                        Vec3& boundsMin, Vec3& boundsMax);
+
+        // AVX2 + FMA path, only valid when HasSIMD() returns true
+        void SkinSIMD(const Vertex* vertices, const VertexBoneData* bones, size_t begin, size_t end,
+                      const Mat4* palette, u32 paletteSize,
+                      Vec3* outPositions, Vec3* outNormals, Vec3* outTangents,
+                      Vec3& boundsMin, Vec3& boundsMax);
+
+        bool HasSIMD();
+
+        // Skins a whole vertex stream as ThreadPool jobs, picking the SIMD path when available
+        void Skin(const std::vector<Vertex>& vertices, const std::vector<VertexBoneData>& bones,
+                  const std::vector<Mat4>& palette, SkinnedMeshCache& out, bool forceScalar = false);
+    }
+
+    // Per-entity skinned vertices, skinned once per palette update and reused by every
+    // consumer within the frame. Palettes are recorded by the AnimationSystem, which draws
+    // the result of entities with Animation::CpuSkinning instead of skinning on the GPU.
+    // Submeshes are skinned on first request after each palette update.
+    // Returned pointers stay valid until the next SetPalette/Remove on that entity.
+    class SkinnedVertexCache
+    {
+    public:
+        static void SetPalette(entt::entity entity, const UUID& modelUUID, const std::vector<Mat4>& palette);
+
+        static const SkinnedMeshCache* Get(entt::entity entity, u32 meshIndex);
+
+        // Entity destroyed or no longer animated
+        static void Remove(entt::entity entity);
+        // Model unloaded or reloaded, its vertex streams are gone
+        static void RemoveModel(const UUID& modelUUID);
+        static void Clear();
+
+    private:
+        struct Entry {
+            UUID ModelUUID;
+            std::vector<Mat4> Palette;
+            u64 Version = 0;
+            std::vector<SkinnedMeshCache> Meshes;
+        };
+
+        static const SkinnedMeshCache* SkinMesh(Entry& entry, u32 meshIndex);
+
+        static inline std::unordered_map<entt::entity, Entry> s_Entries;
+        static inline std::mutex s_Mutex;
+    };
+}
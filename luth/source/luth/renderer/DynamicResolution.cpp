@@ -0,0 +1,25 @@
+#include "luthpch.h"
+#include "luth/renderer/DynamicResolution.h"
+
+namespace Luth
+{
+    f32 DynamicResolution::Update(f32 frameMs)
+    {
+        m_FrameMs = m_FrameMs > 0.0f ? m_FrameMs + (frameMs - m_FrameMs) * 0.1f : frameMs;
+
+        const f32 maxScale = std::max(m_Settings.MaxScale, m_Settings.MinScale);
+        if (!m_Settings.Enabled || frameMs <= 0.0f || m_Settings.TargetMs <= 0.0f) {
+            m_Scale = maxScale;
+            m_PrevError = 0.0f;
+            return m_Scale;
+        }
+
+        f32 error = 1.0f - frameMs / m_Settings.TargetMs;
+        if (error > 0.0f && error < m_Settings.DeadBand) error = 0.0f;     // Over budget always counts
+
+        m_Scale += m_Settings.Proportional * (error - m_PrevError) + m_Settings.Integral * error;
+        m_Scale = std::clamp(m_Scale, m_Settings.MinScale, maxScale);
+        m_PrevError = error;
+        return m_Scale;
+    }
+}
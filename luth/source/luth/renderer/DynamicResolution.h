@@ -0,0 +1,43 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+namespace Luth
+{
+    // Picks the fraction of the viewport the scene is rendered at so frames fit a time
+    // budget. PI controller in velocity form on the relative headroom, 1 - frame / target:
+    // the proportional term answers changes of the headroom, the integral term walks the
+    // scale until the frame time settles on the target. Clamping the output is all the
+    // anti-windup the velocity form needs. Pixel cost goes with the square of the scale,
+    // so the gains are small.
+    //
+    // Measurements arrive a few frames late (GPU queries). Headroom inside the dead band is
+    // ignored so the scale settles just under the target instead of hunting around it.
+    class DynamicResolution
+    {
+    public:
+        struct Settings {
+            bool Enabled = false;
+            f32 TargetMs = 16.6f;
+            f32 MinScale = 0.5f;
+            f32 MaxScale = 1.0f;        // Also the scale while disabled
+            f32 Proportional = 0.1f;
+            f32 Integral = 0.02f;
+            f32 DeadBand = 0.05f;       // Relative headroom
+        };
+
+        // frameMs: cost of a recent frame, returns the scale to render the next one at
+        f32 Update(f32 frameMs);
+
+        f32 GetScale() const { return m_Scale; }
+        f32 GetFrameTime() const { return m_FrameMs; }
+
+        Settings& GetSettings() { return m_Settings; }
+
+    private:
+        Settings m_Settings;
+        f32 m_Scale = 1.0f;
+        f32 m_PrevError = 0.0f;
+        f32 m_FrameMs = 0.0f;       // Smoothed, for display
+    };
+}
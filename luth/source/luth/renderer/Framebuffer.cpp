@@ -1,5 +1,6 @@
 #include "luthpch.h"
 #include "luth/renderer/Framebuffer.h"
+#include "luth/renderer/openGL/GLState.h"
 
 #include <glad/glad.h>
 
@@ -18,18 +19,18 @@ namespace Luth
     Framebuffer::~Framebuffer()
     {
         DeleteAttachments();
-        glDeleteFramebuffers(1, &m_RendererID);
+        GLState::DeleteFramebuffers(1, &m_RendererID);
     }
 
     void Framebuffer::Bind()
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
-        glViewport(0, 0, m_Spec.Width, m_Spec.Height);
+        GLState::BindFramebuffer(m_RendererID);
+        GLState::Viewport(0, 0, m_Spec.Width, m_Spec.Height);
     }
 
     void Framebuffer::Unbind()
     {
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GLState::BindFramebuffer(0);
     }
 
     void Framebuffer::Resize(u32 width, u32 height)
@@ -50,7 +51,7 @@ namespace Luth
             LH_CORE_ERROR("Framebuffer color attachment index out of range!");
             return;
         }
-        glBindTextureUnit(slot, m_ColorAttachments[index]);
+        GLState::BindTextureUnit(slot, m_ColorAttachments[index]);
     }
 
     void Framebuffer::BindDepthAsTexture(u32 slot) const
@@ -63,7 +64,7 @@ namespace Luth
             LH_CORE_ERROR("Depth/stencil attachment is not a texture!");
             return;
         }
-        glBindTextureUnit(slot, m_DepthAttachment);
+        GLState::BindTextureUnit(slot, m_DepthAttachment);
     }
 
     std::vector<std::pair<std::string, u32>> Framebuffer::GetAllAttachments() const
@@ -109,11 +110,11 @@ namespace Luth
     {
         if (m_RendererID) {
             DeleteAttachments();
-            glDeleteFramebuffers(1, &m_RendererID);
+            GLState::DeleteFramebuffers(1, &m_RendererID);
         }
 
         glCreateFramebuffers(1, &m_RendererID);
-        glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+        GLState::BindFramebuffer(m_RendererID);
 
         // Color attachments
         std::vector<GLenum> drawBuffers;
@@ -209,7 +210,7 @@ namespace Luth
             LH_CORE_ERROR("Framebuffer is incomplete: {0}", status);
         }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        GLState::BindFramebuffer(0);
     }
 
     void Framebuffer::DeleteAttachments()
@@ -218,7 +219,7 @@ namespace Luth
         for (size_t i = 0; i < m_ColorAttachments.size(); ++i) {
             const auto& id = m_ColorAttachments[i];
             if (m_Spec.ColorAttachments[i].IsTexture) {
-                glDeleteTextures(1, &id);
+                GLState::DeleteTextures(1, &id);
             }
             else {
                 glDeleteRenderbuffers(1, &id);
@@ -231,7 +232,7 @@ namespace Luth
             if (m_Spec.DepthStencilAttachment.has_value()) {
                 const auto& depthSpec = m_Spec.DepthStencilAttachment.value();
                 if (depthSpec.IsTexture) {
-                    glDeleteTextures(1, &m_DepthAttachment);
+                    GLState::DeleteTextures(1, &m_DepthAttachment);
                 }
                 else {
                     glDeleteRenderbuffers(1, &m_DepthAttachment);
@@ -0,0 +1,81 @@
+#include "luthpch.h"
+#include "luth/renderer/GeometryAllocator.h"
+
+namespace Luth
+{
+    FreeListAllocator::FreeListAllocator(u32 capacity)
+        : m_Capacity(capacity)
+    {
+        if (capacity > 0) m_FreeBlocks[0] = capacity;
+    }
+
+    u32 FreeListAllocator::Allocate(u32 size)
+    {
+        if (size == 0) return k_Invalid;
+
+        for (auto it = m_FreeBlocks.begin(); it != m_FreeBlocks.end(); ++it) {
+            const auto [offset, blockSize] = *it;
+            if (blockSize < size) continue;
+
+            m_FreeBlocks.erase(it);
+            if (blockSize > size) m_FreeBlocks[offset + size] = blockSize - size;
+
+            m_Allocations[offset] = size;
+            m_Used += size;
+            return offset;
+        }
+        return k_Invalid;
+    }
+
+    void FreeListAllocator::Free(u32 offset)
+    {
+        auto allocation = m_Allocations.find(offset);
+        if (allocation == m_Allocations.end()) return;
+
+        u32 size = allocation->second;
+        m_Used -= size;
+        m_Allocations.erase(allocation);
+
+        // Merge with the following free block
+        auto next = m_FreeBlocks.lower_bound(offset);
+        if (next != m_FreeBlocks.end() && offset + size == next->first) {
+            size += next->second;
+            next = m_FreeBlocks.erase(next);
+        }
+
+        // Merge with the preceding free block
+        if (next != m_FreeBlocks.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                prev->second += size;
+                return;
+            }
+        }
+        m_FreeBlocks[offset] = size;
+    }
+
+    void FreeListAllocator::Grow(u32 newCapacity)
+    {
+        if (newCapacity <= m_Capacity) return;
+
+        const u32 added = newCapacity - m_Capacity;
+        if (!m_FreeBlocks.empty()) {
+            auto last = std::prev(m_FreeBlocks.end());
+            if (last->first + last->second == m_Capacity) {
+                last->second += added;
+                m_Capacity = newCapacity;
+                return;
+            }
+        }
+        m_FreeBlocks[m_Capacity] = added;
+        m_Capacity = newCapacity;
+    }
+
+    u32 FreeListAllocator::GetLargestFreeBlock() const
+    {
+        u32 largest = 0;
+        for (const auto& [offset, size] : m_FreeBlocks)
+            largest = std::max(largest, size);
+        return largest;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <map>
+#include <unordered_map>
+
+namespace Luth
+{
+    // Offset / size bookkeeping of one large buffer, in elements (vertices or indices).
+    // First fit over a free list kept sorted by offset; freed blocks merge with their neighbours.
+    // No GL dependency, the GPU side lives in GLGeometryPool.
+    class FreeListAllocator
+    {
+    public:
+        static constexpr u32 k_Invalid = ~0u;
+
+        explicit FreeListAllocator(u32 capacity = 0);
+
+        // Returns the block offset, or k_Invalid when no free block is large enough
+        u32 Allocate(u32 size);
+        // 'offset' must come from Allocate. Unknown offsets are ignored
+        void Free(u32 offset);
+        // Appends free space at the end, merged with a trailing free block
+        void Grow(u32 newCapacity);
+
+        u32 GetCapacity() const { return m_Capacity; }
+        u32 GetUsed() const { return m_Used; }
+        u32 GetLargestFreeBlock() const;
+        u32 GetFreeBlockCount() const { return static_cast<u32>(m_FreeBlocks.size()); }
+        u32 GetAllocationCount() const { return static_cast<u32>(m_Allocations.size()); }
+
+    private:
+        u32 m_Capacity = 0;
+        u32 m_Used = 0;
+        std::map<u32, u32> m_FreeBlocks;            // Offset -> size
+        std::unordered_map<u32, u32> m_Allocations; // Offset -> size
+    };
+
+    // Where a mesh lives inside the shared geometry buffers
+    struct GeometryAllocation {
+        u32 Pool = FreeListAllocator::k_Invalid;   // Vertex format slot
+        u32 BaseVertex = 0;
+        u32 VertexCount = 0;
+        u32 FirstIndex = 0;     // In the index arena matching IndexSize
+        u32 IndexCount = 0;
+        u32 IndexSize = 4;      // Bytes per index
+
+        bool IsValid() const { return Pool != FreeListAllocator::k_Invalid; }
+    };
+
+    // Indices are relative to the mesh's base vertex, so any mesh below 65536 vertices
+    // fits the 16-bit arena wherever it lands in the vertex buffer
+    inline u32 SelectIndexSize(u32 vertexCount)
+    {
+        return vertexCount < 0x10000u ? 2u : 4u;
+    }
+}
@@ -0,0 +1,41 @@
+#include "luthpch.h"
+#include "luth/renderer/IndirectDraw.h"
+
+namespace Luth
+{
+    void IndirectDrawList::Clear()
+    {
+        m_Commands.clear();
+        m_Groups.clear();
+    }
+
+    void IndirectDrawList::BeginGroup(u32 tag)
+    {
+        // Reuse an empty trailing group
+        if (!m_Groups.empty() && m_Groups.back().CommandCount == 0) {
+            m_Groups.back().Tag = tag;
+            return;
+        }
+        m_Groups.push_back({ static_cast<u32>(m_Commands.size()), 0, tag });
+    }
+
+    void IndirectDrawList::Add(const GeometryAllocation& geometry, const MeshIndexRange* ranges, u32 rangeCount,
+                               u32 instanceCount, u32 baseInstance)
+    {
+        if (instanceCount == 0) return;
+        if (m_Groups.empty()) BeginGroup(0);
+
+        for (u32 i = 0; i < rangeCount; ++i) {
+            if (ranges[i].IndexCount == 0) continue;
+
+            DrawElementsIndirectCommand cmd;
+            cmd.Count = ranges[i].IndexCount;
+            cmd.InstanceCount = instanceCount;
+            cmd.FirstIndex = geometry.FirstIndex + ranges[i].IndexOffset;
+            cmd.BaseVertex = static_cast<i32>(geometry.BaseVertex);
+            cmd.BaseInstance = baseInstance;
+            m_Commands.push_back(cmd);
+            m_Groups.back().CommandCount++;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/renderer/GeometryAllocator.h"
+#include "luth/renderer/Meshlet.h"
+
+#include <vector>
+
+namespace Luth
+{
+    // Layout fixed by glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand {
+        u32 Count = 0;
+        u32 InstanceCount = 0;
+        u32 FirstIndex = 0;
+        i32 BaseVertex = 0;
+        u32 BaseInstance = 0;   // First entry of the instance stream, read as gl_BaseInstance
+    };
+    static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+    // Indirect commands of a pass, split into groups that share state (material, vertex format).
+    // Each group becomes one glMultiDrawElementsIndirect call. No GL dependency
+    class IndirectDrawList
+    {
+    public:
+        struct Group {
+            u32 FirstCommand = 0;
+            u32 CommandCount = 0;
+            u32 Tag = 0;            // Caller data, e.g. the command that carries the group's state
+        };
+
+        void Clear();
+
+        // Following Add calls go to a new group
+        void BeginGroup(u32 tag);
+
+        // Draws 'ranges' (relative to the mesh's first index) of a pooled mesh for
+        // 'instanceCount' instances starting at 'baseInstance'
+        void Add(const GeometryAllocation& geometry, const MeshIndexRange* ranges, u32 rangeCount,
+                 u32 instanceCount, u32 baseInstance);
+
+        const std::vector<DrawElementsIndirectCommand>& GetCommands() const { return m_Commands; }
+        const std::vector<Group>& GetGroups() const { return m_Groups; }
+
+    private:
+        std::vector<DrawElementsIndirectCommand> m_Commands;
+        std::vector<Group> m_Groups;
+    };
+}
@@ -0,0 +1,254 @@
+#include "luthpch.h"
+#include "luth/renderer/LightClusters.h"
+#include "luth/core/ThreadPool.h"
+
+#include <bit>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define LH_CLUSTERS_SSE 1
+    #include <immintrin.h>
+#else
+    #define LH_CLUSTERS_SSE 0
+#endif
+
+namespace Luth
+{
+    namespace
+    {
+        // Distance from a value to [min, max], 0 inside
+        inline f32 AxisDistance(f32 min, f32 max, f32 v)
+        {
+            return std::max(std::max(min - v, v - max), 0.0f);
+        }
+    }
+
+    void LightClusters::SetProjection(const Mat4& projection)
+    {
+        m_Orthographic = projection[3][3] == 1.0f;
+
+        // Matrices are built with GLM_FORCE_DEPTH_ZERO_TO_ONE (Math.h)
+        const f32 a = projection[2][2];
+        const f32 b = projection[3][2];
+        m_Near = b / a;
+        m_Far = m_Orthographic ? (b - 1.0f) / a : b / (a + 1.0f);
+        m_Near = std::max(m_Near, 1e-4f);
+        if (!std::isfinite(m_Far) || m_Far <= m_Near) m_Far = m_Near * 1e4f;   // Infinite far plane
+
+        const f32 n = static_cast<f32>(k_Slices);
+        if (m_Orthographic) {
+            m_SliceScale = n / (m_Far - m_Near);
+            m_SliceBias = -n * m_Near / (m_Far - m_Near);
+        }
+        else {
+            const f32 logRatio = std::log(m_Far / m_Near);
+            m_SliceScale = n / logRatio;
+            m_SliceBias = -n * std::log(m_Near) / logRatio;
+        }
+
+        auto sliceDepth = [&](u32 k) {
+            const f32 t = static_cast<f32>(k) / n;
+            return m_Orthographic ? m_Near + (m_Far - m_Near) * t : m_Near * std::pow(m_Far / m_Near, t);
+        };
+
+        // View-space coordinate of an NDC value at a depth (positive), per axis
+        auto unproject = [&](u32 axis, f32 ndc, f32 depth) {
+            const f32 scale = projection[axis][axis];
+            return m_Orthographic ? (ndc - projection[3][axis]) / scale
+                                  : depth * (ndc + projection[2][axis]) / scale;
+        };
+
+        // Bilinear in (ndc, depth): the extremes are at the corners
+        auto extent = [&](u32 axis, f32 ndc0, f32 ndc1, f32 d0, f32 d1, f32& outMin, f32& outMax) {
+            const f32 c[4] = { unproject(axis, ndc0, d0), unproject(axis, ndc1, d0),
+                               unproject(axis, ndc0, d1), unproject(axis, ndc1, d1) };
+            outMin = std::min({ c[0], c[1], c[2], c[3] });
+            outMax = std::max({ c[0], c[1], c[2], c[3] });
+        };
+
+        for (u32 z = 0; z < k_Slices; ++z) {
+            Slice& slice = m_Slices[z];
+            slice.DepthMin = sliceDepth(z);
+            slice.DepthMax = sliceDepth(z + 1);
+
+            for (u32 x = 0; x < k_TilesX; ++x) {
+                const f32 ndc0 = -1.0f + 2.0f * x / k_TilesX;
+                const f32 ndc1 = -1.0f + 2.0f * (x + 1) / k_TilesX;
+                extent(0, ndc0, ndc1, slice.DepthMin, slice.DepthMax, slice.ColMin[x], slice.ColMax[x]);
+            }
+            for (u32 y = 0; y < k_TilesY; ++y) {
+                const f32 ndc0 = -1.0f + 2.0f * y / k_TilesY;
+                const f32 ndc1 = -1.0f + 2.0f * (y + 1) / k_TilesY;
+                extent(1, ndc0, ndc1, slice.DepthMin, slice.DepthMax, slice.RowMin[y], slice.RowMax[y]);
+            }
+        }
+    }
+
+    void LightClusters::GetClusterBounds(u32 x, u32 y, u32 z, Vec3& outMin, Vec3& outMax) const
+    {
+        const Slice& slice = m_Slices[z];
+        outMin = Vec3(slice.ColMin[x], slice.RowMin[y], -slice.DepthMax);
+        outMax = Vec3(slice.ColMax[x], slice.RowMax[y], -slice.DepthMin);
+    }
+
+    void LightClusters::PrepareLights(const Mat4& view, const ClusterLight* lights, u32 count)
+    {
+        auto sliceOf = [&](f32 depth) {
+            depth = std::clamp(depth, m_Near, m_Far);
+            const f32 s = (m_Orthographic ? depth : std::log(depth)) * m_SliceScale + m_SliceBias;
+            return static_cast<i32>(std::floor(s));
+        };
+
+        // One slice of margin each side, the exact test sorts out the rest
+        m_ViewLights.resize(count);
+        for (u32 i = 0; i < count; ++i) {
+            const Vec3 center = Vec3(view * Vec4(lights[i].Position, 1.0f));
+            const f32 radius = std::max(lights[i].Range, 0.0f);
+            const f32 depth = -center.z;
+
+            ViewLight& light = m_ViewLights[i];
+            light.Center = center;
+            light.Radius2 = radius * radius;
+            light.FirstSlice = static_cast<u32>(std::clamp(sliceOf(depth - radius) - 1, 0, (i32)k_Slices - 1));
+            light.LastSlice = static_cast<u32>(std::clamp(sliceOf(depth + radius) + 1, 0, (i32)k_Slices - 1));
+        }
+    }
+
+    void LightClusters::BinSlice(u32 z, SliceBins& bins, bool simd) const
+    {
+        bins.Clusters.clear();
+        bins.Lights.clear();
+
+        const Slice& slice = m_Slices[z];
+        alignas(16) f32 dx2[k_TilesX];
+
+        for (u32 l = 0; l < static_cast<u32>(m_ViewLights.size()); ++l) {
+            const ViewLight& light = m_ViewLights[l];
+            if (z < light.FirstSlice || z > light.LastSlice) continue;
+
+            const f32 dz = AxisDistance(-slice.DepthMax, -slice.DepthMin, light.Center.z);
+            const f32 dz2 = dz * dz;
+            if (dz2 > light.Radius2) continue;
+
+        #if LH_CLUSTERS_SSE
+            const __m128 r2 = _mm_set1_ps(light.Radius2);
+            if (simd) {
+                const __m128 cx = _mm_set1_ps(light.Center.x);
+                for (u32 x = 0; x < k_TilesX; x += 4) {
+                    const __m128 d = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_load_ps(slice.ColMin + x), cx),
+                                                           _mm_sub_ps(cx, _mm_load_ps(slice.ColMax + x))),
+                                                _mm_setzero_ps());
+                    _mm_store_ps(dx2 + x, _mm_mul_ps(d, d));
+                }
+            }
+            else
+        #endif
+            {
+                for (u32 x = 0; x < k_TilesX; ++x) {
+                    const f32 dx = AxisDistance(slice.ColMin[x], slice.ColMax[x], light.Center.x);
+                    dx2[x] = dx * dx;
+                }
+            }
+
+            for (u32 y = 0; y < k_TilesY; ++y) {
+                const f32 dy = AxisDistance(slice.RowMin[y], slice.RowMax[y], light.Center.y);
+                const f32 rowDist = dy * dy + dz2;
+                if (rowDist > light.Radius2) continue;
+
+                const u32 rowBase = y * k_TilesX;
+            #if LH_CLUSTERS_SSE
+                if (simd) {
+                    const __m128 row = _mm_set1_ps(rowDist);
+                    for (u32 x = 0; x < k_TilesX; x += 4) {
+                        u32 mask = static_cast<u32>(_mm_movemask_ps(_mm_cmple_ps(_mm_add_ps(_mm_load_ps(dx2 + x), row), r2)));
+                        while (mask) {
+                            bins.Clusters.push_back(rowBase + x + std::countr_zero(mask));
+                            bins.Lights.push_back(l);
+                            mask &= mask - 1;
+                        }
+                    }
+                    continue;
+                }
+            #endif
+                for (u32 x = 0; x < k_TilesX; ++x) {
+                    if (dx2[x] + rowDist <= light.Radius2) {
+                        bins.Clusters.push_back(rowBase + x);
+                        bins.Lights.push_back(l);
+                    }
+                }
+            }
+        }
+
+        // Counting sort by cluster, stable so each list stays in light order
+        bins.Counts.fill(0);
+        for (u32 cluster : bins.Clusters) ++bins.Counts[cluster];
+
+        std::array<u32, k_ClustersPerSlice> cursor;
+        u32 offset = 0;
+        for (u32 c = 0; c < k_ClustersPerSlice; ++c) {
+            cursor[c] = offset;
+            offset += bins.Counts[c];
+        }
+
+        bins.Indices.resize(bins.Lights.size());
+        for (size_t i = 0; i < bins.Lights.size(); ++i)
+            bins.Indices[cursor[bins.Clusters[i]]++] = bins.Lights[i];
+    }
+
+    void LightClusters::Gather()
+    {
+        m_Ranges.resize(k_ClusterCount);
+        m_Indices.clear();
+
+        for (u32 z = 0; z < k_Slices; ++z) {
+            const SliceBins& bins = m_Bins[z];
+            u32 offset = static_cast<u32>(m_Indices.size());
+            for (u32 c = 0; c < k_ClustersPerSlice; ++c) {
+                m_Ranges[z * k_ClustersPerSlice + c] = { offset, bins.Counts[c] };
+                offset += bins.Counts[c];
+            }
+            m_Indices.insert(m_Indices.end(), bins.Indices.begin(), bins.Indices.end());
+        }
+    }
+
+    void LightClusters::Build(const Mat4& view, const ClusterLight* lights, u32 count, bool forceScalar)
+    {
+        PrepareLights(view, lights, count);
+
+        const bool simd = !forceScalar && LH_CLUSTERS_SSE;
+        ThreadPool::Get().ParallelFor(k_Slices, 1, [&](size_t begin, size_t end) {
+            for (size_t z = begin; z < end; ++z)
+                BinSlice(static_cast<u32>(z), m_Bins[z], simd);
+        });
+
+        Gather();
+    }
+
+    void LightClusters::BuildReference(const Mat4& view, const ClusterLight* lights, u32 count)
+    {
+        PrepareLights(view, lights, count);
+
+        m_Ranges.resize(k_ClusterCount);
+        m_Indices.clear();
+
+        for (u32 z = 0; z < k_Slices; ++z)
+        for (u32 y = 0; y < k_TilesY; ++y)
+        for (u32 x = 0; x < k_TilesX; ++x) {
+            Vec3 bmin, bmax;
+            GetClusterBounds(x, y, z, bmin, bmax);
+
+            ClusterRange& range = m_Ranges[x + y * k_TilesX + z * k_ClustersPerSlice];
+            range = { static_cast<u32>(m_Indices.size()), 0 };
+
+            for (u32 l = 0; l < count; ++l) {
+                const ViewLight& light = m_ViewLights[l];
+                const f32 dx = AxisDistance(bmin.x, bmax.x, light.Center.x);
+                const f32 dy = AxisDistance(bmin.y, bmax.y, light.Center.y);
+                const f32 dz = AxisDistance(bmin.z, bmax.z, light.Center.z);
+                if (dx * dx + (dy * dy + dz * dz) <= light.Radius2) {
+                    m_Indices.push_back(l);
+                    ++range.Count;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/core/Math.h"
+
+#include <array>
+#include <vector>
+
+namespace Luth
+{
+    // Point light as binned: world-space sphere
+    struct ClusterLight {
+        Vec3 Position = Vec3(0.0f);
+        f32 Range = 0.0f;
+    };
+
+    struct ClusterRange {
+        u32 Offset = 0;     // Into the light index list
+        u32 Count = 0;
+    };
+
+    // Clustered light culling. The view frustum is cut into k_TilesX x k_TilesY screen
+    // tiles and k_Slices depth slices (exponential for perspective, linear for ortho).
+    // Each froxel gets the list of point lights whose sphere touches its view-space AABB,
+    // stored as one range per cluster into a flat index list, lights in ascending order.
+    // Cluster index = x + y * k_TilesX + z * k_TilesX * k_TilesY, tile (0, 0) at the
+    // bottom left like gl_FragCoord. Mirrored by LuthClusters.glslh.
+    //
+    // No GL here: Build runs on the ThreadPool (one job per group of slices) with an
+    // SSE path for the per-tile tests, BuildReference tests every light against every
+    // cluster and must produce the exact same lists.
+    class LightClusters
+    {
+    public:
+        static constexpr u32 k_TilesX = 16;
+        static constexpr u32 k_TilesY = 9;
+        static constexpr u32 k_Slices = 24;
+        static constexpr u32 k_ClustersPerSlice = k_TilesX * k_TilesY;
+        static constexpr u32 k_ClusterCount = k_ClustersPerSlice * k_Slices;
+        static_assert(k_TilesX % 4 == 0, "Tile columns are tested four at a time");
+
+        // Slice boundaries and tile extents from a GL projection matrix (perspective or ortho)
+        void SetProjection(const Mat4& projection);
+
+        void Build(const Mat4& view, const ClusterLight* lights, u32 count, bool forceScalar = false);
+        void BuildReference(const Mat4& view, const ClusterLight* lights, u32 count);
+
+        const std::vector<ClusterRange>& GetRanges() const { return m_Ranges; }
+        const std::vector<u32>& GetIndices() const { return m_Indices; }
+
+        // For the shaders: slice = floor(f(depth) * scale + bias), f = log for perspective, identity for ortho
+        f32 GetSliceScale() const { return m_SliceScale; }
+        f32 GetSliceBias() const { return m_SliceBias; }
+        bool IsOrthographic() const { return m_Orthographic; }
+
+        // View-space AABB of a cluster
+        void GetClusterBounds(u32 x, u32 y, u32 z, Vec3& outMin, Vec3& outMax) const;
+
+    private:
+        // Extents are separable: x only depends on the column and slice, y on the row and slice
+        struct Slice {
+            alignas(16) f32 ColMin[k_TilesX];
+            alignas(16) f32 ColMax[k_TilesX];
+            f32 RowMin[k_TilesY];
+            f32 RowMax[k_TilesY];
+            f32 DepthMin = 0.0f;    // Positive view depth
+            f32 DepthMax = 0.0f;
+        };
+
+        // Light in view space, with the slices its sphere may reach (conservative)
+        struct ViewLight {
+            Vec3 Center;
+            f32 Radius2;
+            u32 FirstSlice;
+            u32 LastSlice;
+        };
+
+        // Clusters of one slice as (cluster, light) pairs, then sorted into lists
+        struct SliceBins {
+            std::vector<u32> Clusters;
+            std::vector<u32> Lights;
+            std::vector<u32> Indices;
+            std::array<u32, k_ClustersPerSlice> Counts{};
+        };
+
+        void PrepareLights(const Mat4& view, const ClusterLight* lights, u32 count);
+        void BinSlice(u32 z, SliceBins& bins, bool simd) const;
+        void Gather();
+
+        std::array<Slice, k_Slices> m_Slices{};
+        f32 m_SliceScale = 1.0f;
+        f32 m_SliceBias = 0.0f;
+        f32 m_Near = 0.1f;
+        f32 m_Far = 1000.0f;
+        bool m_Orthographic = false;
+
+        std::vector<ViewLight> m_ViewLights;
+        std::array<SliceBins, k_Slices> m_Bins;
+        std::vector<ClusterRange> m_Ranges;
+        std::vector<u32> m_Indices;
+    };
+}
@@ -1,8 +1,15 @@
 #include "luthpch.h"
 #include "luth/renderer/Material.h"
+#include "luth/renderer/Renderer.h"
+#include "luth/renderer/openGL/GLMaterialBuffer.h"
 
 namespace Luth
 {
+    Material::~Material()
+    {
+        ReleaseGpuBlock();
+    }
+
     void Material::Serialize(nlohmann::json& json) const
     {
         json["shader"] = m_ShaderUUID.ToString();
@@ -12,6 +19,7 @@ namespace Luth
         json["blend_src"] = static_cast<int>(m_BlendSrc);
         json["blend_dst"] = static_cast<int>(m_BlendDst);
         json["alpha_from_diffuse"] = static_cast<int>(m_AlphaFromDiffuse);
+        json["two_sided"] = static_cast<int>(m_TwoSided);
 
         json["color"] = { m_Color.r, m_Color.g, m_Color.b, m_Color.a };
         json["alpha"] = m_Alpha;
@@ -40,6 +48,9 @@ namespace Luth
 
     void Material::Deserialize(const nlohmann::json& json)
     {
+        // Reloaded in place, the old block no longer matches
+        ReleaseGpuBlock();
+
         UUID::FromString(json["shader"].get<std::string>(), m_ShaderUUID);
 
         m_RenderMode = static_cast<RendererAPI::RenderMode>(json.value("render_mode", 0));
@@ -49,6 +60,7 @@ namespace Luth
         m_BlendDst = static_cast<RendererAPI::BlendFactor>(json.value("blend_dst",
             static_cast<int>(RendererAPI::BlendFactor::OneMinusSrcAlpha)));
         m_AlphaFromDiffuse = static_cast<bool>(json.value("alpha_from_diffuse", 0));
+        m_TwoSided = static_cast<bool>(json.value("two_sided", 0));
 
         if (json.contains("color")) {
             auto& jc = json["color"];
@@ -94,6 +106,7 @@ namespace Luth
             tex.useTexture = static_cast<bool>(texJson.value("useTexture", 0));
             m_Maps.push_back(tex);
         }
+        Touch();
     }
 
     const char* Material::ToString(MapType type) {
@@ -109,4 +122,16 @@ namespace Luth
             default: return "Unknown";
         }
     }
+
+    void Material::ReleaseGpuBlock()
+    {
+        switch (Renderer::GetAPI())
+        {
+            case RendererAPI::API::OpenGL:
+                GLMaterialBuffer::Release(*this);
+                break;
+            default:
+                break;
+        }
+    }
 }
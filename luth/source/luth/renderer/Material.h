@@ -43,19 +43,22 @@ namespace Luth
     class Material : public Resource
     {
     public:
+        ~Material() override;
+
         // Shader management
-        void SetShaderUUID(const UUID& uuid) { m_ShaderUUID = uuid; }
+        void SetShaderUUID(const UUID& uuid) { m_ShaderUUID = uuid; Touch(); }
         UUID GetShaderUUID() const { return m_ShaderUUID; }
         std::shared_ptr<Shader> GetShader() const {
             return ShaderLibrary::Get(m_ShaderUUID);
         }
 
         // Map management
-        void AddTexture(const MapInfo& texture) { m_Maps.push_back(texture); }
+        void AddTexture(const MapInfo& texture) { m_Maps.push_back(texture); Touch(); }
         void SetTexture(const MapInfo& texture) {
             int index = static_cast<int>(texture.type);
             if (index >= m_Maps.size()) AddTexture(texture);
             else m_Maps[index] = texture;
+            Touch();
         }
         const std::vector<MapInfo>& GetTextures() const { return m_Maps; }
 
@@ -70,6 +73,7 @@ namespace Luth
             for (auto& tex : m_Maps) {
                 if (tex.type == type) tex.useMap = enable;
             }
+            Touch();
         }
         bool IsUseMapEnabled(MapType type) const {
             for (const auto& tex : m_Maps) {
@@ -81,6 +85,7 @@ namespace Luth
             for (auto& tex : m_Maps) {
                 if (tex.type == type) tex.useTexture = enable;
             }
+            Touch();
         }
         bool IsUseTextureEnabled(MapType type) const {
             for (const auto& tex : m_Maps) {
@@ -98,61 +103,75 @@ namespace Luth
 
         // Render mode
         RendererAPI::RenderMode GetRenderMode() const { return m_RenderMode; }
-        void SetRenderMode(RendererAPI::RenderMode mode) { m_RenderMode = mode; }
+        void SetRenderMode(RendererAPI::RenderMode mode) { m_RenderMode = mode; Touch(); }
 
         // Alpha cutoff for RenderMode::Cutout
         float GetAlphaCutoff() const { return m_AlphaCutoff; }
-        void SetAlphaCutoff(float cutoff) { m_AlphaCutoff = cutoff; }
+        void SetAlphaCutoff(float cutoff) { m_AlphaCutoff = cutoff; Touch(); }
 
         // Blend factors
-        void SetBlendSrc(RendererAPI::BlendFactor factor) { m_BlendSrc = factor; }
+        void SetBlendSrc(RendererAPI::BlendFactor factor) { m_BlendSrc = factor; Touch(); }
         RendererAPI::BlendFactor GetBlendSrc() const { return m_BlendSrc; }
 
-        void SetBlendDst(RendererAPI::BlendFactor factor) { m_BlendDst = factor; }
+        void SetBlendDst(RendererAPI::BlendFactor factor) { m_BlendDst = factor; Touch(); }
         RendererAPI::BlendFactor GetBlendDst() const { return m_BlendDst; }
 
-        void EnableAlphaFromDiffuse(bool enable) { m_AlphaFromDiffuse = enable; }
+        void EnableAlphaFromDiffuse(bool enable) { m_AlphaFromDiffuse = enable; Touch(); }
         bool IsAlphaFromDiffuseEnabled() const { return m_AlphaFromDiffuse; }
 
         // Properties
         Vec4 GetColor() const { return m_Color; }
-        void SetColor(Vec4 color) { m_Color = color; }
+        void SetColor(Vec4 color) { m_Color = color; Touch(); }
 
         float GetAlpha() const { return m_Alpha; }
-        void SetAlpha(float alpha) { m_Alpha = alpha; }
+        void SetAlpha(float alpha) { m_Alpha = alpha; Touch(); }
 
         float GetMetal() const { return m_Metal; }
-        void SetMetal(float metal) { m_Metal = metal; }
+        void SetMetal(float metal) { m_Metal = metal; Touch(); }
 
         float GetRough() const { return m_Rough; }
-        void SetRough(float rough) { m_Rough = rough; }
+        void SetRough(float rough) { m_Rough = rough; Touch(); }
 
         Vec3 GetEmissive() const { return m_Emissive; }
-        void SetEmissive(Vec3 emissive) { m_Emissive = emissive; }
+        void SetEmissive(Vec3 emissive) { m_Emissive = emissive; Touch(); }
 
         Subsurface GetSubsurface() const { return m_Subsurface; }
         void SetSubsurfaceParams(const Vec3& color, float strength, float thickness) {
             m_Subsurface.color = color;
             m_Subsurface.strength = strength;
             m_Subsurface.thicknessScale = thickness;
+            Touch();
         }
-        void SetSubsurfaceColor(const Vec3& color) { m_Subsurface.color = color; }
-        void SetSubsurfaceStrength(float strength) { m_Subsurface.strength = strength; }
-        void SetSubsurfaceThicknessScale(float thickness) { m_Subsurface.thicknessScale = thickness; }
+        void SetSubsurfaceColor(const Vec3& color) { m_Subsurface.color = color; Touch(); }
+        void SetSubsurfaceStrength(float strength) { m_Subsurface.strength = strength; Touch(); }
+        void SetSubsurfaceThicknessScale(float thickness) { m_Subsurface.thicknessScale = thickness; Touch(); }
 
         bool IsGloss() const { return m_IsGloss; }
-        void SetGloss(bool gloss) { m_IsGloss = gloss; }
+        void SetGloss(bool gloss) { m_IsGloss = gloss; Touch(); }
 
         bool IsSingleChannel() const { return m_IsSingleChannel; }
-        void SetSingleChannel(bool singleChannel) { m_IsSingleChannel = singleChannel; }
+        void SetSingleChannel(bool singleChannel) { m_IsSingleChannel = singleChannel; Touch(); }
+
+        bool IsTwoSided() const { return m_TwoSided; }
+        void SetTwoSided(bool twoSided) { m_TwoSided = twoSided; Touch(); }
+        // Back faces are culled: opaque and not two-sided, cutout leaves and cards see both sides
+        bool IsSingleSided() const { return !m_TwoSided && m_RenderMode == RendererAPI::RenderMode::Opaque; }
 
         // Serialization/Deserialization
         void Serialize(nlohmann::json& json) const;
         void Deserialize(const nlohmann::json& json);
 
+        // Bumped by every setter, the GPU parameter block is rewritten when it differs
+        u32 GetRevision() const { return m_Revision; }
+
         static const char* ToString(MapType type);
 
     private:
+        void Touch() { ++m_Revision; }
+        // Returns the GPU parameter block slot, the next bind packs into a fresh one
+        void ReleaseGpuBlock();
+
+        u32 m_Revision = 1;
         UUID m_ShaderUUID;
         std::vector<MapInfo> m_Maps;
 
@@ -163,6 +182,7 @@ namespace Luth
         bool m_AlphaFromDiffuse = false;
         bool m_IsGloss = false;
         bool m_IsSingleChannel = false;
+        bool m_TwoSided = false;
 
         Vec4 m_Color = Vec4(1.0f);
         float m_Alpha = 1.0f;
@@ -2,6 +2,7 @@
 
 #include "luth/renderer/Mesh.h"
 #include "luth/renderer/openGL/GLMesh.h"
+#include "luth/renderer/openGL/GLGeometryPool.h"
 #include "luth/renderer/vulkan/VKMesh.h"
 #include "luth/renderer/Renderer.h"
 #include "luth/renderer/RendererAPI.h"
@@ -32,4 +33,25 @@ namespace Luth
                 return nullptr;
         }
     }
+
+    std::shared_ptr<Mesh> Mesh::Create(const void* vertices, u32 vertexCount, const BufferLayout& layout,
+        const std::vector<u32>& indices)
+    {
+        switch (Renderer::GetAPI())
+        {
+            case RendererAPI::API::OpenGL:
+            {
+                const GeometryAllocation allocation = GLGeometryPool::Allocate(
+                    vertices, vertexCount, layout, indices.data(), static_cast<u32>(indices.size()));
+                LH_CORE_ASSERT(allocation.IsValid(), "Failed to allocate mesh in the geometry pool!");
+
+                return std::make_shared<GLMesh>(allocation);
+            }
+
+            case RendererAPI::API::Vulkan:
+            default:
+                LH_CORE_ASSERT(false, "Unknown renderer API!");
+                return nullptr;
+        }
+    }
 }
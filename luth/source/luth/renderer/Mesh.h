@@ -1,21 +1,67 @@
 #pragma once
 
 #include "luth/renderer/Buffer.h"
+#include "luth/renderer/GeometryAllocator.h"
 #include "luth/renderer/Material.h"
+#include "luth/renderer/Meshlet.h"
 
 #include <memory>
+#include <vector>
 
 namespace Luth
 {
+    // How the vertex shader restores packed attributes (see VertexQuantization.h)
+    struct VertexDecode {
+        bool Quantized = false;
+        Vec3 PositionOffset = Vec3(0.0f);
+        Vec3 PositionScale = Vec3(1.0f);
+    };
+
+    // Index range of one level of detail. All levels share the vertex buffer.
+    struct MeshLod {
+        u32 IndexOffset = 0;
+        u32 IndexCount = 0;
+        f32 ScreenSize = 1.0f;  // Used below this projected height (fraction of the viewport)
+        f32 Error = 0.0f;       // Simplification error, relative to the mesh extent
+    };
+
     class Mesh
     {
     public:
         virtual ~Mesh() = default;
         virtual void Bind() const = 0;
-        virtual void Draw() const = 0;
+        virtual void Draw(u32 lod = 0) const = 0;
+        virtual void DrawInstanced(u32 instanceCount, u32 lod = 0) const = 0;
+        // One multi-draw over the given index ranges, e.g. the meshlets that survived culling
+        virtual void DrawRanges(const MeshIndexRange* ranges, u32 rangeCount) const = 0;
+
+        void SetVertexDecode(const VertexDecode& decode) { m_VertexDecode = decode; }
+        const VertexDecode& GetVertexDecode() const { return m_VertexDecode; }
+
+        // Without LODs the whole index buffer is level 0
+        void SetLods(std::vector<MeshLod> lods) { m_Lods = std::move(lods); }
+        const std::vector<MeshLod>& GetLods() const { return m_Lods; }
+        u32 GetLodCount() const { return m_Lods.empty() ? 1 : static_cast<u32>(m_Lods.size()); }
+
+        // Clusters of LOD 0, empty when the mesh is too small to be worth culling per cluster
+        void SetMeshlets(std::vector<Meshlet> meshlets) { m_Meshlets = std::move(meshlets); }
+        const std::vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+
+        // Location inside the shared geometry pool, invalid for meshes with their own buffers
+        const GeometryAllocation& GetAllocation() const { return m_Allocation; }
+        bool IsPooled() const { return m_Allocation.IsValid(); }
 
         static std::shared_ptr<Mesh> Create(
             const std::shared_ptr<VertexBuffer>& vb,
             const std::shared_ptr<IndexBuffer>& ib = nullptr);
+        // Sub-allocates the mesh in the shared geometry pool (16-bit indices below 65536 vertices)
+        static std::shared_ptr<Mesh> Create(const void* vertices, u32 vertexCount, const BufferLayout& layout,
+            const std::vector<u32>& indices);
+
+    protected:
+        GeometryAllocation m_Allocation;
+        VertexDecode m_VertexDecode;
+        std::vector<MeshLod> m_Lods;
+        std::vector<Meshlet> m_Meshlets;
     };
 }
@@ -0,0 +1,322 @@
+#include "luthpch.h"
+#include "luth/renderer/MeshOptimizer.h"
+#include "luth/renderer/Model.h"
+
+#include <numeric>
+
+namespace Luth::MeshOptimizer
+{
+    namespace
+    {
+        constexpr i32 k_OverdrawViewport = 256;
+
+        // FIFO post-transform cache, one timestamp per vertex
+        class FifoCache
+        {
+        public:
+            FifoCache(u32 vertexCount, u32 size) : m_Stamps(vertexCount, 0), m_Size(size), m_Time(size + 1) {}
+
+            // Returns true on a miss
+            bool Access(u32 vertex)
+            {
+                if (m_Time - m_Stamps[vertex] < m_Size) return false;
+                m_Stamps[vertex] = ++m_Time;
+                return true;
+            }
+
+            u32 AccessTriangle(const u32* tri) { return Access(tri[0]) + Access(tri[1]) + Access(tri[2]); }
+
+            void Flush() { m_Time += m_Size + 1; }
+
+        private:
+            std::vector<u32> m_Stamps;
+            u32 m_Size;
+            u32 m_Time;
+        };
+
+        struct OverdrawCounter {
+            u64 Shaded = 0;
+            u64 Covered = 0;
+        };
+
+        f32 Edge(const Vec3& a, const Vec3& b, f32 x, f32 y)
+        {
+            return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+        }
+
+        // Orthographic view, points already in viewport pixels (xy) and [0, 1] depth (z, smaller is closer)
+        void RasterizeView(const std::vector<Vec3>& points, const std::vector<u32>& indices, OverdrawCounter& counter)
+        {
+            std::vector<f32> depth(k_OverdrawViewport * k_OverdrawViewport, FLOAT_MAX);
+
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                const Vec3& a = points[indices[i + 0]];
+                const Vec3& b = points[indices[i + 1]];
+                const Vec3& c = points[indices[i + 2]];
+
+                const f32 area = Edge(a, b, c.x, c.y);
+                if (area <= 0.0f) continue; // Back-facing or degenerate
+
+                const i32 minX = std::max(0, (i32)std::floor(std::min({ a.x, b.x, c.x })));
+                const i32 minY = std::max(0, (i32)std::floor(std::min({ a.y, b.y, c.y })));
+                const i32 maxX = std::min(k_OverdrawViewport - 1, (i32)std::ceil(std::max({ a.x, b.x, c.x })));
+                const i32 maxY = std::min(k_OverdrawViewport - 1, (i32)std::ceil(std::max({ a.y, b.y, c.y })));
+
+                for (i32 y = minY; y <= maxY; ++y) {
+                    for (i32 x = minX; x <= maxX; ++x) {
+                        const f32 px = x + 0.5f, py = y + 0.5f;
+                        const f32 w0 = Edge(b, c, px, py);
+                        const f32 w1 = Edge(c, a, px, py);
+                        const f32 w2 = Edge(a, b, px, py);
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+                        const f32 z = (w0 * a.z + w1 * b.z + w2 * c.z) / area;
+                        f32& stored = depth[y * k_OverdrawViewport + x];
+                        if (z < stored) {
+                            if (stored == FLOAT_MAX) counter.Covered++;
+                            stored = z;
+                            counter.Shaded++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // ============================================================================
+    //                              VERTEX CACHE
+    // ============================================================================
+
+    void OptimizeVertexCache(std::vector<u32>& indices, u32 vertexCount, u32 cacheSize)
+    {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || vertexCount == 0) return;
+
+        // Vertex -> triangle adjacency
+        std::vector<u32> live(vertexCount, 0);
+        for (u32 index : indices) live[index]++;
+
+        std::vector<u32> offsets(vertexCount + 1, 0);
+        for (u32 v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + live[v];
+
+        std::vector<u32> adjacency(indices.size());
+        std::vector<u32> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i) adjacency[cursor[indices[i]]++] = static_cast<u32>(i / 3);
+
+        std::vector<u32> cacheTime(vertexCount, 0);
+        std::vector<u8> emitted(triangleCount, 0);
+        std::vector<u32> deadEnd, candidates, result;
+        deadEnd.reserve(indices.size());
+        result.reserve(triangleCount * 3);
+
+        u32 time = cacheSize + 1;
+        u32 scan = 0;
+        u32 fanning = 0;
+
+        while (fanning != ~0u) {
+            // Emit every remaining triangle around the fanning vertex
+            candidates.clear();
+            for (u32 a = offsets[fanning]; a < offsets[fanning + 1]; ++a) {
+                const u32 t = adjacency[a];
+                if (emitted[t]) continue;
+                emitted[t] = 1;
+
+                for (u32 k = 0; k < 3; ++k) {
+                    const u32 v = indices[t * 3 + k];
+                    result.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    live[v]--;
+                    if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+                }
+            }
+
+            // Next fanning vertex: the oldest candidate that will still be cached once its fan is emitted
+            fanning = ~0u;
+            i64 bestPriority = -1;
+            for (u32 v : candidates) {
+                if (live[v] == 0) continue;
+                i64 priority = 0;
+                if (time - cacheTime[v] + 2 * live[v] <= cacheSize) priority = time - cacheTime[v];
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    fanning = v;
+                }
+            }
+            if (fanning != ~0u) continue;
+
+            // Dead end: most recently referenced vertex with work left, then the next one in input order
+            while (!deadEnd.empty() && fanning == ~0u) {
+                const u32 v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) fanning = v;
+            }
+            while (fanning == ~0u && scan < vertexCount) {
+                if (live[scan] > 0) fanning = scan;
+                else ++scan;
+            }
+        }
+
+        indices.swap(result);
+    }
+
+    // ============================================================================
+    //                                OVERDRAW
+    // ============================================================================
+
+    void OptimizeOverdraw(std::vector<u32>& indices, const std::vector<Vertex>& vertices, f32 threshold, u32 cacheSize)
+    {
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2 || vertices.empty()) return;
+
+        FifoCache cache(static_cast<u32>(vertices.size()), cacheSize);
+
+        // Hard boundaries: triangles that start cold, where reordering costs nothing
+        std::vector<size_t> hard;
+        u32 totalMisses = 0;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const u32 misses = cache.AccessTriangle(&indices[t * 3]);
+            if (t == 0 || misses == 3) hard.push_back(t);
+            totalMisses += misses;
+        }
+        hard.push_back(triangleCount);
+        const f32 meshACMR = static_cast<f32>(totalMisses) / triangleCount;
+
+        // Soft boundaries: split further once a cluster amortized its cold start
+        std::vector<size_t> clusters;
+        for (size_t h = 0; h + 1 < hard.size(); ++h) {
+            size_t start = hard[h];
+            u32 misses = 0;
+            cache.Flush();
+            clusters.push_back(start);
+
+            for (size_t t = start; t < hard[h + 1]; ++t) {
+                misses += cache.AccessTriangle(&indices[t * 3]);
+                if (t + 1 < hard[h + 1] && misses <= threshold * meshACMR * (t - start + 1)) {
+                    start = t + 1;
+                    misses = 0;
+                    cache.Flush();
+                    clusters.push_back(start);
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+        const size_t clusterCount = clusters.size() - 1;
+        if (clusterCount < 2) return;
+
+        // Area-weighted centroid and normal per cluster
+        std::vector<Vec3> centroids(clusterCount, Vec3(0.0f)), normals(clusterCount, Vec3(0.0f));
+        std::vector<f32> areas(clusterCount, 0.0f);
+        Vec3 meshCentroid(0.0f);
+        f32 meshArea = 0.0f;
+
+        for (size_t c = 0; c < clusterCount; ++c) {
+            for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+                const Vec3& a = vertices[indices[t * 3 + 0]].Position;
+                const Vec3& b = vertices[indices[t * 3 + 1]].Position;
+                const Vec3& d = vertices[indices[t * 3 + 2]].Position;
+                const Vec3 normal = glm::cross(b - a, d - a);
+                const f32 area = glm::length(normal);
+
+                centroids[c] += (a + b + d) * (area / 3.0f);
+                normals[c] += normal;
+                areas[c] += area;
+            }
+            meshCentroid += centroids[c];
+            meshArea += areas[c];
+        }
+        if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+        // Outward-facing clusters occlude the rest, draw them first
+        std::vector<f32> keys(clusterCount, 0.0f);
+        for (size_t c = 0; c < clusterCount; ++c) {
+            const f32 length = glm::length(normals[c]);
+            if (areas[c] <= 0.0f || length <= 0.0f) continue;
+            keys[c] = glm::dot(centroids[c] / areas[c] - meshCentroid, normals[c] / length);
+        }
+
+        std::vector<u32> order(clusterCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) { return keys[a] > keys[b]; });
+
+        std::vector<u32> result;
+        result.reserve(indices.size());
+        for (u32 c : order) {
+            result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+        }
+        indices.swap(result);
+    }
+
+    // ============================================================================
+    //                              VERTEX FETCH
+    // ============================================================================
+
+    std::vector<u32> OptimizeVertexFetch(std::vector<u32>& indices, u32 vertexCount, u32& outVertexCount)
+    {
+        std::vector<u32> remap(vertexCount, ~0u);
+        u32 next = 0;
+
+        for (u32& index : indices) {
+            if (remap[index] == ~0u) remap[index] = next++;
+            index = remap[index];
+        }
+
+        outVertexCount = next;
+        return remap;
+    }
+
+    // ============================================================================
+    //                               STATISTICS
+    // ============================================================================
+
+    MeshOptimizationStats Analyze(const std::vector<u32>& indices, const std::vector<Vertex>& vertices, u32 cacheSize)
+    {
+        MeshOptimizationStats stats;
+        stats.Valid = true;
+        const size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0 || vertices.empty()) return stats;
+
+        // Vertex cache
+        FifoCache cache(static_cast<u32>(vertices.size()), cacheSize);
+        std::vector<u8> referenced(vertices.size(), 0);
+        u32 misses = 0, unique = 0;
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            misses += cache.Access(indices[i]);
+            if (!referenced[indices[i]]) {
+                referenced[indices[i]] = 1;
+                unique++;
+            }
+        }
+        stats.ACMR = static_cast<f32>(misses) / triangleCount;
+        stats.ATVR = static_cast<f32>(misses) / unique;
+
+        // Overdraw, rasterized along +-X, +-Y, +-Z
+        Vec3 boundsMin(FLOAT_MAX), boundsMax(-FLOAT_MAX);
+        for (const auto& vertex : vertices) {
+            boundsMin = glm::min(boundsMin, vertex.Position);
+            boundsMax = glm::max(boundsMax, vertex.Position);
+        }
+        const Vec3 extent = boundsMax - boundsMin;
+        const f32 scale = 1.0f / std::max({ extent.x, extent.y, extent.z, 1e-6f });
+
+        OverdrawCounter counter;
+        std::vector<Vec3> points(vertices.size());
+        for (i32 axis = 0; axis < 3; ++axis) {
+            for (i32 flip = 0; flip < 2; ++flip) {
+                for (size_t v = 0; v < vertices.size(); ++v) {
+                    const Vec3 n = (vertices[v].Position - boundsMin) * scale;
+                    const Vec3 p(n[(axis + 1) % 3], n[(axis + 2) % 3], n[axis]);
+
+                    // Camera on the +axis side looking down, or mirrored in x (which also flips
+                    // the winding) to look from the -axis side. Counter-clockwise is front-facing
+                    points[v] = flip ? Vec3((1.0f - p.x) * k_OverdrawViewport, p.y * k_OverdrawViewport, p.z)
+                                     : Vec3(p.x * k_OverdrawViewport, p.y * k_OverdrawViewport, 1.0f - p.z);
+                }
+                RasterizeView(points, indices, counter);
+            }
+        }
+        stats.Overdraw = counter.Covered ? static_cast<f32>(counter.Shaded) / counter.Covered : 0.0f;
+
+        return stats;
+    }
+}
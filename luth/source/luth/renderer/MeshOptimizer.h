@@ -0,0 +1,52 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <vector>
+
+namespace Luth
+{
+    struct Vertex;
+
+    // Post-transform cache and overdraw figures of an index buffer.
+    // Costly (six software rasterizations), computed on request from the editor
+    struct MeshOptimizationStats {
+        f32 ACMR = 0.0f;        // Transformed vertices per triangle (0.5 best, 3 worst)
+        f32 ATVR = 0.0f;        // Transformed vertices per unique vertex (1 best)
+        f32 Overdraw = 0.0f;    // Shaded / covered pixels over 6 axis-aligned views (1 best)
+        bool Valid = false;     // Set by Analyze
+    };
+
+    namespace MeshOptimizer
+    {
+        // FIFO size assumed by the optimizer and the statistics
+        constexpr u32 k_CacheSize = 16;
+
+        // Tipsify (Sander et al. 2007): reorders triangles for the post-transform vertex cache
+        void OptimizeVertexCache(std::vector<u32>& indices, u32 vertexCount, u32 cacheSize = k_CacheSize);
+
+        // Splits cache-ordered triangles into clusters and draws the most outward-facing ones first.
+        // 'threshold' bounds how much worse the ACMR may get (1.05 allows 5%)
+        void OptimizeOverdraw(std::vector<u32>& indices, const std::vector<Vertex>& vertices,
+                              f32 threshold = 1.05f, u32 cacheSize = k_CacheSize);
+
+        // Renumbers vertices in first-use order and drops unreferenced ones.
+        // Returns old -> new index (~0u when dropped), to apply to every per-vertex stream
+        std::vector<u32> OptimizeVertexFetch(std::vector<u32>& indices, u32 vertexCount, u32& outVertexCount);
+
+        template<typename T>
+        void RemapVertices(std::vector<T>& stream, const std::vector<u32>& remap, u32 vertexCount)
+        {
+            if (stream.empty()) return;
+
+            std::vector<T> result(vertexCount);
+            for (size_t i = 0; i < remap.size() && i < stream.size(); ++i) {
+                if (remap[i] != ~0u) result[remap[i]] = stream[i];
+            }
+            stream.swap(result);
+        }
+
+        MeshOptimizationStats Analyze(const std::vector<u32>& indices, const std::vector<Vertex>& vertices,
+                                      u32 cacheSize = k_CacheSize);
+    }
+}
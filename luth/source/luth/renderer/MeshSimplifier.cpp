@@ -0,0 +1,244 @@
+#include "luthpch.h"
+#include "luth/renderer/MeshSimplifier.h"
+#include "luth/renderer/Model.h"
+
+#include <numeric>
+#include <unordered_set>
+
+namespace Luth::MeshSimplifier
+{
+    namespace
+    {
+        constexpr u32 k_MaxPasses = 64;
+
+        // Symmetric 4x4 plane quadric
+        struct Quadric {
+            f64 a2 = 0, ab = 0, ac = 0, ad = 0;
+            f64 b2 = 0, bc = 0, bd = 0;
+            f64 c2 = 0, cd = 0;
+            f64 d2 = 0;
+            f64 w = 0;      // Accumulated plane weight
+
+            void AddPlane(const Vec3& n, f64 d, f64 weight)
+            {
+                a2 += weight * n.x * n.x; ab += weight * n.x * n.y; ac += weight * n.x * n.z; ad += weight * n.x * d;
+                b2 += weight * n.y * n.y; bc += weight * n.y * n.z; bd += weight * n.y * d;
+                c2 += weight * n.z * n.z; cd += weight * n.z * d;
+                d2 += weight * d * d;
+                w += weight;
+            }
+
+            Quadric& operator+=(const Quadric& o)
+            {
+                a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad;
+                b2 += o.b2; bc += o.bc; bd += o.bd;
+                c2 += o.c2; cd += o.cd;
+                d2 += o.d2;
+                w += o.w;
+                return *this;
+            }
+
+            // Sum of squared distances to the accumulated planes
+            f64 Evaluate(const Vec3& p) const
+            {
+                const f64 x = p.x, y = p.y, z = p.z;
+                const f64 error = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                                + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                                + c2 * z * z + 2 * cd * z
+                                + d2;
+                return std::max(error, 0.0);
+            }
+
+            // Weighted mean squared distance, comparable to a squared length whatever the
+            // triangle areas (and so the mesh scale) behind the weights
+            f64 EvaluateMean(const Vec3& p) const
+            {
+                return w > 0.0 ? Evaluate(p) / w : 0.0;
+            }
+        };
+
+        struct Collapse {
+            u32 From;
+            u32 To;
+            f64 Cost;
+        };
+
+        struct PositionHash {
+            size_t operator()(const Vec3& p) const
+            {
+                const Vec3 q = p + Vec3(0.0f);  // -0 and +0 compare equal, hash them alike
+                u32 bits[3];
+                std::memcpy(bits, &q, sizeof(bits));
+                return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+            }
+        };
+
+        u64 EdgeKey(u32 a, u32 b) { return (static_cast<u64>(a) << 32) | b; }
+
+        // Locks vertices that share a position with another vertex (attribute seams)
+        // and vertices on edges used by a single triangle (open borders)
+        std::vector<u8> FindLockedVertices(const std::vector<Vertex>& vertices, const std::vector<u32>& indices)
+        {
+            const u32 vertexCount = static_cast<u32>(vertices.size());
+            std::vector<u8> locked(vertexCount, 0);
+
+            std::unordered_map<Vec3, u32, PositionHash> firstAtPosition;
+            std::vector<u32> canonical(vertexCount);
+            std::vector<u32> groupSize(vertexCount, 0);
+            for (u32 v = 0; v < vertexCount; ++v) {
+                canonical[v] = firstAtPosition.try_emplace(vertices[v].Position, v).first->second;
+                groupSize[canonical[v]]++;
+            }
+
+            std::unordered_set<u64> edges;
+            edges.reserve(indices.size());
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (u32 k = 0; k < 3; ++k) {
+                    edges.insert(EdgeKey(canonical[indices[i + k]], canonical[indices[i + (k + 1) % 3]]));
+                }
+            }
+
+            std::vector<u8> borderPosition(vertexCount, 0);
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (u32 k = 0; k < 3; ++k) {
+                    const u32 a = canonical[indices[i + k]], b = canonical[indices[i + (k + 1) % 3]];
+                    if (!edges.contains(EdgeKey(b, a))) borderPosition[a] = borderPosition[b] = 1;
+                }
+            }
+
+            for (u32 v = 0; v < vertexCount; ++v) {
+                locked[v] = groupSize[canonical[v]] > 1 || borderPosition[canonical[v]];
+            }
+            return locked;
+        }
+
+        // Moving 'from' onto 'to' must not flip or collapse any remaining triangle around 'from'
+        bool FlipsTriangles(const std::vector<Vertex>& vertices, const std::vector<u32>& indices,
+                            const std::vector<u32>& offsets, const std::vector<u32>& adjacency, u32 from, u32 to)
+        {
+            const Vec3& target = vertices[to].Position;
+            for (u32 a = offsets[from]; a < offsets[from + 1]; ++a) {
+                const u32* tri = &indices[adjacency[a] * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to) continue;    // Removed by the collapse
+
+                const Vec3& p0 = vertices[tri[0]].Position;
+                const Vec3& p1 = vertices[tri[1]].Position;
+                const Vec3& p2 = vertices[tri[2]].Position;
+                const Vec3& q0 = tri[0] == from ? target : p0;
+                const Vec3& q1 = tri[1] == from ? target : p1;
+                const Vec3& q2 = tri[2] == from ? target : p2;
+
+                const Vec3 before = glm::cross(p1 - p0, p2 - p0);
+                const Vec3 after = glm::cross(q1 - q0, q2 - q0);
+                if (glm::dot(before, after) <= 0.0f) return true;
+            }
+            return false;
+        }
+    }
+
+    std::vector<u32> Simplify(const std::vector<Vertex>& vertices, const std::vector<u32>& indices,
+                              size_t targetIndexCount, f32 targetError, f32* outError)
+    {
+        std::vector<u32> result = indices;
+        if (outError) *outError = 0.0f;
+
+        const u32 vertexCount = static_cast<u32>(vertices.size());
+        if (result.size() <= targetIndexCount || vertexCount == 0) return result;
+
+        // Error scale
+        Vec3 boundsMin(FLOAT_MAX), boundsMax(-FLOAT_MAX);
+        for (const auto& vertex : vertices) {
+            boundsMin = glm::min(boundsMin, vertex.Position);
+            boundsMax = glm::max(boundsMax, vertex.Position);
+        }
+        const Vec3 extent = boundsMax - boundsMin;
+        const f64 scale = std::max({ extent.x, extent.y, extent.z, 1e-6f });
+        const f64 maxCost = (targetError * scale) * (targetError * scale);
+
+        const std::vector<u8> locked = FindLockedVertices(vertices, result);
+
+        // Area-weighted face quadrics
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i + 2 < result.size(); i += 3) {
+            const Vec3& p0 = vertices[result[i + 0]].Position;
+            const Vec3& p1 = vertices[result[i + 1]].Position;
+            const Vec3& p2 = vertices[result[i + 2]].Position;
+            Vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const f32 area = glm::length(normal);
+            if (area <= 0.0f) continue;
+
+            normal /= area;
+            const f64 d = -glm::dot(normal, p0);
+            for (u32 k = 0; k < 3; ++k) quadrics[result[i + k]].AddPlane(normal, d, area);
+        }
+
+        std::vector<u32> offsets(vertexCount + 1), adjacency, remap(vertexCount);
+        std::vector<u8> touched(vertexCount);
+        std::vector<Collapse> collapses;
+        f64 appliedCost = 0.0;
+
+        for (u32 pass = 0; pass < k_MaxPasses && result.size() > targetIndexCount; ++pass) {
+            // Vertex -> triangle adjacency of the current triangles
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for (u32 index : result) offsets[index + 1]++;
+            for (u32 v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+            adjacency.resize(result.size());
+            std::vector<u32> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < result.size(); ++i) adjacency[cursor[result[i]]++] = static_cast<u32>(i / 3);
+
+            // Candidate collapses along every edge, cheapest first
+            collapses.clear();
+            for (size_t i = 0; i < result.size(); i += 3) {
+                for (u32 k = 0; k < 3; ++k) {
+                    const u32 a = result[i + k], b = result[i + (k + 1) % 3];
+                    for (const auto [from, to] : { std::pair{ a, b }, std::pair{ b, a } }) {
+                        if (locked[from] || from == to) continue;
+
+                        Quadric q = quadrics[from];
+                        q += quadrics[to];
+                        collapses.push_back({ from, to, q.EvaluateMean(vertices[to].Position) });
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Cost < b.Cost; });
+
+            // Apply independent collapses, each one removes about two triangles
+            std::iota(remap.begin(), remap.end(), 0u);
+            std::fill(touched.begin(), touched.end(), 0);
+            const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+            size_t removed = 0;
+
+            for (const Collapse& c : collapses) {
+                if (c.Cost > maxCost || removed >= trianglesToRemove) break;
+                if (touched[c.From] || touched[c.To]) continue;
+                if (FlipsTriangles(vertices, result, offsets, adjacency, c.From, c.To)) continue;
+
+                remap[c.From] = c.To;
+                quadrics[c.To] += quadrics[c.From];
+                appliedCost = std::max(appliedCost, c.Cost);
+                removed += 2;
+
+                // Keep the neighborhood stable for the rest of this pass
+                for (u32 a = offsets[c.From]; a < offsets[c.From + 1]; ++a) {
+                    const u32* tri = &result[adjacency[a] * 3];
+                    touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+                }
+            }
+            if (removed == 0) break;
+
+            // Rewrite indices and drop the collapsed triangles
+            size_t write = 0;
+            for (size_t i = 0; i < result.size(); i += 3) {
+                const u32 a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+                if (a == b || b == c || a == c) continue;
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+
+        if (outError) *outError = static_cast<f32>(std::sqrt(appliedCost) / scale);
+        return result;
+    }
+}
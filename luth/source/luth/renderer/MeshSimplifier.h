@@ -0,0 +1,21 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <vector>
+
+namespace Luth
+{
+    struct Vertex;
+
+    namespace MeshSimplifier
+    {
+        // Quadric error metric edge collapse (Garland & Heckbert 1997) onto existing vertices,
+        // so every level indexes the original vertex buffer. Vertices on open borders (submesh
+        // and material boundaries) and on UV / normal seams are locked in place.
+        // Stops at 'targetIndexCount' or once a collapse would exceed 'targetError', both
+        // errors relative to the mesh extent. 'outError' receives the largest error applied.
+        std::vector<u32> Simplify(const std::vector<Vertex>& vertices, const std::vector<u32>& indices,
+                                  size_t targetIndexCount, f32 targetError, f32* outError = nullptr);
+    }
+}
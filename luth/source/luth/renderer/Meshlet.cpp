@@ -0,0 +1,278 @@
+#include "luthpch.h"
+#include "luth/renderer/Meshlet.h"
+#include "luth/renderer/Model.h"
+
+namespace Luth
+{
+    namespace
+    {
+        // Normal cones wider than this (dot against the axis) are not worth testing
+        constexpr f32 k_MinConeSpread = 0.1f;
+
+        struct PositionHash {
+            size_t operator()(const Vec3& p) const
+            {
+                const Vec3 q = p + Vec3(0.0f);  // -0 and +0 compare equal, hash them alike
+                u32 bits[3];
+                std::memcpy(bits, &q, sizeof(bits));
+                return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+            }
+        };
+
+        // True when every edge, welded by position, is shared by at least two triangles
+        bool IsClosed(const std::vector<u32>& indices, const std::vector<Vertex>& vertices)
+        {
+            std::unordered_map<Vec3, u32, PositionHash> firstAtPosition;
+            std::vector<u32> canonical(vertices.size());
+            for (u32 v = 0; v < vertices.size(); ++v)
+                canonical[v] = firstAtPosition.try_emplace(vertices[v].Position, v).first->second;
+
+            std::unordered_map<u64, u32> edgeUses;
+            edgeUses.reserve(indices.size());
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                for (u32 e = 0; e < 3; ++e) {
+                    u32 a = canonical[indices[i + e]];
+                    u32 b = canonical[indices[i + (e + 1) % 3]];
+                    if (a == b) continue;
+                    if (a > b) std::swap(a, b);
+                    edgeUses[(static_cast<u64>(a) << 32) | b]++;
+                }
+            }
+
+            for (const auto& [edge, uses] : edgeUses) {
+                if (uses < 2) return false;
+            }
+            return true;
+        }
+
+        void ComputeBounds(Meshlet& meshlet, const u32* indices, const std::vector<Vertex>& vertices, bool coneCulling)
+        {
+            const u32 triangleCount = meshlet.IndexCount / 3;
+
+            Vec3 boundsMin(FLOAT_MAX), boundsMax(-FLOAT_MAX);
+            for (u32 i = 0; i < meshlet.IndexCount; ++i) {
+                boundsMin = glm::min(boundsMin, vertices[indices[i]].Position);
+                boundsMax = glm::max(boundsMax, vertices[indices[i]].Position);
+            }
+            meshlet.Center = (boundsMin + boundsMax) * 0.5f;
+            meshlet.Radius = 0.0f;
+            for (u32 i = 0; i < meshlet.IndexCount; ++i)
+                meshlet.Radius = std::max(meshlet.Radius, glm::distance(vertices[indices[i]].Position, meshlet.Center));
+
+            meshlet.ConeApex = meshlet.Center;
+            meshlet.ConeCutoff = 2.0f;
+            if (!coneCulling) return;
+
+            // Area weighted average of the face normals
+            Vec3 axis(0.0f);
+            for (u32 t = 0; t < triangleCount; ++t) {
+                const Vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+                const Vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+                const Vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+                axis += glm::cross(p1 - p0, p2 - p0);
+            }
+            const f32 axisLength = glm::length(axis);
+            if (axisLength <= 0.0f) return;
+            axis /= axisLength;
+
+            f32 minDot = 1.0f;
+            for (u32 t = 0; t < triangleCount; ++t) {
+                const Vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+                const Vec3 n = glm::cross(vertices[indices[t * 3 + 1]].Position - p0, vertices[indices[t * 3 + 2]].Position - p0);
+                const f32 length = glm::length(n);
+                if (length > 0.0f) minDot = std::min(minDot, glm::dot(n / length, axis));
+            }
+            if (minDot <= k_MinConeSpread) return;
+
+            // Move the apex back along the axis until every triangle plane lies in front of it
+            f32 maxT = 0.0f;
+            for (u32 t = 0; t < triangleCount; ++t) {
+                const Vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+                const Vec3 n = glm::cross(vertices[indices[t * 3 + 1]].Position - p0, vertices[indices[t * 3 + 2]].Position - p0);
+                const f32 length = glm::length(n);
+                if (length <= 0.0f) continue;
+
+                const Vec3 unit = n / length;
+                maxT = std::max(maxT, glm::dot(meshlet.Center - p0, unit) / glm::dot(axis, unit));
+            }
+
+            meshlet.ConeAxis = axis;
+            meshlet.ConeApex = meshlet.Center - axis * maxT;
+            meshlet.ConeCutoff = std::sqrt(std::max(1.0f - minDot * minDot, 0.0f));    // Planar clusters round above 1
+        }
+    }
+
+    // ============================================================================
+    //                                  BUILDER
+    // ============================================================================
+
+    std::vector<Meshlet> MeshletBuilder::Build(std::vector<u32>& indices, const std::vector<Vertex>& vertices,
+                                               u32 maxVertices, u32 maxTriangles)
+    {
+        std::vector<Meshlet> meshlets;
+        const u32 triangleCount = static_cast<u32>(indices.size() / 3);
+        const u32 vertexCount = static_cast<u32>(vertices.size());
+        if (triangleCount == 0 || maxVertices < 3 || maxTriangles == 0) return meshlets;
+
+        // Vertex -> triangle adjacency
+        std::vector<u32> adjacencyOffsets(vertexCount + 1, 0);
+        for (u32 index : indices) adjacencyOffsets[index + 1]++;
+        for (u32 v = 0; v < vertexCount; ++v) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+        std::vector<u32> adjacency(indices.size());
+        std::vector<u32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (u32 t = 0; t < triangleCount; ++t) {
+            for (u32 c = 0; c < 3; ++c) adjacency[fill[indices[t * 3 + c]]++] = t;
+        }
+
+        std::vector<u8> emitted(triangleCount, 0);
+        std::vector<u32> vertexOwner(vertexCount, ~0u);     // Meshlet currently using the vertex
+        std::vector<u32> result;
+        result.reserve(indices.size());
+
+        std::vector<u32> meshletVertices;
+        meshletVertices.reserve(maxVertices);
+        u32 cursor = 0;
+
+        while (true) {
+            while (cursor < triangleCount && emitted[cursor]) ++cursor;
+            if (cursor == triangleCount) break;
+
+            const u32 meshletIndex = static_cast<u32>(meshlets.size());
+            Meshlet meshlet;
+            meshlet.IndexOffset = static_cast<u32>(result.size());
+            meshletVertices.clear();
+            Vec3 centroidSum(0.0f);
+
+            auto newVertices = [&](u32 t) {
+                u32 count = 0;
+                for (u32 c = 0; c < 3; ++c) count += vertexOwner[indices[t * 3 + c]] != meshletIndex;
+                return count;
+            };
+
+            auto append = [&](u32 t) {
+                for (u32 c = 0; c < 3; ++c) {
+                    const u32 v = indices[t * 3 + c];
+                    if (vertexOwner[v] != meshletIndex) {
+                        vertexOwner[v] = meshletIndex;
+                        meshletVertices.push_back(v);
+                        centroidSum += vertices[v].Position;
+                    }
+                    result.push_back(v);
+                }
+                emitted[t] = 1;
+                meshlet.IndexCount += 3;
+            };
+
+            append(cursor);
+
+            while (meshlet.IndexCount / 3 < maxTriangles) {
+                const Vec3 centroid = centroidSum / static_cast<f32>(meshletVertices.size());
+
+                // Neighbouring triangle adding the fewest vertices, closest to the cluster on ties
+                u32 best = ~0u, bestNew = 4;
+                f32 bestDistance = FLOAT_MAX;
+                for (u32 v : meshletVertices) {
+                    for (u32 a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a) {
+                        const u32 t = adjacency[a];
+                        if (emitted[t]) continue;
+
+                        const u32 extra = newVertices(t);
+                        if (meshletVertices.size() + extra > maxVertices || extra > bestNew) continue;
+
+                        const Vec3 triangleCenter = (vertices[indices[t * 3]].Position +
+                            vertices[indices[t * 3 + 1]].Position + vertices[indices[t * 3 + 2]].Position) / 3.0f;
+                        const f32 distance = glm::distance(triangleCenter, centroid);
+                        if (extra < bestNew || distance < bestDistance) {
+                            best = t;
+                            bestNew = extra;
+                            bestDistance = distance;
+                        }
+                    }
+                }
+
+                // No neighbour left: a disconnected part may lie anywhere in the mesh and would
+                // inflate the bounds, it starts the next meshlet instead
+                if (best == ~0u) break;
+
+                append(best);
+            }
+
+            meshlet.VertexCount = static_cast<u32>(meshletVertices.size());
+            meshlets.push_back(meshlet);
+        }
+
+        indices.swap(result);
+
+        const bool coneCulling = IsClosed(indices, vertices);
+        for (auto& meshlet : meshlets)
+            ComputeBounds(meshlet, indices.data() + meshlet.IndexOffset, vertices, coneCulling);
+
+        return meshlets;
+    }
+
+    // ============================================================================
+    //                                   CULLER
+    // ============================================================================
+
+    MeshletCullView MeshletCuller::MakeView(const Mat4& viewProj, const Mat4& model,
+                                            const Vec3& cameraPosition, const Vec3& cameraForward, bool orthographic,
+                                            bool cullBackfaces)
+    {
+        // Planes of the combined matrix are already in model space
+        MeshletCullView view;
+        view.Planes = CreateFrustumFromCamera(viewProj * model);
+        view.Orthographic = orthographic;
+        view.CullBackfaces = cullBackfaces;
+
+        const Mat4 inverseModel = glm::inverse(model);
+        view.Position = Vec3(inverseModel * Vec4(cameraPosition, 1.0f));
+        view.Direction = glm::normalize(Mat3(inverseModel) * cameraForward);
+        return view;
+    }
+
+    bool MeshletCuller::IsOutsideFrustum(const Meshlet& meshlet, const MeshletCullView& view)
+    {
+        return !IsInFrustum(view.Planes, meshlet.Center, meshlet.Radius);
+    }
+
+    bool MeshletCuller::IsBackfacing(const Meshlet& meshlet, const MeshletCullView& view)
+    {
+        if (meshlet.ConeCutoff > 1.0f) return false;
+
+        // Strict: a cluster seen exactly edge-on is kept, the rasterizer may still cover it
+        if (view.Orthographic)
+            return glm::dot(view.Direction, meshlet.ConeAxis) > meshlet.ConeCutoff;
+
+        const Vec3 toApex = meshlet.ConeApex - view.Position;
+        const f32 distance = glm::length(toApex);
+        return distance > 0.0f && glm::dot(toApex, meshlet.ConeAxis) > meshlet.ConeCutoff * distance;
+    }
+
+    u32 MeshletCuller::Cull(const std::vector<Meshlet>& meshlets, const MeshletCullView& view,
+                            std::vector<MeshIndexRange>& out, MeshletCullStats* stats)
+    {
+        const size_t first = out.size();
+        u32 kept = 0;
+
+        for (const auto& meshlet : meshlets) {
+            if (IsOutsideFrustum(meshlet, view)) {
+                if (stats) stats->FrustumCulled++;
+                continue;
+            }
+            if (view.CullBackfaces && IsBackfacing(meshlet, view)) {
+                if (stats) stats->BackfaceCulled++;
+                continue;
+            }
+
+            ++kept;
+            if (out.size() > first && out.back().IndexOffset + out.back().IndexCount == meshlet.IndexOffset)
+                out.back().IndexCount += meshlet.IndexCount;
+            else
+                out.push_back({ meshlet.IndexOffset, meshlet.IndexCount });
+        }
+
+        if (stats) stats->Tested += static_cast<u32>(meshlets.size());
+        return kept;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/core/Math.h"
+
+#include <vector>
+
+namespace Luth
+{
+    struct Vertex;
+
+    // Contiguous run of a mesh index buffer
+    struct MeshIndexRange {
+        u32 IndexOffset = 0;
+        u32 IndexCount = 0;
+    };
+
+    // Small cluster of triangles, culled as a unit. Bounds are in model space
+    struct Meshlet {
+        u32 IndexOffset = 0;
+        u32 IndexCount = 0;
+        u32 VertexCount = 0;                    // Unique vertices referenced
+        Vec3 Center = Vec3(0.0f);               // Bounding sphere
+        f32 Radius = 0.0f;
+        Vec3 ConeApex = Vec3(0.0f);             // Normal cone
+        Vec3 ConeAxis = Vec3(0.0f, 0.0f, 1.0f);
+        f32 ConeCutoff = 2.0f;                  // Above 1: never backfacing
+    };
+
+    // Camera, expressed in the model space of the meshlets being culled
+    struct MeshletCullView {
+        Frustum Planes;
+        Vec3 Position = Vec3(0.0f);     // Eye, perspective only
+        Vec3 Direction = Vec3(0.0f);    // View direction, orthographic only
+        bool Orthographic = false;
+        bool CullBackfaces = false;     // Normal cones, only for draws that cull back faces too
+    };
+
+    struct MeshletCullStats {
+        u32 Tested = 0;
+        u32 FrustumCulled = 0;
+        u32 BackfaceCulled = 0;
+    };
+
+    namespace MeshletBuilder
+    {
+        constexpr u32 k_MaxVertices = 64;
+        constexpr u32 k_MaxTriangles = 124;
+
+        // Splits the triangles into meshlets grown over shared vertices and rewrites 'indices'
+        // in meshlet order. Disconnected parts start a new meshlet, keeping bounds tight.
+        // Normal cones are only built on closed meshes.
+        std::vector<Meshlet> Build(std::vector<u32>& indices, const std::vector<Vertex>& vertices,
+                                   u32 maxVertices = k_MaxVertices, u32 maxTriangles = k_MaxTriangles);
+    }
+
+    namespace MeshletCuller
+    {
+        // 'cullBackfaces' only for RenderCommand::singleSided draws, the rasterizer culls the same faces
+        MeshletCullView MakeView(const Mat4& viewProj, const Mat4& model,
+                                 const Vec3& cameraPosition, const Vec3& cameraForward, bool orthographic,
+                                 bool cullBackfaces);
+
+        bool IsOutsideFrustum(const Meshlet& meshlet, const MeshletCullView& view);
+        bool IsBackfacing(const Meshlet& meshlet, const MeshletCullView& view);
+
+        // Appends the index ranges of the surviving meshlets to 'out', merging adjacent ones.
+        // Returns the number of meshlets kept
+        u32 Cull(const std::vector<Meshlet>& meshlets, const MeshletCullView& view,
+                 std::vector<MeshIndexRange>& out, MeshletCullStats* stats = nullptr);
+    }
+}
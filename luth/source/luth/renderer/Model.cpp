@@ -1,13 +1,28 @@
 #include "luthpch.h"
 #include "luth/renderer/Model.h"
+#include "luth/renderer/MeshSimplifier.h"
+#include "luth/renderer/VertexQuantization.h"
 #include "luth/resources/Resources.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include <functional>
 #include <string>
 
 namespace Luth
 {
+    namespace
+    {
+        constexpr f32 k_LodMaxError = 0.05f;        // Relative to the mesh extent
+        constexpr f32 k_LodScreenSize = 0.5f;       // LOD 1 kicks in below half the viewport height
+        constexpr size_t k_LodMinTriangles = 64;
+        constexpr size_t k_MeshletMinTriangles = 4096;  // Smaller meshes are culled as a whole
+
+        // Layout of the .meta material slots ('mesh_index_version'). 0 or missing: one slot per
+        // mesh instance in node order, from before static meshes were stored once
+        constexpr u32 k_MeshIndexVersion = 1;
+    }
+
     Model::Model(const fs::path& path)
     {
         LoadModel(path);
@@ -15,24 +30,99 @@ namespace Luth
 
     void Model::Init()
     {
-        ProcessMeshData();
-
-        // Deserialize materials
         fs::path metaPath = m_Path;
         metaPath += ".meta";
 
+        nlohmann::json json;
+        bool hasMeta = false;
         if (fs::exists(metaPath)) {
             std::ifstream file(metaPath);
             if (file.good()) {
-                nlohmann::json json;
                 file >> json;
-                Deserialize(json);
+                hasMeta = true;
             }
         }
         else {
             LH_CORE_WARN("No meta file found for model: {0}", m_Path.string());
         }
 
+        // Import settings decide the vertex order and format, so read them before uploading
+        if (hasMeta) LoadImportSettings(json);
+        if (m_ImportSettings.OptimizeMesh) OptimizeMeshes();
+        if (m_ImportSettings.BuildMeshlets && !m_IsSkinned) BuildMeshlets();
+        if (m_ImportSettings.LodCount > 0) GenerateLods();
+
+        for (auto& meshData : m_MeshesData) {
+            // Bounding sphere for LOD selection
+            Vec3 boundsMin(FLOAT_MAX), boundsMax(-FLOAT_MAX);
+            for (const auto& vertex : meshData.Vertices) {
+                boundsMin = glm::min(boundsMin, vertex.Position);
+                boundsMax = glm::max(boundsMax, vertex.Position);
+            }
+            meshData.BoundsCenter = meshData.Vertices.empty() ? Vec3(0.0f) : (boundsMin + boundsMax) * 0.5f;
+            meshData.BoundsRadius = 0.0f;
+            for (const auto& vertex : meshData.Vertices)
+                meshData.BoundsRadius = std::max(meshData.BoundsRadius, glm::distance(vertex.Position, meshData.BoundsCenter));
+        }
+
+        ProcessMeshData();
+
+        // Deserialize materials
+        if (hasMeta) Deserialize(json);
+
+        CacheModelInfo();
+    }
+
+    void Model::LoadImportSettings(const nlohmann::json& json)
+    {
+        m_ImportSettings = {};
+        if (!json.contains("type_settings") || !json["type_settings"].is_object()) return;
+
+        const auto& settings = json["type_settings"];
+        if (settings.contains("optimize_mesh") && settings["optimize_mesh"].is_boolean())
+            m_ImportSettings.OptimizeMesh = settings["optimize_mesh"].get<bool>();
+        if (settings.contains("quantize_vertices") && settings["quantize_vertices"].is_boolean())
+            m_ImportSettings.QuantizeVertices = settings["quantize_vertices"].get<bool>();
+        if (settings.contains("lod_count") && settings["lod_count"].is_number_integer())
+            m_ImportSettings.LodCount = static_cast<u32>(glm::clamp(settings["lod_count"].get<i32>(), 0, 8));
+        if (settings.contains("lod_reduction") && settings["lod_reduction"].is_number())
+            m_ImportSettings.LodReduction = glm::clamp(settings["lod_reduction"].get<f32>(), 0.05f, 0.95f);
+        if (settings.contains("build_meshlets") && settings["build_meshlets"].is_boolean())
+            m_ImportSettings.BuildMeshlets = settings["build_meshlets"].get<bool>();
+    }
+
+    void Model::OptimizeMeshes()
+    {
+        for (u32 i = 0; i < m_MeshesData.size(); ++i) {
+            auto& meshData = m_MeshesData[i];
+            const u32 vertexCount = static_cast<u32>(meshData.Vertices.size());
+
+            #if defined(DEBUG)
+            const MeshOptimizationStats before = MeshOptimizer::Analyze(meshData.Indices, meshData.Vertices);
+            #endif
+
+            MeshOptimizer::OptimizeVertexCache(meshData.Indices, vertexCount);
+            MeshOptimizer::OptimizeOverdraw(meshData.Indices, meshData.Vertices);
+
+            u32 fetchedCount = 0;
+            const std::vector<u32> remap = MeshOptimizer::OptimizeVertexFetch(meshData.Indices, vertexCount, fetchedCount);
+            MeshOptimizer::RemapVertices(meshData.Vertices, remap, fetchedCount);
+            MeshOptimizer::RemapVertices(meshData.TangentSigns, remap, fetchedCount);
+            OnVerticesRemapped(i, remap, fetchedCount);
+
+            #if defined(DEBUG)
+            const MeshOptimizationStats after = MeshOptimizer::Analyze(meshData.Indices, meshData.Vertices);
+            LH_CORE_TRACE(" - {0}: ACMR {1:.3f} -> {2:.3f}, overdraw {3:.3f} -> {4:.3f}", meshData.Name,
+                before.ACMR, after.ACMR, before.Overdraw, after.Overdraw);
+            #endif
+        }
+    }
+
+    void Model::AnalyzeMeshes()
+    {
+        for (auto& meshData : m_MeshesData)
+            meshData.Stats = MeshOptimizer::Analyze(meshData.Indices, meshData.Vertices);
+
         CacheModelInfo();
     }
 
@@ -45,6 +135,7 @@ namespace Luth
             }
         }
         json["dependencies"] = materials_json;
+        json["mesh_index_version"] = k_MeshIndexVersion;
     }
 
     void Model::Deserialize(const nlohmann::json& json)
@@ -103,6 +194,30 @@ namespace Luth
                 m_Materials[index] = uuid;
             }
         }
+
+        i32 meshIndexVersion = 0;
+        if (json.contains("mesh_index_version") && json["mesh_index_version"].is_number_integer())
+            meshIndexVersion = json["mesh_index_version"].get<i32>();
+        if (meshIndexVersion < static_cast<i32>(k_MeshIndexVersion)) RemapLegacyMaterials();
+    }
+
+    void Model::RemapLegacyMaterials()
+    {
+        // Skinned models were never reordered
+        if (m_IsSkinned || m_LegacyMeshOrder.empty()) return;
+
+        // Each unique mesh takes the slot of its first instance, the next Save writes the new layout
+        std::vector<UUID> remapped(m_MeshesData.size());
+        std::vector<u8> assigned(m_MeshesData.size(), 0);
+        for (size_t slot = 0; slot < m_LegacyMeshOrder.size() && slot < m_Materials.size(); ++slot) {
+            const u32 mesh = m_LegacyMeshOrder[slot];
+            if (mesh >= remapped.size() || assigned[mesh]) continue;
+            remapped[mesh] = m_Materials[slot];
+            assigned[mesh] = 1;
+        }
+
+        m_Materials.swap(remapped);
+        LH_CORE_INFO("Remapped legacy material slots of {0} to unique meshes", m_Path.filename().string());
     }
 
     void Model::LoadModel(const fs::path& path)
@@ -121,7 +236,36 @@ namespace Luth
             return;
         }
 
-        ProcessNode(scene->mRootNode, scene, AxisCorrectionMatrix(scene));
+        const bool hasBones = std::any_of(scene->mMeshes, scene->mMeshes + scene->mNumMeshes,
+            [](const aiMesh* mesh) { return mesh->HasBones(); });
+
+        if (hasBones) {
+            // Skinning works on the flattened meshes, one per node instance in depth-first node
+            // order under a single root node. Each keeps its aiMesh in SourceMesh for the bone weights
+            ProcessNode(scene->mRootNode, scene, AxisCorrectionMatrix(scene));
+
+            ModelNode root;
+            root.Name = scene->mRootNode->mName.C_Str();
+            for (u32 i = 0; i < m_MeshesData.size(); ++i) root.MeshIndices.push_back(i);
+            m_Nodes.push_back(std::move(root));
+        }
+        else {
+            // Previous import order, one mesh per instance, to read older .meta material slots
+            std::function<void(const aiNode*)> collectInstances = [&](const aiNode* node) {
+                m_LegacyMeshOrder.insert(m_LegacyMeshOrder.end(), node->mMeshes, node->mMeshes + node->mNumMeshes);
+                for (u32 i = 0; i < node->mNumChildren; ++i) collectInstances(node->mChildren[i]);
+            };
+            collectInstances(scene->mRootNode);
+
+            // Every aiMesh once, in its own space. Nodes place them
+            m_MeshesData.reserve(scene->mNumMeshes);
+            for (u32 i = 0; i < scene->mNumMeshes; ++i) {
+                m_MeshesData.push_back(ProcessMesh(scene->mMeshes[i], scene, Mat4(1.0f)));
+                m_MeshesData.back().SourceMesh = i;
+            }
+
+            ProcessNodeHierarchy(scene->mRootNode, -1, AxisCorrectionMatrix(scene));
+        }
 
         // New material system :3
         LoadMaterials(path);
@@ -141,6 +285,7 @@ namespace Luth
         for (uint32_t i = 0; i < node->mNumMeshes; i++) {
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
             m_MeshesData.push_back(ProcessMesh(mesh, scene, nodeTransform));
+            m_MeshesData.back().SourceMesh = node->mMeshes[i];
         }
 
         // Process children recursively
@@ -149,15 +294,39 @@ namespace Luth
         }
     }
 
+    void Model::ProcessNodeHierarchy(aiNode* node, int32_t parentIndex, const Mat4& rootCorrection)
+    {
+        const int32_t index = static_cast<int32_t>(m_Nodes.size());
+
+        ModelNode entry;
+        entry.Name = node->mName.C_Str();
+        entry.Parent = parentIndex;
+        entry.LocalTransform = AiMat4ToGLM(node->mTransformation);
+        if (parentIndex < 0) entry.LocalTransform = rootCorrection * entry.LocalTransform;
+        entry.MeshIndices.assign(node->mMeshes, node->mMeshes + node->mNumMeshes);
+        m_Nodes.push_back(std::move(entry));
+
+        for (uint32_t i = 0; i < node->mNumChildren; i++) {
+            ProcessNodeHierarchy(node->mChildren[i], index, rootCorrection);
+        }
+
+        // Drop empty leaves (cameras, lights, helpers), children come right after their parent
+        if (parentIndex >= 0 && m_Nodes.size() == static_cast<size_t>(index) + 1 && m_Nodes.back().MeshIndices.empty())
+            m_Nodes.pop_back();
+    }
+
     MeshData Model::ProcessMesh(aiMesh* mesh, const aiScene* scene, const Mat4& transform)
     {
         MeshData data;
         data.Name = mesh->mName.C_Str();
+        data.HasTexCoord1 = mesh->mTextureCoords[1] != nullptr;
 
         data.Vertices.reserve(mesh->mNumVertices);
         data.Indices.reserve(mesh->mNumFaces * 3);  // Assuming triangulation
 
         const Mat3 normalMatrix = ConvertToNormalMatrix(transform);
+        const bool hasTangentFrame = mesh->mNormals && mesh->mTangents && mesh->mBitangents;
+        if (hasTangentFrame) data.TangentSigns.reserve(mesh->mNumVertices);
 
         // Process vertices with transform
         for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
@@ -184,6 +353,13 @@ namespace Luth
                 vertex.Tangent = glm::normalize(transformedTangent);
             }
 
+            // Handedness of the UV frame, so mirrored UVs survive a rebuilt bitangent
+            if (hasTangentFrame) {
+                const aiVector3D& bitan = mesh->mBitangents[i];
+                const Vec3 bitangent = normalMatrix * Vec3(bitan.x, bitan.y, bitan.z);
+                data.TangentSigns.push_back(glm::dot(glm::cross(vertex.Normal, vertex.Tangent), bitangent) < 0.0f ? -1 : 1);
+            }
+
             data.Vertices.push_back(vertex);
         }
 
@@ -366,19 +542,106 @@ namespace Luth
     void Model::ProcessMeshData()
     {
         for (auto& meshData : m_MeshesData) {
-            auto vb = VertexBuffer::Create(meshData.Vertices.data(), meshData.Vertices.size() * sizeof(Vertex));
-            vb->SetLayout({
+            if (m_ImportSettings.QuantizeVertices) {
+                const QuantizedVertexStream stream = VertexQuantization::Quantize(meshData);
+                #if defined(DEBUG)
+                LH_CORE_TRACE(" - {0}: {1} B/vertex, max position error {2}", meshData.Name,
+                    stream.Layout.GetStride(), VertexQuantization::MaxPositionError(meshData, stream));
+                #endif
+
+                auto mesh = CreateMesh(meshData, stream.Data.data(), stream.Layout);
+                mesh->SetVertexDecode(stream.Decode);
+                meshData.VertexStride = stream.Layout.GetStride();
+                m_Meshes.push_back(mesh);
+                continue;
+            }
+
+            const BufferLayout layout = {
                 { ShaderDataType::Float3, "a_Position"  },
                 { ShaderDataType::Float3, "a_Normal"    },
                 { ShaderDataType::Float2, "a_TexCoord0" },
                 { ShaderDataType::Float2, "a_TexCoord1" },
-                { ShaderDataType::Float3, "a_Tangent"   } }
-            );
-            auto ib = IndexBuffer::Create(meshData.Indices.data(), meshData.Indices.size());
-            m_Meshes.push_back(Mesh::Create(vb, ib));
+                { ShaderDataType::Float3, "a_Tangent"   }
+            };
+            m_Meshes.push_back(CreateMesh(meshData, meshData.Vertices.data(), layout));
         }
     }
 
+    void Model::GenerateLods()
+    {
+        const f32 reduction = m_ImportSettings.LodReduction;
+
+        for (auto& meshData : m_MeshesData) {
+            meshData.Lods.clear();
+            const u32 vertexCount = static_cast<u32>(meshData.Vertices.size());
+            f32 error = 0.0f;
+
+            // Each level simplifies the previous one, so errors accumulate
+            for (u32 level = 1; level <= m_ImportSettings.LodCount; ++level) {
+                const std::vector<u32>& source = meshData.Lods.empty() ? meshData.Indices : meshData.Lods.back().Indices;
+                const size_t target = static_cast<size_t>(meshData.Indices.size() / 3 * std::pow(reduction, (f32)level)) * 3;
+                if (target < k_LodMinTriangles * 3) break;
+
+                f32 levelError = 0.0f;
+                std::vector<u32> indices = MeshSimplifier::Simplify(meshData.Vertices, source, target,
+                    k_LodMaxError - error, &levelError);
+
+                // Locked borders and seams or the error budget stalled the reduction
+                if (indices.size() > source.size() * 0.9f) break;
+
+                MeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+                error += levelError;
+
+                MeshLodData lod;
+                lod.Indices = std::move(indices);
+                lod.Error = error;
+                lod.ScreenSize = k_LodScreenSize * std::pow(std::sqrt(reduction), (f32)(level - 1));
+                meshData.Lods.push_back(std::move(lod));
+            }
+
+            #if defined(DEBUG)
+            for (size_t i = 0; i < meshData.Lods.size(); ++i) {
+                LH_CORE_TRACE(" - {0} LOD{1}: {2} triangles, error {3:.4f}", meshData.Name, i + 1,
+                    meshData.Lods[i].Indices.size() / 3, meshData.Lods[i].Error);
+            }
+            #endif
+        }
+    }
+
+    void Model::BuildMeshlets()
+    {
+        for (auto& meshData : m_MeshesData) {
+            meshData.Meshlets.clear();
+            if (meshData.Indices.size() < k_MeshletMinTriangles * 3) continue;
+
+            meshData.Meshlets = MeshletBuilder::Build(meshData.Indices, meshData.Vertices);
+
+            #if defined(DEBUG)
+            LH_CORE_TRACE(" - {0}: {1} meshlets, {2:.1f} triangles avg", meshData.Name, meshData.Meshlets.size(),
+                meshData.Indices.size() / 3.0f / meshData.Meshlets.size());
+            #endif
+        }
+    }
+
+    std::shared_ptr<Mesh> Model::CreateMesh(MeshData& meshData, const void* vertices, const BufferLayout& layout)
+    {
+        std::vector<MeshLod> lods;
+        lods.push_back({ 0, static_cast<u32>(meshData.Indices.size()), 1.0f, 0.0f });
+
+        std::vector<u32> indices = meshData.Indices;
+        for (const auto& lod : meshData.Lods) {
+            lods.push_back({ static_cast<u32>(indices.size()), static_cast<u32>(lod.Indices.size()), lod.ScreenSize, lod.Error });
+            indices.insert(indices.end(), lod.Indices.begin(), lod.Indices.end());
+        }
+
+        // The pool picks the 16 or 32-bit index arena from the vertex count
+        auto mesh = Mesh::Create(vertices, static_cast<u32>(meshData.Vertices.size()), layout, indices);
+        meshData.IndexFormat = mesh->GetAllocation().IndexSize == sizeof(u16) ? IndexType::UInt16 : IndexType::UInt32;
+        mesh->SetLods(std::move(lods));
+        mesh->SetMeshlets(meshData.Meshlets);
+        return mesh;
+    }
+
     ModelInfo Model::GetModelInfo() const
     {
         ModelInfo info;
@@ -386,6 +649,9 @@ namespace Luth
         info.IsSkinned = m_IsSkinned;
         info.TotalMeshCount = static_cast<uint32_t>(m_MeshesData.size());
         info.MaterialCount = static_cast<uint32_t>(m_Materials.size());
+        info.NodeCount = static_cast<uint32_t>(m_Nodes.size());
+        for (const auto& node : m_Nodes)
+            info.MeshInstanceCount += static_cast<uint32_t>(node.MeshIndices.size());
 
         // Calculate totals and per-mesh info
         for (const auto& meshData : m_MeshesData) {
@@ -397,6 +663,13 @@ namespace Luth
             meshInfo.VertexCount = static_cast<uint32_t>(meshData.Vertices.size());
             meshInfo.IndexCount = static_cast<uint32_t>(meshData.Indices.size());
             meshInfo.MaterialIndex = meshData.MaterialIndex;
+            meshInfo.VertexStride = meshData.VertexStride;
+            meshInfo.IndexSize = meshData.IndexFormat == IndexType::UInt16 ? 2 : 4;
+            meshInfo.Stats = meshData.Stats;
+            meshInfo.LodIndexCounts.push_back(static_cast<uint32_t>(meshData.Indices.size()));
+            for (const auto& lod : meshData.Lods)
+                meshInfo.LodIndexCounts.push_back(static_cast<uint32_t>(lod.Indices.size()));
+            meshInfo.MeshletCount = static_cast<uint32_t>(meshData.Meshlets.size());
             info.Meshes.push_back(meshInfo);
         }
 
@@ -2,6 +2,7 @@
 
 #include "luth/renderer/Material.h"
 #include "luth/renderer/Mesh.h"
+#include "luth/renderer/MeshOptimizer.h"
 #include "luth/resources/Resource.h"
 
 #include <string>
@@ -20,11 +21,37 @@ namespace Luth
         glm::vec3 Tangent;
     };
 
+    // Coarser index list over the same vertices, see MeshSimplifier
+    struct MeshLodData {
+        std::vector<uint32_t> Indices;
+        float Error = 0.0f;         // Relative to the mesh extent
+        float ScreenSize = 0.0f;    // Used below this projected height (fraction of the viewport)
+    };
+
     struct MeshData {
         std::vector<Vertex> Vertices;
         std::vector<uint32_t> Indices;
+        std::vector<int8_t> TangentSigns;   // Bitangent handedness per vertex, empty when unknown (+1)
         uint32_t MaterialIndex = 0;
+        uint32_t SourceMesh = 0;            // Index in aiScene::mMeshes, a mesh placed by many nodes repeats it
+        uint32_t VertexStride = sizeof(Vertex);
+        IndexType IndexFormat = IndexType::UInt32;
+        bool HasTexCoord1 = false;
+        MeshOptimizationStats Stats;
+        std::vector<MeshLodData> Lods;      // LOD 1..n, LOD 0 is Indices
+        std::vector<Meshlet> Meshlets;      // Clusters of LOD 0, Indices are stored in meshlet order
+        Vec3 BoundsCenter = Vec3(0.0f);
+        float BoundsRadius = 0.0f;
+        std::string Name;
+    };
+
+    // Node of the imported scene graph. Meshes are stored once and referenced by index,
+    // so a mesh placed by many nodes is uploaded a single time
+    struct ModelNode {
         std::string Name;
+        Mat4 LocalTransform = Mat4(1.0f);
+        int32_t Parent = -1;                // Index in the node table, -1 for the root
+        std::vector<uint32_t> MeshIndices;
     };
 
     struct MeshInfo {
@@ -32,6 +59,11 @@ namespace Luth
         uint32_t VertexCount = 0;
         uint32_t IndexCount = 0;
         uint32_t MaterialIndex = 0;
+        uint32_t VertexStride = 0;
+        uint32_t IndexSize = 4;
+        MeshOptimizationStats Stats;
+        std::vector<uint32_t> LodIndexCounts;   // LOD 0..n
+        uint32_t MeshletCount = 0;
     };
 
     struct BoneNodeInfo {
@@ -53,6 +85,8 @@ namespace Luth
         uint32_t TotalVertexCount = 0;
         uint32_t TotalIndexCount = 0;
         uint32_t MaterialCount = 0;
+        uint32_t NodeCount = 0;
+        uint32_t MeshInstanceCount = 0;     // Mesh references over all nodes
         std::vector<MeshInfo> Meshes;
 
         // Skinned model data
@@ -62,6 +96,15 @@ namespace Luth
         std::vector<AnimationInfo> Animations;
     };
 
+    // Read from the 'type_settings' of the model .meta
+    struct ModelImportSettings {
+        bool OptimizeMesh = true;       // Vertex cache, overdraw and vertex fetch reordering
+        bool QuantizeVertices = false;  // Packed 20/24 byte vertices, static meshes only
+        u32 LodCount = 3;               // Simplified levels generated below LOD 0
+        f32 LodReduction = 0.5f;        // Triangle ratio between consecutive levels
+        bool BuildMeshlets = true;      // Clusters for per-cluster culling, large static meshes only
+    };
+
     class Model : public Resource
     {
     public:
@@ -69,10 +112,14 @@ namespace Luth
         virtual ~Model() = default;
 
         void Init();
+        // Fills MeshData::Stats, too slow to run on every load
+        void AnalyzeMeshes();
 
         std::vector<MeshData>& GetMeshesData() { return m_MeshesData; }
         std::vector<std::shared_ptr<Mesh>>& GetMeshes() { return m_Meshes; }
+        const std::vector<ModelNode>& GetNodes() const { return m_Nodes; }
         const ModelInfo& GetCachedModelInfo() const { return m_ModelInfo; }
+        const ModelImportSettings& GetImportSettings() const { return m_ImportSettings; }
 
         void AddMaterial(UUID uuid, u32 index) {
             if (index >= m_Materials.size()) {
@@ -91,14 +138,27 @@ namespace Luth
     private:
         void LoadModel(const fs::path& path);
         void ProcessNode(aiNode* node, const aiScene* scene, const Mat4& parentTransform = Mat4(1.0f));
+        void ProcessNodeHierarchy(aiNode* node, int32_t parentIndex, const Mat4& rootCorrection);
         MeshData ProcessMesh(aiMesh* mesh, const aiScene* scene, const Mat4& transform);
         Material ProcessMaterial(aiMaterial* material, const fs::path& directory);
         void LoadMaterials(const fs::path& path);
         Mat4 AxisCorrectionMatrix(const aiScene* scene);
+        void LoadImportSettings(const nlohmann::json& json);
+        void RemapLegacyMaterials();
+        void OptimizeMeshes();
+        void GenerateLods();
+        void BuildMeshlets();
 
         virtual void ProcessMeshData();
 
     protected:
+        // Called after OptimizeMeshes renumbers a mesh's vertices, to reorder extra per-vertex data
+        virtual void OnVerticesRemapped(u32 meshIndex, const std::vector<u32>& remap, u32 vertexCount) {}
+
+        // Uploads the vertices ('meshData.Vertices.size()' of them, laid out as 'layout') and LOD 0
+        // followed by every coarser level into the shared geometry pool
+        std::shared_ptr<Mesh> CreateMesh(MeshData& meshData, const void* vertices, const BufferLayout& layout);
+
         virtual ModelInfo GetModelInfo() const;
         void CacheModelInfo() { m_ModelInfo = GetModelInfo(); }
         ModelInfo m_ModelInfo;
@@ -106,7 +166,10 @@ namespace Luth
         fs::path m_Path;
         std::vector<MeshData> m_MeshesData;
         std::vector<std::shared_ptr<Mesh>> m_Meshes;
+        std::vector<ModelNode> m_Nodes;
         std::vector<UUID> m_Materials;
+        std::vector<u32> m_LegacyMeshOrder;     // aiMesh of each pre-hierarchy mesh index, static models
+        ModelImportSettings m_ImportSettings;
 
         bool m_IsSkinned = false;
     };
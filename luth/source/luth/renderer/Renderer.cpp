@@ -26,6 +26,10 @@ namespace Luth
     // Forwarding commands
     //===========================================
 
+    void Renderer::BeginFrame() {
+        s_RendererAPI->BeginFrame();
+    }
+
     void Renderer::BindFramebuffer(const std::shared_ptr<Framebuffer>& framebuffer) {
         s_RendererAPI->BindFramebuffer(framebuffer);
     }
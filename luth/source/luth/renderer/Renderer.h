@@ -16,6 +16,8 @@ namespace Luth
         static void Init(RendererAPI::API api, void* window);
         static void Shutdown();
 
+        static void BeginFrame();
+
         static void BindFramebuffer(const std::shared_ptr<Framebuffer>& framebuffer);
 
         static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height);
@@ -36,6 +36,9 @@ namespace Luth
         virtual void Init() = 0;
         virtual void Shutdown() = 0;
 
+        // Called once per frame before anything is rendered
+        virtual void BeginFrame() = 0;
+
         virtual void BindFramebuffer(const std::shared_ptr<Framebuffer>& framebuffer) = 0;
 
         virtual void SetViewport(u32 x, u32 y, u32 width, u32 height) = 0;
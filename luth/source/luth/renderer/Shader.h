@@ -2,13 +2,22 @@
 
 #include "luth/core/LuthTypes.h"
 #include "luth/core/Math.h"
+#include "luth/renderer/ShaderProperty.h"
 #include "luth/resources/Resource.h"
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Luth
 {
+    // Uniform block as reflected from the linked program
+    struct UniformBlockInfo {
+        std::string Name;
+        u32 Binding = 0;
+        u32 Size = 0;       // Bytes, std140
+    };
+
 	class Shader : public Resource
 	{
 	public:
@@ -25,6 +34,32 @@ namespace Luth
         virtual void SetVec4(const std::string& name, const glm::vec4& vector) = 0;
         virtual void SetMat4(const std::string& name, const glm::mat4& matrix) = 0;
 
+        // Hashed identifiers, see LH_PROP
+        virtual void SetBool(ShaderProperty property, bool value) = 0;
+        virtual void SetInt(ShaderProperty property, int value) = 0;
+        virtual void SetFloat(ShaderProperty property, float value) = 0;
+        virtual void SetVec2(ShaderProperty property, const glm::vec2& vector) = 0;
+        virtual void SetVec3(ShaderProperty property, const glm::vec3& vector) = 0;
+        virtual void SetVec4(ShaderProperty property, const glm::vec4& vector) = 0;
+        virtual void SetMat4(ShaderProperty property, const glm::mat4& matrix) = 0;
+
+        virtual const std::vector<UniformBlockInfo>& GetUniformBlocks() const = 0;
+
+        // Selects the variant for a ShaderKeywords mask, compiled on first use. Bits the shader
+        // does not declare are dropped. Takes effect on the next Bind()
+        virtual void SetKeywords(u32 keywords) = 0;
+        virtual u32 GetKeywords() const = 0;
+        virtual u32 GetDeclaredKeywords() const = 0;
+        // Compiles a variant ahead of its first draw
+        virtual void Prewarm(u32 keywords) = 0;
+        virtual u32 GetVariantCount() const = 0;
+
+        // Source files this shader was built from, itself first then its includes (canonical)
+        virtual const std::vector<fs::path>& GetDependencies() const = 0;
+        // Rebuilds in place from disk, compiled variants included. Keeps the current
+        // programs and returns false if the new source does not compile
+        virtual bool Reload() = 0;
+
         static std::shared_ptr<Shader> Create(const fs::path& filePath);
         static std::shared_ptr<Shader> Create(const std::string& vertexSrc, const std::string& fragmentSrc);
 
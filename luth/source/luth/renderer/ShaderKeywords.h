@@ -0,0 +1,65 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <string_view>
+#include <utility>
+
+namespace Luth
+{
+    // Engine-wide keyword bits. A shader declares the ones it reacts to with
+    // '#pragma multi_compile LH_...', each combination in use compiles to its own program
+    // with the matching '#define's. Keywords a shader does not declare are ignored.
+    namespace ShaderKeywords
+    {
+        constexpr u32 Skinned          = 1u << 0;
+        constexpr u32 AlphaCutout      = 1u << 1;
+        constexpr u32 AlphaBlend       = 1u << 2;
+        constexpr u32 AlphaFromDiffuse = 1u << 3;
+        constexpr u32 Gloss            = 1u << 4;
+        constexpr u32 SingleChannel    = 1u << 5;
+        constexpr u32 DiffuseMap       = 1u << 6;   // Map bits follow MapType order
+        constexpr u32 AlphaMap         = 1u << 7;
+        constexpr u32 NormalMap        = 1u << 8;
+        constexpr u32 MetalMap         = 1u << 9;
+        constexpr u32 RoughMap         = 1u << 10;
+        constexpr u32 SpecularMap      = 1u << 11;
+        constexpr u32 OcclusionMap     = 1u << 12;
+        constexpr u32 EmissiveMap      = 1u << 13;
+        constexpr u32 ThicknessMap     = 1u << 14;
+        constexpr u32 GBufferDebug     = 1u << 15;  // Extra G-buffer outputs for the editor views
+        constexpr u32 SSAOLow          = 1u << 16;  // SSAO sample count tiers, none is medium
+        constexpr u32 SSAOHigh         = 1u << 17;
+        constexpr u32 SSAOUltra        = 1u << 18;
+
+        inline constexpr std::pair<std::string_view, u32> k_Names[] = {
+            { "LH_SKINNED",            Skinned },
+            { "LH_ALPHA_CUTOUT",       AlphaCutout },
+            { "LH_ALPHA_BLEND",        AlphaBlend },
+            { "LH_ALPHA_FROM_DIFFUSE", AlphaFromDiffuse },
+            { "LH_GLOSS",              Gloss },
+            { "LH_SINGLE_CHANNEL",     SingleChannel },
+            { "LH_DIFFUSE_MAP",        DiffuseMap },
+            { "LH_ALPHA_MAP",          AlphaMap },
+            { "LH_NORMAL_MAP",         NormalMap },
+            { "LH_METAL_MAP",          MetalMap },
+            { "LH_ROUGH_MAP",          RoughMap },
+            { "LH_SPECULAR_MAP",       SpecularMap },
+            { "LH_OCCLUSION_MAP",      OcclusionMap },
+            { "LH_EMISSIVE_MAP",       EmissiveMap },
+            { "LH_THICKNESS_MAP",      ThicknessMap },
+            { "LH_GBUFFER_DEBUG",      GBufferDebug },
+            { "LH_SSAO_LOW",           SSAOLow },
+            { "LH_SSAO_HIGH",          SSAOHigh },
+            { "LH_SSAO_ULTRA",         SSAOUltra },
+        };
+
+        // 0 for unknown names
+        constexpr u32 FromName(std::string_view name)
+        {
+            for (const auto& [keyword, bit] : k_Names)
+                if (keyword == name) return bit;
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#include "luthpch.h"
+#include "luth/renderer/ShaderPreprocessor.h"
+#include "luth/renderer/Shader.h"
+#include "luth/resources/FileSystem.h"
+
+#include <unordered_set>
+
+namespace Luth
+{
+    struct ShaderPreprocessor::Context {
+        Result& Out;
+        std::unordered_set<fs::path> Pasted;    // '#pragma once' files already in the current stage
+        std::vector<fs::path> Stack;            // Files being expanded, for cycle detection
+
+        u32 IndexOf(const fs::path& path)
+        {
+            auto it = std::find(Out.Dependencies.begin(), Out.Dependencies.end(), path);
+            if (it != Out.Dependencies.end()) return static_cast<u32>(it - Out.Dependencies.begin());
+            Out.Dependencies.push_back(path);
+            return static_cast<u32>(Out.Dependencies.size()) - 1;
+        }
+    };
+
+    ShaderPreprocessor::Result ShaderPreprocessor::Process(const fs::path& filePath)
+    {
+        Result result;
+        Context ctx{ result };
+
+        std::lock_guard lock(s_Mutex);
+        const fs::path path = fs::weakly_canonical(filePath);
+        ctx.IndexOf(path);
+        result.Success = Expand(path, ctx);
+        return result;
+    }
+
+    void ShaderPreprocessor::Clear()
+    {
+        std::lock_guard lock(s_Mutex);
+        s_Files.clear();
+    }
+
+    const ShaderPreprocessor::ParsedFile* ShaderPreprocessor::GetParsed(const fs::path& path)
+    {
+        std::error_code ec;
+        const auto time = fs::last_write_time(path, ec);
+        if (ec) return nullptr;
+
+        if (auto it = s_Files.find(path); it != s_Files.end() && it->second.Time == time)
+            return &it->second;
+
+        const std::string source = Shader::Load(path);
+
+        ParsedFile parsed;
+        parsed.Time = time;
+
+        std::istringstream stream(source);
+        ParsedFile::Chunk chunk;
+        u32 lineNumber = 0;
+        for (std::string line; std::getline(stream, line); ) {
+            ++lineNumber;
+
+            const size_t first = line.find_first_not_of(" \t");
+            const std::string_view directive = first == std::string::npos ? std::string_view() : std::string_view(line).substr(first);
+
+            if (directive.starts_with("#pragma once")) {
+                parsed.Once = true;
+                chunk.Text += '\n';     // Keeps the line count
+                continue;
+            }
+
+            // Stages compile separately, '#pragma once' files go into each
+            if (directive.starts_with("#type")) {
+                chunk.Text += line;
+                chunk.Text += '\n';
+                chunk.NewStage = true;
+                parsed.Chunks.push_back(std::move(chunk));
+                chunk = {};
+                continue;
+            }
+
+            if (directive.starts_with("#include")) {
+                const size_t open = line.find_first_of("\"<");
+                const size_t close = open == std::string::npos ? std::string::npos : line.find_first_of("\">", open + 1);
+                if (close == std::string::npos) {
+                    LH_CORE_ERROR("{0}({1}): malformed #include", path.string(), lineNumber);
+                    chunk.Text += '\n';
+                    continue;
+                }
+
+                chunk.Include = line.substr(open + 1, close - open - 1);
+                chunk.NextLine = lineNumber + 1;
+                parsed.Chunks.push_back(std::move(chunk));
+                chunk = {};
+                continue;
+            }
+
+            chunk.Text += line;
+            chunk.Text += '\n';
+        }
+        parsed.Chunks.push_back(std::move(chunk));
+
+        return &(s_Files[path] = std::move(parsed));
+    }
+
+    bool ShaderPreprocessor::Expand(const fs::path& path, Context& ctx)
+    {
+        if (std::find(ctx.Stack.begin(), ctx.Stack.end(), path) != ctx.Stack.end()) {
+            LH_CORE_ERROR("Shader include cycle through {0}", path.string());
+            return false;
+        }
+
+        const ParsedFile* parsed = GetParsed(path);
+        if (!parsed) {
+            LH_CORE_ERROR("Could not open shader file: {0}", path.string());
+            return false;
+        }
+
+        if (parsed->Once && !ctx.Pasted.insert(path).second) return true;
+
+        ctx.Stack.push_back(path);
+        const u32 index = ctx.IndexOf(path);
+
+        bool success = true;
+        for (const auto& chunk : parsed->Chunks) {
+            ctx.Out.Source += chunk.Text;
+            if (chunk.NewStage) ctx.Pasted.clear();
+            if (chunk.Include.empty()) continue;
+
+            const fs::path include = Resolve(path, chunk.Include);
+            if (include.empty()) {
+                LH_CORE_ERROR("{0}({1}): cannot find include '{2}'", path.string(), chunk.NextLine - 1, chunk.Include);
+                success = false;
+                break;
+            }
+
+            ctx.Out.Source += FMT("#line 1 {0}\n", ctx.IndexOf(include));
+            if (!Expand(include, ctx)) {
+                success = false;
+                break;
+            }
+            ctx.Out.Source += FMT("#line {0} {1}\n", chunk.NextLine, index);
+        }
+
+        ctx.Stack.pop_back();
+        return success;
+    }
+
+    fs::path ShaderPreprocessor::Resolve(const fs::path& from, const std::string& include)
+    {
+        std::error_code ec;
+        for (const fs::path& candidate : { from.parent_path() / include, FileSystem::AssetsPath("shaders/include") / include }) {
+            if (fs::exists(candidate, ec)) return fs::weakly_canonical(candidate, ec);
+        }
+        return {};
+    }
+}
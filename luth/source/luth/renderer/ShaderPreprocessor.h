@@ -0,0 +1,56 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Luth
+{
+    // Expands '#include "file"' in shader sources. Names resolve against the including
+    // file's folder first, then assets/shaders/include. Files containing '#pragma once'
+    // are pasted once per stage ('#type' section), include cycles are an error.
+    //
+    // Each included file is wrapped in '#line 1 <index>' / '#line <n> <parent>', so
+    // compiler messages read '<index>(<line>)' with index into Result::Dependencies.
+    class ShaderPreprocessor
+    {
+    public:
+        struct Result {
+            std::string Source;
+            std::vector<fs::path> Dependencies;     // Canonical, [0] is the shader itself
+            bool Success = false;
+        };
+
+        static Result Process(const fs::path& filePath);
+
+        // Files are re-read when their timestamp changes, this drops the cache entirely
+        static void Clear();
+
+    private:
+        // A file split at its include directives
+        struct ParsedFile {
+            struct Chunk {
+                std::string Text;           // Verbatim up to the directive
+                std::string Include;        // Empty when the chunk ends at a stage or the file end
+                u32 NextLine = 0;           // Line after the directive
+                bool NewStage = false;      // Text ends with a '#type' line
+            };
+
+            fs::file_time_type Time;
+            std::vector<Chunk> Chunks;
+            bool Once = false;
+        };
+
+        struct Context;
+
+        static const ParsedFile* GetParsed(const fs::path& path);
+        static bool Expand(const fs::path& path, Context& ctx);
+        static fs::path Resolve(const fs::path& from, const std::string& include);
+
+        static inline std::mutex s_Mutex;
+        static inline std::unordered_map<fs::path, ParsedFile> s_Files;
+    };
+}
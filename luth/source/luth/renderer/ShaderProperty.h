@@ -0,0 +1,31 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <string_view>
+
+namespace Luth
+{
+    // Uniform identifier hashed from its name (32-bit FNV-1a). LH_PROP("u_Radius") hashes at
+    // compile time, so setting a uniform costs a table probe instead of a string build and lookup.
+    struct ShaderProperty
+    {
+        u32 Id = 0;
+        const char* Name = "";
+
+        static constexpr u32 Hash(std::string_view name)
+        {
+            u32 hash = 2166136261u;
+            for (char c : name) {
+                hash ^= static_cast<u8>(c);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        explicit consteval ShaderProperty(const char* name)
+            : Id(Hash(name)), Name(name) {}
+    };
+}
+
+#define LH_PROP(name) ::Luth::ShaderProperty(name)
@@ -26,40 +26,15 @@ namespace Luth
 
         m_GlobalInverseTransform = glm::inverse(AiMat4ToGLM(m_Scene->mRootNode->mTransformation));
 
-        // Convert vertices to skinned version
-        for (uint32_t i = 0; i < m_Scene->mNumMeshes; ++i) {
-            aiMesh* mesh = m_Scene->mMeshes[i];
-
-            // Create skinned vertices from base vertices
-            std::vector<SkinnedVertex> skinnedVertices;
-            skinnedVertices.reserve(m_MeshesData[i].Vertices.size());
-
-            for (const Vertex& v : m_MeshesData[i].Vertices) {
-                SkinnedVertex sv;
-                // Copy base data
-                sv.Position  = v.Position;
-                sv.Normal    = v.Normal;
-                sv.TexCoord0 = v.TexCoord0;
-                sv.TexCoord1 = v.TexCoord1;
-                sv.Tangent   = v.Tangent;
-                // Initialize bone data
-                sv.BoneIDs = glm::ivec4(-1);
-                sv.BoneWeights = glm::vec4(0.0f);
-                skinnedVertices.push_back(sv);
-            }
-
-            // Add bone weights
-            ExtractBoneWeights(mesh, skinnedVertices);
-
-            m_MeshesData[i].Vertices.clear();
-            m_MeshesData[i].Vertices.reserve(skinnedVertices.size());
-            for (auto& sv : skinnedVertices) {
-                // Store as base Vertex - handle this in ProcessMeshData
-                m_MeshesData[i].Vertices.push_back(static_cast<Vertex>(sv));
-            }
-
-            // Store extended data separately
-            m_SkinnedVertices.push_back(std::move(skinnedVertices));
+        // Bone influences, stored next to the base vertices. m_MeshesData is in node order,
+        // each entry reads the weights of the aiMesh it was built from
+        m_BoneData.resize(m_MeshesData.size());
+        m_SkinFormats.resize(m_MeshesData.size(), SkinFormat::Compact8);
+        for (size_t i = 0; i < m_MeshesData.size(); ++i) {
+            m_BoneData[i].resize(m_MeshesData[i].Vertices.size());
+            const u32 source = m_MeshesData[i].SourceMesh;
+            if (source >= m_Scene->mNumMeshes) continue;
+            m_SkinFormats[i] = ExtractBoneWeights(m_Scene->mMeshes[source], m_BoneData[i]);
         }
 
         // Build bone hierarchy
@@ -138,8 +113,15 @@ namespace Luth
         }
     }
 
-    void SkinnedModel::ExtractBoneWeights(aiMesh* mesh, std::vector<SkinnedVertex>& vertices)
+    SkinFormat SkinnedModel::ExtractBoneWeights(aiMesh* mesh, std::vector<VertexBoneData>& boneData)
     {
+        struct Influences {
+            u32 IDs[4] = { 0, 0, 0, 0 };
+            f32 Weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        };
+        std::vector<Influences> raw(boneData.size());
+        u32 maxBoneID = 0;
+
         for (uint32_t boneIndex = 0; boneIndex < mesh->mNumBones; ++boneIndex) {
             aiBone* bone = mesh->mBones[boneIndex];
             std::string boneName = bone->mName.C_Str();
@@ -157,49 +139,128 @@ namespace Luth
                 boneID = m_BoneMapping[boneName];
             }
 
-            // Set id / weights
+            // Keep the 4 strongest influences per vertex
             for (uint32_t w = 0; w < bone->mNumWeights; ++w) {
                 uint32_t vertexID = bone->mWeights[w].mVertexId;
                 float weight = bone->mWeights[w].mWeight;
-                SetVertexBoneData(vertices[vertexID], boneID, weight);
+                if (vertexID >= raw.size() || weight <= 0.0f) continue;
+
+                Influences& inf = raw[vertexID];
+                int slot = 0;
+                for (int i = 1; i < 4; ++i) {
+                    if (inf.Weights[i] < inf.Weights[slot]) slot = i;
+                }
+                if (weight > inf.Weights[slot]) {
+                    inf.IDs[slot] = boneID;
+                    inf.Weights[slot] = weight;
+                    maxBoneID = std::max(maxBoneID, boneID);
+                }
             }
         }
 
-        // Normalize vertex weights
-        for (auto& vert : vertices) {
-            float total = vert.BoneWeights.x
-                + vert.BoneWeights.y
-                + vert.BoneWeights.z
-                + vert.BoneWeights.w;
-            if (total > 0.0f) {
-                vert.BoneWeights /= total;
+        const SkinFormat format = maxBoneID <= 0xFF ? SkinFormat::Compact8 : SkinFormat::Wide16;
+        const u32 scale = format == SkinFormat::Compact8 ? 0xFF : 0xFFFF;
+
+        // Quantize with largest-remainder rounding so every vertex sums to exactly 'scale'
+        for (size_t v = 0; v < raw.size(); ++v) {
+            const Influences& inf = raw[v];
+            VertexBoneData& out = boneData[v];
+
+            const float total = inf.Weights[0] + inf.Weights[1] + inf.Weights[2] + inf.Weights[3];
+            if (total <= 0.0f) continue;
+
+            u32 quantized[4];
+            float remainder[4];
+            u32 sum = 0;
+            for (int i = 0; i < 4; ++i) {
+                const float exact = inf.Weights[i] / total * scale;
+                quantized[i] = static_cast<u32>(exact);
+                remainder[i] = exact - quantized[i];
+                sum += quantized[i];
+            }
+            while (sum < scale) {
+                int best = 0;
+                for (int i = 1; i < 4; ++i) {
+                    if (remainder[i] > remainder[best]) best = i;
+                }
+                quantized[best]++;
+                remainder[best] = -1.0f;
+                sum++;
+            }
+
+            for (int i = 0; i < 4; ++i) {
+                out.BoneIDs[i] = quantized[i] ? static_cast<u16>(inf.IDs[i]) : 0;
+                out.Weights[i] = static_cast<u16>(format == SkinFormat::Compact8 ? quantized[i] * 257 : quantized[i]);
             }
         }
+
+        return format;
+    }
+
+    void SkinnedModel::OnVerticesRemapped(u32 meshIndex, const std::vector<u32>& remap, u32 vertexCount)
+    {
+        if (meshIndex < m_BoneData.size())
+            MeshOptimizer::RemapVertices(m_BoneData[meshIndex], remap, vertexCount);
     }
 
     void SkinnedModel::ProcessMeshData()
     {
         for (size_t i = 0; i < m_MeshesData.size(); ++i) {
             auto& meshData = m_MeshesData[i];
+            const auto& bones = m_BoneData[i];
+            const bool compact = m_SkinFormats[i] == SkinFormat::Compact8;
+
+            // Interleave base vertex + packed bone attributes for upload only
+            const size_t boneSize = compact ? 8 : 16;
+            const size_t stride = sizeof(Vertex) + boneSize;
+            std::vector<u8> packed(meshData.Vertices.size() * stride);
+
+            for (size_t v = 0; v < meshData.Vertices.size(); ++v) {
+                u8* dst = packed.data() + v * stride;
+                memcpy(dst, &meshData.Vertices[v], sizeof(Vertex));
+                dst += sizeof(Vertex);
+
+                if (compact) {
+                    for (int b = 0; b < 4; ++b) {
+                        dst[b]     = static_cast<u8>(bones[v].BoneIDs[b]);
+                        dst[4 + b] = static_cast<u8>(bones[v].Weights[b] / 257);
+                    }
+                }
+                else {
+                    memcpy(dst, bones[v].BoneIDs.data(), 8);
+                    memcpy(dst + 8, bones[v].Weights.data(), 8);
+                }
+            }
 
-            auto vb = VertexBuffer::Create(m_SkinnedVertices[i].data(), m_SkinnedVertices[i].size() * sizeof(SkinnedVertex));
-            vb->SetLayout({
+            const ShaderDataType boneType = compact ? ShaderDataType::UByte4 : ShaderDataType::UShort4;
+
+            const BufferLayout layout = {
                 { ShaderDataType::Float3, "a_Position"    },
                 { ShaderDataType::Float3, "a_Normal"      },
                 { ShaderDataType::Float2, "a_TexCoord0"   },
                 { ShaderDataType::Float2, "a_TexCoord1"   },
                 { ShaderDataType::Float3, "a_Tangent"     },
-                { ShaderDataType::Int4,   "a_BoneIDs"     },
-                { ShaderDataType::Float4, "a_BoneWeights" }
-            });
+                { boneType,               "a_BoneIDs"     },
+                { boneType,               "a_BoneWeights", true }
+            };
 
-            auto ib = IndexBuffer::Create(meshData.Indices.data(), meshData.Indices.size());
-            m_Meshes.push_back(Mesh::Create(vb, ib));
+            m_Meshes.push_back(CreateMesh(meshData, packed.data(), layout));
+            meshData.VertexStride = static_cast<u32>(stride);
         }
     }
 
     void SkinnedModel::UpdateAnimation(float timeInSeconds, i32 animationIndex)
     {
+        if (!m_Scene || !m_Scene->mAnimations) return;
+
+        SamplePose(timeInSeconds, animationIndex, m_Pose);
+        for (size_t i = 0; i < m_BoneInfo.size(); ++i)
+            m_BoneInfo[i].FinalTransform = m_Pose[i];
+    }
+
+    void SkinnedModel::SamplePose(float timeInSeconds, i32 animationIndex, std::vector<Mat4>& palette) const
+    {
+        palette.assign(m_BoneInfo.size(), Mat4(1.0f));
         if (!m_Scene || !m_Scene->mAnimations) return;
 		if (animationIndex >= m_Scene->mNumAnimations) animationIndex = 0;
 
@@ -208,10 +269,31 @@ namespace Luth
         float timeInTicks = timeInSeconds * ticksPerSecond;
         float animationTime = fmod(timeInTicks, (float)animation->mDuration);
 
-        ReadNodeHierarchy(animation, animationTime, m_Scene->mRootNode, Mat4(1.0f));
+        ReadNodeHierarchy(animation, animationTime, m_Scene->mRootNode, Mat4(1.0f), palette);
+    }
+
+    u32 SkinnedModel::GetAnimationCount() const
+    {
+        return m_Scene ? m_Scene->mNumAnimations : 0;
+    }
+
+    std::string SkinnedModel::GetAnimationName(i32 animationIndex) const
+    {
+        if (animationIndex < 0 || (u32)animationIndex >= GetAnimationCount()) return {};
+        return m_Scene->mAnimations[animationIndex]->mName.C_Str();
+    }
+
+    f32 SkinnedModel::GetAnimationDuration(i32 animationIndex) const
+    {
+        if (animationIndex < 0 || (u32)animationIndex >= GetAnimationCount()) return 0.0f;
+
+        const aiAnimation* animation = m_Scene->mAnimations[animationIndex];
+        float ticksPerSecond = (float)(animation->mTicksPerSecond != 0.0 ? animation->mTicksPerSecond : 24.0);
+        return (float)animation->mDuration / ticksPerSecond;
     }
 
-    void SkinnedModel::ReadNodeHierarchy(const aiAnimation* animation, float animationTime, const aiNode* node, const Mat4& parentTransform)
+    void SkinnedModel::ReadNodeHierarchy(const aiAnimation* animation, float animationTime, const aiNode* node,
+                                         const Mat4& parentTransform, std::vector<Mat4>& palette) const
     {
         std::string nodeName(node->mName.C_Str());
 
@@ -233,20 +315,21 @@ namespace Luth
 
         Mat4 globalTransform = parentTransform * nodeTransform;
 
-        if (m_BoneMapping.find(nodeName) != m_BoneMapping.end()) {
-            uint32_t boneIndex = m_BoneMapping[nodeName];
-            m_BoneInfo[boneIndex].FinalTransform =
+        auto bone = m_BoneMapping.find(nodeName);
+        if (bone != m_BoneMapping.end()) {
+            uint32_t boneIndex = bone->second;
+            palette[boneIndex] =
 				m_GlobalInverseTransform *
                 globalTransform *
                 m_BoneInfo[boneIndex].OffsetMatrix;
 		}
 
         for (uint32_t i = 0; i < node->mNumChildren; ++i) {
-            ReadNodeHierarchy(animation, animationTime, node->mChildren[i], globalTransform);
+            ReadNodeHierarchy(animation, animationTime, node->mChildren[i], globalTransform, palette);
         }
     }
 
-    const aiNodeAnim* SkinnedModel::FindNodeAnim(const aiAnimation* animation, const std::string& nodeName)
+    const aiNodeAnim* SkinnedModel::FindNodeAnim(const aiAnimation* animation, const std::string& nodeName) const
     {
         for (uint32_t i = 0; i < animation->mNumChannels; ++i) {
             if (nodeName == animation->mChannels[i]->mNodeName.C_Str())
@@ -255,7 +338,7 @@ namespace Luth
         return nullptr;
     }
 
-    aiVector3D SkinnedModel::InterpolatePosition(float animationTime, const aiNodeAnim* nodeAnim)
+    aiVector3D SkinnedModel::InterpolatePosition(float animationTime, const aiNodeAnim* nodeAnim) const
     {
         if (nodeAnim->mNumPositionKeys == 1) {
             return nodeAnim->mPositionKeys[0].mValue;
@@ -272,7 +355,7 @@ namespace Luth
         return start + factor * (end - start);
     }
 
-    uint32_t SkinnedModel::FindPosition(float animationTime, const aiNodeAnim* nodeAnim)
+    uint32_t SkinnedModel::FindPosition(float animationTime, const aiNodeAnim* nodeAnim) const
     {
         for (uint32_t i = 0; i + 1 < nodeAnim->mNumPositionKeys; i++) {
             if (animationTime < nodeAnim->mPositionKeys[i + 1].mTime)
@@ -281,7 +364,7 @@ namespace Luth
         return nodeAnim->mNumPositionKeys > 1 ? nodeAnim->mNumPositionKeys - 2 : 0;
     }
 
-    aiQuaternion SkinnedModel::InterpolateRotation(float animationTime, const aiNodeAnim* nodeAnim)
+    aiQuaternion SkinnedModel::InterpolateRotation(float animationTime, const aiNodeAnim* nodeAnim) const
     {
         if (nodeAnim->mNumRotationKeys == 1) {
             return nodeAnim->mRotationKeys[0].mValue;
@@ -301,7 +384,7 @@ namespace Luth
         return result.Normalize();
     }
 
-    uint32_t SkinnedModel::FindRotation(float animationTime, const aiNodeAnim* nodeAnim)
+    uint32_t SkinnedModel::FindRotation(float animationTime, const aiNodeAnim* nodeAnim) const
     {
         for (uint32_t i = 0; i + 1 < nodeAnim->mNumRotationKeys; i++) {
             if (animationTime < nodeAnim->mRotationKeys[i + 1].mTime)
@@ -310,7 +393,7 @@ namespace Luth
         return nodeAnim->mNumRotationKeys > 1 ? nodeAnim->mNumRotationKeys - 2 : 0;
     }
 
-    aiVector3D SkinnedModel::InterpolateScaling(float animationTime, const aiNodeAnim* nodeAnim)
+    aiVector3D SkinnedModel::InterpolateScaling(float animationTime, const aiNodeAnim* nodeAnim) const
     {
         if (nodeAnim->mNumScalingKeys == 1) {
             return nodeAnim->mScalingKeys[0].mValue;
@@ -327,7 +410,7 @@ namespace Luth
         return start + factor * (end - start);
     }
 
-    uint32_t SkinnedModel::FindScaling(float animationTime, const aiNodeAnim* nodeAnim)
+    uint32_t SkinnedModel::FindScaling(float animationTime, const aiNodeAnim* nodeAnim) const
     {
         for (uint32_t i = 0; i + 1 < nodeAnim->mNumScalingKeys; i++) {
             if (animationTime < nodeAnim->mScalingKeys[i + 1].mTime)
@@ -5,11 +5,25 @@
 
 #include <assimp/Importer.hpp>
 
+#include <array>
+
+// Palette size of BonesUBO in the shaders
+#define MAX_BONES 512
+
 namespace Luth
 {
-    struct SkinnedVertex : public Vertex {
-        glm::ivec4 BoneIDs = glm::ivec4(-1);
-        glm::vec4 BoneWeights = glm::vec4(0.0f);
+    // Up to 4 influences per vertex, kept alongside MeshData::Vertices.
+    // Weights are unorm16 summing to exactly 65535; 8-bit meshes store q8 * 257
+    // so the CPU sees the same values the GPU decodes.
+    struct VertexBoneData {
+        std::array<u16, 4> BoneIDs = { 0, 0, 0, 0 };
+        std::array<u16, 4> Weights = { 0, 0, 0, 0 };
+    };
+
+    // GPU encoding of the bone attributes, chosen per mesh by the highest bone ID it references
+    enum class SkinFormat : u8 {
+        Compact8,   // u8 IDs,  unorm8 weights  ( 8 bytes)
+        Wide16      // u16 IDs, unorm16 weights (16 bytes)
     };
 
     struct BoneInfo {
@@ -35,6 +49,13 @@ namespace Luth
         void ProcessMeshData() override;
 
         void UpdateAnimation(float timeInSeconds, i32 animationIndex);
+        // Samples the clip into 'palette' (one final transform per bone) without touching
+        // the model's own pose, safe to call from worker threads
+        void SamplePose(float timeInSeconds, i32 animationIndex, std::vector<Mat4>& palette) const;
+
+        u32 GetAnimationCount() const;
+        std::string GetAnimationName(i32 animationIndex) const;
+        f32 GetAnimationDuration(i32 animationIndex) const;  // Seconds
 
         const std::vector<BoneInfo>& GetBoneTransforms() const { return m_BoneInfo; }
         std::vector<Mat4> GetFinalTransforms() const {
@@ -48,38 +69,34 @@ namespace Luth
 
 		const glm::mat4& GetGlobalInverseTransform() const { return m_GlobalInverseTransform; }
 
+        const std::vector<VertexBoneData>& GetBoneData(u32 meshIndex) const { return m_BoneData[meshIndex]; }
+        SkinFormat GetSkinFormat(u32 meshIndex) const { return m_SkinFormats[meshIndex]; }
+        u32 GetSkinnedMeshCount() const { return static_cast<u32>(m_BoneData.size()); }
+
         const std::vector<BoneNode>& GetBoneHierarchy() const { return m_BoneHierarchy; }
         uint32_t GetRootNodeIndex() const { return m_RootNodeIndex; }
 
     private:
-        void ExtractBoneWeights(aiMesh* mesh, std::vector<SkinnedVertex>& vertices);
+        SkinFormat ExtractBoneWeights(aiMesh* mesh, std::vector<VertexBoneData>& boneData);
         void BuildBoneHierarchy(const aiNode* node, int parentIndex);
 
-        inline void SetVertexBoneData(SkinnedVertex& vert, int boneID, float weight)
-        {
-            for (int i = 0; i < 4; i++) {
-                if (vert.BoneIDs[i] < 0) {
-                    vert.BoneIDs[i] = (float)boneID;
-                    vert.BoneWeights[i] = weight;
-                    break;
-                }
-            }
-        }
+        const aiNodeAnim* FindNodeAnim(const aiAnimation* animation, const std::string& nodeName) const;
 
-        const aiNodeAnim* FindNodeAnim(const aiAnimation* animation, const std::string& nodeName);
+        aiVector3D InterpolatePosition(float animationTime, const aiNodeAnim* nodeAnim) const;
+        uint32_t FindPosition(float animationTime, const aiNodeAnim* nodeAnim) const;
 
-        aiVector3D InterpolatePosition(float animationTime, const aiNodeAnim* nodeAnim);
-        uint32_t FindPosition(float animationTime, const aiNodeAnim* nodeAnim);
+        aiQuaternion InterpolateRotation(float animationTime, const aiNodeAnim* nodeAnim) const;
+        uint32_t FindRotation(float animationTime, const aiNodeAnim* nodeAnim) const;
 
-        aiQuaternion InterpolateRotation(float animationTime, const aiNodeAnim* nodeAnim);
-        uint32_t FindRotation(float animationTime, const aiNodeAnim* nodeAnim);
+        aiVector3D InterpolateScaling(float animationTime, const aiNodeAnim* nodeAnim) const;
+        uint32_t FindScaling(float animationTime, const aiNodeAnim* nodeAnim) const;
 
-        aiVector3D InterpolateScaling(float animationTime, const aiNodeAnim* nodeAnim);
-        uint32_t FindScaling(float animationTime, const aiNodeAnim* nodeAnim);
-
-        void ReadNodeHierarchy(const aiAnimation* animation, float animationTime, const aiNode* node, const glm::mat4& parentTransform);
+        void ReadNodeHierarchy(const aiAnimation* animation, float animationTime, const aiNode* node,
+                               const glm::mat4& parentTransform, std::vector<Mat4>& palette) const;
 
     protected:
+        void OnVerticesRemapped(u32 meshIndex, const std::vector<u32>& remap, u32 vertexCount) override;
+
         virtual ModelInfo GetModelInfo() const override;
 
     private:
@@ -87,9 +104,11 @@ namespace Luth
         const aiScene* m_Scene = nullptr;
 
         glm::mat4 m_GlobalInverseTransform;
-        std::vector<std::vector<SkinnedVertex>> m_SkinnedVertices;
+        std::vector<std::vector<VertexBoneData>> m_BoneData;
+        std::vector<SkinFormat> m_SkinFormats;
         std::unordered_map<std::string, uint32_t> m_BoneMapping;
         std::vector<BoneInfo> m_BoneInfo;
+        std::vector<Mat4> m_Pose;   // UpdateAnimation scratch
         uint32_t m_BoneCount = 0;
 
         std::vector<BoneNode> m_BoneHierarchy;
@@ -0,0 +1,235 @@
+#include "luthpch.h"
+#include "luth/renderer/VertexAnimation.h"
+#include "luth/renderer/CpuSkinning.h"
+#include "luth/renderer/SkinnedModel.h"
+#include "luth/renderer/VertexPacking.h"
+#include "luth/renderer/openGL/GLState.h"
+
+#include <glad/glad.h>
+#include <glm/gtx/component_wise.hpp>
+
+namespace Luth
+{
+    namespace
+    {
+        constexpr u32 k_VATMagic   = 0x5441564C; // "LVAT"
+        constexpr u32 k_VATVersion = 2;     // 2: vertices in optimized import order
+
+        BakedVertex PackBakedVertex(const Vec3& position, const Vec3& normal, const Vec3& tangent)
+        {
+            BakedVertex out;
+            out.PositionXY = VertexPacking::PackHalf2({ position.x, position.y });
+            out.PositionZ  = VertexPacking::PackHalf2({ position.z, 0.0f });
+            out.Normal     = VertexPacking::PackOctSnorm16(normal);
+            out.Tangent    = VertexPacking::PackOctSnorm16(tangent);
+            return out;
+        }
+
+        template<typename T>
+        void WritePOD(std::ofstream& out, const T& value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        bool ReadPOD(std::ifstream& in, T& value) {
+            return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+    }
+
+    // ============================================================================
+    //                          VERTEX ANIMATION TEXTURE
+    // ============================================================================
+
+    VertexAnimationTexture::~VertexAnimationTexture()
+    {
+        for (u32 buffer : m_Buffers) {
+            if (buffer) GLState::DeleteBuffers(1, &buffer);
+        }
+    }
+
+    bool VertexAnimationTexture::Save(const fs::path& path) const
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            LH_CORE_ERROR("Failed to write vertex animation: {0}", path.string());
+            return false;
+        }
+
+        WritePOD(out, k_VATMagic);
+        WritePOD(out, k_VATVersion);
+        WritePOD(out, m_FrameRate);
+        WritePOD(out, m_FrameCount);
+        WritePOD(out, static_cast<u32>(m_ClipName.size()));
+        out.write(m_ClipName.data(), m_ClipName.size());
+        WritePOD(out, static_cast<u32>(m_Tracks.size()));
+
+        for (const auto& track : m_Tracks) {
+            WritePOD(out, track.VertexCount);
+            out.write(reinterpret_cast<const char*>(track.Frames.data()), track.Frames.size() * sizeof(BakedVertex));
+        }
+        return static_cast<bool>(out);
+    }
+
+    std::shared_ptr<VertexAnimationTexture> VertexAnimationTexture::Load(const fs::path& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return nullptr;
+
+        u32 magic = 0, version = 0, nameLength = 0, trackCount = 0;
+        auto vat = std::make_shared<VertexAnimationTexture>();
+
+        if (!ReadPOD(in, magic) || magic != k_VATMagic ||
+            !ReadPOD(in, version) || version != k_VATVersion) {
+            LH_CORE_WARN("Outdated or invalid vertex animation: {0}", path.string());
+            return nullptr;
+        }
+
+        if (!ReadPOD(in, vat->m_FrameRate) || !ReadPOD(in, vat->m_FrameCount) || !ReadPOD(in, nameLength)) {
+            LH_CORE_ERROR("Truncated vertex animation: {0}", path.string());
+            return nullptr;
+        }
+
+        vat->m_ClipName.resize(nameLength);
+        in.read(vat->m_ClipName.data(), nameLength);
+
+        if (!ReadPOD(in, trackCount)) {
+            LH_CORE_ERROR("Truncated vertex animation: {0}", path.string());
+            return nullptr;
+        }
+
+        vat->m_Tracks.resize(trackCount);
+        vat->m_Buffers.assign(trackCount, 0);
+        for (auto& track : vat->m_Tracks) {
+            if (!ReadPOD(in, track.VertexCount)) {
+                LH_CORE_ERROR("Truncated vertex animation: {0}", path.string());
+                return nullptr;
+            }
+            track.Frames.resize(static_cast<size_t>(track.VertexCount) * vat->m_FrameCount);
+            if (!in.read(reinterpret_cast<char*>(track.Frames.data()), track.Frames.size() * sizeof(BakedVertex))) {
+                LH_CORE_ERROR("Truncated vertex animation: {0}", path.string());
+                return nullptr;
+            }
+        }
+
+        return vat;
+    }
+
+    void VertexAnimationTexture::Bind(u32 meshIndex, u32 binding)
+    {
+        if (meshIndex >= m_Tracks.size()) return;
+
+        u32& buffer = m_Buffers[meshIndex];
+        if (!buffer) {
+            const auto& frames = m_Tracks[meshIndex].Frames;
+            glCreateBuffers(1, &buffer);
+            glNamedBufferStorage(buffer, frames.size() * sizeof(BakedVertex), frames.data(), 0);
+        }
+        GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
+    }
+
+    size_t VertexAnimationTexture::GetSizeInBytes() const
+    {
+        size_t size = 0;
+        for (const auto& track : m_Tracks)
+            size += track.Frames.size() * sizeof(BakedVertex);
+        return size;
+    }
+
+    // ============================================================================
+    //                                   BAKER
+    // ============================================================================
+
+    std::shared_ptr<VertexAnimationTexture> VertexAnimationBaker::Bake(const SkinnedModel& model, i32 animationIndex, f32 frameRate)
+    {
+        if (animationIndex < 0 || (u32)animationIndex >= model.GetAnimationCount() || frameRate <= 0.0f) {
+            LH_CORE_ERROR("Cannot bake animation {0} of {1}", animationIndex, model.GetName());
+            return nullptr;
+        }
+
+        auto vat = std::make_shared<VertexAnimationTexture>();
+        vat->m_ClipName = model.GetAnimationName(animationIndex);
+        vat->m_FrameRate = frameRate;
+        vat->m_FrameCount = std::max(1u, (u32)std::ceil(model.GetAnimationDuration(animationIndex) * frameRate));
+
+        const u32 meshCount = model.GetSkinnedMeshCount();
+        vat->m_Tracks.resize(meshCount);
+        vat->m_Buffers.assign(meshCount, 0);
+        for (u32 m = 0; m < meshCount; ++m) {
+            auto& track = vat->m_Tracks[m];
+            track.VertexCount = static_cast<u32>(model.GetMeshesData()[m].Vertices.size());
+            track.Frames.resize(static_cast<size_t>(track.VertexCount) * vat->m_FrameCount);
+        }
+
+        std::vector<Mat4> palette;
+        for (u32 frame = 0; frame < vat->m_FrameCount; ++frame) {
+            model.SamplePose(frame / frameRate, animationIndex, palette);
+
+            for (u32 m = 0; m < meshCount; ++m) {
+                auto& track = vat->m_Tracks[m];
+                BakeFrame(model.GetMeshesData()[m].Vertices, model.GetBoneData(m), palette,
+                          track.Frames.data() + static_cast<size_t>(frame) * track.VertexCount);
+            }
+        }
+
+        LH_CORE_INFO("Baked '{0}' ({1} frames @ {2} fps, {3} KB)", vat->m_ClipName, vat->m_FrameCount,
+            frameRate, vat->GetSizeInBytes() / 1024);
+        return vat;
+    }
+
+    f32 VertexAnimationBaker::Validate(const SkinnedModel& model, i32 animationIndex, const VertexAnimationTexture& vat)
+    {
+        if (vat.GetMeshCount() != model.GetSkinnedMeshCount()) return FLOAT_MAX;
+
+        f32 maxError = 0.0f, maxExtent = 0.0f;
+        std::vector<Vec3> positions, normals, tangents;
+        std::vector<Mat4> palette;
+
+        for (u32 frame = 0; frame < vat.GetFrameCount(); ++frame) {
+            model.SamplePose(frame / vat.GetFrameRate(), animationIndex, palette);
+
+            for (u32 m = 0; m < vat.GetMeshCount(); ++m) {
+                const auto& vertices = model.GetMeshesData()[m].Vertices;
+                const auto& track = vat.GetTrack(m);
+                if (track.VertexCount != vertices.size()) return FLOAT_MAX;
+
+                positions.resize(vertices.size());
+                normals.resize(vertices.size());
+                tangents.resize(vertices.size());
+
+                Vec3 bmin(FLOAT_MAX), bmax(-FLOAT_MAX);
+                CpuSkinning::SkinScalar(vertices.data(), model.GetBoneData(m).data(), 0, vertices.size(),
+                    palette.data(), static_cast<u32>(palette.size()),
+                    positions.data(), normals.data(), tangents.data(), bmin, bmax);
+
+                const BakedVertex* baked = track.Frames.data() + static_cast<size_t>(frame) * track.VertexCount;
+                for (u32 v = 0; v < track.VertexCount; ++v)
+                    maxError = std::max(maxError, glm::length(DecodePosition(baked[v]) - positions[v]));
+
+                maxExtent = std::max({ maxExtent, glm::compMax(glm::abs(bmin)), glm::compMax(glm::abs(bmax)) });
+            }
+        }
+        return maxExtent > 0.0f ? maxError / maxExtent : maxError;
+    }
+
+    void VertexAnimationBaker::BakeFrame(const std::vector<Vertex>& vertices, const std::vector<VertexBoneData>& bones,
+                                         const std::vector<Mat4>& palette, BakedVertex* out)
+    {
+        // Bakes already run as jobs, skin inline rather than fanning out to the pool
+        const size_t count = vertices.size();
+        std::vector<Vec3> positions(count), normals(count), tangents(count);
+        Vec3 bmin(FLOAT_MAX), bmax(-FLOAT_MAX);
+
+        const auto skin = CpuSkinning::HasSIMD() ? &CpuSkinning::SkinSIMD : &CpuSkinning::SkinScalar;
+        skin(vertices.data(), bones.data(), 0, count, palette.data(), static_cast<u32>(palette.size()),
+             positions.data(), normals.data(), tangents.data(), bmin, bmax);
+
+        for (size_t v = 0; v < count; ++v)
+            out[v] = PackBakedVertex(positions[v], normals[v], tangents[v]);
+    }
+
+    Vec3 VertexAnimationBaker::DecodePosition(const BakedVertex& v)
+    {
+        const Vec2 xy = VertexPacking::UnpackHalf2(v.PositionXY);
+        return { xy.x, xy.y, VertexPacking::UnpackHalf2(v.PositionZ).x };
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Luth
+{
+    class SkinnedModel;
+    struct Vertex;
+    struct VertexBoneData;
+
+    // One baked sample, 16 bytes: half3 position + octahedral snorm16 normal/tangent.
+    // Matches 'BakedFrames' in LuthDeferredGeo.glsl
+    struct BakedVertex {
+        u32 PositionXY = 0;     // packHalf2x16(x, y)
+        u32 PositionZ  = 0;     // packHalf2x16(z, 0)
+        u32 Normal     = 0;     // packSnorm2x16(oct(n))
+        u32 Tangent    = 0;     // packSnorm2x16(oct(t))
+    };
+
+    // Skinned vertices of one clip sampled at a fixed rate, one track per submesh.
+    // Frames are stored frame-major: Frames[frame * VertexCount + vertex].
+    class VertexAnimationTexture
+    {
+    public:
+        struct MeshTrack {
+            u32 VertexCount = 0;
+            std::vector<BakedVertex> Frames;
+        };
+
+        VertexAnimationTexture() = default;
+        ~VertexAnimationTexture();
+
+        VertexAnimationTexture(const VertexAnimationTexture&) = delete;
+        VertexAnimationTexture& operator=(const VertexAnimationTexture&) = delete;
+
+        bool Save(const fs::path& path) const;
+        static std::shared_ptr<VertexAnimationTexture> Load(const fs::path& path);
+
+        // Uploads on first use, then binds the mesh track as a shader storage buffer
+        void Bind(u32 meshIndex, u32 binding);
+
+        const std::string& GetClipName() const { return m_ClipName; }
+        f32 GetFrameRate() const { return m_FrameRate; }
+        u32 GetFrameCount() const { return m_FrameCount; }
+        f32 GetDuration() const { return m_FrameRate > 0.0f ? m_FrameCount / m_FrameRate : 0.0f; }
+        u32 GetMeshCount() const { return static_cast<u32>(m_Tracks.size()); }
+        const MeshTrack& GetTrack(u32 meshIndex) const { return m_Tracks[meshIndex]; }
+        size_t GetSizeInBytes() const;
+
+    private:
+        friend class VertexAnimationBaker;
+
+        std::string m_ClipName;
+        f32 m_FrameRate = 30.0f;
+        u32 m_FrameCount = 0;
+        std::vector<MeshTrack> m_Tracks;
+        std::vector<u32> m_Buffers;     // GL SSBO per track, 0 until uploaded
+    };
+
+    // Bakes run on worker threads: poses are sampled into local palettes, the model's
+    // live skeleton is never touched, and skinning stays on the calling thread.
+    class VertexAnimationBaker
+    {
+    public:
+        // Max Validate() error accepted for a bake, half floats give ~5e-4
+        static constexpr f32 k_Tolerance = 2e-3f;
+
+        // Samples the clip with the CPU skinner
+        static std::shared_ptr<VertexAnimationTexture> Bake(const SkinnedModel& model, i32 animationIndex, f32 frameRate = 30.0f);
+
+        // Largest position error of the decoded bake against the scalar reference skinner,
+        // re-evaluated at every baked frame, relative to the largest reference coordinate
+        static f32 Validate(const SkinnedModel& model, i32 animationIndex, const VertexAnimationTexture& vat);
+
+        // One mesh posed by 'palette', packed into 'out' (vertices.size() entries)
+        static void BakeFrame(const std::vector<Vertex>& vertices, const std::vector<VertexBoneData>& bones,
+                              const std::vector<Mat4>& palette, BakedVertex* out);
+        static Vec3 DecodePosition(const BakedVertex& v);
+    };
+}
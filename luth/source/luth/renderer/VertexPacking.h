@@ -0,0 +1,37 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <glm/gtc/packing.hpp>
+
+namespace Luth::VertexPacking
+{
+    // Octahedral mapping of a unit vector onto [-1, 1]^2
+    inline Vec2 OctEncode(Vec3 n)
+    {
+        n /= (std::abs(n.x) + std::abs(n.y) + std::abs(n.z)) + 1e-20f;
+        Vec2 e(n.x, n.y);
+        if (n.z < 0.0f) {
+            e = (1.0f - glm::abs(Vec2(e.y, e.x))) *
+                Vec2(e.x >= 0.0f ? 1.0f : -1.0f, e.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return e;
+    }
+
+    inline Vec3 OctDecode(Vec2 e)
+    {
+        Vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        const f32 t = glm::clamp(-n.z, 0.0f, 1.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    // Matches GLSL packSnorm2x16 / unpackSnorm2x16
+    inline u32 PackOctSnorm16(const Vec3& n) { return glm::packSnorm2x16(OctEncode(n)); }
+    inline Vec3 UnpackOctSnorm16(u32 p)      { return OctDecode(glm::unpackSnorm2x16(p)); }
+
+    // Matches GLSL packHalf2x16 / unpackHalf2x16
+    inline u32 PackHalf2(const Vec2& v) { return glm::packHalf2x16(v); }
+    inline Vec2 UnpackHalf2(u32 p)      { return glm::unpackHalf2x16(p); }
+}
@@ -0,0 +1,97 @@
+#include "luthpch.h"
+#include "luth/renderer/VertexQuantization.h"
+#include "luth/renderer/Model.h"
+#include "luth/renderer/VertexPacking.h"
+
+namespace Luth::VertexQuantization
+{
+    namespace
+    {
+        u16 QuantizeUnorm16(f32 value)
+        {
+            return static_cast<u16>(std::round(glm::clamp(value, 0.0f, 1.0f) * 65535.0f));
+        }
+
+        template<typename T>
+        void Write(u8*& dst, const T& value)
+        {
+            std::memcpy(dst, &value, sizeof(T));
+            dst += sizeof(T);
+        }
+    }
+
+    QuantizedVertexStream Quantize(const MeshData& mesh)
+    {
+        QuantizedVertexStream stream;
+
+        if (mesh.HasTexCoord1) {
+            stream.Layout = {
+                { ShaderDataType::UShort4, "a_Position",  true    },
+                { ShaderDataType::Short2,  "a_Normal",    true    },
+                { ShaderDataType::Half2,   "a_TexCoord0"          },
+                { ShaderDataType::Half2,   "a_TexCoord1"          },
+                { ShaderDataType::Short2,  "a_Tangent",   true    } };
+        }
+        else {
+            // UV1 stays unbound and reads as the default attribute value
+            stream.Layout = {
+                { ShaderDataType::UShort4, "a_Position",  true    },
+                { ShaderDataType::Short2,  "a_Normal",    true    },
+                { ShaderDataType::Half2,   "a_TexCoord0"          },
+                { ShaderDataType::Short2,  "a_Tangent",   true, 4 } };
+        }
+
+        // Position range
+        Vec3 boundsMin(FLOAT_MAX), boundsMax(-FLOAT_MAX);
+        for (const auto& vertex : mesh.Vertices) {
+            boundsMin = glm::min(boundsMin, vertex.Position);
+            boundsMax = glm::max(boundsMax, vertex.Position);
+        }
+        if (mesh.Vertices.empty()) boundsMin = boundsMax = Vec3(0.0f);
+
+        const Vec3 extent = glm::max(boundsMax - boundsMin, Vec3(1e-6f));
+        stream.Decode.Quantized = true;
+        stream.Decode.PositionOffset = boundsMin;
+        stream.Decode.PositionScale = extent;
+
+        // Pack
+        const u32 stride = stream.Layout.GetStride();
+        stream.Data.resize(static_cast<size_t>(stride) * mesh.Vertices.size());
+
+        u8* dst = stream.Data.data();
+        for (size_t i = 0; i < mesh.Vertices.size(); ++i) {
+            const Vertex& vertex = mesh.Vertices[i];
+            const Vec3 position = (vertex.Position - boundsMin) / extent;
+            const bool flipped = i < mesh.TangentSigns.size() && mesh.TangentSigns[i] < 0;
+
+            Write(dst, QuantizeUnorm16(position.x));
+            Write(dst, QuantizeUnorm16(position.y));
+            Write(dst, QuantizeUnorm16(position.z));
+            Write(dst, static_cast<u16>(flipped ? 0 : 65535));
+            Write(dst, VertexPacking::PackOctSnorm16(vertex.Normal));
+            Write(dst, VertexPacking::PackHalf2(vertex.TexCoord0));
+            if (mesh.HasTexCoord1)
+                Write(dst, VertexPacking::PackHalf2(vertex.TexCoord1));
+            Write(dst, VertexPacking::PackOctSnorm16(vertex.Tangent));
+        }
+
+        return stream;
+    }
+
+    f32 MaxPositionError(const MeshData& mesh, const QuantizedVertexStream& stream)
+    {
+        const u32 stride = stream.Layout.GetStride();
+        if (stream.Data.size() != static_cast<size_t>(stride) * mesh.Vertices.size()) return FLOAT_MAX;
+
+        f32 maxError = 0.0f;
+        for (size_t i = 0; i < mesh.Vertices.size(); ++i) {
+            u16 packed[3];
+            std::memcpy(packed, stream.Data.data() + i * stride, sizeof(packed));
+
+            const Vec3 decoded = stream.Decode.PositionOffset +
+                Vec3(packed[0], packed[1], packed[2]) / 65535.0f * stream.Decode.PositionScale;
+            maxError = std::max(maxError, glm::length(decoded - mesh.Vertices[i].Position));
+        }
+        return maxError;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "luth/renderer/Buffer.h"
+#include "luth/renderer/Mesh.h"
+
+#include <vector>
+
+namespace Luth
+{
+    struct MeshData;
+
+    // Packed static vertex stream, 20 bytes per vertex (24 with a second UV set):
+    //   a_Position  u16x4 unorm   xyz in mesh bounds, w = bitangent sign (0: -1, 1: +1)
+    //   a_Normal    i16x2 snorm   octahedral
+    //   a_TexCoord0 f16x2
+    //   a_TexCoord1 f16x2         only when the mesh has one
+    //   a_Tangent   i16x2 snorm   octahedral
+    // Decoded in LuthDeferredGeo.glsl / LuthForwardLight.glsl when u_VertexQuantized is set
+    struct QuantizedVertexStream {
+        std::vector<u8> Data;
+        BufferLayout Layout;
+        VertexDecode Decode;
+    };
+
+    namespace VertexQuantization
+    {
+        QuantizedVertexStream Quantize(const MeshData& mesh);
+
+        // Largest position error of the packed stream, in model units
+        f32 MaxPositionError(const MeshData& mesh, const QuantizedVertexStream& stream);
+    }
+}
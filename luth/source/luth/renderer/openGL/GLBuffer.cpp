@@ -1,10 +1,40 @@
 #include "luthpch.h"
 #include "luth/renderer/openGL/GLBuffer.h"
+#include "luth/renderer/openGL/GLState.h"
 
 #include <glad/glad.h>
 
 namespace Luth
 {
+    uint32_t ShaderDataTypeToGLType(ShaderDataType type)
+    {
+        switch (type) {
+            case ShaderDataType::Float:    return GL_FLOAT;
+            case ShaderDataType::Float2:   return GL_FLOAT;
+            case ShaderDataType::Float3:   return GL_FLOAT;
+            case ShaderDataType::Float4:   return GL_FLOAT;
+            case ShaderDataType::Int:      return GL_INT;
+            case ShaderDataType::Int2:     return GL_INT;
+            case ShaderDataType::Int3:     return GL_INT;
+            case ShaderDataType::Int4:     return GL_INT;
+            case ShaderDataType::Mat3:     return GL_FLOAT;
+            case ShaderDataType::Mat4:     return GL_FLOAT;
+            case ShaderDataType::Bool:     return GL_BOOL;
+            case ShaderDataType::UByte4:   return GL_UNSIGNED_BYTE;
+            case ShaderDataType::UShort4:  return GL_UNSIGNED_SHORT;
+            case ShaderDataType::Short2:   return GL_SHORT;
+            case ShaderDataType::Half2:    return GL_HALF_FLOAT;
+            default:
+                LH_CORE_ASSERT(false, "Unknown ShaderDataType!");
+                return 0;
+        }
+    }
+
+    uint32_t IndexTypeToGLType(IndexType type)
+    {
+        return type == IndexType::UInt16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
     // Vertex Buffer
     // ------------------------
     GLVertexBuffer::GLVertexBuffer(uint32_t size)
@@ -23,7 +53,7 @@ namespace Luth
 
     GLVertexBuffer::~GLVertexBuffer()
     {
-        glDeleteBuffers(1, &m_BufferID);
+        GLState::DeleteBuffers(1, &m_BufferID);
     }
 
     void GLVertexBuffer::Bind() const
@@ -43,15 +73,16 @@ namespace Luth
 
     // Index Buffer
     // ------------------------
-    GLIndexBuffer::GLIndexBuffer(const uint32_t* indices, uint32_t count)
-        : m_Count(count) {
-        glGenBuffers(1, &m_BufferID);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_BufferID);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+    GLIndexBuffer::GLIndexBuffer(const void* indices, uint32_t count, IndexType type)
+        : m_Count(count), m_Type(type) {
+        const size_t indexSize = type == IndexType::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        // Not through GL_ELEMENT_ARRAY_BUFFER: that is the bound VAO's state
+        glCreateBuffers(1, &m_BufferID);
+        glNamedBufferData(m_BufferID, count * indexSize, indices, GL_STATIC_DRAW);
     }
 
     GLIndexBuffer::~GLIndexBuffer() {
-        glDeleteBuffers(1, &m_BufferID);
+        GLState::DeleteBuffers(1, &m_BufferID);
     }
 
     void GLIndexBuffer::Bind() const {
@@ -4,6 +4,12 @@
 
 namespace Luth
 {
+    // GL component type of a layout element (GLenum)
+    uint32_t ShaderDataTypeToGLType(ShaderDataType type);
+
+    // GL index type for glDrawElements* (GLenum)
+    uint32_t IndexTypeToGLType(IndexType type);
+
     class GLVertexBuffer : public VertexBuffer
     {
     public:
@@ -26,15 +32,17 @@ namespace Luth
     class GLIndexBuffer : public IndexBuffer
     {
     public:
-        GLIndexBuffer(const uint32_t* indices, uint32_t count);
+        GLIndexBuffer(const void* indices, uint32_t count, IndexType type);
         ~GLIndexBuffer();
 
         void Bind() const override;
         void Unbind() const override;
         uint32_t GetCount() const override { return m_Count; }
+        IndexType GetIndexType() const override { return m_Type; }
 
     private:
         uint32_t m_BufferID;
         uint32_t m_Count;
+        IndexType m_Type;
     };
 }
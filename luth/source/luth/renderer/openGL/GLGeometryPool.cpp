@@ -0,0 +1,194 @@
+#include "luthpch.h"
+#include "luth/renderer/openGL/GLGeometryPool.h"
+#include "luth/renderer/openGL/GLBuffer.h"
+#include "luth/renderer/openGL/GLState.h"
+
+#include <glad/glad.h>
+
+namespace Luth
+{
+    namespace
+    {
+        // Smallest buffer created on first use, later growth doubles
+        constexpr u32 k_MinVertexCount = 1u << 14;
+        constexpr u32 k_MinIndexCount  = 1u << 16;
+
+        // Replaces 'buffer' by one of 'newBytes', keeping the first 'usedBytes'
+        void ReallocateBuffer(u32& buffer, size_t usedBytes, size_t newBytes)
+        {
+            u32 grown = 0;
+            glCreateBuffers(1, &grown);
+            glNamedBufferData(grown, newBytes, nullptr, GL_STATIC_DRAW);
+            if (buffer) {
+                if (usedBytes > 0) glCopyNamedBufferSubData(buffer, grown, 0, 0, usedBytes);
+                GLState::DeleteBuffers(1, &buffer);
+            }
+            buffer = grown;
+        }
+
+        std::string LayoutKey(const BufferLayout& layout)
+        {
+            std::string key = std::to_string(layout.GetStride());
+            for (const auto& element : layout.GetElements()) {
+                key += "|" + std::to_string(element.Location) + ":" + std::to_string((int)element.Type) +
+                       (element.Normalized ? "n" : "") + "@" + std::to_string(element.Offset);
+            }
+            return key;
+        }
+
+        u32 ArenaIndexSize(u32 arena) { return arena == 0 ? sizeof(u16) : sizeof(u32); }
+    }
+
+    GeometryAllocation GLGeometryPool::Allocate(const void* vertices, u32 vertexCount, const BufferLayout& layout,
+                                                const u32* indices, u32 indexCount)
+    {
+        GeometryAllocation allocation;
+        if (vertexCount == 0 || indexCount == 0) return allocation;
+
+        const u32 poolIndex = FindOrCreatePool(layout);
+        VertexPool& pool = s_Pools[poolIndex];
+
+        u32 baseVertex = pool.Vertices.Allocate(vertexCount);
+        if (baseVertex == FreeListAllocator::k_Invalid) {
+            GrowVertices(pool, pool.Vertices.GetCapacity() + vertexCount);
+            baseVertex = pool.Vertices.Allocate(vertexCount);
+        }
+
+        const u32 indexSize = SelectIndexSize(vertexCount);
+        const u32 arenaIndex = ArenaIndex(indexSize);
+        IndexArena& arena = s_Arenas[arenaIndex];
+
+        u32 firstIndex = arena.Indices.Allocate(indexCount);
+        if (firstIndex == FreeListAllocator::k_Invalid) {
+            GrowIndices(arenaIndex, arena.Indices.GetCapacity() + indexCount);
+            firstIndex = arena.Indices.Allocate(indexCount);
+        }
+
+        glNamedBufferSubData(pool.VBO, (size_t)baseVertex * pool.Stride, (size_t)vertexCount * pool.Stride, vertices);
+        if (indexSize == sizeof(u16)) {
+            const std::vector<u16> narrowed(indices, indices + indexCount);
+            glNamedBufferSubData(arena.IBO, (size_t)firstIndex * sizeof(u16), (size_t)indexCount * sizeof(u16), narrowed.data());
+        }
+        else {
+            glNamedBufferSubData(arena.IBO, (size_t)firstIndex * sizeof(u32), (size_t)indexCount * sizeof(u32), indices);
+        }
+
+        allocation.Pool = poolIndex;
+        allocation.BaseVertex = baseVertex;
+        allocation.VertexCount = vertexCount;
+        allocation.FirstIndex = firstIndex;
+        allocation.IndexCount = indexCount;
+        allocation.IndexSize = indexSize;
+        return allocation;
+    }
+
+    void GLGeometryPool::Free(const GeometryAllocation& allocation)
+    {
+        if (!allocation.IsValid() || allocation.Pool >= s_Pools.size()) return;
+
+        s_Pools[allocation.Pool].Vertices.Free(allocation.BaseVertex);
+        s_Arenas[ArenaIndex(allocation.IndexSize)].Indices.Free(allocation.FirstIndex);
+    }
+
+    void GLGeometryPool::Bind(u32 pool, u32 indexSize)
+    {
+        if (pool < s_Pools.size()) GLState::BindVertexArray(s_Pools[pool].VAOs[ArenaIndex(indexSize)]);
+    }
+
+    std::vector<GLGeometryPool::PoolStats> GLGeometryPool::GetStats()
+    {
+        std::vector<PoolStats> stats;
+        for (const auto& pool : s_Pools) {
+            stats.push_back({ pool.Key, pool.Stride, pool.Vertices.GetUsed(),
+                              pool.Vertices.GetCapacity(), pool.Vertices.GetFreeBlockCount() });
+        }
+        return stats;
+    }
+
+    size_t GLGeometryPool::GetUsedIndexBytes()
+    {
+        size_t bytes = 0;
+        for (u32 a = 0; a < k_ArenaCount; ++a)
+            bytes += (size_t)s_Arenas[a].Indices.GetUsed() * ArenaIndexSize(a);
+        return bytes;
+    }
+
+    size_t GLGeometryPool::GetIndexCapacityBytes()
+    {
+        size_t bytes = 0;
+        for (u32 a = 0; a < k_ArenaCount; ++a)
+            bytes += (size_t)s_Arenas[a].Indices.GetCapacity() * ArenaIndexSize(a);
+        return bytes;
+    }
+
+    void GLGeometryPool::Shutdown()
+    {
+        for (auto& pool : s_Pools) {
+            GLState::DeleteVertexArrays(k_ArenaCount, pool.VAOs.data());
+            if (pool.VBO) GLState::DeleteBuffers(1, &pool.VBO);
+        }
+        s_Pools.clear();
+
+        for (auto& arena : s_Arenas) {
+            if (arena.IBO) GLState::DeleteBuffers(1, &arena.IBO);
+            arena = IndexArena();
+        }
+    }
+
+    u32 GLGeometryPool::FindOrCreatePool(const BufferLayout& layout)
+    {
+        const std::string key = LayoutKey(layout);
+        for (u32 i = 0; i < s_Pools.size(); ++i) {
+            if (s_Pools[i].Key == key) return i;
+        }
+
+        VertexPool pool;
+        pool.Key = key;
+        pool.Stride = layout.GetStride();
+        glCreateVertexArrays(k_ArenaCount, pool.VAOs.data());
+
+        for (u32 a = 0; a < k_ArenaCount; ++a) {
+            const u32 vao = pool.VAOs[a];
+            for (const auto& element : layout.GetElements()) {
+                const GLuint location = static_cast<GLuint>(element.Location);
+                glEnableVertexArrayAttrib(vao, location);
+                if (element.IsInteger()) {
+                    glVertexArrayAttribIFormat(vao, location, element.GetComponentCount(),
+                        ShaderDataTypeToGLType(element.Type), element.Offset);
+                }
+                else {
+                    glVertexArrayAttribFormat(vao, location, element.GetComponentCount(),
+                        ShaderDataTypeToGLType(element.Type), element.Normalized ? GL_TRUE : GL_FALSE, element.Offset);
+                }
+                glVertexArrayAttribBinding(vao, location, 0);
+            }
+            if (s_Arenas[a].IBO) glVertexArrayElementBuffer(vao, s_Arenas[a].IBO);
+        }
+
+        s_Pools.push_back(std::move(pool));
+
+        LH_CORE_INFO("Created geometry pool {0} (stride {1})", s_Pools.size() - 1, layout.GetStride());
+        return static_cast<u32>(s_Pools.size() - 1);
+    }
+
+    void GLGeometryPool::GrowVertices(VertexPool& pool, u32 minCapacity)
+    {
+        const u32 capacity = std::max({ minCapacity, pool.Vertices.GetCapacity() * 2, k_MinVertexCount });
+        ReallocateBuffer(pool.VBO, (size_t)pool.Vertices.GetCapacity() * pool.Stride, (size_t)capacity * pool.Stride);
+        pool.Vertices.Grow(capacity);
+        for (u32 vao : pool.VAOs)
+            glVertexArrayVertexBuffer(vao, 0, pool.VBO, 0, pool.Stride);
+    }
+
+    void GLGeometryPool::GrowIndices(u32 arenaIndex, u32 minCapacity)
+    {
+        IndexArena& arena = s_Arenas[arenaIndex];
+        const size_t indexSize = ArenaIndexSize(arenaIndex);
+        const u32 capacity = std::max({ minCapacity, arena.Indices.GetCapacity() * 2, k_MinIndexCount });
+        ReallocateBuffer(arena.IBO, (size_t)arena.Indices.GetCapacity() * indexSize, (size_t)capacity * indexSize);
+        arena.Indices.Grow(capacity);
+
+        for (const auto& pool : s_Pools)
+            glVertexArrayElementBuffer(pool.VAOs[arenaIndex], arena.IBO);
+    }
+}
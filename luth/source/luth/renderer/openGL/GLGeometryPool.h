@@ -0,0 +1,67 @@
+#pragma once
+
+#include "luth/renderer/Buffer.h"
+#include "luth/renderer/GeometryAllocator.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace Luth
+{
+    // Shared GPU geometry: one vertex buffer per vertex format and two index buffers (16 and
+    // 32-bit), sub-allocated per mesh. Meshes below 65536 vertices take the 16-bit one.
+    // Every format has a VAO per index buffer, so meshes sharing both draw without switching
+    // buffers, which lets whole batches go through glMultiDrawElementsIndirect.
+    // Buffers start empty and grow on demand (copy into a buffer twice as large).
+    class GLGeometryPool
+    {
+    public:
+        struct PoolStats {
+            std::string Format;
+            u32 Stride = 0;
+            u32 UsedVertices = 0;
+            u32 CapacityVertices = 0;
+            u32 FreeBlocks = 0;
+        };
+
+        static GeometryAllocation Allocate(const void* vertices, u32 vertexCount, const BufferLayout& layout,
+                                           const u32* indices, u32 indexCount);
+        static void Free(const GeometryAllocation& allocation);
+
+        // Binds the VAO of a vertex format slot whose element buffer is the 'indexSize' arena
+        static void Bind(u32 pool, u32 indexSize);
+
+        static std::vector<PoolStats> GetStats();
+        // In bytes, over both index arenas
+        static size_t GetUsedIndexBytes();
+        static size_t GetIndexCapacityBytes();
+
+        static void Shutdown();
+
+    private:
+        // 0: 16-bit, 1: 32-bit
+        static constexpr u32 k_ArenaCount = 2;
+
+        struct IndexArena {
+            u32 IBO = 0;
+            FreeListAllocator Indices;
+        };
+
+        struct VertexPool {
+            std::string Key;
+            u32 Stride = 0;
+            u32 VBO = 0;
+            std::array<u32, k_ArenaCount> VAOs = {};
+            FreeListAllocator Vertices;
+        };
+
+        static u32 ArenaIndex(u32 indexSize) { return indexSize == 2 ? 0 : 1; }
+        static u32 FindOrCreatePool(const BufferLayout& layout);
+        static void GrowVertices(VertexPool& pool, u32 minCapacity);
+        static void GrowIndices(u32 arena, u32 minCapacity);
+
+        static inline std::vector<VertexPool> s_Pools;
+        static inline std::array<IndexArena, k_ArenaCount> s_Arenas;
+    };
+}
@@ -0,0 +1,114 @@
+#include "luthpch.h"
+#include "luth/renderer/openGL/GLMaterialBuffer.h"
+#include "luth/renderer/openGL/GLState.h"
+#include "luth/renderer/Material.h"
+
+#include <glad/glad.h>
+
+namespace Luth
+{
+    namespace
+    {
+        constexpr u32 k_InitialSlots = 64;
+    }
+
+    void GLMaterialBuffer::Bind(const Material& material)
+    {
+        auto it = s_Slots.find(&material);
+        if (it == s_Slots.end()) {
+            u32 index = 0;
+            if (!s_FreeSlots.empty()) {
+                index = s_FreeSlots.back();
+                s_FreeSlots.pop_back();
+            }
+            else {
+                index = s_NextSlot++;
+                if (index >= s_Capacity) Grow(index + 1);
+            }
+            it = s_Slots.emplace(&material, Slot{ index, 0 }).first;
+        }
+
+        Slot& slot = it->second;
+        const GLintptr offset = static_cast<GLintptr>(slot.Index) * s_SlotStride;
+        if (slot.Revision != material.GetRevision()) {
+            const MaterialParamsGPU params = Pack(material);
+            glNamedBufferSubData(s_UBO, offset, sizeof(MaterialParamsGPU), &params);
+            slot.Revision = material.GetRevision();
+            ++s_UploadCount;
+        }
+
+        GLState::BindBufferRange(GL_UNIFORM_BUFFER, k_Binding, s_UBO, offset, sizeof(MaterialParamsGPU));
+    }
+
+    void GLMaterialBuffer::Release(const Material& material)
+    {
+        // Nothing was bound yet, or the buffer is gone (materials outliving the renderer)
+        if (!s_UBO) return;
+
+        auto it = s_Slots.find(&material);
+        if (it == s_Slots.end()) return;
+
+        s_FreeSlots.push_back(it->second.Index);
+        s_Slots.erase(it);
+    }
+
+    void GLMaterialBuffer::Shutdown()
+    {
+        if (s_UBO) GLState::DeleteBuffers(1, &s_UBO);
+        s_UBO = 0;
+        s_Capacity = 0;
+        s_NextSlot = 0;
+        s_Slots.clear();
+        s_FreeSlots.clear();
+    }
+
+    MaterialParamsGPU GLMaterialBuffer::Pack(const Material& material)
+    {
+        MaterialParamsGPU params;
+        params.Color = material.GetColor();
+        params.Emissive = material.GetEmissive();
+        params.Alpha = material.GetAlpha();
+        params.Metalness = material.GetMetal();
+        params.Roughness = material.GetRough();
+        params.AlphaCutoff = material.GetAlphaCutoff();
+        params.RenderMode = static_cast<i32>(material.GetRenderMode());
+        params.AlphaFromDiffuse = material.IsAlphaFromDiffuseEnabled() ? 1 : 0;
+        params.IsGloss = material.IsGloss() ? 1 : 0;
+        params.IsSingleChannel = material.IsSingleChannel() ? 1 : 0;
+
+        const Subsurface subsurface = material.GetSubsurface();
+        params.SubsurfaceColor = subsurface.color;
+        params.SubsurfaceStrength = subsurface.strength;
+        params.SubsurfaceThickness = subsurface.thicknessScale;
+
+        for (const auto& map : material.GetTextures()) {
+            const u32 index = static_cast<u32>(map.type);
+            if (index >= std::size(params.Maps)) continue;
+            params.Maps[index].UseTexture = map.useTexture ? 1 : 0;
+            params.Maps[index].UvIndex = static_cast<i32>(map.uvIndex);
+        }
+        return params;
+    }
+
+    void GLMaterialBuffer::Grow(u32 minSlots)
+    {
+        if (s_SlotStride == 0) {
+            GLint alignment = 256;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            const u32 align = static_cast<u32>(std::max(alignment, 1));
+            s_SlotStride = (static_cast<u32>(sizeof(MaterialParamsGPU)) + align - 1) / align * align;
+        }
+
+        const u32 capacity = std::max({ minSlots, s_Capacity * 2, k_InitialSlots });
+
+        u32 grown = 0;
+        glCreateBuffers(1, &grown);
+        glNamedBufferData(grown, static_cast<GLsizeiptr>(capacity) * s_SlotStride, nullptr, GL_DYNAMIC_DRAW);
+        if (s_UBO) {
+            glCopyNamedBufferSubData(s_UBO, grown, 0, 0, static_cast<GLsizeiptr>(s_Capacity) * s_SlotStride);
+            GLState::DeleteBuffers(1, &s_UBO);
+        }
+        s_UBO = grown;
+        s_Capacity = capacity;
+    }
+}
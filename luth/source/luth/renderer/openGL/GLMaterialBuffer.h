@@ -0,0 +1,78 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/core/Math.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Luth
+{
+    class Material;
+
+    // Matches 'MaterialUBO' in LuthDeferredGeo.glsl / LuthForwardLight.glsl (std140)
+    struct MaterialParamsGPU {
+        Vec4 Color = Vec4(1.0f);
+        Vec3 Emissive = Vec3(0.0f);
+        f32 Alpha = 1.0f;
+        f32 Metalness = 0.5f;
+        f32 Roughness = 0.5f;
+        f32 AlphaCutoff = 0.5f;
+        i32 RenderMode = 0;
+        i32 AlphaFromDiffuse = 0;
+        i32 IsGloss = 0;
+        i32 IsSingleChannel = 0;
+        i32 Pad0 = 0;
+
+        Vec3 SubsurfaceColor = Vec3(0.0f);
+        f32 SubsurfaceStrength = 1.0f;
+        f32 SubsurfaceThickness = 1.0f;
+        f32 Pad1[3] = {};
+
+        struct Map {
+            i32 UseTexture = 0;
+            i32 UvIndex = 0;
+            i32 Pad[2] = {};
+        } Maps[9];
+    };
+    static_assert(sizeof(MaterialParamsGPU) == 240, "MaterialParamsGPU must match the std140 MaterialUBO");
+
+    // Persistent std140 parameter blocks, one slot per material in a single uniform buffer.
+    // A slot is rewritten only when the material's revision changed, binding a material
+    // is then one glBindBufferRange. Textures go to the unit matching their MapType.
+    // Slots belong to a material instance rather than its UUID, which copies share,
+    // and are recycled when the material is destroyed or reloaded.
+    class GLMaterialBuffer
+    {
+    public:
+        static constexpr u32 k_Binding = 3;
+        static constexpr const char* k_BlockName = "MaterialUBO";
+
+        // Uploads the block if stale and binds its range to k_Binding
+        static void Bind(const Material& material);
+        // Returns the material's slot to the free list. No GL calls, safe after Shutdown
+        static void Release(const Material& material);
+
+        static u32 GetSlotCount() { return static_cast<u32>(s_Slots.size()); }
+        static u32 GetUploadCount() { return s_UploadCount; }
+
+        static void Shutdown();
+
+    private:
+        struct Slot {
+            u32 Index = 0;
+            u32 Revision = 0;
+        };
+
+        static MaterialParamsGPU Pack(const Material& material);
+        static void Grow(u32 minSlots);
+
+        static inline std::unordered_map<const Material*, Slot> s_Slots;
+        static inline std::vector<u32> s_FreeSlots;
+        static inline u32 s_NextSlot = 0;      // Slots below were handed out at least once
+        static inline u32 s_UBO = 0;
+        static inline u32 s_Capacity = 0;       // In slots
+        static inline u32 s_SlotStride = 0;     // sizeof(MaterialParamsGPU) rounded to the UBO offset alignment
+        static inline u32 s_UploadCount = 0;
+    };
+}
@@ -1,5 +1,7 @@
 #include "luthpch.h"
 #include "luth/renderer/openGL/GLMesh.h"
+#include "luth/renderer/openGL/GLGeometryPool.h"
+#include "luth/renderer/openGL/GLState.h"
 #include "luth/resources/libraries/TextureCache.h"
 
 namespace Luth
@@ -8,42 +10,107 @@ namespace Luth
         const std::shared_ptr<GLIndexBuffer>& indexBuffer)
         : m_VertexBuffer(vertexBuffer), m_IndexBuffer(indexBuffer)
     {
+        if (m_IndexBuffer) {
+            m_IndexType = IndexTypeToGLType(m_IndexBuffer->GetIndexType());
+            m_IndexCount = m_IndexBuffer->GetCount();
+        }
         CreateVAO();
     }
 
+    GLMesh::GLMesh(const GeometryAllocation& allocation)
+        : m_IndexType(allocation.IndexSize == sizeof(u16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT),
+          m_IndexCount(allocation.IndexCount)
+    {
+        m_Allocation = allocation;
+    }
+
+    GLMesh::~GLMesh()
+    {
+        if (m_Allocation.IsValid()) GLGeometryPool::Free(m_Allocation);
+        if (m_VAO) GLState::DeleteVertexArrays(1, &m_VAO);
+    }
+
     void GLMesh::Bind() const
     {
-        glBindVertexArray(m_VAO);
+        BindVAO();
     }
 
-    void GLMesh::Draw() const
+    void GLMesh::Draw(u32 lod) const
     {
-        glBindVertexArray(m_VAO);
-        if (m_IndexBuffer) {
-            //glLineWidth(0.1f);
-            //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-            glDrawElements(GL_TRIANGLES, m_IndexBuffer->GetCount(), GL_UNSIGNED_INT, nullptr);
-        }
-        else {
-            // glDrawArrays(GL_TRIANGLES, 0, m_VertexBuffer->GetVertexCount());
+        if (m_IndexCount == 0) return;
+
+        BindVAO();
+        const MeshLod range = GetLodRange(lod);
+        glDrawElementsBaseVertex(GL_TRIANGLES, range.IndexCount, m_IndexType,
+            GetIndexPointer(range.IndexOffset), static_cast<GLint>(m_Allocation.BaseVertex));
+    }
+
+    void GLMesh::DrawInstanced(u32 instanceCount, u32 lod) const
+    {
+        if (m_IndexCount == 0 || instanceCount == 0) return;
+
+        BindVAO();
+        const MeshLod range = GetLodRange(lod);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.IndexCount, m_IndexType,
+            GetIndexPointer(range.IndexOffset), instanceCount, static_cast<GLint>(m_Allocation.BaseVertex));
+    }
+
+    void GLMesh::DrawRanges(const MeshIndexRange* ranges, u32 rangeCount) const
+    {
+        if (m_IndexCount == 0 || rangeCount == 0) return;
+
+        // Scratch arrays reused across draws, rendering is single threaded
+        static std::vector<GLsizei> counts;
+        static std::vector<const void*> offsets;
+        static std::vector<GLint> baseVertices;
+        counts.resize(rangeCount);
+        offsets.resize(rangeCount);
+        baseVertices.assign(rangeCount, static_cast<GLint>(m_Allocation.BaseVertex));
+        for (u32 i = 0; i < rangeCount; ++i) {
+            counts[i] = static_cast<GLsizei>(ranges[i].IndexCount);
+            offsets[i] = GetIndexPointer(ranges[i].IndexOffset);
         }
+
+        BindVAO();
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts.data(), m_IndexType,
+            offsets.data(), static_cast<GLsizei>(rangeCount), baseVertices.data());
+    }
+
+    void GLMesh::BindVAO() const
+    {
+        if (m_Allocation.IsValid()) GLGeometryPool::Bind(m_Allocation.Pool, m_Allocation.IndexSize);
+        else GLState::BindVertexArray(m_VAO);
+    }
+
+    MeshLod GLMesh::GetLodRange(u32 lod) const
+    {
+        if (m_Lods.empty()) return { 0, m_IndexCount };
+        return m_Lods[std::min<u32>(lod, static_cast<u32>(m_Lods.size()) - 1)];
+    }
+
+    const void* GLMesh::GetIndexPointer(u32 indexOffset) const
+    {
+        // Pooled meshes start at their first index inside the shared buffer
+        const size_t indexSize = m_IndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        const size_t first = m_Allocation.IsValid() ? m_Allocation.FirstIndex : 0;
+        return reinterpret_cast<const void*>(static_cast<uintptr_t>((first + indexOffset) * indexSize));
     }
 
     void GLMesh::CreateVAO()
     {
         glGenVertexArrays(1, &m_VAO);
-        glBindVertexArray(m_VAO);
+        GLState::BindVertexArray(m_VAO);
 
         m_VertexBuffer->Bind();
 
         const auto& layout = m_VertexBuffer->GetLayout();
-        uint32_t index = 0;
         uint32_t stride = layout.GetStride();
 
         for (const auto& element : layout.GetElements()) {
+            const GLuint index = static_cast<GLuint>(element.Location);
             glEnableVertexAttribArray(index);
             GLenum glType = ShaderDataTypeToGLType(element.Type);
-            if (glType == GL_INT || glType == GL_UNSIGNED_INT) {
+            if (element.IsInteger()) {
                 glVertexAttribIPointer(
                     index,
                     element.GetComponentCount(),
@@ -60,31 +127,9 @@ namespace Luth
                     stride,
                     (const void*)(intptr_t)element.Offset);
             }
-
-            index++;
         }
 
-        m_IndexBuffer->Bind();
-        glBindVertexArray(0);
-    }
-
-    GLenum GLMesh::ShaderDataTypeToGLType(ShaderDataType type)
-    {
-        switch (type) {
-            case ShaderDataType::Float:    return GL_FLOAT;
-            case ShaderDataType::Float2:   return GL_FLOAT;
-            case ShaderDataType::Float3:   return GL_FLOAT;
-            case ShaderDataType::Float4:   return GL_FLOAT;
-            case ShaderDataType::Int:      return GL_INT;
-            case ShaderDataType::Int2:     return GL_INT;
-            case ShaderDataType::Int3:     return GL_INT;
-            case ShaderDataType::Int4:     return GL_INT;
-            case ShaderDataType::Mat3:     return GL_FLOAT;
-            case ShaderDataType::Mat4:     return GL_FLOAT;
-            case ShaderDataType::Bool:     return GL_BOOL;
-            default:
-                LH_CORE_ASSERT(false, "Unknown ShaderDataType!");
-                return 0;
-        }
+        if (m_IndexBuffer) m_IndexBuffer->Bind();
+        GLState::BindVertexArray(0);
     }
 }
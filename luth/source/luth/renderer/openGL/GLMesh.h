@@ -16,15 +16,25 @@ namespace Luth
     public:
         GLMesh(const std::shared_ptr<GLVertexBuffer>& vertexBuffer,
             const std::shared_ptr<GLIndexBuffer>& indexBuffer);
+        // Mesh living in the shared geometry pool, drawn through the pool's VAO
+        explicit GLMesh(const GeometryAllocation& allocation);
+        ~GLMesh() override;
 
         void Bind() const override;
-        void Draw() const override;
+        void Draw(u32 lod = 0) const override;
+        void DrawInstanced(u32 instanceCount, u32 lod = 0) const override;
+        void DrawRanges(const MeshIndexRange* ranges, u32 rangeCount) const override;
 
     private:
         void CreateVAO();
-        static GLenum ShaderDataTypeToGLType(ShaderDataType type);
+        MeshLod GetLodRange(u32 lod) const;
+        const void* GetIndexPointer(u32 indexOffset) const;
 
-        GLuint m_VAO;
+        void BindVAO() const;
+
+        GLuint m_VAO = 0;
+        GLenum m_IndexType = GL_UNSIGNED_INT;
+        u32 m_IndexCount = 0;
         std::shared_ptr<GLVertexBuffer> m_VertexBuffer;
         std::shared_ptr<GLIndexBuffer> m_IndexBuffer;
     };
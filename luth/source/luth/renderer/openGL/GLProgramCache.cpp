@@ -0,0 +1,185 @@
+#include "luthpch.h"
+#include "luth/renderer/openGL/GLProgramCache.h"
+#include "luth/resources/FileSystem.h"
+
+#include <chrono>
+#include <fstream>
+
+namespace Luth
+{
+    namespace
+    {
+        constexpr u32 k_Magic = 0x4250484C;     // 'LHPB'
+        constexpr u32 k_Version = 1;
+        constexpr u32 k_MaxBinarySize = 64u << 20;     // Far above any real program, rejects corrupt headers
+
+        struct BinaryHeader {
+            u32 Magic = k_Magic;
+            u32 Version = k_Version;
+            u64 Key = 0;
+            u32 Format = 0;
+            u32 Size = 0;
+        };
+
+        // 64-bit FNV-1a
+        u64 Hash(u64 hash, std::string_view data)
+        {
+            for (char c : data) {
+                hash ^= static_cast<u8>(c);
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        std::string GLString(GLenum name)
+        {
+            const auto* str = reinterpret_cast<const char*>(glGetString(name));
+            return str ? str : "";
+        }
+
+        fs::path BinaryPath(u64 key)
+        {
+            return FileSystem::CachePath("shaders") / FMT("{:016x}.bin", key);
+        }
+
+        f64 ElapsedMs(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    bool GLProgramCache::IsEnabled()
+    {
+        if (s_Enabled < 0) {
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            s_Enabled = formats > 0 ? 1 : 0;
+            if (!s_Enabled) LH_CORE_WARN("Driver exposes no program binary formats, shader cache disabled");
+
+            s_DriverHash = Hash(14695981039346656037ull, GLString(GL_VENDOR));
+            s_DriverHash = Hash(s_DriverHash, GLString(GL_RENDERER));
+            s_DriverHash = Hash(s_DriverHash, GLString(GL_VERSION));
+        }
+        return s_Enabled == 1;
+    }
+
+    u64 GLProgramCache::Key(const std::unordered_map<GLenum, std::string>& sources)
+    {
+        IsEnabled();
+
+        // Stage order must not depend on the map's iteration order
+        std::vector<GLenum> stages;
+        for (const auto& [type, source] : sources) stages.push_back(type);
+        std::sort(stages.begin(), stages.end());
+
+        u64 key = s_DriverHash;
+        for (GLenum type : stages) {
+            key = Hash(key, std::string_view(reinterpret_cast<const char*>(&type), sizeof(type)));
+            key = Hash(key, sources.at(type));
+        }
+        return key;
+    }
+
+    GLuint GLProgramCache::Load(u64 key)
+    {
+        if (!IsEnabled()) return 0;
+
+        const fs::path path = BinaryPath(key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            ++s_Stats.Misses;
+            return 0;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::error_code ec;
+        const uintmax_t fileSize = fs::file_size(path, ec);
+        const uintmax_t remaining = !ec && fileSize > sizeof(BinaryHeader) ? fileSize - sizeof(BinaryHeader) : 0;
+
+        BinaryHeader header;
+        std::vector<char> binary;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (file && header.Magic == k_Magic && header.Version == k_Version && header.Key == key &&
+            header.Size <= remaining && header.Size <= k_MaxBinarySize) {
+            binary.resize(header.Size);
+            file.read(binary.data(), header.Size);
+        }
+        file.close();
+
+        GLuint program = 0;
+        if (!binary.empty() && file) {
+            program = glCreateProgram();
+            glProgramBinary(program, header.Format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            if (!linked) {
+                glDeleteProgram(program);
+                program = 0;
+            }
+        }
+
+        // Truncated, oversized, stale format or refused by the driver: drop it, the caller recompiles
+        if (!program) {
+            ++s_Stats.Rejected;
+            ++s_Stats.Misses;
+            fs::remove(path, ec);
+            return 0;
+        }
+
+        ++s_Stats.Hits;
+        s_Stats.LoadMs += ElapsedMs(start);
+        return program;
+    }
+
+    void GLProgramCache::Store(u64 key, GLuint program)
+    {
+        if (!IsEnabled() || !program) return;
+
+        GLint size = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+        if (size <= 0) return;
+
+        BinaryHeader header;
+        header.Key = key;
+        std::vector<char> binary(size);
+        GLenum format = 0;
+        glGetProgramBinary(program, size, nullptr, &format, binary.data());
+        header.Format = format;
+        header.Size = static_cast<u32>(size);
+
+        const fs::path path = BinaryPath(key);
+        FileSystem::CreateDirectories(path.parent_path());
+
+        // Written aside and renamed so a crash never leaves a half file under the real name
+        fs::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                LH_CORE_WARN("Could not write shader binary {0}", temp.string());
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), binary.size());
+        }
+
+        std::error_code ec;
+        fs::rename(temp, path, ec);
+        if (ec) {
+            fs::remove(temp, ec);
+            return;
+        }
+        ++s_Stats.Stores;
+    }
+
+    void GLProgramCache::Shutdown()
+    {
+        if (s_Stats.Hits + s_Stats.Misses > 0) {
+            LH_CORE_INFO("Program cache: {0} hits ({1:.1f} ms), {2} misses ({3:.1f} ms compiling), {4} rejected",
+                         s_Stats.Hits, s_Stats.LoadMs, s_Stats.Misses, s_Stats.CompileMs, s_Stats.Rejected);
+        }
+        s_Stats = {};
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <glad/glad.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace Luth
+{
+    // Linked programs saved with glGetProgramBinary under <project>/Cache/shaders.
+    // The key hashes every stage's final source (keyword defines included) together with
+    // the driver's vendor, renderer and version strings, so a driver update or an edited
+    // shader simply misses. Binaries the driver rejects are deleted and recompiled.
+    class GLProgramCache
+    {
+    public:
+        struct Stats {
+            u32 Hits = 0;
+            u32 Misses = 0;
+            u32 Rejected = 0;       // Found on disk but refused by glProgramBinary
+            u32 Stores = 0;
+            f64 LoadMs = 0.0;       // Time spent in glProgramBinary (hits)
+            f64 CompileMs = 0.0;    // Time spent compiling and linking (misses)
+        };
+
+        static u64 Key(const std::unordered_map<GLenum, std::string>& sources);
+
+        // Linked program or 0 on a miss
+        static GLuint Load(u64 key);
+        static void Store(u64 key, GLuint program);
+
+        static bool IsEnabled();
+        static void AddCompileTime(f64 ms) { s_Stats.CompileMs += ms; }
+        static const Stats& GetStats() { return s_Stats; }
+
+        static void Shutdown();
+
+    private:
+        static inline Stats s_Stats;
+        static inline i32 s_Enabled = -1;   // -1 until queried
+        static inline u64 s_DriverHash = 0;
+    };
+}
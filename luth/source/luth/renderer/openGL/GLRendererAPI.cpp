@@ -1,6 +1,11 @@
 #include "luthpch.h"
 #include "luth/renderer/OpenGL/GLRendererAPI.h"
 #include "luth/core/Log.h"
+#include "luth/renderer/openGL/GLGeometryPool.h"
+#include "luth/renderer/openGL/GLMaterialBuffer.h"
+#include "luth/renderer/openGL/GLProgramCache.h"
+#include "luth/renderer/openGL/GLState.h"
+#include "luth/renderer/openGL/GLUploadRing.h"
 
 #include <glad/glad.h>
 
@@ -17,6 +22,7 @@ namespace Luth
             return;
         }
 
+        GLState::Invalidate();
         EnableDepthTest(true);
         EnableBlending(true);
         SetBlendFunction(BlendFactor::SrcAlpha, BlendFactor::OneMinusSrcAlpha);
@@ -31,28 +37,38 @@ namespace Luth
 
     void GLRendererAPI::Shutdown()
     {
-        glBindVertexArray(0);
+        GLState::BindVertexArray(0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
         m_Meshes.clear();
+        GLGeometryPool::Shutdown();
+        GLMaterialBuffer::Shutdown();
+        GLProgramCache::Shutdown();
+        GLUploadRing::Shutdown();
+    }
+
+    void GLRendererAPI::BeginFrame()
+    {
+        GLState::NewFrame();
+        GLUploadRing::BeginFrame();
     }
 
     void GLRendererAPI::BindFramebuffer(const std::shared_ptr<Framebuffer>& framebuffer)
     {
         if (framebuffer) {
-            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->GetRendererID());
+            GLState::BindFramebuffer(framebuffer->GetRendererID());
             auto spec = framebuffer->GetSpecification();
             Renderer::SetViewport(0, 0, spec.Width, spec.Height);
         }
         else {
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            GLState::BindFramebuffer(0);
         }
     }
 
     void GLRendererAPI::SetViewport(u32 x, u32 y, u32 width, u32 height)
     {
-        glViewport(x, y, width, height);
+        GLState::Viewport(x, y, width, height);
         LH_GL_CHECK_ERROR();
     }
 
@@ -83,29 +99,24 @@ namespace Luth
 
     void GLRendererAPI::EnableDepthMask(bool enable)
     {
-        glDepthMask(enable ? GL_TRUE : GL_FALSE);
+        GLState::DepthMask(enable);
         LH_GL_CHECK_ERROR();
     }
 
     bool GLRendererAPI::IsDepthMaskEnabled()
     {
-        GLboolean currentState;
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &currentState);
-        LH_GL_CHECK_ERROR();
-        return currentState == GL_TRUE;
+        return GLState::GetDepthMask();
     }
 
     void GLRendererAPI::EnableDepthTest(bool enable)
     {
-        m_DepthTestEnabled = enable;
-        enable ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+        GLState::SetEnabled(GL_DEPTH_TEST, enable);
         LH_GL_CHECK_ERROR();
     }
 
     void GLRendererAPI::EnableBlending(bool enable)
     {
-        m_BlendingEnabled = enable;
-        enable ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+        GLState::SetEnabled(GL_BLEND, enable);
         LH_GL_CHECK_ERROR();
     }
 
@@ -113,7 +124,7 @@ namespace Luth
     {
         GLenum glSrc = BlendFactorToGL(srcFactor);
         GLenum glDst = BlendFactorToGL(dstFactor);
-        glBlendFunc(glSrc, glDst);
+        GLState::BlendFunc(glSrc, glDst);
         LH_GL_CHECK_ERROR();
     }
 
@@ -158,7 +169,7 @@ namespace Luth
 
             glGenVertexArrays(1, &quadVAO);
             glGenBuffers(1, &quadVBO);
-            glBindVertexArray(quadVAO);
+            GLState::BindVertexArray(quadVAO);
             glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
             glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
 
@@ -169,7 +180,7 @@ namespace Luth
             glEnableVertexAttribArray(1);
             glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
 
-            glBindVertexArray(0);
+            GLState::BindVertexArray(0);
         }
         LH_GL_CHECK_ERROR();
     }
@@ -177,9 +188,8 @@ namespace Luth
     void GLRendererAPI::DrawFullscreenQuad()
     {
         if (quadVAO == 0) InitFullscreenQuad();
-        glBindVertexArray(quadVAO);
+        GLState::BindVertexArray(quadVAO);
         glDrawArrays(GL_TRIANGLES, 0, 6);
-        glBindVertexArray(0);
         LH_GL_CHECK_ERROR();
     }
 
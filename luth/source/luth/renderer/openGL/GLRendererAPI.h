@@ -4,6 +4,7 @@
 #include "luth/renderer/Framebuffer.h"
 #include "luth/renderer/Mesh.h"
 #include "luth/renderer/openGL/GLMesh.h"
+#include "luth/renderer/openGL/GLState.h"
 
 #include <memory>
 
@@ -15,6 +16,8 @@ namespace Luth
         virtual void Init() override;
         virtual void Shutdown() override;
 
+        virtual void BeginFrame() override;
+
         virtual void BindFramebuffer(const std::shared_ptr<Framebuffer>& framebuffer) override;
 
         virtual void SetViewport(u32 x, u32 y, u32 width, u32 height) override;
@@ -25,7 +28,7 @@ namespace Luth
         virtual bool IsDepthMaskEnabled() override;
 
         virtual void EnableDepthTest(bool enable);
-        virtual bool IsDepthTestEnabled() const { return m_DepthTestEnabled; }
+        virtual bool IsDepthTestEnabled() const { return GLState::IsEnabled(GL_DEPTH_TEST); }
 
         virtual void EnableBlending(bool enable);
         virtual void SetBlendFunction(BlendFactor srcFactor, BlendFactor dstFactor);
@@ -43,8 +46,6 @@ namespace Luth
         GLenum BlendFactorToGL(BlendFactor factor) const;
         void CheckError(const char* file, int line);
 
-        bool m_DepthTestEnabled = true;
-        bool m_BlendingEnabled = true;
         glm::vec4 m_ClearColor = { 0.1f, 0.1f, 0.1f, 1.0f };
 
         std::vector<std::shared_ptr<GLMesh>> m_Meshes;
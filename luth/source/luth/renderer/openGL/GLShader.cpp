@@ -1,40 +1,132 @@
 #include "luthpch.h"
 #include "luth/renderer/openGL/GLShader.h"
+#include "luth/renderer/openGL/GLMaterialBuffer.h"
+#include "luth/renderer/openGL/GLProgramCache.h"
+#include "luth/renderer/openGL/GLState.h"
+#include "luth/renderer/ShaderKeywords.h"
+#include "luth/renderer/ShaderPreprocessor.h"
 
 #include <glm/gtc/type_ptr.hpp>
+#include <bit>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
 namespace Luth
 {
     GLShader::GLShader(const fs::path& filePath)
+        : m_Path(filePath)
     {
-        std::string source = Load(filePath);
-        auto shaderSources = PreProcess(source);
-        Compile(shaderSources);
+        auto processed = ShaderPreprocessor::Process(filePath);
+        m_Dependencies = std::move(processed.Dependencies);
+        if (processed.Success) m_Sources = PreProcess(processed.Source);
+        SetKeywords(0);
     }
 
     GLShader::GLShader(const std::string& vertexSrc, const std::string& fragmentSrc)
     {
-        std::unordered_map<GLenum, std::string> sources;
-        sources[GL_VERTEX_SHADER] = vertexSrc;
-        sources[GL_FRAGMENT_SHADER] = fragmentSrc;
-        Compile(sources);
+        m_Sources[GL_VERTEX_SHADER] = vertexSrc;
+        m_Sources[GL_FRAGMENT_SHADER] = fragmentSrc;
+        SetKeywords(0);
     }
 
     GLShader::~GLShader()
     {
-        glDeleteProgram(m_ShaderID);
+        for (auto& [keywords, variant] : m_Variants)
+            if (variant.Program) GLState::DeleteProgram(variant.Program);
     }
 
     void GLShader::Bind() const
     {
-        glUseProgram(m_ShaderID);
+        GLState::UseProgram(m_Active->Program);
+    }
+
+    bool GLShader::Reload()
+    {
+        if (m_Path.empty()) return false;
+
+        GLShader fresh(m_Path);
+        if (!fresh.m_Active->Program) return false;
+
+        // Rebuild every variant in use so the next draws do not stall on compiles
+        for (const auto& [keywords, variant] : m_Variants)
+            fresh.Prewarm(keywords);
+
+        // The old programs leave with 'fresh'
+        std::swap(m_Dependencies, fresh.m_Dependencies);
+        std::swap(m_Sources, fresh.m_Sources);
+        std::swap(m_DeclaredKeywords, fresh.m_DeclaredKeywords);
+        std::swap(m_Variants, fresh.m_Variants);
+
+        const u32 keywords = m_ActiveKeywords;
+        m_Active = nullptr;
+        SetKeywords(keywords);
+        return true;
+    }
+
+    void GLShader::SetKeywords(u32 keywords)
+    {
+        keywords &= m_DeclaredKeywords;
+        if (m_Active && keywords == m_ActiveKeywords) return;
+
+        Variant* variant = &GetOrCompileVariant(keywords);
+        // A broken variant falls back to the base program
+        if (!variant->Program && keywords != 0) {
+            variant = &GetOrCompileVariant(0);
+            keywords = 0;
+        }
+
+        m_Active = variant;
+        m_ActiveKeywords = keywords;
+    }
+
+    void GLShader::Prewarm(u32 keywords)
+    {
+        GetOrCompileVariant(keywords & m_DeclaredKeywords);
+    }
+
+    GLShader::Variant& GLShader::GetOrCompileVariant(u32 keywords)
+    {
+        if (auto it = m_Variants.find(keywords); it != m_Variants.end())
+            return it->second;
+
+        // Keyword defines go right after each stage's #version line
+        std::string defines;
+        for (const auto& [name, bit] : ShaderKeywords::k_Names)
+            if (keywords & bit) defines += "#define " + std::string(name) + "\n";
+
+        auto sources = m_Sources;
+        if (!defines.empty()) {
+            for (auto& [type, source] : sources) {
+                size_t insertPos = 0;
+                if (size_t version = source.find("#version"); version != std::string::npos) {
+                    insertPos = source.find('\n', version);
+                    insertPos = insertPos == std::string::npos ? source.size() : insertPos + 1;
+                }
+                source.insert(insertPos, defines);
+            }
+        }
+
+        Variant& variant = m_Variants[keywords];
+        if (sources.empty()) return variant;    // Preprocessing failed, already reported
+
+        const u64 cacheKey = GLProgramCache::Key(sources);
+        variant.Program = GLProgramCache::Load(cacheKey);
+        if (!variant.Program) {
+            const auto start = std::chrono::steady_clock::now();
+            variant.Program = Compile(sources);
+            GLProgramCache::AddCompileTime(std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count());
+            GLProgramCache::Store(cacheKey, variant.Program);
+        }
+        if (variant.Program) Reflect(variant);
+
+        if (keywords != 0) LH_CORE_TRACE("Compiled variant {0:#x} of shader '{1}'", keywords, GetName());
+        return variant;
     }
 
     void GLShader::Unbind() const
     {
-        glUseProgram(0);
+        GLState::UseProgram(0);
     }
 
     void GLShader::SetBool(const std::string& name, bool value)
@@ -79,9 +171,58 @@ namespace Luth
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
     }
 
+    void GLShader::SetBool(ShaderProperty property, bool value)
+    {
+        glUniform1i(GetUniformLocation(property.Id, property.Name), value ? 1 : 0);
+    }
+
+    void GLShader::SetInt(ShaderProperty property, int value)
+    {
+        glUniform1i(GetUniformLocation(property.Id, property.Name), value);
+    }
+
+    void GLShader::SetFloat(ShaderProperty property, float value)
+    {
+        glUniform1f(GetUniformLocation(property.Id, property.Name), value);
+    }
+
+    void GLShader::SetVec2(ShaderProperty property, const glm::vec2& vector)
+    {
+        glUniform2fv(GetUniformLocation(property.Id, property.Name), 1, glm::value_ptr(vector));
+    }
+
+    void GLShader::SetVec3(ShaderProperty property, const glm::vec3& vector)
+    {
+        glUniform3fv(GetUniformLocation(property.Id, property.Name), 1, glm::value_ptr(vector));
+    }
+
+    void GLShader::SetVec4(ShaderProperty property, const glm::vec4& vector)
+    {
+        glUniform4fv(GetUniformLocation(property.Id, property.Name), 1, glm::value_ptr(vector));
+    }
+
+    void GLShader::SetMat4(ShaderProperty property, const glm::mat4& matrix)
+    {
+        glUniformMatrix4fv(GetUniformLocation(property.Id, property.Name), 1, GL_FALSE, glm::value_ptr(matrix));
+    }
+
     std::unordered_map<GLenum, std::string> GLShader::PreProcess(const std::string& source)
     {
         std::unordered_map<GLenum, std::string> shaderSources;
+
+        // Keyword declarations: '#pragma multi_compile KEYWORD...'
+        const char* pragmaToken = "#pragma multi_compile";
+        for (size_t pragma = source.find(pragmaToken); pragma != std::string::npos;
+             pragma = source.find(pragmaToken, pragma + 1)) {
+            const size_t eol = source.find_first_of("\r\n", pragma);
+            std::istringstream keywords(source.substr(pragma + strlen(pragmaToken), eol - pragma - strlen(pragmaToken)));
+            for (std::string keyword; keywords >> keyword; ) {
+                const u32 bit = ShaderKeywords::FromName(keyword);
+                if (!bit) LH_CORE_WARN("Unknown shader keyword '{0}'", keyword);
+                m_DeclaredKeywords |= bit;
+            }
+        }
+
         const char* typeToken = "#type";
         size_t typeTokenLength = strlen(typeToken);
         size_t pos = source.find(typeToken, 0);
@@ -103,7 +244,7 @@ namespace Luth
         return shaderSources;
     }
 
-    void GLShader::Compile(const std::unordered_map<GLenum, std::string>& shaderSources)
+    GLuint GLShader::Compile(const std::unordered_map<GLenum, std::string>& shaderSources)
     {
         GLuint program = glCreateProgram();
         std::vector<GLuint> shaderIDs;
@@ -124,15 +265,20 @@ namespace Luth
                 std::vector<GLchar> infoLog(maxLength);
                 glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
                 glDeleteShader(shader);
+                for (auto id : shaderIDs)
+                    glDeleteShader(id);
+                glDeleteProgram(program);
 
                 LH_CORE_ERROR("Shader compilation failed:\n{0}", infoLog.data());
-                return;
+                return 0;
             }
 
             glAttachShader(program, shader);
             shaderIDs.push_back(shader);
         }
 
+        // Lets GLProgramCache read the linked binary back
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
         glLinkProgram(program);
         GLint isLinked = 0;
         glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
@@ -149,13 +295,68 @@ namespace Luth
             glDeleteProgram(program);
 
             LH_CORE_ERROR("Shader linking failed: {0}", infoLog.data());
-            return;
+            return 0;
         }
 
-        for (auto id : shaderIDs)
+        for (auto id : shaderIDs) {
             glDetachShader(program, id);
+            glDeleteShader(id);
+        }
+
+        return program;
+    }
+
+    void GLShader::Reflect(Variant& variant)
+    {
+        const GLuint program = variant.Program;
+
+        // Default block uniforms, block members have no location
+        GLint uniformCount = 0;
+        glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+        variant.Locations.resize(std::bit_ceil(static_cast<u32>(std::max(uniformCount, 8)) * 2));
+
+        std::unordered_map<u32, std::string> names;
+        auto add = [&](const std::string& name, GLint location) {
+            const u32 id = ShaderProperty::Hash(name);
+            if (auto [it, inserted] = names.emplace(id, name); !inserted) {
+                LH_CORE_ERROR("Uniforms '{0}' and '{1}' share a property id, rename one", it->second, name);
+                return;
+            }
+            InsertLocation(variant, id, name.c_str(), location);
+        };
+
+        const GLenum uniformProps[] = { GL_NAME_LENGTH, GL_LOCATION, GL_BLOCK_INDEX };
+        for (GLint i = 0; i < uniformCount; ++i) {
+            GLint values[3] = {};
+            glGetProgramResourceiv(program, GL_UNIFORM, i, 3, uniformProps, 3, nullptr, values);
+            if (values[2] != -1 || values[1] == -1) continue;
+
+            std::string name(values[0], '\0');
+            glGetProgramResourceName(program, GL_UNIFORM, i, values[0], nullptr, name.data());
+            name.resize(strlen(name.c_str()));
+
+            add(name, values[1]);
+            // Arrays are reported as "name[0]", also answer to the bare name
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+                add(name.substr(0, name.size() - 3), values[1]);
+        }
+
+        GLint blockCount = 0;
+        glGetProgramInterfaceiv(program, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+        const GLenum blockProps[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+        for (GLint i = 0; i < blockCount; ++i) {
+            GLint values[3] = {};
+            glGetProgramResourceiv(program, GL_UNIFORM_BLOCK, i, 3, blockProps, 3, nullptr, values);
+
+            std::string name(values[0], '\0');
+            glGetProgramResourceName(program, GL_UNIFORM_BLOCK, i, values[0], nullptr, name.data());
+            name.resize(strlen(name.c_str()));
 
-        m_ShaderID = program;
+            if (name == GLMaterialBuffer::k_BlockName && values[2] != sizeof(MaterialParamsGPU))
+                LH_CORE_ERROR("{0} is {1} bytes, MaterialParamsGPU expects {2}", name, values[2], sizeof(MaterialParamsGPU));
+
+            variant.UniformBlocks.push_back({ name, static_cast<u32>(values[1]), static_cast<u32>(values[2]) });
+        }
     }
 
     GLenum GLShader::ShaderTypeFromString(const std::string& type)
@@ -170,14 +371,69 @@ namespace Luth
 
     GLint GLShader::GetUniformLocation(const std::string& name)
     {
-        if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-            return m_UniformLocationCache[name];
+        return GetUniformLocation(ShaderProperty::Hash(name), name.c_str());
+    }
+
+    GLint GLShader::GetUniformLocation(u32 id, const char* name)
+    {
+        Variant& variant = *m_Active;
+        if (!variant.Locations.empty()) {
+            const u32 mask = static_cast<u32>(variant.Locations.size()) - 1;
+            for (u32 i = id & mask; variant.Locations[i].Used; i = (i + 1) & mask) {
+                if (variant.Locations[i].Id != id) continue;
+
+                #if defined(DEBUG)
+                LH_CORE_ASSERT(variant.Locations[i].Name == name,
+                    FMT("Uniforms '{0}' and '{1}' share a property id, rename one", variant.Locations[i].Name, name));
+                #endif
+                return variant.Locations[i].Location;
+            }
+        }
 
-        GLint location = glGetUniformLocation(m_ShaderID, name.c_str());
-        if (location == -1)
+        // Not reflected: array elements past the first, or uniforms the compiler removed.
+        // Cached either way so a missing uniform is reported once
+        GLint location = variant.Program ? glGetUniformLocation(variant.Program, name) : -1;
+        if (location == -1 && variant.Program)
             LH_CORE_WARN("Uniform '{0}' not found!", name);
 
-        m_UniformLocationCache[name] = location;
+        InsertLocation(variant, id, name, location);
         return location;
     }
+
+    void GLShader::InsertLocation(Variant& variant, u32 id, const char* name, GLint location)
+    {
+        auto& locations = variant.Locations;
+
+        // Keep the load factor under 1/2
+        if ((variant.LocationCount + 1) * 2 > locations.size()) {
+            std::vector<LocationSlot> old = std::move(locations);
+            locations.assign(std::max<size_t>(16, old.size() * 2), {});
+            variant.LocationCount = 0;
+            for (const auto& slot : old) {
+                if (!slot.Used) continue;
+                #if defined(DEBUG)
+                InsertLocation(variant, slot.Id, slot.Name.c_str(), slot.Location);
+                #else
+                InsertLocation(variant, slot.Id, "", slot.Location);
+                #endif
+            }
+        }
+
+        const u32 mask = static_cast<u32>(locations.size()) - 1;
+        u32 i = id & mask;
+        while (locations[i].Used && locations[i].Id != id) i = (i + 1) & mask;
+
+        #if defined(DEBUG)
+        LH_CORE_ASSERT(!locations[i].Used || locations[i].Name == name,
+            FMT("Uniforms '{0}' and '{1}' share a property id, rename one", locations[i].Name, name));
+        #endif
+
+        if (!locations[i].Used) ++variant.LocationCount;
+        locations[i].Id = id;
+        locations[i].Location = location;
+        locations[i].Used = true;
+        #if defined(DEBUG)
+        locations[i].Name = name;
+        #endif
+    }
 }
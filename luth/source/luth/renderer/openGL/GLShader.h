@@ -24,14 +24,66 @@ namespace Luth
         void SetVec4(const std::string& name, const glm::vec4& vector) override;
         void SetMat4(const std::string& name, const glm::mat4& matrix) override;
 
+        void SetBool(ShaderProperty property, bool value) override;
+        void SetInt(ShaderProperty property, int value) override;
+        void SetFloat(ShaderProperty property, float value) override;
+        void SetVec2(ShaderProperty property, const glm::vec2& vector) override;
+        void SetVec3(ShaderProperty property, const glm::vec3& vector) override;
+        void SetVec4(ShaderProperty property, const glm::vec4& vector) override;
+        void SetMat4(ShaderProperty property, const glm::mat4& matrix) override;
+
+        const std::vector<UniformBlockInfo>& GetUniformBlocks() const override { return m_Active->UniformBlocks; }
+
+        void SetKeywords(u32 keywords) override;
+        u32 GetKeywords() const override { return m_ActiveKeywords; }
+        u32 GetDeclaredKeywords() const override { return m_DeclaredKeywords; }
+        void Prewarm(u32 keywords) override;
+        u32 GetVariantCount() const override { return static_cast<u32>(m_Variants.size()); }
+
+        const std::vector<fs::path>& GetDependencies() const override { return m_Dependencies; }
+        bool Reload() override;
+
     private:
+        // Open addressing table, property id -> location. Uniforms missing from the
+        // reflection (array elements past the first, optimized out) are added on first use.
+        // Only the hash is compared, debug builds keep the name to catch collisions
+        struct LocationSlot {
+            u32 Id = 0;
+            GLint Location = -1;
+            bool Used = false;
+            #if defined(DEBUG)
+            std::string Name;
+            #endif
+        };
+
+        // One linked program per keyword combination
+        struct Variant {
+            GLuint Program = 0;
+            std::vector<LocationSlot> Locations;
+            u32 LocationCount = 0;
+            std::vector<UniformBlockInfo> UniformBlocks;
+        };
+
         std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
-        void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+        // Returns 0 on failure
+        GLuint Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+        Variant& GetOrCompileVariant(u32 keywords);
+
+        // Fills the location table and block list from the linked program
+        void Reflect(Variant& variant);
 
         GLenum ShaderTypeFromString(const std::string& type);
         GLint GetUniformLocation(const std::string& name);
+        GLint GetUniformLocation(u32 id, const char* name);
+        static void InsertLocation(Variant& variant, u32 id, const char* name, GLint location);
+
+        fs::path m_Path;
+        std::vector<fs::path> m_Dependencies;
+        std::unordered_map<GLenum, std::string> m_Sources;
+        u32 m_DeclaredKeywords = 0;
 
-        GLuint m_ShaderID;
-        std::unordered_map<std::string, GLint> m_UniformLocationCache;
+        std::unordered_map<u32, Variant> m_Variants;    // Keyword mask -> variant, node addresses are stable
+        Variant* m_Active = nullptr;
+        u32 m_ActiveKeywords = 0;
     };
 }
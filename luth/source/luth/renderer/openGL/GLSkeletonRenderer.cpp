@@ -1,5 +1,6 @@
 #include "luthpch.h"
 #include "luth/renderer/OpenGL/GLSkeletonRenderer.h"
+#include "luth/renderer/openGL/GLState.h"
 #include "luth/renderer/SkinnedModel.h"
 
 #include <glad/glad.h>
@@ -41,18 +42,18 @@ namespace Luth
         glGenBuffers(1, &m_VBO);
 
         // Set up vertex attributes
-        glBindVertexArray(m_VAO);
+        GLState::BindVertexArray(m_VAO);
         glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
 
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
 
-        glBindVertexArray(0);
+        GLState::BindVertexArray(0);
     }
 
     GLSkeletonRenderer::~GLSkeletonRenderer() {
-        glDeleteVertexArrays(1, &m_VAO);
-        glDeleteBuffers(1, &m_VBO);
+        GLState::DeleteVertexArrays(1, &m_VAO);
+        GLState::DeleteBuffers(1, &m_VBO);
     }
 
     void GLSkeletonRenderer::Update(const SkinnedModel& model) {
@@ -85,24 +86,24 @@ namespace Luth
         m_VertexCount = static_cast<uint32_t>(lines.size());
 
         // Update GPU buffer
-        glBindVertexArray(m_VAO);
+        GLState::BindVertexArray(m_VAO);
         glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
         glBufferData(GL_ARRAY_BUFFER,
             lines.size() * sizeof(glm::vec3),
             lines.data(),
             GL_DYNAMIC_DRAW);
-        glBindVertexArray(0);
+        GLState::BindVertexArray(0);
     }
 
     void GLSkeletonRenderer::Draw() {
         if (m_VertexCount == 0) return;
 
         m_Shader->Bind();
-        m_Shader->SetVec3("uColor", glm::vec3(1.0f, 0.0f, 0.0f)); // Red color
+        m_Shader->SetVec3(LH_PROP("uColor"), glm::vec3(1.0f, 0.0f, 0.0f)); // Red color
 
-        glBindVertexArray(m_VAO);
+        GLState::BindVertexArray(m_VAO);
         glDrawArrays(GL_LINES, 0, m_VertexCount);
-        glBindVertexArray(0);
+        GLState::BindVertexArray(0);
 
         m_Shader->Unbind();
     }
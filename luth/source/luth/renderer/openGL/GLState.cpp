@@ -0,0 +1,214 @@
+#include "luthpch.h"
+#include "luth/renderer/openGL/GLState.h"
+
+namespace Luth
+{
+    void GLState::NewFrame()
+    {
+        s_LastFrame = s_Frame;
+        s_Frame = {};
+        Invalidate();
+    }
+
+    void GLState::Invalidate()
+    {
+        s_Program = k_Unknown;
+        s_VertexArray = k_Unknown;
+        s_Framebuffer = k_Unknown;
+        s_Textures.fill(k_Unknown);
+        s_UniformBuffers.fill({});
+        s_StorageBuffers.fill({});
+        s_Viewport.fill(-1);
+        s_Enabled.fill(-1);
+        s_DepthMask = -1;
+        s_DepthFunc = k_Unknown;
+        s_BlendSrc = s_BlendDst = k_Unknown;
+        s_CullFace = k_Unknown;
+    }
+
+    void GLState::UseProgram(u32 program)
+    {
+        if (Elide(s_Program == program)) return;
+        s_Program = program;
+        glUseProgram(program);
+    }
+
+    void GLState::BindVertexArray(u32 vao)
+    {
+        if (Elide(s_VertexArray == vao)) return;
+        s_VertexArray = vao;
+        glBindVertexArray(vao);
+    }
+
+    void GLState::BindTextureUnit(u32 unit, u32 texture)
+    {
+        if (unit < k_TextureUnits) {
+            if (Elide(s_Textures[unit] == texture)) return;
+            s_Textures[unit] = texture;
+        }
+        else Elide(false);
+        glBindTextureUnit(unit, texture);
+    }
+
+    void GLState::BindFramebuffer(u32 framebuffer)
+    {
+        if (Elide(s_Framebuffer == framebuffer)) return;
+        s_Framebuffer = framebuffer;
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    }
+
+    void GLState::Viewport(i32 x, i32 y, i32 width, i32 height)
+    {
+        const std::array<i32, 4> viewport = { x, y, width, height };
+        if (Elide(s_Viewport == viewport)) return;
+        s_Viewport = viewport;
+        glViewport(x, y, width, height);
+    }
+
+    void GLState::BindBufferBase(GLenum target, u32 index, u32 buffer)
+    {
+        auto* bindings = Bindings(target);
+        if (bindings && index < k_BufferBindings) {
+            BufferBinding& binding = (*bindings)[index];
+            if (Elide(binding.Buffer == buffer && binding.Offset == 0 && binding.Size == 0)) return;
+            binding = { buffer, 0, 0 };
+        }
+        else Elide(false);
+        glBindBufferBase(target, index, buffer);
+    }
+
+    void GLState::BindBufferRange(GLenum target, u32 index, u32 buffer, GLintptr offset, GLsizeiptr size)
+    {
+        auto* bindings = Bindings(target);
+        if (bindings && index < k_BufferBindings) {
+            BufferBinding& binding = (*bindings)[index];
+            if (Elide(binding.Buffer == buffer && binding.Offset == offset && binding.Size == size)) return;
+            binding = { buffer, offset, size };
+        }
+        else Elide(false);
+        glBindBufferRange(target, index, buffer, offset, size);
+    }
+
+    void GLState::SetEnabled(GLenum capability, bool enabled)
+    {
+        const u32 index = CapabilityIndex(capability);
+        if (index < CapabilityCount) {
+            if (Elide(s_Enabled[index] == static_cast<i8>(enabled))) return;
+            s_Enabled[index] = static_cast<i8>(enabled);
+        }
+        else Elide(false);
+        enabled ? glEnable(capability) : glDisable(capability);
+    }
+
+    bool GLState::IsEnabled(GLenum capability)
+    {
+        const u32 index = CapabilityIndex(capability);
+        if (index >= CapabilityCount) return glIsEnabled(capability) == GL_TRUE;
+
+        if (s_Enabled[index] < 0) s_Enabled[index] = glIsEnabled(capability) == GL_TRUE ? 1 : 0;
+        return s_Enabled[index] == 1;
+    }
+
+    void GLState::DepthMask(bool enabled)
+    {
+        if (Elide(s_DepthMask == static_cast<i8>(enabled))) return;
+        s_DepthMask = static_cast<i8>(enabled);
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+
+    bool GLState::GetDepthMask()
+    {
+        if (s_DepthMask < 0) {
+            GLboolean mask = GL_TRUE;
+            glGetBooleanv(GL_DEPTH_WRITEMASK, &mask);
+            s_DepthMask = mask == GL_TRUE ? 1 : 0;
+        }
+        return s_DepthMask == 1;
+    }
+
+    void GLState::DepthFunc(GLenum func)
+    {
+        if (Elide(s_DepthFunc == func)) return;
+        s_DepthFunc = func;
+        glDepthFunc(func);
+    }
+
+    void GLState::BlendFunc(GLenum src, GLenum dst)
+    {
+        if (Elide(s_BlendSrc == src && s_BlendDst == dst)) return;
+        s_BlendSrc = src;
+        s_BlendDst = dst;
+        glBlendFunc(src, dst);
+    }
+
+    void GLState::CullFace(GLenum face)
+    {
+        if (Elide(s_CullFace == face)) return;
+        s_CullFace = face;
+        glCullFace(face);
+    }
+
+    void GLState::DeleteProgram(u32 program)
+    {
+        if (s_Program == program) s_Program = k_Unknown;
+        glDeleteProgram(program);
+    }
+
+    void GLState::DeleteVertexArrays(i32 count, const u32* vaos)
+    {
+        for (i32 i = 0; i < count; ++i)
+            if (s_VertexArray == vaos[i]) s_VertexArray = k_Unknown;
+        glDeleteVertexArrays(count, vaos);
+    }
+
+    void GLState::DeleteTextures(i32 count, const u32* textures)
+    {
+        for (i32 i = 0; i < count; ++i)
+            for (u32& bound : s_Textures)
+                if (bound == textures[i]) bound = k_Unknown;
+        glDeleteTextures(count, textures);
+    }
+
+    void GLState::DeleteBuffers(i32 count, const u32* buffers)
+    {
+        for (i32 i = 0; i < count; ++i) {
+            for (auto* bindings : { &s_UniformBuffers, &s_StorageBuffers })
+                for (BufferBinding& binding : *bindings)
+                    if (binding.Buffer == buffers[i]) binding = {};
+        }
+        glDeleteBuffers(count, buffers);
+    }
+
+    void GLState::DeleteFramebuffers(i32 count, const u32* framebuffers)
+    {
+        for (i32 i = 0; i < count; ++i)
+            if (s_Framebuffer == framebuffers[i]) s_Framebuffer = k_Unknown;
+        glDeleteFramebuffers(count, framebuffers);
+    }
+
+    u32 GLState::CapabilityIndex(GLenum capability)
+    {
+        switch (capability) {
+            case GL_BLEND:              return CapBlend;
+            case GL_DEPTH_TEST:         return CapDepthTest;
+            case GL_CULL_FACE:          return CapCullFace;
+            case GL_FRAMEBUFFER_SRGB:   return CapFramebufferSRGB;
+            default:                    return CapabilityCount;
+        }
+    }
+
+    std::array<GLState::BufferBinding, GLState::k_BufferBindings>* GLState::Bindings(GLenum target)
+    {
+        switch (target) {
+            case GL_UNIFORM_BUFFER:         return &s_UniformBuffers;
+            case GL_SHADER_STORAGE_BUFFER:  return &s_StorageBuffers;
+            default:                        return nullptr;
+        }
+    }
+
+    bool GLState::Elide(bool redundant)
+    {
+        ++(redundant ? s_Frame.Elided : s_Frame.Issued);
+        return redundant;
+    }
+}
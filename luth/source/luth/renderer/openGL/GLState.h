@@ -0,0 +1,94 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <glad/glad.h>
+
+#include <array>
+
+namespace Luth
+{
+    // Shadow of the GL context state the renderer touches: program, VAO, texture units,
+    // uniform / storage buffer bindings, framebuffer, viewport, blend / depth / cull state.
+    // Calls that would set what is already set are dropped, so draws can bind everything
+    // they need without knowing what the previous draw left behind.
+    //
+    // Anything binding these behind its back makes the shadow stale. Renderer code goes
+    // through here, and the whole shadow is forgotten at the start of every frame (ImGui
+    // and friends). Deleting an object unbinds it and frees its name for reuse, so deletes
+    // of cached kinds of objects go through here as well.
+    class GLState
+    {
+    public:
+        struct Stats {
+            u32 Issued = 0;
+            u32 Elided = 0;
+        };
+
+        // Publishes the finished frame's counters and forgets the cached state
+        static void NewFrame();
+        static void Invalidate();
+
+        static void UseProgram(u32 program);
+        static void BindVertexArray(u32 vao);
+        static void BindTextureUnit(u32 unit, u32 texture);
+        static void BindFramebuffer(u32 framebuffer);
+        static void Viewport(i32 x, i32 y, i32 width, i32 height);
+
+        // GL_UNIFORM_BUFFER and GL_SHADER_STORAGE_BUFFER are cached, other targets pass through
+        static void BindBufferBase(GLenum target, u32 index, u32 buffer);
+        static void BindBufferRange(GLenum target, u32 index, u32 buffer, GLintptr offset, GLsizeiptr size);
+
+        // GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE and GL_FRAMEBUFFER_SRGB are cached
+        static void SetEnabled(GLenum capability, bool enabled);
+        static bool IsEnabled(GLenum capability);
+
+        static void DepthMask(bool enabled);
+        static bool GetDepthMask();
+        static void DepthFunc(GLenum func);
+        static void BlendFunc(GLenum src, GLenum dst);
+        static void CullFace(GLenum face);
+
+        static void DeleteProgram(u32 program);
+        static void DeleteVertexArrays(i32 count, const u32* vaos);
+        static void DeleteTextures(i32 count, const u32* textures);
+        static void DeleteBuffers(i32 count, const u32* buffers);
+        static void DeleteFramebuffers(i32 count, const u32* framebuffers);
+
+        // Last finished frame
+        static const Stats& GetStats() { return s_LastFrame; }
+
+    private:
+        static constexpr u32 k_Unknown = ~0u;
+        static constexpr u32 k_TextureUnits = 32;   // Higher units pass through
+        static constexpr u32 k_BufferBindings = 16;
+
+        struct BufferBinding {
+            u32 Buffer = k_Unknown;
+            GLintptr Offset = 0;
+            GLsizeiptr Size = 0;    // 0 for the whole buffer
+        };
+
+        enum Capability : u32 { CapBlend, CapDepthTest, CapCullFace, CapFramebufferSRGB, CapabilityCount };
+
+        static u32 CapabilityIndex(GLenum capability);
+        static std::array<BufferBinding, k_BufferBindings>* Bindings(GLenum target);
+        static bool Elide(bool redundant);
+
+        static inline u32 s_Program = k_Unknown;
+        static inline u32 s_VertexArray = k_Unknown;
+        static inline u32 s_Framebuffer = k_Unknown;
+        static inline std::array<u32, k_TextureUnits> s_Textures;
+        static inline std::array<BufferBinding, k_BufferBindings> s_UniformBuffers;
+        static inline std::array<BufferBinding, k_BufferBindings> s_StorageBuffers;
+        static inline std::array<i32, 4> s_Viewport;
+        static inline std::array<i8, CapabilityCount> s_Enabled;    // -1 unknown
+        static inline i8 s_DepthMask = -1;
+        static inline GLenum s_DepthFunc = k_Unknown;
+        static inline GLenum s_BlendSrc = k_Unknown, s_BlendDst = k_Unknown;
+        static inline GLenum s_CullFace = k_Unknown;
+
+        static inline Stats s_Frame;
+        static inline Stats s_LastFrame;
+    };
+}
@@ -1,5 +1,6 @@
 #include "Luthpch.h"
 #include "luth/renderer/openGL/GLTexture.h"
+#include "luth/renderer/openGL/GLState.h"
 #include "luth/resources/FileSystem.h"
 #include "luth/utils/ImageUtils.h"
 
@@ -23,14 +24,13 @@ namespace Luth
     GLTexture::~GLTexture()
     {
         LH_CORE_TRACE("Destroying GLTexture (ID: {0}, '{1}')", m_TextureID, m_Path.filename().string());
-        glDeleteTextures(1, &m_TextureID);
+        GLState::DeleteTextures(1, &m_TextureID);
     }
 
     void GLTexture::Bind(uint32_t slot) const
     {
         //LH_CORE_TRACE("Binding texture ID {0} to slot {1}", m_TextureID, slot);
-        glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(GL_TEXTURE_2D, m_TextureID);
+        GLState::BindTextureUnit(slot, m_TextureID);
     }
 
     void GLTexture::SetWrapMode(TextureWrapMode mode)
@@ -0,0 +1,134 @@
+#include "luthpch.h"
+#include "luth/renderer/openGL/GLUploadRing.h"
+#include "luth/renderer/openGL/GLState.h"
+
+namespace Luth
+{
+    namespace
+    {
+        constexpr size_t k_InitialSegmentSize = 1u << 20;
+        constexpr GLbitfield k_MapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        size_t AlignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    void GLUploadRing::BeginFrame()
+    {
+        ++s_Frame;
+        if (!s_Buffer) {
+            Create(k_InitialSegmentSize);
+            return;
+        }
+
+        s_Fences[s_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        s_Segment = (s_Segment + 1) % k_FramesInFlight;
+        Wait(s_Fences[s_Segment]);
+        s_Head = 0;
+
+        // Nothing writes to a retired buffer any more, GL keeps it alive for queued commands
+        std::erase_if(s_Retired, [](Retired& retired) {
+            if (--retired.FramesLeft > 0) return false;
+            GLState::DeleteBuffers(1, &retired.Buffer);
+            return true;
+        });
+    }
+
+    UploadAllocation GLUploadRing::Allocate(size_t bytes, size_t alignment)
+    {
+        if (!s_Buffer) Create(k_InitialSegmentSize);
+        if (alignment == 0) alignment = s_Alignment;
+        bytes = std::max<size_t>(bytes, 16);     // Empty ranges can't be bound
+
+        size_t offset = AlignUp(s_Head, alignment);
+        if (offset + bytes > s_SegmentSize) {
+            Grow(bytes);
+            offset = 0;
+        }
+        s_Head = offset + bytes;
+
+        const size_t absolute = s_Segment * s_SegmentSize + offset;
+        return { s_Mapped + absolute, s_Buffer, static_cast<u32>(absolute), static_cast<u32>(bytes) };
+    }
+
+    UploadAllocation GLUploadRing::Upload(const void* data, size_t bytes, size_t alignment)
+    {
+        UploadAllocation allocation = Allocate(bytes, alignment);
+        if (data && bytes) std::memcpy(allocation.Data, data, bytes);
+        return allocation;
+    }
+
+    void GLUploadRing::Bind(GLenum target, u32 index, const UploadAllocation& allocation)
+    {
+        GLState::BindBufferRange(target, index, allocation.Buffer, allocation.Offset, allocation.Size);
+    }
+
+    void GLUploadRing::Shutdown()
+    {
+        for (GLsync& fence : s_Fences) {
+            if (fence) glDeleteSync(fence);
+            fence = nullptr;
+        }
+        for (Retired& retired : s_Retired)
+            GLState::DeleteBuffers(1, &retired.Buffer);
+        s_Retired.clear();
+
+        if (s_Buffer) {
+            glUnmapNamedBuffer(s_Buffer);
+            GLState::DeleteBuffers(1, &s_Buffer);
+        }
+        s_Buffer = 0;
+        s_Mapped = nullptr;
+        s_SegmentSize = s_Head = 0;
+        s_Segment = 0;
+    }
+
+    void GLUploadRing::Create(size_t segmentSize)
+    {
+        if (s_Alignment == 0) {
+            GLint uniform = 256, storage = 256;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform);
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storage);
+            s_Alignment = static_cast<size_t>(std::max({ uniform, storage, 16 }));
+        }
+
+        s_SegmentSize = AlignUp(segmentSize, s_Alignment);
+        const GLsizeiptr size = static_cast<GLsizeiptr>(s_SegmentSize * k_FramesInFlight);
+
+        glCreateBuffers(1, &s_Buffer);
+        glNamedBufferStorage(s_Buffer, size, nullptr, k_MapFlags);
+        s_Mapped = static_cast<u8*>(glMapNamedBufferRange(s_Buffer, 0, size, k_MapFlags));
+        s_Segment = 0;
+        s_Head = 0;
+
+        LH_CORE_TRACE("Upload ring: {0} KB per frame, {1} frames in flight", s_SegmentSize / 1024, k_FramesInFlight);
+    }
+
+    void GLUploadRing::Grow(size_t minSegmentSize)
+    {
+        // Allocations made this frame stay valid: the retired buffer stays mapped until deleted
+        s_Retired.push_back({ s_Buffer, k_FramesInFlight });
+        for (GLsync& fence : s_Fences) {
+            if (fence) glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        Create(std::max(s_SegmentSize * 2, minSegmentSize));
+    }
+
+    void GLUploadRing::Wait(GLsync& fence)
+    {
+        if (!fence) return;
+
+        GLbitfield flags = 0;
+        while (true) {
+            const GLenum result = glClientWaitSync(fence, flags, 1'000'000);   // 1 ms
+            if (result != GL_TIMEOUT_EXPIRED) break;                        // Signaled, or failed
+            flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
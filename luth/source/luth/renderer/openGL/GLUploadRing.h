@@ -0,0 +1,70 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <glad/glad.h>
+
+#include <vector>
+
+namespace Luth
+{
+    // Slice of the upload ring, written through Data and valid until the frame ends
+    struct UploadAllocation {
+        void* Data = nullptr;
+        u32 Buffer = 0;
+        u32 Offset = 0;
+        u32 Size = 0;
+
+        bool IsValid() const { return Data != nullptr; }
+    };
+
+    // Per-frame GPU data (camera, lights, bone palettes, instance streams) goes through one
+    // persistently mapped, coherent buffer cut into k_FramesInFlight segments. A frame
+    // bump-allocates from its segment and the CPU writes straight into the mapping, the
+    // segment is fenced when the frame ends and only rewritten once that fence has passed.
+    // No glBufferSubData into a buffer the GPU may still be reading, so no implicit syncs.
+    // A frame that outgrows its segment moves to a larger buffer, the old one is deleted
+    // once the frames using it are done.
+    class GLUploadRing
+    {
+    public:
+        static constexpr u32 k_FramesInFlight = 3;
+
+        // Fences the finished frame's segment and waits for the next one to be free
+        static void BeginFrame();
+        // Incremented by BeginFrame, allocations are valid during the frame they were made in
+        static u64 GetFrame() { return s_Frame; }
+
+        // alignment 0: the UBO / SSBO offset alignment
+        static UploadAllocation Allocate(size_t bytes, size_t alignment = 0);
+        static UploadAllocation Upload(const void* data, size_t bytes, size_t alignment = 0);
+
+        template<typename T>
+        static UploadAllocation Upload(const T& value) { return Upload(&value, sizeof(T)); }
+
+        // glBindBufferRange over the allocation
+        static void Bind(GLenum target, u32 index, const UploadAllocation& allocation);
+
+        static void Shutdown();
+
+    private:
+        struct Retired {
+            u32 Buffer = 0;
+            u32 FramesLeft = 0;
+        };
+
+        static void Create(size_t segmentSize);
+        static void Grow(size_t minSegmentSize);
+        static void Wait(GLsync& fence);
+
+        static inline u32 s_Buffer = 0;
+        static inline u8* s_Mapped = nullptr;
+        static inline size_t s_SegmentSize = 0;
+        static inline size_t s_Head = 0;            // In the current segment
+        static inline u32 s_Segment = 0;
+        static inline u64 s_Frame = 0;
+        static inline size_t s_Alignment = 0;
+        static inline GLsync s_Fences[k_FramesInFlight] = {};
+        static inline std::vector<Retired> s_Retired;
+    };
+}
@@ -1,6 +1,7 @@
 #include "luthpch.h"
 #include "luth/renderer/openGL/GLVertexArray.h"
 #include "luth/renderer/openGL/GLBuffer.h"
+#include "luth/renderer/openGL/GLState.h"
 
 #include <glad/glad.h>
 
@@ -11,42 +12,52 @@ namespace Luth
     }
 
     GLVertexArray::~GLVertexArray() {
-        glDeleteVertexArrays(1, &m_VertexArrayID);
+        GLState::DeleteVertexArrays(1, &m_VertexArrayID);
     }
 
     void GLVertexArray::Bind() const {
-        glBindVertexArray(m_VertexArrayID);
+        GLState::BindVertexArray(m_VertexArrayID);
     }
 
     void GLVertexArray::Unbind() const {
-        glBindVertexArray(0);
+        GLState::BindVertexArray(0);
     }
 
     void GLVertexArray::AddVertexBuffer(const std::shared_ptr<VertexBuffer>& vb)
     {
-        glBindVertexArray(m_VertexArrayID);
+        GLState::BindVertexArray(m_VertexArrayID);
         vb->Bind();
 
         const auto& layout = vb->GetLayout();
-        uint32_t index = 0;
         for (const auto& element : layout.GetElements()) {
+            const GLuint index = static_cast<GLuint>(element.Location);
             glEnableVertexAttribArray(index);
-            glVertexAttribPointer(
-                index,
-                element.GetComponentCount(),
-                GL_FLOAT,
-                element.Normalized ? GL_TRUE : GL_FALSE,
-                layout.GetStride(),
-                (const void*)element.Offset
-            );
-            index++;
+            if (element.IsInteger()) {
+                glVertexAttribIPointer(
+                    index,
+                    element.GetComponentCount(),
+                    ShaderDataTypeToGLType(element.Type),
+                    layout.GetStride(),
+                    (const void*)(intptr_t)element.Offset
+                );
+            }
+            else {
+                glVertexAttribPointer(
+                    index,
+                    element.GetComponentCount(),
+                    ShaderDataTypeToGLType(element.Type),
+                    element.Normalized ? GL_TRUE : GL_FALSE,
+                    layout.GetStride(),
+                    (const void*)(intptr_t)element.Offset
+                );
+            }
         }
         m_VertexBuffers.push_back(vb);
     }
 
     void GLVertexArray::SetIndexBuffer(const std::shared_ptr<IndexBuffer>& ib)
     {
-        glBindVertexArray(m_VertexArrayID);
+        GLState::BindVertexArray(m_VertexArrayID);
         ib->Bind();
         m_IndexBuffer = ib;
     }
@@ -0,0 +1,182 @@
+#include "Luthpch.h"
+#include "luth/renderer/pipeline/InstanceBatcher.h"
+#include "luth/renderer/pipeline/RenderUtils.h"
+#include "luth/renderer/openGL/GLGeometryPool.h"
+#include "luth/renderer/openGL/GLUploadRing.h"
+
+#include <glad/glad.h>
+
+namespace Luth
+{
+    namespace
+    {
+        constexpr u32 k_InstanceBinding = 5;
+
+        // Material first so indirect groups (one per material) stay contiguous,
+        // mirrored instances of a single-sided material draw two-sided
+        auto BatchKey(const RenderCommand& cmd)
+        {
+            return std::make_tuple((u64)cmd.meshRend->MaterialUUID, cmd.singleSided, (u64)cmd.meshRend->ModelUUID,
+                                   cmd.meshRend->MeshIndex, cmd.lod);
+        }
+
+        const Mesh* ResolveMesh(const RenderCommand& cmd)
+        {
+            auto model = ModelLibrary::Get(cmd.meshRend->ModelUUID);
+            if (!model || cmd.meshRend->MeshIndex >= model->GetMeshes().size()) return nullptr;
+            return model->GetMeshes()[cmd.meshRend->MeshIndex].get();
+        }
+
+        MeshIndexRange LodRange(const Mesh& mesh, u32 lod)
+        {
+            const auto& lods = mesh.GetLods();
+            if (lods.empty()) return { 0, mesh.GetAllocation().IndexCount };
+
+            const MeshLod& level = lods[std::min<u32>(lod, static_cast<u32>(lods.size()) - 1)];
+            return { level.IndexOffset, level.IndexCount };
+        }
+    }
+
+    void InstanceBatcher::Build(const std::vector<RenderCommand>& commands, bool sort, bool frontToBack)
+    {
+        m_Commands = commands;
+        m_Batches.clear();
+        m_Instances.clear();
+
+        if (sort) {
+            std::stable_sort(m_Commands.begin(), m_Commands.end(), [](const auto& a, const auto& b) {
+                return BatchKey(a) < BatchKey(b);
+            });
+        }
+
+        for (u32 i = 0; i < m_Commands.size(); ++i) {
+            const RenderCommand& cmd = m_Commands[i];
+            m_Instances.push_back({ cmd.transform->matrix });
+
+            // Skinned meshes each have their own pose, never merge them
+            if (!m_Batches.empty() && !cmd.meshRend->isSkinned) {
+                const RenderCommand& first = m_Commands[m_Batches.back().First];
+                if (!first.meshRend->isSkinned && BatchKey(first) == BatchKey(cmd)) {
+                    m_Batches.back().Count++;
+                    m_Batches.back().Distance = std::min(m_Batches.back().Distance, cmd.distance);
+                    continue;
+                }
+            }
+            m_Batches.push_back({ i, 1, cmd.distance });
+        }
+
+        // Batches keep their instance ranges, only the submission order changes
+        if (frontToBack) {
+            std::stable_sort(m_Batches.begin(), m_Batches.end(), [](const Batch& a, const Batch& b) {
+                return a.Distance < b.Distance;
+            });
+        }
+    }
+
+    void InstanceBatcher::BuildSteps(const RenderContext& ctx, bool depthOnly)
+    {
+        m_Steps.clear();
+        m_DrawList.Clear();
+
+        for (u32 b = 0; b < m_Batches.size(); ++b) {
+            const Batch& batch = m_Batches[b];
+            const RenderCommand& first = m_Commands[batch.First];
+            const Mesh* mesh = ResolveMesh(first);
+            if (!mesh) continue;
+
+            if (first.meshRend->isSkinned || !mesh->IsPooled()) {
+                m_Steps.push_back({ false, b });
+                continue;
+            }
+
+            // Quantized meshes carry their own decode uniforms, they cannot share a group
+            const u32 pool = mesh->GetAllocation().Pool;
+            const u32 indexSize = mesh->GetAllocation().IndexSize;
+            const Mesh* decodeMesh = mesh->GetVertexDecode().Quantized ? mesh : nullptr;
+            const bool noMaterial = depthOnly && !RenderUtils::NeedsDepthMaterial(RenderUtils::ResolveMaterial(*first.meshRend).get());
+
+            const Step* last = m_Steps.empty() ? nullptr : &m_Steps.back();
+            const bool sameMaterial = last && ((last->NoMaterial && noMaterial) ||
+                m_Commands[m_Batches[last->Batch].First].meshRend->MaterialUUID == first.meshRend->MaterialUUID);
+            const bool sameGroup = last && last->Indirect && last->Pool == pool && last->IndexSize == indexSize &&
+                last->DecodeMesh == decodeMesh && sameMaterial &&
+                m_Commands[m_Batches[last->Batch].First].singleSided == first.singleSided;
+
+            if (!sameGroup) {
+                const u32 stepIndex = static_cast<u32>(m_Steps.size());
+                m_DrawList.BeginGroup(stepIndex);
+                m_Steps.push_back({ true, b, static_cast<u32>(m_DrawList.GetGroups().size()) - 1, pool, indexSize, noMaterial, decodeMesh });
+            }
+
+            // A single command keeps its visible clusters, instances draw the whole LOD
+            if (batch.Count == 1 && first.rangeCount > 0) {
+                m_DrawList.Add(mesh->GetAllocation(), ctx.clusterRanges.data() + first.firstRange, first.rangeCount,
+                               1, batch.First);
+            }
+            else {
+                const MeshIndexRange range = LodRange(*mesh, first.lod);
+                m_DrawList.Add(mesh->GetAllocation(), &range, 1, batch.Count, batch.First);
+            }
+        }
+    }
+
+    void InstanceBatcher::Upload()
+    {
+        GLUploadRing::Bind(GL_SHADER_STORAGE_BUFFER, k_InstanceBinding,
+                           GLUploadRing::Upload(m_Instances.data(), m_Instances.size() * sizeof(InstanceGPU)));
+
+        const auto& commands = m_DrawList.GetCommands();
+        const UploadAllocation indirect = GLUploadRing::Upload(commands.data(),
+            commands.size() * sizeof(DrawElementsIndirectCommand), alignof(DrawElementsIndirectCommand));
+        m_IndirectBuffer = indirect.Buffer;
+        m_IndirectOffset = indirect.Offset;
+    }
+
+    void InstanceBatcher::Draw(const RenderContext& ctx, Shader& shader, u32 passKeywords, bool depthOnly)
+    {
+        m_DrawCount = 0;
+        if (m_Commands.empty()) return;
+
+        BuildSteps(ctx, depthOnly);
+        const bool anyIndirect = !m_DrawList.GetCommands().empty();
+        if (anyIndirect) Upload();
+
+        shader.Bind();
+        shader.SetBool(LH_PROP("u_IsInstanced"), false);
+        if (anyIndirect) glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBuffer);
+
+        const auto& groups = m_DrawList.GetGroups();
+        for (u32 s = 0; s < m_Steps.size(); ++s) {
+            const Step& step = m_Steps[s];
+            const Batch& batch = m_Batches[step.Batch];
+            const RenderCommand& first = m_Commands[batch.First];
+
+            if (!step.Indirect) {
+                for (u32 i = 0; i < batch.Count; ++i) {
+                    RenderUtils::DrawCommand(ctx, m_Commands[batch.First + i], shader, true, passKeywords, depthOnly);
+                    ++m_DrawCount;
+                }
+                continue;
+            }
+
+            // Groups that ended up empty were reused by the next step
+            const auto& group = groups[step.Group];
+            if (group.Tag != s || group.CommandCount == 0) continue;
+
+            RenderUtils::BindMaterial(*first.meshRend, shader, passKeywords, depthOnly);
+            RenderUtils::SetFaceCulling(first);
+            RenderUtils::SetVertexDecode(*ResolveMesh(first), shader);
+            shader.SetBool(LH_PROP("u_IsInstanced"), true);
+
+            GLGeometryPool::Bind(step.Pool, step.IndexSize);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, step.IndexSize == sizeof(u16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                reinterpret_cast<const void*>(static_cast<uintptr_t>(m_IndirectOffset + group.FirstCommand * sizeof(DrawElementsIndirectCommand))),
+                static_cast<GLsizei>(group.CommandCount), 0);
+
+            shader.SetBool(LH_PROP("u_IsInstanced"), false);
+            ++m_DrawCount;
+        }
+
+        if (anyIndirect) glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "luth/renderer/IndirectDraw.h"
+#include "luth/renderer/pipeline/RenderPass.h"
+
+#include <vector>
+
+namespace Luth
+{
+    // Merges render commands sharing model / mesh / material / LOD into instances and turns
+    // them into indirect commands over the shared geometry pool: one glMultiDrawElementsIndirect
+    // per material and vertex format. World matrices are streamed to an SSBO read by the
+    // geometry and forward shaders through gl_BaseInstance + gl_InstanceID.
+    class InstanceBatcher
+    {
+    public:
+        // Matches 'InstanceData' in LuthDeferredGeo.glsl / LuthForwardLight.glsl
+        struct InstanceGPU {
+            Mat4 Model;
+        };
+
+        InstanceBatcher() = default;
+
+        InstanceBatcher(const InstanceBatcher&) = delete;
+        InstanceBatcher& operator=(const InstanceBatcher&) = delete;
+
+        // 'sort' groups every matching command, by material first. Without it the order is
+        // kept (back-to-front transparency) and only neighbouring commands are merged.
+        // 'frontToBack' then orders the batches by their nearest command, for early-Z at the
+        // cost of fewer merged multi-draws
+        void Build(const std::vector<RenderCommand>& commands, bool sort, bool frontToBack = false);
+
+        // Builds the indirect commands, uploads them with the instance stream and issues
+        // one multi-draw per group. Skinned and non-pooled meshes keep the per-command path.
+        // depthOnly: see RenderUtils::BindMaterial, materials other than cutout then share groups
+        void Draw(const RenderContext& ctx, Shader& shader, u32 passKeywords = 0, bool depthOnly = false);
+
+        u32 GetBatchCount() const { return static_cast<u32>(m_Batches.size()); }
+        u32 GetDrawCount() const { return m_DrawCount; }
+        u32 GetIndirectCount() const { return static_cast<u32>(m_DrawList.GetCommands().size()); }
+
+    private:
+        struct Batch {
+            u32 First = 0;
+            u32 Count = 0;
+            f32 Distance = 0.0f;    // Nearest command
+        };
+
+        // One multi-draw (a group of m_DrawList) or one regular batch, in submission order
+        struct Step {
+            bool Indirect = false;
+            u32 Batch = 0;          // Carries the material and vertex decode of the step
+            u32 Group = 0;
+            u32 Pool = 0;
+            u32 IndexSize = 4;      // Index arena of the pool
+            bool NoMaterial = false;    // Depth-only and not cutout: no material state is read
+            const Mesh* DecodeMesh = nullptr;   // Set when the group depends on per-mesh decode uniforms
+        };
+
+        void BuildSteps(const RenderContext& ctx, bool depthOnly);
+        void Upload();
+
+        std::vector<RenderCommand> m_Commands;
+        std::vector<Batch> m_Batches;
+        std::vector<InstanceGPU> m_Instances;
+        std::vector<Step> m_Steps;
+        IndirectDrawList m_DrawList;
+        u32 m_DrawCount = 0;
+
+        // This frame's indirect commands in the upload ring
+        u32 m_IndirectBuffer = 0;
+        u32 m_IndirectOffset = 0;
+    };
+}
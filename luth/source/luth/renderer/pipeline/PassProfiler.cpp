@@ -0,0 +1,216 @@
+#include "luthpch.h"
+#include "luth/renderer/pipeline/PassProfiler.h"
+
+#include <glad/glad.h>
+
+#include <iomanip>
+
+namespace Luth
+{
+    void PassProfiler::Window::Push(f32 sample)
+    {
+        Samples[Next] = sample;
+        Next = (Next + 1) % k_WindowSize;
+        Count = std::min(Count + 1, k_WindowSize);
+    }
+
+    PassProfiler::Timing PassProfiler::Window::Compute() const
+    {
+        Timing timing;
+        if (Count == 0) return timing;
+
+        std::array<f32, k_WindowSize> sorted;
+        std::copy_n(Samples.begin(), Count, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + Count);
+
+        f32 sum = 0.0f;
+        for (u32 i = 0; i < Count; ++i) sum += sorted[i];
+
+        timing.Average = sum / Count;
+        timing.Median = sorted[Count / 2];
+        timing.P95 = sorted[std::min(Count - 1, static_cast<u32>(Count * 0.95f))];
+        timing.Max = sorted[Count - 1];
+        return timing;
+    }
+
+    PassProfiler::PassProfiler() : m_Epoch(Clock::now()) {}
+
+    PassProfiler::~PassProfiler()
+    {
+        for (QuerySet& set : m_Queries) {
+            if (!set.Queries.empty())
+                glDeleteQueries(static_cast<GLsizei>(set.Queries.size()), set.Queries.data());
+        }
+    }
+
+    void PassProfiler::BeginFrame(u32 passCount)
+    {
+        m_Recording = nullptr;
+        if (!m_Enabled) return;
+
+        if (m_TimerBits < 0) {
+            GLint bits = 0;
+            glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &bits);
+            m_TimerBits = bits;
+            if (bits == 0) LH_CORE_WARN("GPU timer queries unsupported, only CPU pass times are recorded");
+        }
+
+        if (m_Passes.size() != passCount) m_Passes.resize(passCount);
+        for (PassData& pass : m_Passes) pass.Active = false;
+
+        ++m_Frame;
+        QuerySet& set = m_Queries[m_Frame % k_FramesInFlight];
+        Resolve(set);
+        set.Frame = m_Frame;
+
+        m_Trace.push_back({ m_Frame, {} });
+        while (m_Trace.size() > k_TraceFrames) m_Trace.pop_front();
+        m_Recording = &m_Trace.back();
+    }
+
+    void PassProfiler::BeginPass(u32 pass, const char* name)
+    {
+        if (!m_Recording || pass >= m_Passes.size()) return;
+
+        PassData& data = m_Passes[pass];
+        if (data.Name != name) {
+            data.Name = name;
+            data.Cpu.Clear();
+            data.Gpu.Clear();
+        }
+        data.Active = true;
+
+        // Queries and events line up: the n-th query of a frame times its n-th event
+        if (HasGpuTimer()) {
+            QuerySet& set = m_Queries[m_Frame % k_FramesInFlight];
+            if (set.Used == set.Queries.size()) {
+                u32 query = 0;
+                glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+                set.Queries.push_back(query);
+            }
+            glBeginQuery(GL_TIME_ELAPSED, set.Queries[set.Used++]);
+        }
+
+        m_Recording->Events.push_back({ pass, Now() });
+        m_PassOpen = true;
+    }
+
+    void PassProfiler::EndPass()
+    {
+        if (!m_Recording || !m_PassOpen) return;
+        m_PassOpen = false;
+
+        if (HasGpuTimer()) glEndQuery(GL_TIME_ELAPSED);
+
+        // CPU side: the time spent recording the pass' commands
+        Event& event = m_Recording->Events.back();
+        event.CpuDuration = Now() - event.CpuStart;
+        m_Passes[event.Pass].Cpu.Push(static_cast<f32>(event.CpuDuration / 1000.0));
+    }
+
+    void PassProfiler::EndFrame()
+    {
+        if (!m_Recording) return;
+
+        // Culled passes start over when they come back
+        for (PassData& pass : m_Passes) {
+            if (pass.Active) continue;
+            pass.Cpu.Clear();
+            pass.Gpu.Clear();
+        }
+        m_Recording = nullptr;
+    }
+
+    void PassProfiler::Resolve(QuerySet& set)
+    {
+        FrameRecord* record = FindFrame(set.Frame);
+
+        f64 total = 0.0;
+        u32 i = 0;
+        for (; i < set.Used; ++i) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(set.Queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;      // Still in flight: dropped, the slot is reused now
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(set.Queries[i], GL_QUERY_RESULT, &nanoseconds);
+            total += nanoseconds / 1'000'000.0;
+            if (!record || i >= record->Events.size()) continue;
+
+            Event& event = record->Events[i];
+            event.GpuDuration = nanoseconds / 1000.0;
+            if (event.Pass < m_Passes.size())
+                m_Passes[event.Pass].Gpu.Push(static_cast<f32>(nanoseconds / 1'000'000.0));
+        }
+
+        // Only frames read back whole
+        if (i > 0 && i == set.Used) m_GpuFrameTime = static_cast<f32>(total);
+        set.Used = 0;
+    }
+
+    PassProfiler::FrameRecord* PassProfiler::FindFrame(u64 frame)
+    {
+        if (m_Trace.empty()) return nullptr;
+
+        const u64 last = m_Trace.back().Frame;
+        if (frame > last || last - frame >= m_Trace.size()) return nullptr;
+
+        FrameRecord& record = m_Trace[m_Trace.size() - 1 - static_cast<size_t>(last - frame)];
+        return record.Frame == frame ? &record : nullptr;
+    }
+
+    f64 PassProfiler::Now() const
+    {
+        return std::chrono::duration<f64, std::micro>(Clock::now() - m_Epoch).count();
+    }
+
+    std::vector<PassProfiler::PassStats> PassProfiler::GetStats() const
+    {
+        std::vector<PassStats> stats;
+        if (m_Trace.empty()) return stats;
+
+        for (const Event& event : m_Trace.back().Events) {
+            const PassData& pass = m_Passes[event.Pass];
+            stats.push_back({ pass.Name, pass.Cpu.Compute(), pass.Gpu.Compute() });
+        }
+        return stats;
+    }
+
+    bool PassProfiler::ExportTrace(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            LH_CORE_WARN("Could not write render trace {0}", path.string());
+            return false;
+        }
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+        auto write = [&](const std::string& name, u32 thread, f64 start, f64 duration, u64 frame) {
+            file << ",\n{\"name\":\"" << name << "\",\"cat\":\"render\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+                 << ",\"ts\":" << start << ",\"dur\":" << duration << ",\"args\":{\"frame\":" << frame << "}}";
+        };
+
+        for (const FrameRecord& record : m_Trace) {
+            // Elapsed-time queries carry no start time. GPU passes run back to back and
+            // none can start before its commands were recorded
+            f64 gpuCursor = 0.0;
+            for (const Event& event : record.Events) {
+                const std::string& name = m_Passes[event.Pass].Name;
+                write(name, 1, event.CpuStart, event.CpuDuration, record.Frame);
+                if (event.GpuDuration < 0.0) continue;
+
+                const f64 gpuStart = std::max(gpuCursor, event.CpuStart);
+                write(name, 2, gpuStart, event.GpuDuration, record.Frame);
+                gpuCursor = gpuStart + event.GpuDuration;
+            }
+        }
+        file << "\n]}\n";
+
+        LH_CORE_INFO("Render trace of {0} frames written to {1}", m_Trace.size(), path.string());
+        return true;
+    }
+}
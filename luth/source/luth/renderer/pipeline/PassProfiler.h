@@ -0,0 +1,121 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Luth
+{
+    // CPU and GPU time of every pass the RenderPipeline executes. Each pass is wrapped in
+    // a GL_TIME_ELAPSED query, a frame's queries are read back k_FramesInFlight frames later
+    // and only if the results are there: a late result is dropped, never waited for.
+    // Samples feed a rolling window per pass, and the last frames are kept so they can be
+    // written out as a Chrome trace (chrome://tracing, Perfetto).
+    class PassProfiler
+    {
+    public:
+        static constexpr u32 k_FramesInFlight = 3;
+        static constexpr u32 k_WindowSize = 120;    // Samples per pass in the rolling stats
+        static constexpr u32 k_TraceFrames = 300;
+
+        // Milliseconds over the window
+        struct Timing {
+            f32 Average = 0.0f;
+            f32 Median = 0.0f;
+            f32 P95 = 0.0f;
+            f32 Max = 0.0f;
+        };
+
+        struct PassStats {
+            std::string Name;
+            Timing Cpu;
+            Timing Gpu;
+        };
+
+        PassProfiler();
+        ~PassProfiler();
+
+        PassProfiler(const PassProfiler&) = delete;
+        PassProfiler& operator=(const PassProfiler&) = delete;
+
+        // Collects the queries of the frame whose slot is reused, then records into it
+        void BeginFrame(u32 passCount);
+        void BeginPass(u32 pass, const char* name);
+        void EndPass();
+        void EndFrame();
+
+        void SetEnabled(bool enabled) { m_Enabled = enabled; }
+        bool IsEnabled() const { return m_Enabled; }
+
+        // False when the driver's timer has no bits (some software rasterizers), CPU times still work
+        bool HasGpuTimer() const { return m_TimerBits > 0; }
+
+        // GPU time of all passes of the latest frame read back, ms. 0 until there is one
+        f32 GetGpuFrameTime() const { return m_GpuFrameTime; }
+
+        // Passes executed in the last frame, in execution order
+        std::vector<PassStats> GetStats() const;
+
+        bool ExportTrace(const std::filesystem::path& path) const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Window {
+            std::array<f32, k_WindowSize> Samples{};
+            u32 Count = 0;
+            u32 Next = 0;
+
+            void Push(f32 sample);
+            void Clear() { Count = Next = 0; }
+            Timing Compute() const;
+        };
+
+        struct PassData {
+            std::string Name;
+            Window Cpu;
+            Window Gpu;
+            bool Active = false;    // Executed last frame
+        };
+
+        struct Event {
+            u32 Pass = 0;
+            f64 CpuStart = 0.0;     // us since the profiler was created
+            f64 CpuDuration = 0.0;
+            f64 GpuDuration = -1.0; // Until the query is read back
+        };
+
+        struct FrameRecord {
+            u64 Frame = 0;
+            std::vector<Event> Events;
+        };
+
+        struct QuerySet {
+            u64 Frame = 0;
+            u32 Used = 0;
+            std::vector<u32> Queries;
+        };
+
+        void Resolve(QuerySet& set);
+        FrameRecord* FindFrame(u64 frame);
+        f64 Now() const;
+
+        bool m_Enabled = true;
+        i32 m_TimerBits = -1;       // -1 until queried
+        u64 m_Frame = 0;
+        f32 m_GpuFrameTime = 0.0f;
+        Clock::time_point m_Epoch;
+
+        std::vector<PassData> m_Passes;
+        std::array<QuerySet, k_FramesInFlight> m_Queries;
+        std::deque<FrameRecord> m_Trace;
+
+        FrameRecord* m_Recording = nullptr;
+        bool m_PassOpen = false;
+    };
+}
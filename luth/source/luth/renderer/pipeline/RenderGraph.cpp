@@ -0,0 +1,409 @@
+#include "Luthpch.h"
+#include "luth/renderer/pipeline/RenderGraph.h"
+#include "luth/renderer/openGL/GLState.h"
+
+#include <numeric>
+#include <queue>
+
+namespace Luth
+{
+    namespace
+    {
+        size_t BytesPerPixel(GLenum format)
+        {
+            switch (format) {
+                case GL_R8:                 return 1;
+                case GL_R16F:               return 2;
+                case GL_RGB16F:             return 6;
+                case GL_RGBA16F:            return 8;
+                case GL_RGBA32F:            return 16;
+                case GL_DEPTH32F_STENCIL8:  return 8;
+                default:                    return 4;   // RGBA8, RG16F, R11F_G11F_B10F, D24S8...
+            }
+        }
+
+        bool HasStencil(GLenum format)
+        {
+            return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+        }
+    }
+
+    // Builder ============================================================
+
+    RGHandle RenderGraphBuilder::Create(std::string_view name, const RGTextureDesc& desc)
+    {
+        const RGHandle handle = m_Graph.Declare(name);
+        auto& resource = m_Graph.m_Resources[handle];
+        if (resource.Creator != ~0u) {
+            LH_CORE_ERROR("Render graph: '{0}' is created by both '{1}' and '{2}'", resource.Name,
+                          m_Graph.m_Passes[resource.Creator].Name, m_Graph.m_Passes[m_Pass].Name);
+            return handle;
+        }
+        resource.Desc = desc;
+        resource.Creator = m_Pass;
+        m_Graph.Use(m_Pass, handle, RenderGraph::Access::Create);
+        return handle;
+    }
+
+    RGHandle RenderGraphBuilder::Import(std::string_view name, u32 texture, const RGTextureDesc& desc)
+    {
+        const RGHandle handle = Create(name, desc);
+        m_Graph.m_Resources[handle].Imported = true;
+        m_Graph.m_Imports[handle] = texture;
+        return handle;
+    }
+
+    RGHandle RenderGraphBuilder::Read(std::string_view name)
+    {
+        const RGHandle handle = m_Graph.Declare(name);
+        m_Graph.Use(m_Pass, handle, RenderGraph::Access::Read);
+        return handle;
+    }
+
+    RGHandle RenderGraphBuilder::Write(std::string_view name)
+    {
+        const RGHandle handle = m_Graph.Declare(name);
+        m_Graph.Use(m_Pass, handle, RenderGraph::Access::Write);
+        return handle;
+    }
+
+    u32 RenderGraphBuilder::GetWidth() const { return m_Graph.m_Width; }
+    u32 RenderGraphBuilder::GetHeight() const { return m_Graph.m_Height; }
+
+    // Declarations =======================================================
+
+    RenderGraph::~RenderGraph()
+    {
+        ReleaseFramebuffers();
+        for (const auto& texture : m_Pool)
+            GLState::DeleteTextures(1, &texture.ID);
+    }
+
+    void RenderGraph::Begin(u32 width, u32 height)
+    {
+        m_Width = width;
+        m_Height = height;
+        m_Passes.clear();
+        m_Resources.clear();
+        m_Names.clear();
+        m_Imports.clear();
+    }
+
+    RenderGraphBuilder RenderGraph::AddPass(std::string_view name)
+    {
+        m_Passes.push_back({ .Name = std::string(name) });
+        return RenderGraphBuilder(*this, static_cast<u32>(m_Passes.size()) - 1);
+    }
+
+    RGHandle RenderGraph::Declare(std::string_view name)
+    {
+        auto [it, inserted] = m_Names.try_emplace(std::string(name), static_cast<RGHandle>(m_Resources.size()));
+        if (inserted) {
+            m_Resources.push_back({ .Name = std::string(name) });
+            m_Imports.push_back(0);
+        }
+        return it->second;
+    }
+
+    void RenderGraph::Use(u32 pass, RGHandle handle, Access access)
+    {
+        // One entry per resource, the strongest access wins
+        auto& uses = m_Passes[pass].Uses;
+        for (auto& [h, a] : uses) {
+            if (h != handle) continue;
+            if (access == Access::Create || (access == Access::Write && a == Access::Read)) a = access;
+            return;
+        }
+        uses.emplace_back(handle, access);
+    }
+
+    // Compilation ========================================================
+
+    void RenderGraph::Compile(std::string_view output)
+    {
+        if (m_Compiled && output == m_CompiledOutput && m_Passes == m_CompiledPasses && m_Resources == m_CompiledResources) {
+            for (RGHandle h = 0; h < m_Resources.size(); ++h)
+                if (m_Resources[h].Imported) m_Textures[h] = m_Imports[h];
+            return;
+        }
+
+        m_Compiled = true;
+        m_CompiledOutput = output;
+        m_CompiledPasses = m_Passes;
+        m_CompiledResources = m_Resources;
+
+        for (const auto& resource : m_Resources)
+            if (resource.Creator == ~0u) LH_CORE_ERROR("Render graph: no pass creates '{0}'", resource.Name);
+
+        if (!Order()) {
+            LH_CORE_ERROR("Render graph: dependency cycle, running passes in declaration order");
+            m_Order.resize(m_Passes.size());
+            std::iota(m_Order.begin(), m_Order.end(), 0u);
+        }
+
+        auto it = m_Names.find(std::string(output));
+        Cull(it != m_Names.end() ? it->second : k_NoResource);
+        Allocate();
+    }
+
+    bool RenderGraph::Order()
+    {
+        const u32 passCount = static_cast<u32>(m_Passes.size());
+        std::vector<std::vector<u32>> edges(passCount);
+        std::vector<u32> inDegree(passCount, 0);
+        auto addEdge = [&](u32 from, u32 to) {
+            if (from == to) return;
+            edges[from].push_back(to);
+            ++inDegree[to];
+        };
+
+        // Writers: creator first, then the others as declared. Readers see the last write
+        for (RGHandle h = 0; h < m_Resources.size(); ++h) {
+            std::vector<u32> writers, readers;
+            if (m_Resources[h].Creator != ~0u) writers.push_back(m_Resources[h].Creator);
+            for (u32 p = 0; p < passCount; ++p) {
+                for (const auto& [handle, access] : m_Passes[p].Uses) {
+                    if (handle != h) continue;
+                    if (access == Access::Write) writers.push_back(p);
+                    else if (access == Access::Read) readers.push_back(p);
+                }
+            }
+
+            for (size_t i = 1; i < writers.size(); ++i) addEdge(writers[i - 1], writers[i]);
+            if (!writers.empty())
+                for (u32 reader : readers) addEdge(writers.back(), reader);
+        }
+
+        // Kahn's, lowest declaration index first so independent passes keep their order
+        std::priority_queue<u32, std::vector<u32>, std::greater<u32>> ready;
+        for (u32 p = 0; p < passCount; ++p)
+            if (inDegree[p] == 0) ready.push(p);
+
+        m_Order.clear();
+        while (!ready.empty()) {
+            const u32 p = ready.top();
+            ready.pop();
+            m_Order.push_back(p);
+            for (u32 next : edges[p])
+                if (--inDegree[next] == 0) ready.push(next);
+        }
+        return m_Order.size() == passCount;
+    }
+
+    void RenderGraph::Cull(RGHandle output)
+    {
+        const u32 passCount = static_cast<u32>(m_Passes.size());
+        std::vector<u32> position(passCount);
+        for (u32 i = 0; i < m_Order.size(); ++i) position[m_Order[i]] = i;
+
+        // Unknown output: nothing to trace from, run everything
+        if (output == k_NoResource) {
+            m_Live.assign(passCount, true);
+            return;
+        }
+
+        // Passes that write a resource before a given point in the order
+        auto writersBefore = [&](RGHandle h, u32 limit, std::vector<u32>& out) {
+            for (u32 p = 0; p < passCount; ++p) {
+                if (position[p] >= limit) continue;
+                for (const auto& [handle, access] : m_Passes[p].Uses)
+                    if (handle == h && access != Access::Read) out.push_back(p);
+            }
+        };
+
+        m_Live.assign(passCount, false);
+        std::vector<u32> pending;
+        writersBefore(output, passCount, pending);
+        while (!pending.empty()) {
+            const u32 p = pending.back();
+            pending.pop_back();
+            if (m_Live[p]) continue;
+            m_Live[p] = true;
+
+            // Writes keep the previous contents, so they depend on earlier writers too
+            for (const auto& [handle, access] : m_Passes[p].Uses)
+                if (access != Access::Create) writersBefore(handle, position[p], pending);
+        }
+
+        std::erase_if(m_Order, [&](u32 p) { return !m_Live[p]; });
+    }
+
+    void RenderGraph::Allocate()
+    {
+        const u32 resourceCount = static_cast<u32>(m_Resources.size());
+        const u32 end = static_cast<u32>(m_Order.size());
+
+        // Lifetimes in execution positions, the output lives to the end of the frame
+        std::vector<u32> first(resourceCount, end), last(resourceCount, 0);
+        for (u32 i = 0; i < end; ++i) {
+            for (const auto& [handle, access] : m_Passes[m_Order[i]].Uses) {
+                first[handle] = std::min(first[handle], i);
+                last[handle] = std::max(last[handle], i);
+            }
+        }
+        if (auto it = m_Names.find(m_CompiledOutput); it != m_Names.end()) last[it->second] = end;
+
+        std::vector<RGHandle> transients;
+        for (RGHandle h = 0; h < resourceCount; ++h)
+            if (first[h] < end && !m_Resources[h].Imported && m_Resources[h].Creator != ~0u) transients.push_back(h);
+        std::stable_sort(transients.begin(), transients.end(), [&](RGHandle a, RGHandle b) { return first[a] < first[b]; });
+
+        // Textures from the previous compile are reused before creating any
+        std::vector<PhysicalTexture> previous = std::move(m_Pool);
+        m_Pool.clear();
+
+        auto acquire = [&](const RGTextureDesc& desc) {
+            auto it = std::find_if(previous.begin(), previous.end(), [&](const auto& t) { return t.Desc == desc; });
+            if (it != previous.end()) {
+                m_Pool.push_back(*it);
+                previous.erase(it);
+            }
+            else {
+                PhysicalTexture texture{ 0, desc };
+                glCreateTextures(GL_TEXTURE_2D, 1, &texture.ID);
+                glTextureStorage2D(texture.ID, 1, desc.Format, desc.Width, desc.Height);
+                glTextureParameteri(texture.ID, GL_TEXTURE_MIN_FILTER, desc.Filter);
+                glTextureParameteri(texture.ID, GL_TEXTURE_MAG_FILTER, desc.Filter);
+                glTextureParameteri(texture.ID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTextureParameteri(texture.ID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                m_Pool.push_back(texture);
+            }
+            return static_cast<u32>(m_Pool.size()) - 1;
+        };
+
+        m_Textures.assign(resourceCount, 0);
+        m_Stats = { .Passes = static_cast<u32>(m_Passes.size()), .Culled = static_cast<u32>(m_Passes.size()) - end };
+
+        std::vector<std::pair<u32, u32>> active;    // (last use, pool index)
+        std::vector<u32> available;
+        for (RGHandle h : transients) {
+            std::erase_if(active, [&](const auto& entry) {
+                if (entry.first >= first[h]) return false;
+                available.push_back(entry.second);
+                return true;
+            });
+
+            const RGTextureDesc& desc = m_Resources[h].Desc;
+            auto it = std::find_if(available.begin(), available.end(), [&](u32 i) { return m_Pool[i].Desc == desc; });
+            u32 index;
+            if (it != available.end()) {
+                index = *it;
+                available.erase(it);
+            }
+            else {
+                index = acquire(desc);
+            }
+
+            active.emplace_back(last[h], index);
+            m_Textures[h] = m_Pool[index].ID;
+            ++m_Stats.Textures;
+            m_Stats.RequestedBytes += size_t(desc.Width) * desc.Height * BytesPerPixel(desc.Format);
+        }
+
+        for (RGHandle h = 0; h < resourceCount; ++h)
+            if (m_Resources[h].Imported) m_Textures[h] = m_Imports[h];
+
+        for (const auto& texture : m_Pool) {
+            ++m_Stats.PhysicalTextures;
+            m_Stats.AllocatedBytes += size_t(texture.Desc.Width) * texture.Desc.Height * BytesPerPixel(texture.Desc.Format);
+        }
+
+        // Framebuffers may reference what's going away
+        if (!previous.empty()) {
+            ReleaseFramebuffers();
+            for (const auto& texture : previous)
+                GLState::DeleteTextures(1, &texture.ID);
+        }
+    }
+
+    void RenderGraph::ReleaseFramebuffers()
+    {
+        for (const auto& [key, fbo] : m_Framebuffers)
+            GLState::DeleteFramebuffers(1, &fbo);
+        m_Framebuffers.clear();
+    }
+
+    // Execution ==========================================================
+
+    void RenderGraph::BindTexture(RGHandle handle, u32 slot) const
+    {
+        GLState::BindTextureUnit(slot, GetTexture(handle));
+    }
+
+    void RenderGraph::BindTarget(std::initializer_list<RGHandle> colors, RGHandle depth)
+    {
+        std::vector<u32> key;
+        key.reserve(colors.size() + 1);
+        for (RGHandle color : colors) key.push_back(GetTexture(color));
+        key.push_back(depth != k_NoResource ? GetTexture(depth) : 0);
+
+        auto [it, inserted] = m_Framebuffers.try_emplace(std::move(key), 0);
+        if (inserted) {
+            u32& fbo = it->second;
+            glCreateFramebuffers(1, &fbo);
+
+            std::vector<GLenum> drawBuffers;
+            for (RGHandle color : colors) {
+                const GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers.size());
+                glNamedFramebufferTexture(fbo, attachment, GetTexture(color), 0);
+                drawBuffers.push_back(attachment);
+            }
+            if (drawBuffers.empty()) glNamedFramebufferDrawBuffer(fbo, GL_NONE);
+            else glNamedFramebufferDrawBuffers(fbo, static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+
+            if (depth != k_NoResource) {
+                const GLenum attachment = HasStencil(GetDesc(depth).Format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+                glNamedFramebufferTexture(fbo, attachment, GetTexture(depth), 0);
+            }
+
+            const GLenum status = glCheckNamedFramebufferStatus(fbo, GL_FRAMEBUFFER);
+            if (status != GL_FRAMEBUFFER_COMPLETE)
+                LH_CORE_ERROR("Render graph framebuffer is incomplete: {0}", status);
+        }
+
+        const RGTextureDesc& extent = GetDesc(colors.size() ? *colors.begin() : depth);
+        GLState::BindFramebuffer(it->second);
+        if (extent.Scaled) GLState::Viewport(0, 0, ScaleExtent(extent.Width), ScaleExtent(extent.Height));
+        else GLState::Viewport(0, 0, extent.Width, extent.Height);
+    }
+
+    Vec2 RenderGraph::GetUVScale(RGHandle handle) const
+    {
+        if (handle >= m_Resources.size()) return Vec2(1.0f);
+
+        const RGTextureDesc& desc = m_Resources[handle].Desc;
+        if (!desc.Scaled || desc.Width == 0 || desc.Height == 0) return Vec2(1.0f);
+        return Vec2(static_cast<f32>(ScaleExtent(desc.Width)) / desc.Width,
+                    static_cast<f32>(ScaleExtent(desc.Height)) / desc.Height);
+    }
+
+    // Introspection ======================================================
+
+    u32 RenderGraph::GetTexture(std::string_view name) const
+    {
+        auto it = m_Names.find(std::string(name));
+        return it != m_Names.end() ? GetTexture(it->second) : 0;
+    }
+
+    Vec2 RenderGraph::GetUVScale(std::string_view name) const
+    {
+        auto it = m_Names.find(std::string(name));
+        return it != m_Names.end() ? GetUVScale(it->second) : Vec2(1.0f);
+    }
+
+    std::vector<std::pair<std::string, u32>> RenderGraph::GetTextures() const
+    {
+        std::vector<std::pair<std::string, u32>> textures;
+        for (RGHandle h = 0; h < m_Resources.size(); ++h)
+            if (GetTexture(h)) textures.emplace_back(m_Resources[h].Name, GetTexture(h));
+        return textures;
+    }
+
+    std::vector<std::string> RenderGraph::GetCulledPasses() const
+    {
+        std::vector<std::string> culled;
+        for (u32 p = 0; p < m_Passes.size(); ++p)
+            if (p < m_Live.size() && !m_Live[p]) culled.push_back(m_Passes[p].Name);
+        return culled;
+    }
+}
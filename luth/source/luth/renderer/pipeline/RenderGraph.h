@@ -0,0 +1,180 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/core/Math.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Luth
+{
+    class RenderGraph;
+
+    using RGHandle = u32;
+    constexpr RGHandle k_NoResource = ~0u;
+
+    struct RGTextureDesc {
+        u32 Width = 0;
+        u32 Height = 0;
+        GLenum Format = GL_RGBA16F;
+        GLenum Filter = GL_LINEAR;
+        bool Scaled = true;     // Drawn at the render scale, false for display resolution targets
+
+        bool operator==(const RGTextureDesc&) const = default;
+    };
+
+    // Handed to RenderPass::Setup, records what the pass touches this frame. Names are
+    // resolved once every pass is declared, so the declaration order doesn't matter
+    class RenderGraphBuilder
+    {
+    public:
+        // New texture written by this pass. Transient: its memory may be shared with
+        // textures whose lifetimes don't overlap, so the first use must clear or overwrite it
+        RGHandle Create(std::string_view name, const RGTextureDesc& desc);
+
+        // Texture owned by the pass (history and such), written by it this frame
+        RGHandle Import(std::string_view name, u32 texture, const RGTextureDesc& desc);
+
+        // Sampled, or attached without being written (depth testing)
+        RGHandle Read(std::string_view name);
+
+        // Rendered into on top of the existing contents
+        RGHandle Write(std::string_view name);
+
+        // Display size. Textures are allocated for it, scaled ones are drawn into a corner
+        u32 GetWidth() const;
+        u32 GetHeight() const;
+
+    private:
+        friend class RenderGraph;
+        RenderGraphBuilder(RenderGraph& graph, u32 pass) : m_Graph(graph), m_Pass(pass) {}
+
+        RenderGraph& m_Graph;
+        u32 m_Pass;
+    };
+
+    // Frame graph over the pipeline's passes. Every frame each pass declares the named
+    // textures it creates, reads and writes. Compile then:
+    //   - orders the passes: a resource's creator, then its other writers in declaration
+    //     order, then its readers
+    //   - culls passes that don't contribute to the output resource
+    //   - gives transient textures with the same description and disjoint lifetimes the
+    //     same GL texture
+    // Scaled textures keep their size when the render scale changes: they are drawn into
+    // their lower-left corner (BindTarget's viewport) and sampled through RenderUV in the
+    // shaders, so dynamic resolution never reallocates.
+    // The result is reused while the declarations stay the same, so steady frames only
+    // pay for the declarations.
+    class RenderGraph
+    {
+    public:
+        struct Stats {
+            u32 Passes = 0;
+            u32 Culled = 0;
+            u32 Textures = 0;           // Transient, in executed passes
+            u32 PhysicalTextures = 0;
+            size_t RequestedBytes = 0;  // Had each transient its own texture
+            size_t AllocatedBytes = 0;
+        };
+
+        RenderGraph() = default;
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        // Declarations
+        void Begin(u32 width, u32 height);
+        RenderGraphBuilder AddPass(std::string_view name);
+        void Compile(std::string_view output);
+
+        // Pass indices (in AddPass order) to execute, and to skip
+        const std::vector<u32>& GetExecutionOrder() const { return m_Order; }
+        bool IsCulled(u32 pass) const { return !m_Live[pass]; }
+
+        // Execution
+        u32 GetTexture(RGHandle handle) const { return handle < m_Textures.size() ? m_Textures[handle] : 0; }
+        const RGTextureDesc& GetDesc(RGHandle handle) const { return m_Resources[handle].Desc; }
+        void BindTexture(RGHandle handle, u32 slot) const;
+
+        // Fraction of each axis scaled textures are drawn at
+        void SetRenderScale(f32 scale) { m_RenderScale = scale; }
+        f32 GetRenderScale() const { return m_RenderScale; }
+        u32 ScaleExtent(u32 size) const { return std::max(static_cast<u32>(std::ceil(size * m_RenderScale)), 1u); }
+
+        // Part of the texture holding this frame's image, in UVs
+        Vec2 GetUVScale(RGHandle handle) const;
+
+        // Binds a framebuffer over these textures and sets the viewport to their drawn size
+        void BindTarget(std::initializer_list<RGHandle> colors, RGHandle depth = k_NoResource);
+
+        // Last compiled frame, for the editor
+        u32 GetTexture(std::string_view name) const;
+        Vec2 GetUVScale(std::string_view name) const;
+        std::vector<std::pair<std::string, u32>> GetTextures() const;
+        const Stats& GetStats() const { return m_Stats; }
+        std::vector<std::string> GetCulledPasses() const;
+
+    private:
+        friend class RenderGraphBuilder;
+
+        enum class Access : u8 { Create, Read, Write };
+
+        struct PassDecl {
+            std::string Name;
+            std::vector<std::pair<RGHandle, Access>> Uses;
+            bool operator==(const PassDecl&) const = default;
+        };
+
+        struct ResourceDecl {
+            std::string Name;
+            RGTextureDesc Desc;
+            u32 Creator = ~0u;
+            bool Imported = false;
+            bool operator==(const ResourceDecl&) const = default;
+        };
+
+        struct PhysicalTexture {
+            u32 ID = 0;
+            RGTextureDesc Desc;
+        };
+
+        RGHandle Declare(std::string_view name);
+        void Use(u32 pass, RGHandle handle, Access access);
+
+        bool Order();
+        void Cull(RGHandle output);
+        void Allocate();
+        void ReleaseFramebuffers();
+
+        u32 m_Width = 0, m_Height = 0;
+        f32 m_RenderScale = 1.0f;
+
+        // This frame's declarations
+        std::vector<PassDecl> m_Passes;
+        std::vector<ResourceDecl> m_Resources;
+        std::unordered_map<std::string, RGHandle> m_Names;
+        std::vector<u32> m_Imports;     // Texture per resource, imported ones only
+
+        // Compiled from the previous declarations
+        std::vector<PassDecl> m_CompiledPasses;
+        std::vector<ResourceDecl> m_CompiledResources;
+        std::string m_CompiledOutput;
+        bool m_Compiled = false;
+
+        std::vector<u32> m_Order;
+        std::vector<bool> m_Live;
+        std::vector<u32> m_Textures;    // Per resource
+        std::vector<PhysicalTexture> m_Pool;
+        std::map<std::vector<u32>, u32> m_Framebuffers;
+        Stats m_Stats;
+    };
+}
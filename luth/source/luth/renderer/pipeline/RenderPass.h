@@ -3,6 +3,8 @@
 #include "luth/renderer/Renderer.h"
 #include "luth/renderer/Framebuffer.h"
 #include "luth/renderer/Shader.h"
+#include "luth/renderer/Meshlet.h"
+#include "luth/renderer/pipeline/RenderGraph.h"
 #include "luth/ECS/Components.h"
 #include "luth/core/Math.h"
 
@@ -19,6 +21,10 @@ namespace Luth
         WorldTransform* transform;
         MeshRenderer* meshRend;
         float distance;
+        u32 lod = 0;
+        u32 firstRange = 0;     // Visible clusters in RenderContext::clusterRanges,
+        u32 rangeCount = 0;     // none: the whole LOD is drawn
+        bool singleSided = false;   // Back faces culled, by the rasterizer and the cluster normal cones
     };
 
     struct RenderContext
@@ -26,18 +32,28 @@ namespace Luth
         RenderPipeline* pipeline = nullptr;
         entt::registry& registry;
         Vec3 cameraPos;
+        Mat4 view;
+        Mat4 projection;
         std::vector<RenderCommand> opaque;
         std::vector<RenderCommand> transparent;
+        std::vector<RenderCommand> baked;       // Opaque, with BakedAnimation
+        std::vector<MeshIndexRange> clusterRanges;     // Meshlets surviving culling, compacted per frame
         u32 width, height;
     };
 
+    // Passes own their shaders and persistent state. Textures shared with other passes
+    // are declared to the RenderGraph in Setup each frame and looked up by handle in Execute
     class RenderPass
     {
     public:
         virtual ~RenderPass() = default;
+        virtual const char* GetName() const = 0;
         virtual void Init(u32 width, u32 height) = 0;
         virtual void Resize(u32 width, u32 height) = 0;
-        virtual void Execute(const RenderContext& ctx) = 0;
-        virtual std::vector<std::pair<std::string, u32>> GetAllAttachments() const { return {}; }
+        virtual void Setup(RenderGraphBuilder& builder) = 0;
+        virtual void Execute(const RenderContext& ctx, RenderGraph& graph) = 0;
+
+        // Nothing consumed the pass' outputs this frame, it was skipped
+        virtual void OnCulled() {}
     };
 }
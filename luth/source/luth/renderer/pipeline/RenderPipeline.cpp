@@ -14,7 +14,23 @@ namespace Luth
     }
 
     void RenderPipeline::RenderAll(const RenderContext& ctx) {
-        for (auto& p : m_Passes)
-            p->Execute(ctx);
+        m_Graph->Begin(m_Width, m_Height);
+        for (auto& p : m_Passes) {
+            RenderGraphBuilder builder = m_Graph->AddPass(p->GetName());
+            p->Setup(builder);
+        }
+        m_Graph->Compile(m_Output);
+
+        m_Profiler->BeginFrame(static_cast<u32>(m_Passes.size()));
+        for (u32 i : m_Graph->GetExecutionOrder()) {
+            m_Profiler->BeginPass(i, m_Passes[i]->GetName());
+            m_Passes[i]->Execute(ctx, *m_Graph);
+            m_Profiler->EndPass();
+        }
+        m_Profiler->EndFrame();
+        for (u32 i = 0; i < m_Passes.size(); ++i)
+            if (m_Graph->IsCulled(i)) m_Passes[i]->OnCulled();
+
+        Framebuffer::Unbind();
     }
 }
@@ -2,6 +2,7 @@
 
 #include "luth/core/LuthTypes.h"
 #include "luth/renderer/pipeline/RenderPass.h"
+#include "luth/renderer/pipeline/PassProfiler.h"
 #include "luth/renderer/pipeline/passes/GeometryPass.h"
 #include "luth/renderer/pipeline/passes/LightingPass.h"
 #include "luth/renderer/pipeline/passes/TransparentPass.h"
@@ -9,6 +10,7 @@
 #include "luth/renderer/pipeline/passes/PostProcessPass.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace Luth
@@ -35,35 +37,31 @@ namespace Luth
             return nullptr;
         }
 
-        // Query final color attachment from PostProcessPass
-        u32 GetFinalColorAttachment() const {
-            if (auto pp = GetPass<PostProcessPass>())
-				return pp->GetFinalColorAttachment();
-            return 0;
-        }
+        // Graph resource the frame is rendered for, passes not contributing to it are culled
+        void SetOutput(const std::string& name) { m_Output = name; }
+        const std::string& GetOutput() const { return m_Output; }
 
-        // Collect attachments from all passes
-        std::vector<std::pair<std::string, u32>> GetAllAttachments() const {
-            std::vector<std::pair<std::string, u32>> allAttachments;
+        u32 GetFinalColorAttachment() const { return m_Graph->GetTexture("Final"); }
 
-            for (auto& pass : m_Passes) {
-                auto attachments = pass->GetAllAttachments();
-                allAttachments.insert(allAttachments.end(),
-                    attachments.begin(), attachments.end());
-            }
-            return allAttachments;
-        }
+        // Textures of the last frame, by resource name
+        std::vector<std::pair<std::string, u32>> GetAllAttachments() const { return m_Graph->GetTextures(); }
+        u32 GetAttachmentByName(const std::string& name) const { return m_Graph->GetTexture(name); }
+        Vec2 GetAttachmentUVScale(const std::string& name) const { return m_Graph->GetUVScale(name); }
 
-        // Lookup an attachment by its name
-        u32 GetAttachmentByName(const std::string& name) const {
-            if (name == "Final") return GetFinalColorAttachment();
-            for (auto& [label, id] : GetAllAttachments())
-                if (label == name) return id;
-            return 0;
-        }
+        // Fraction of the viewport the scene is rendered at, upscaled by the PostProcessPass
+        void SetRenderScale(f32 scale) { m_Graph->SetRenderScale(scale); }
+        f32 GetRenderScale() const { return m_Graph->GetRenderScale(); }
+
+        const RenderGraph& GetGraph() const { return *m_Graph; }
+
+        // CPU / GPU time of the executed passes
+        PassProfiler& GetProfiler() const { return *m_Profiler; }
 
     private:
         std::vector<std::unique_ptr<RenderPass>> m_Passes;
+        std::unique_ptr<RenderGraph> m_Graph = std::make_unique<RenderGraph>();
+        std::unique_ptr<PassProfiler> m_Profiler = std::make_unique<PassProfiler>();
+        std::string m_Output = "Final";
         u32 m_Width = 0, m_Height = 0;
     };
 }
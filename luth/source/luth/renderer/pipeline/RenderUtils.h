@@ -3,15 +3,54 @@
 #include "luth/core/Log.h"
 #include "luth/ECS/Entity.h"
 #include "luth/renderer/Shader.h"
+#include "luth/renderer/ShaderKeywords.h"
+#include "luth/renderer/SkinnedModel.h"
+#include "luth/renderer/openGL/GLMaterialBuffer.h"
+#include "luth/renderer/openGL/GLState.h"
+#include "luth/renderer/openGL/GLUploadRing.h"
 #include "luth/renderer/pipeline/RenderPass.h"
 #include "luth/resources/libraries/ModelLibrary.h"
 #include "luth/resources/libraries/MaterialLibrary.h"
 
 namespace Luth::RenderUtils
 {
-    inline void BindMaterialTextures(const std::shared_ptr<Material>& material, Shader& shader)
+    // BonesUBO in LuthDeferredGeo.glsl / LuthForwardLight.glsl
+    constexpr u32 k_BonesBinding = 2;
+    // SkinnedVertices in LuthSkinnedVertices.glslh
+    constexpr u32 k_SkinnedVerticesBinding = 9;
+
+    // The AnimationSystem wrote this frame's palette or skinned stream for the mesh
+    inline bool HasCurrentSkinning(const MeshRenderer& meshRend)
+    {
+        return meshRend.isSkinned && meshRend.SkinningFrame == GLUploadRing::GetFrame();
+    }
+
+    // Skinned on the CPU this frame (Animation::CpuSkinning): the vertex stage reads the
+    // skinned stream and the palette is not used
+    inline bool IsCpuSkinned(const MeshRenderer& meshRend)
+    {
+        return HasCurrentSkinning(meshRend) && meshRend.SkinnedSize > 0;
+    }
+
+    // Identity palette, shared by every skinned mesh without a current one this frame
+    inline void BindBindPosePalette()
+    {
+        static u64 frame = 0;
+        static UploadAllocation palette;
+        if (frame != GLUploadRing::GetFrame()) {
+            palette = GLUploadRing::Allocate(MAX_BONES * sizeof(Mat4));
+            std::fill_n(static_cast<Mat4*>(palette.Data), MAX_BONES, Mat4(1.0f));
+            frame = GLUploadRing::GetFrame();
+        }
+        GLState::BindBufferRange(GL_UNIFORM_BUFFER, k_BonesBinding, palette.Buffer, palette.Offset, palette.Size);
+    }
+
+    // Parameters come from the material's persistent UBO block, each map's texture is
+    // bound to the unit matching its MapType (u_MapTextures[] bindings in the shaders)
+    inline void BindMaterialResources(const std::shared_ptr<Material>& material)
     {
-        int slot = 0;
+        GLMaterialBuffer::Bind(*material);
+
         for (auto& texInfo : material->GetTextures()) {
             auto texture = TextureCache::Get(texInfo.Uuid);
             
@@ -30,29 +69,22 @@ namespace Luth::RenderUtils
                 }
             }
 
-            texture->Bind(slot);
-            std::string prefix = "u_Maps[" + std::to_string((int)texInfo.type) + "]";
-            shader.SetBool(prefix + ".useTexture", texInfo.useTexture);
-            shader.SetInt(prefix + ".uvIndex", texInfo.uvIndex);
-            shader.SetInt(prefix + ".texture", slot++);
+            texture->Bind(static_cast<u32>(texInfo.type));
         }
+    }
 
-        // Material uniforms
-        shader.SetVec4("u_Color",      material->GetColor());
-        shader.SetFloat("u_Alpha",     material->GetAlpha());
-        shader.SetFloat("u_Metalness", material->GetMetal());
-        shader.SetFloat("u_Roughness", material->GetRough());
-        shader.SetVec3("u_Emissive",   material->GetEmissive());
-
-        shader.SetBool("u_IsGloss",         material->IsGloss());
-        shader.SetBool("u_IsSingleChannel", material->IsSingleChannel());
-
-        shader.SetVec3("u_Subsurface.color",           material->GetSubsurface().color);
-        shader.SetFloat("u_Subsurface.strength",       material->GetSubsurface().strength);
-        shader.SetFloat("u_Subsurface.thicknessScale", material->GetSubsurface().thicknessScale);
+    // Tells the vertex stage how to read the mesh's attributes (float or quantized)
+    inline void SetVertexDecode(const Mesh& mesh, Shader& shader)
+    {
+        const VertexDecode& decode = mesh.GetVertexDecode();
+        shader.SetBool(LH_PROP("u_VertexQuantized"), decode.Quantized);
+        if (decode.Quantized) {
+            shader.SetVec3(LH_PROP("u_PosOffset"), decode.PositionOffset);
+            shader.SetVec3(LH_PROP("u_PosScale"), decode.PositionScale);
+        }
     }
 
-    inline void RenderMesh(const RenderCommand& cmd, Shader& shader)
+    inline void RenderMesh(const RenderContext& ctx, const RenderCommand& cmd, Shader& shader)
     {
         auto& meshRend = *cmd.meshRend;
         auto model = ModelLibrary::Get(meshRend.ModelUUID);
@@ -67,36 +99,101 @@ namespace Luth::RenderUtils
             return;
         }
 
-        shader.SetMat4("u_Model", cmd.transform->matrix);
-        meshes[meshRend.MeshIndex]->Draw();
+        const bool cpuSkinned = IsCpuSkinned(meshRend);
+        if (cpuSkinned) {
+            GLState::BindBufferRange(GL_SHADER_STORAGE_BUFFER, k_SkinnedVerticesBinding, meshRend.SkinnedBuffer,
+                                     meshRend.SkinnedOffset, meshRend.SkinnedSize);
+            shader.SetBool(LH_PROP("u_CpuSkinned"), true);
+        }
+        else if (HasCurrentSkinning(meshRend) && meshRend.BonesSize > 0) {
+            GLState::BindBufferRange(GL_UNIFORM_BUFFER, k_BonesBinding, meshRend.BonesBuffer,
+                                     meshRend.BonesOffset, meshRend.BonesSize);
+        }
+        else if (meshRend.isSkinned) {
+            BindBindPosePalette();
+        }
+
+        shader.SetMat4(LH_PROP("u_Model"), cmd.transform->matrix);
+        SetVertexDecode(*meshes[meshRend.MeshIndex], shader);
+        if (cmd.rangeCount > 0)
+            meshes[meshRend.MeshIndex]->DrawRanges(ctx.clusterRanges.data() + cmd.firstRange, cmd.rangeCount);
+        else
+            meshes[meshRend.MeshIndex]->Draw(cmd.lod);
+
+        // Uniforms stick to the program, later draws of it skin as usual
+        if (cpuSkinned) shader.SetBool(LH_PROP("u_CpuSkinned"), false);
     }
 
-    inline void DrawCommand(const RenderCommand& cmd, Shader& shader, bool bindMaterial = true)
+    // Keyword mask for the shader variant matching the material's features
+    inline u32 MaterialKeywords(const Material& material)
     {
-        std::shared_ptr<Material> material;
-        if (bindMaterial) {
-            material = MaterialLibrary::Get(cmd.meshRend->MaterialUUID);
-            if (!material) material = MaterialLibrary::Get(UUID(7)); // fallback
+        using RenderMode = RendererAPI::RenderMode;
+
+        u32 keywords = 0;
+        switch (material.GetRenderMode()) {
+            case RenderMode::Cutout:      keywords |= ShaderKeywords::AlphaCutout; break;
+            case RenderMode::Transparent:
+            case RenderMode::Fade:        keywords |= ShaderKeywords::AlphaBlend;  break;
+            default: break;
         }
+        if (material.IsAlphaFromDiffuseEnabled()) keywords |= ShaderKeywords::AlphaFromDiffuse;
+        if (material.IsGloss())                   keywords |= ShaderKeywords::Gloss;
+        if (material.IsSingleChannel())           keywords |= ShaderKeywords::SingleChannel;
+
+        for (const auto& map : material.GetTextures())
+            if (map.useTexture) keywords |= ShaderKeywords::DiffuseMap << static_cast<u32>(map.type);
+        return keywords;
+    }
+
+    // Material keywords read by depth-only shaders (LuthDepthPrepass), cutout materials only
+    constexpr u32 k_DepthAlphaKeywords = ShaderKeywords::AlphaCutout | ShaderKeywords::AlphaFromDiffuse |
+                                         ShaderKeywords::DiffuseMap | ShaderKeywords::AlphaMap;
+
+    // Depth-only passes read no material state except the alpha of cutout materials
+    inline bool NeedsDepthMaterial(const Material* material)
+    {
+        return material && material->GetRenderMode() == RendererAPI::RenderMode::Cutout;
+    }
+
+    inline std::shared_ptr<Material> ResolveMaterial(const MeshRenderer& meshRend)
+    {
+        auto material = MaterialLibrary::Get(meshRend.MaterialUUID);
+        return material ? material : MaterialLibrary::Get(UUID(7)); // fallback
+    }
 
+    // Selects the shader variant, binds it and the MeshRenderer's material (or the fallback).
+    // passKeywords are ORed in for pass-wide features (e.g. G-buffer debug outputs).
+    // depthOnly keeps the skinning and cutout alpha keywords and skips the material
+    // resources of everything that is not cutout
+    inline void BindMaterial(const MeshRenderer& meshRend, Shader& shader, u32 passKeywords = 0, bool depthOnly = false)
+    {
+        auto material = ResolveMaterial(meshRend);
+        if (depthOnly && !NeedsDepthMaterial(material.get())) material = nullptr;
+
+        const bool gpuSkinned = meshRend.isSkinned && !IsCpuSkinned(meshRend);
+        u32 keywords = passKeywords | (gpuSkinned ? ShaderKeywords::Skinned : 0);
+        if (material) keywords |= MaterialKeywords(*material) & (depthOnly ? k_DepthAlphaKeywords : ~0u);
+
+        shader.SetKeywords(keywords);
         shader.Bind();
+        if (!material) return;
 
-        if (bindMaterial && material) {
-            // per-material modes
-            shader.SetInt("u_RenderMode", static_cast<int>(material->GetRenderMode()));
+        BindMaterialResources(material);
+    }
 
-            if (material->GetRenderMode() == RendererAPI::RenderMode::Cutout) {
-                shader.SetFloat("u_AlphaCutoff", material->GetAlphaCutoff());
-            }
-            else if (material->GetRenderMode() == RendererAPI::RenderMode::Transparent) {
-                shader.SetBool("u_AlphaFromDiffuse", material->IsAlphaFromDiffuseEnabled());
-                shader.SetFloat("u_Alpha", material->GetAlpha());
-            }
+    // Single-sided draws cull back faces, matching the cluster normal cone test
+    inline void SetFaceCulling(const RenderCommand& cmd)
+    {
+        GLState::SetEnabled(GL_CULL_FACE, cmd.singleSided);
+    }
 
-            // Uniforms & Textures
-            BindMaterialTextures(material, shader);
-        }
+    inline void DrawCommand(const RenderContext& ctx, const RenderCommand& cmd, Shader& shader,
+                            bool bindMaterial = true, u32 passKeywords = 0, bool depthOnly = false)
+    {
+        if (bindMaterial) BindMaterial(*cmd.meshRend, shader, passKeywords, depthOnly);
+        else shader.Bind();
+        SetFaceCulling(cmd);
 
-        RenderMesh(cmd, shader);
+        RenderMesh(ctx, cmd, shader);
     }
 }
@@ -1,44 +1,206 @@
 #include "Luthpch.h"
 #include "luth/renderer/pipeline/passes/GeometryPass.h"
 #include "luth/renderer/pipeline/RenderUtils.h"
+#include "luth/renderer/openGL/GLState.h"
+#include "luth/renderer/openGL/GLUploadRing.h"
+#include "luth/resources/libraries/VertexAnimationLibrary.h"
 
 namespace Luth
 {
+	namespace
+	{
+		auto BakedBatchKey(const entt::registry& registry, const RenderCommand& cmd)
+		{
+			const auto& anim = registry.get<BakedAnimation>(cmd.entity);
+			return std::make_tuple((u64)cmd.meshRend->ModelUUID, cmd.meshRend->MeshIndex,
+								   (u64)cmd.meshRend->MaterialUUID, anim.AnimationIndex, cmd.lod, cmd.singleSided);
+		}
+	}
+
 	void GeometryPass::Init(u32 w, u32 h)
 	{
 		m_GeoShader = ShaderLibrary::Get("LuthDeferredGeo");
-		m_GeoFBO = Framebuffer::Create({
-			.Width = w, .Height = h,
-			.ColorAttachments = {
-				{ .InternalFormat = GL_RGB16F,	.Name = "Position" },
-				{ .InternalFormat = GL_RGB16F,	.Name = "Normal"   },
-				{ .InternalFormat = GL_RGBA16F, .Name = "Albedo"   },
-				{ .InternalFormat = GL_RGB16F,	.Name = "MRAO"	   },
-				{ .InternalFormat = GL_RGBA16F, .Name = "ET"       },
-				{ .InternalFormat = GL_RGB16F,	.Name = "Bone"     }
-			},
-			.DepthStencilAttachment = {{ .InternalFormat = GL_DEPTH24_STENCIL8 }}
-		});
+		m_DepthShader = ShaderLibrary::Get("LuthDepthPrepass");
 
 		// Prevent light from leaking
 		Renderer::SetClearColor(Vec4(0));
 	}
 
-	void GeometryPass::Resize(u32 w, u32 h) {
-		m_GeoFBO->Resize(w, h);
+	void GeometryPass::Setup(RenderGraphBuilder& builder)
+	{
+		const u32 w = builder.GetWidth(), h = builder.GetHeight();
+		m_Normal   = builder.Create("GBuffer Normal", { w, h, GL_RG16_SNORM });
+		m_Albedo   = builder.Create("Base Color",     { w, h, GL_SRGB8_ALPHA8 });
+		m_MRAO     = builder.Create("MRAO",           { w, h, GL_RGBA8 });
+		m_Emissive = builder.Create("Emission",       { w, h, GL_R11F_G11F_B10F });
+
+		// Sampled to rebuild positions, never filtered
+		m_Depth    = builder.Create("Depth",          { w, h, GL_DEPTH24_STENCIL8, GL_NEAREST });
+
+		if (m_DebugOutputs) {
+			m_DebugPosition = builder.Create("Position",        { w, h, GL_RGB16F });
+			m_DebugNormal   = builder.Create("Normal",          { w, h, GL_RGB16F });
+			m_DebugBones    = builder.Create("Bones Influence", { w, h, GL_RGB16F });
+		}
 	}
 
-	void GeometryPass::Execute(const RenderContext& ctx)
+	void GeometryPass::Execute(const RenderContext& ctx, RenderGraph& graph)
 	{
-		m_GeoFBO->Bind();
-		Renderer::Clear(BufferBit::Color | BufferBit::Depth);
+		UpdateDepthPrepass(ctx);
+		if (!ctx.baked.empty()) PrepareBaked(ctx);
+
 		Renderer::EnableBlending(false);
+		GLState::DepthMask(true);
+
+		if (m_PrepassActive) {
+			graph.BindTarget({}, m_Depth);
+			Renderer::Clear(BufferBit::Depth);
+
+			// Cutout materials pick the alpha-tested variant, the rest share the plain one
+			// and bind no material state
+			m_DepthBatcher.Build(ctx.opaque, true, true);
+			m_DepthBatcher.Draw(ctx, *m_DepthShader, 0, true);
+			if (!ctx.baked.empty()) DrawBaked(ctx, *m_DepthShader, 0, true);
+
+			// Only the nearest surface passes, depth is final
+			GLState::DepthFunc(GL_EQUAL);
+			GLState::DepthMask(false);
+		}
+
+		if (m_DebugOutputs)
+			graph.BindTarget({ m_Normal, m_Albedo, m_MRAO, m_Emissive, m_DebugPosition, m_DebugNormal, m_DebugBones }, m_Depth);
+		else
+			graph.BindTarget({ m_Normal, m_Albedo, m_MRAO, m_Emissive }, m_Depth);
+		Renderer::Clear(m_PrepassActive ? BufferBit::Color : BufferBit::Color | BufferBit::Depth);
+
+		// Albedo is stored sRGB, encoded on write
+		GLState::SetEnabled(GL_FRAMEBUFFER_SRGB, true);
+
+		m_Batcher.Build(ctx.opaque, true);
+		m_Batcher.Draw(ctx, *m_GeoShader, PassKeywords());
+
+		if (!ctx.baked.empty()) DrawBaked(ctx, *m_GeoShader, PassKeywords());
+
+		GLState::SetEnabled(GL_FRAMEBUFFER_SRGB, false);
+		GLState::SetEnabled(GL_CULL_FACE, false);
+		GLState::DepthFunc(GL_LESS);
+		GLState::DepthMask(true);
+	}
+
+	void GeometryPass::UpdateDepthPrepass(const RenderContext& ctx)
+	{
+		m_Overdraw = m_Overdraw + (EstimateOverdraw(ctx) - m_Overdraw) * 0.1f;
+
+		bool active = m_PrepassMode == DepthPrepass::On;
+		if (m_PrepassMode == DepthPrepass::Auto) {
+			// Hysteresis, scenes hovering around the threshold don't flip every frame
+			const f32 threshold = m_PrepassActive ? m_OverdrawThreshold * 0.8f : m_OverdrawThreshold;
+			active = m_Overdraw > threshold;
+		}
+		active = active && m_DepthShader;
+
+		m_PrepassFrames = active == m_PrepassActive ? m_PrepassFrames + 1 : 0;
+		m_PrepassActive = active;
+	}
+
+	f32 GeometryPass::EstimateOverdraw(const RenderContext& ctx) const
+	{
+		// Sum of the screen fractions covered by the bounding spheres, each at most the whole screen
+		const Mat4& proj = ctx.projection;
+		const bool perspective = proj[3][3] == 0.0f;
+
+		f32 coverage = 0.0f;
+		auto accumulate = [&](const RenderCommand& cmd) {
+			auto model = ModelLibrary::Get(cmd.meshRend->ModelUUID);
+			if (!model || cmd.meshRend->MeshIndex >= model->GetMeshesData().size()) return;
+
+			const MeshData& data = model->GetMeshesData()[cmd.meshRend->MeshIndex];
+			const Mat4& m = cmd.transform->matrix;
+			const Vec3 center = Vec3(ctx.view * m * Vec4(data.BoundsCenter, 1.0f));
+			const f32 scale = std::max({ glm::length(Vec3(m[0])), glm::length(Vec3(m[1])), glm::length(Vec3(m[2])) });
+			const f32 radius = data.BoundsRadius * scale;
+
+			const f32 depth = -center.z;
+			if (depth < -radius) return;                            // Behind the camera
+			if (perspective && depth <= radius) { coverage += 1.0f; return; }   // Camera inside
+
+			// Half extents and center in NDC
+			const f32 w = perspective ? depth : 1.0f;
+			const f32 rx = radius * proj[0][0] / w, ry = radius * proj[1][1] / w;
+			const f32 cx = (center.x * proj[0][0] + proj[3][0]) / w;
+			const f32 cy = (center.y * proj[1][1] + proj[3][1]) / w;
+			if (std::abs(cx) - rx > 1.0f || std::abs(cy) - ry > 1.0f) return;
+
+			coverage += std::min(glm::pi<f32>() * rx * ry / 4.0f, 1.0f);
+		};
+
+		for (const auto& cmd : ctx.opaque) accumulate(cmd);
+		for (const auto& cmd : ctx.baked) accumulate(cmd);
+		return coverage;
+	}
+
+	void GeometryPass::PrepareBaked(const RenderContext& ctx)
+	{
+		m_Baked = ctx.baked;
+		std::sort(m_Baked.begin(), m_Baked.end(), [&](const auto& a, const auto& b) {
+			return BakedBatchKey(ctx.registry, a) < BakedBatchKey(ctx.registry, b);
+		});
+
+		// One instance stream for both passes, batches index into it
+		m_BakedInstances.clear();
+		for (const auto& cmd : m_Baked) {
+			const auto& anim = ctx.registry.get<BakedAnimation>(cmd.entity);
+			m_BakedInstances.push_back({ cmd.transform->matrix, Vec4(anim.TimeOffset, anim.Speed, 0.0f, 0.0f) });
+		}
+
+		GLUploadRing::Bind(GL_SHADER_STORAGE_BUFFER, 3, GLUploadRing::Upload(m_BakedInstances.data(),
+			m_BakedInstances.size() * sizeof(BakedInstanceGPU)));
+
+		// Sampled once, the pre-pass and the G-buffer must pose the same frame
+		m_BakedTime = Time::GetTime();
+	}
+
+	void GeometryPass::DrawBaked(const RenderContext& ctx, Shader& shader, u32 passKeywords, bool depthOnly)
+	{
+		for (size_t begin = 0; begin < m_Baked.size();) {
+			size_t end = begin + 1;
+			while (end < m_Baked.size() && BakedBatchKey(ctx.registry, m_Baked[end]) == BakedBatchKey(ctx.registry, m_Baked[begin])) ++end;
+
+			const RenderCommand& first = m_Baked[begin];
+			const i32 clip = ctx.registry.get<BakedAnimation>(first.entity).AnimationIndex;
+			auto model = ModelLibrary::Get(first.meshRend->ModelUUID);
+			auto vat = VertexAnimationLibrary::Get(first.meshRend->ModelUUID, clip);
+
+			if (!model || first.meshRend->MeshIndex >= model->GetMeshes().size()) {
+				begin = end;
+				continue;
+			}
+
+			// No bake (still baking, static model, bad clip): draw the bind pose one by one
+			if (!vat || first.meshRend->MeshIndex >= vat->GetMeshCount()) {
+				for (size_t i = begin; i < end; ++i)
+					RenderUtils::DrawCommand(ctx, m_Baked[i], shader, true, passKeywords, depthOnly);
+				begin = end;
+				continue;
+			}
+
+			// Uniforms are per variant, the material may have switched programs
+			RenderUtils::BindMaterial(*first.meshRend, shader, passKeywords, depthOnly);
+			RenderUtils::SetFaceCulling(first);
+			shader.SetFloat(LH_PROP("u_Time"), m_BakedTime);
+			vat->Bind(first.meshRend->MeshIndex, 4);
+
+			const auto& mesh = model->GetMeshes()[first.meshRend->MeshIndex];
+			RenderUtils::SetVertexDecode(*mesh, shader);
+			shader.SetBool(LH_PROP("u_IsBaked"), true);
+			shader.SetInt(LH_PROP("u_BakedBase"), (int)begin);
+			shader.SetInt(LH_PROP("u_BakedVertexCount"), (int)vat->GetTrack(first.meshRend->MeshIndex).VertexCount);
+			shader.SetInt(LH_PROP("u_BakedFrameCount"), (int)vat->GetFrameCount());
+			shader.SetFloat(LH_PROP("u_BakedFrameRate"), vat->GetFrameRate());
 
-		m_GeoShader->Bind();
-		for (auto& cmd : ctx.opaque) {
-			m_GeoShader->SetBool("u_IsSkinned", cmd.meshRend->isSkinned);
-			RenderUtils::DrawCommand(cmd, *m_GeoShader);
+			mesh->DrawInstanced((u32)(end - begin), first.lod);
+			shader.SetBool(LH_PROP("u_IsBaked"), false);
+			begin = end;
 		}
-		m_GeoFBO->Unbind();
 	}
 }
@@ -1,33 +1,94 @@
 #pragma once
 
 #include "luth/renderer/pipeline/RenderPass.h"
+#include "luth/renderer/pipeline/InstanceBatcher.h"
+#include "luth/renderer/ShaderKeywords.h"
+
+#include <string_view>
 
 namespace Luth
 {
+    // Packed G-buffer (mirrored by LuthGBuffer.glslh), 20 bytes per pixel with depth:
+    //   "GBuffer Normal"  RG16_SNORM      octahedral world normal
+    //   "Base Color"      SRGB8_ALPHA8    albedo, thickness
+    //   "MRAO"            RGBA8           metallic, roughness, ao, flags
+    //   "Emission"        R11F_G11F_B10F  emissive
+    //   "Depth"           D24S8           world position is rebuilt from it and the inverse matrices
+    // With debug outputs on (LH_GBUFFER_DEBUG variant) world position, normal and bone
+    // weights are also written to "Position", "Normal" and "Bones Influence", for the
+    // editor's views only.
+    //
+    // The optional depth pre-pass lays down opaque depth first with a position-only shader
+    // (LuthDepthPrepass), nearest batches first. The G-buffer is then written with GL_EQUAL
+    // and no depth writes, so its heavy fragment shader runs once per pixel. It pays for
+    // itself when there is overdraw, Auto turns it on while the estimated depth complexity
+    // (projected bounds of the opaque draws over the screen) is above the threshold.
     class GeometryPass : public RenderPass
     {
     public:
+        enum class DepthPrepass { Off, On, Auto };
+
+        const char* GetName() const override { return "Geometry"; }
         void Init(u32 width, u32 height) override;
-        void Resize(u32 width, u32 height) override;
-        void Execute(const RenderContext& ctx) override;
-
-        u32 GetFinalColorAttachment() const { return m_GeoFBO->GetColorAttachmentID(); }
-
-        std::vector<std::pair<std::string, u32>> GetAllAttachments() const {
-            return {
-			  { "Position",        m_GeoFBO->GetColorAttachmentID(0) },
-			  { "Normal",          m_GeoFBO->GetColorAttachmentID(1) },
-			  { "Base Color",      m_GeoFBO->GetColorAttachmentID(2) },
-			  { "MRAO",            m_GeoFBO->GetColorAttachmentID(3) },
-			  { "ET",              m_GeoFBO->GetColorAttachmentID(4) },
-			  { "Bones Influence", m_GeoFBO->GetColorAttachmentID(5) }
-            };
+        void Resize(u32 width, u32 height) override {}
+        void Setup(RenderGraphBuilder& builder) override;
+        void Execute(const RenderContext& ctx, RenderGraph& graph) override;
+
+        // Declares the debug targets from the next frame on
+        void SetDebugOutputs(bool enabled) { m_DebugOutputs = enabled; }
+        bool HasDebugOutputs() const { return m_DebugOutputs; }
+
+        // Views that need the debug targets
+        static bool IsDebugView(std::string_view name) {
+            return name == "Position" || name == "Normal" || name == "Bones Influence";
         }
 
-        std::shared_ptr<Framebuffer> GetGBuffer() const { return m_GeoFBO; }
+        void SetDepthPrepass(DepthPrepass mode) { m_PrepassMode = mode; }
+        DepthPrepass GetDepthPrepass() const { return m_PrepassMode; }
+        void SetOverdrawThreshold(f32 threshold) { m_OverdrawThreshold = threshold; }
+        f32 GetOverdrawThreshold() const { return m_OverdrawThreshold; }
+
+        // Smoothed estimate of how many opaque surfaces cover each pixel
+        f32 GetOverdraw() const { return m_Overdraw; }
+        bool IsDepthPrepassActive() const { return m_PrepassActive; }
+        // Frames rendered since the pre-pass was last turned on or off, for A/B timings
+        u32 GetPrepassFrames() const { return m_PrepassFrames; }
         
 	private:
-        std::shared_ptr<Framebuffer> m_GeoFBO;
+        void UpdateDepthPrepass(const RenderContext& ctx);
+        f32 EstimateOverdraw(const RenderContext& ctx) const;
+
+        // Sorts the BakedAnimation entities into batches and uploads their instances,
+        // once for both the pre-pass and the G-buffer
+        void PrepareBaked(const RenderContext& ctx);
+        // Instanced draws of the batches, by model / mesh / material / clip
+        void DrawBaked(const RenderContext& ctx, Shader& shader, u32 passKeywords, bool depthOnly = false);
+
+        u32 PassKeywords() const { return m_DebugOutputs ? ShaderKeywords::GBufferDebug : 0; }
+
+        struct BakedInstanceGPU {
+            Mat4 Model;
+            Vec4 Params;    // x: time offset, y: speed
+        };
+
+        RGHandle m_Normal = k_NoResource, m_Albedo = k_NoResource, m_MRAO = k_NoResource;
+        RGHandle m_Emissive = k_NoResource, m_Depth = k_NoResource;
+        RGHandle m_DebugPosition = k_NoResource, m_DebugNormal = k_NoResource, m_DebugBones = k_NoResource;
+
         std::shared_ptr<Shader> m_GeoShader;
+        std::shared_ptr<Shader> m_DepthShader;
+        bool m_DebugOutputs = false;
+        InstanceBatcher m_Batcher;
+        InstanceBatcher m_DepthBatcher;     // Front to back
+
+        DepthPrepass m_PrepassMode = DepthPrepass::Auto;
+        f32 m_OverdrawThreshold = 2.0f;
+        f32 m_Overdraw = 0.0f;
+        bool m_PrepassActive = false;
+        u32 m_PrepassFrames = 0;
+
+        std::vector<RenderCommand> m_Baked;                // Sorted by batch
+        std::vector<BakedInstanceGPU> m_BakedInstances;    // Streamed to SSBO 3 through the upload ring
+        f32 m_BakedTime = 0.0f;
     };
 }
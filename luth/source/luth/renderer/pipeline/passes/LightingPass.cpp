@@ -1,7 +1,5 @@
 #include "Luthpch.h"
 #include "luth/renderer/pipeline/passes/LightingPass.h"
-#include "luth/renderer/pipeline/passes/SSAOPass.h"
-#include "luth/renderer/pipeline/passes/GeometryPass.h"
 #include "luth/renderer/pipeline/RenderPipeline.h"
 
 namespace Luth
@@ -9,45 +7,44 @@ namespace Luth
     void LightingPass::Init(u32 w, u32 h)
     {
         m_LightShader = ShaderLibrary::Get("LuthDeferredLight");
-        m_LightFBO = Framebuffer::Create({
-            .Width = w, .Height = h,
-            .ColorAttachments = {{.InternalFormat = GL_RGBA16F }}
-        });
     }
 
-    void LightingPass::Resize(u32 w, u32 h)
+    void LightingPass::Setup(RenderGraphBuilder& builder)
     {
-        m_LightFBO->Resize(w, h);
+        m_Depth    = builder.Read("Depth");
+        m_Normal   = builder.Read("GBuffer Normal");
+        m_Albedo   = builder.Read("Base Color");
+        m_MRAO     = builder.Read("MRAO");
+        m_Emissive = builder.Read("Emission");
+        m_SSAO     = builder.Read("SSAO");
+        m_Light    = builder.Create("HDR", { builder.GetWidth(), builder.GetHeight(), GL_RGBA16F });
     }
 
-    void LightingPass::Execute(const RenderContext& ctx)
+    void LightingPass::Execute(const RenderContext& ctx, RenderGraph& graph)
     {
-        m_LightFBO->Bind();
+        graph.BindTarget({ m_Light });
         Renderer::Clear(BufferBit::Color);
 
         m_LightShader->Bind();
-        auto geoFBO = ctx.pipeline->GetPass<GeometryPass>()->GetGBuffer();
-        auto ssaoFBO = ctx.pipeline->GetPass<SSAOPass>()->GetGBuffer();
 
-		geoFBO->BindColorAsTexture(0, 0);
-        m_LightShader->SetInt("o_Position", 0);
+		graph.BindTexture(m_Depth, 0);
+        m_LightShader->SetInt(LH_PROP("o_Depth"), 0);
 
-        geoFBO->BindColorAsTexture(1, 1);
-		m_LightShader->SetInt("o_Normal", 1);
+        graph.BindTexture(m_Normal, 1);
+		m_LightShader->SetInt(LH_PROP("o_Normal"), 1);
 
-        geoFBO->BindColorAsTexture(2, 2);
-		m_LightShader->SetInt("o_Albedo", 2);
+        graph.BindTexture(m_Albedo, 2);
+		m_LightShader->SetInt(LH_PROP("o_Albedo"), 2);
 
-        geoFBO->BindColorAsTexture(3, 3);
-        m_LightShader->SetInt("o_MRO", 3);
+        graph.BindTexture(m_MRAO, 3);
+        m_LightShader->SetInt(LH_PROP("o_MRAO"), 3);
 
-        geoFBO->BindColorAsTexture(4, 4);
-        m_LightShader->SetInt("o_ET", 4);
+        graph.BindTexture(m_Emissive, 4);
+        m_LightShader->SetInt(LH_PROP("o_Emissive"), 4);
 
-		ssaoFBO->BindColorAsTexture(0, 5);
-        m_LightShader->SetInt("o_SSAO", 5);
+		graph.BindTexture(m_SSAO, 5);
+        m_LightShader->SetInt(LH_PROP("o_SSAO"), 5);
 
         Renderer::DrawFullscreenQuad();
-        m_LightFBO->Unbind();
     }
 }
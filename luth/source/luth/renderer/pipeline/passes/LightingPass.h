@@ -4,25 +4,21 @@
 
 namespace Luth
 {
+    // Resolves the G-buffer into "HDR", which TransparentPass then draws on top of
     class LightingPass : public RenderPass
     {
     public:
+        const char* GetName() const override { return "Lighting"; }
         void Init(u32 width, u32 height) override;
-        void Resize(u32 width, u32 height) override;
-        void Execute(const RenderContext& ctx) override;
-        
-        u32 GetFinalColorAttachment() const { return m_LightFBO->GetColorAttachmentID(); }
-
-        std::vector<std::pair<std::string, u32>> GetAllAttachments() const {
-            return {
-              { "Light", m_LightFBO->GetColorAttachmentID() },
-            };
-        }
-
-        std::shared_ptr<Framebuffer> GetGBuffer() const { return m_LightFBO; }
+        void Resize(u32 width, u32 height) override {}
+        void Setup(RenderGraphBuilder& builder) override;
+        void Execute(const RenderContext& ctx, RenderGraph& graph) override;
         
     private:
-        std::shared_ptr<Framebuffer> m_LightFBO;
+        RGHandle m_Depth = k_NoResource, m_Normal = k_NoResource, m_Albedo = k_NoResource;
+        RGHandle m_MRAO = k_NoResource, m_Emissive = k_NoResource, m_SSAO = k_NoResource;
+        RGHandle m_Light = k_NoResource;
+
         std::shared_ptr<Shader> m_LightShader;
     };
 }
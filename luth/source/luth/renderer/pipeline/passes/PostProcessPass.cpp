@@ -1,6 +1,5 @@
 #include "Luthpch.h"
 #include "luth/renderer/pipeline/passes/PostProcessPass.h"
-#include "luth/renderer/pipeline/passes/LightingPass.h"
 #include "luth/renderer/pipeline/RenderPipeline.h"
 
 namespace Luth
@@ -8,116 +7,87 @@ namespace Luth
     void PostProcessPass::Init(u32 width, u32 height)
     {
         // Load shaders
-        m_BloomExtractShader = ShaderLibrary::Get("LuthBloomExtract");
-        m_BloomBlurShader = ShaderLibrary::Get("LuthBloomBlur");
+        m_BloomDownsampleShader = ShaderLibrary::Get("LuthBloomDownsample");
+        m_BloomUpsampleShader = ShaderLibrary::Get("LuthBloomUpsample");
         m_PostProcessShader = ShaderLibrary::Get("LuthPostProcess");
-
-        // Bloom extract at full resolution
-        m_BloomExtractFBO = Framebuffer::Create({
-            .Width = width,
-            .Height = height,
-            .ColorAttachments = {{.InternalFormat = GL_RGB16F }}
-        });
-
-        // Ping-pong blur buffers at half resolution
-        Framebuffer::Spec half = {
-            .Width = width / 2,
-            .Height = height / 2,
-            .ColorAttachments = {{.InternalFormat = GL_RGB16F }}
-        };
-        m_PingPongFBO[0] = Framebuffer::Create(half);
-        m_PingPongFBO[1] = Framebuffer::Create(half);
-
-        // Final output
-        m_OutputFBO = Framebuffer::Create({
-            .Width = width,
-            .Height = height,
-            .ColorAttachments = {{.InternalFormat = GL_RGBA16F }}
-        });
     }
 
-    void PostProcessPass::Resize(u32 width, u32 height)
+    void PostProcessPass::Setup(RenderGraphBuilder& builder)
     {
-        m_BloomExtractFBO->Resize(width, height);
-        m_PingPongFBO[0]->Resize(width / 2, height / 2);
-        m_PingPongFBO[1]->Resize(width / 2, height / 2);
-        m_OutputFBO->Resize(width, height);
+        const u32 width = builder.GetWidth(), height = builder.GetHeight();
+        m_Scene = builder.Read("HDR");
+
+        // Always at least one level, stop before one would drop under 2 pixels on either axis
+        m_BloomMips.clear();
+        u32 w = std::max(width / 2, 1u), h = std::max(height / 2, 1u);
+        for (int i = 0; i < m_BloomMipCount; ++i) {
+            m_BloomMips.push_back(builder.Create(FMT("Bloom{0}", i), { w, h, GL_R11F_G11F_B10F }));
+            w /= 2;
+            h /= 2;
+            if (w < 2 || h < 2) break;
+        }
+
+        // Upscaled from the render scale here, the editor and the screen get the display size
+        m_Output = builder.Create("Final", { width, height, GL_RGBA8, GL_LINEAR, false });
     }
 
-    void PostProcessPass::Execute(const RenderContext& ctx)
+    void PostProcessPass::Execute(const RenderContext& ctx, RenderGraph& graph)
     {
-        auto lightFBO = ctx.pipeline->GetPass<TransparentPass>()->GetGBuffer();
-
-        // 1) Brightness extract
-        m_BloomExtractShader->Bind();
-        m_BloomExtractShader->SetFloat("u_Threshold", m_BloomThreshold);
+        const u32 mipCount = static_cast<u32>(m_BloomMips.size());
 
-        lightFBO->BindColorAsTexture(0, 0);
-        m_BloomExtractShader->SetInt("u_Scene", 0);
-
-        m_BloomExtractFBO->Bind();
-        Renderer::Clear(BufferBit::Color);
-        Renderer::DrawFullscreenQuad();
-        m_BloomExtractFBO->Unbind();
+        // 1) Downsample chain, thresholding on the way into the first level
+        m_BloomDownsampleShader->Bind();
+        m_BloomDownsampleShader->SetFloat(LH_PROP("u_Threshold"), m_BloomThreshold);
+        for (u32 i = 0; i < mipCount; ++i) {
+            graph.BindTexture(i == 0 ? m_Scene : m_BloomMips[i - 1], 0);
+            m_BloomDownsampleShader->SetBool(LH_PROP("u_Prefilter"), i == 0);
 
-        // 2) Gaussian blur ping-pong
-        bool horizontal = true;
-        bool firstIteration = true;
-        const float blurStrength = 2.0f; // Adjust based on resolution
-
-        for (int i = 0; i < m_BloomPasses * 2; i++)
-        {
-            m_PingPongFBO[horizontal]->Bind();
-            Renderer::Clear(BufferBit::Color);
-            m_BloomBlurShader->Bind();
-
-            // Bind input texture
-            if (firstIteration) {
-                m_BloomExtractFBO->BindColorAsTexture(0, 0);
-                firstIteration = false;
-            }
-            else {
-                m_PingPongFBO[!horizontal]->BindColorAsTexture(0, 0);
-            }
+            graph.BindTarget({ m_BloomMips[i] });
+            Renderer::DrawFullscreenQuad();
+        }
 
-            // Set blur parameters
-            m_BloomBlurShader->SetFloat("u_Horizontal", horizontal);
-            m_BloomBlurShader->SetFloat("u_BlurStrength", m_BloomStrength);
+        // 2) Upsample back to the first level, each adding onto the larger mip
+        m_BloomUpsampleShader->Bind();
+        m_BloomUpsampleShader->SetFloat(LH_PROP("u_FilterRadius"), m_BloomRadius);
+        Renderer::EnableBlending(true);
+        Renderer::SetBlendFunction(RendererAPI::BlendFactor::One, RendererAPI::BlendFactor::One);
+        for (u32 i = mipCount - 1; i > 0; --i) {
+            graph.BindTexture(m_BloomMips[i], 0);
 
+            graph.BindTarget({ m_BloomMips[i - 1] });
             Renderer::DrawFullscreenQuad();
-            m_PingPongFBO[horizontal]->Unbind();
-
-            horizontal = !horizontal;
         }
+        Renderer::SetBlendFunction(RendererAPI::BlendFactor::SrcAlpha, RendererAPI::BlendFactor::OneMinusSrcAlpha);
+        Renderer::EnableBlending(false);
 
         // 3) Final composite
         m_PostProcessShader->Bind();
         // bind inputs
-        lightFBO->BindColorAsTexture(0, 0);
-        m_PostProcessShader->SetInt("u_Scene", 0);
-        m_PingPongFBO[0]->BindColorAsTexture(0, 1);
-        m_PostProcessShader->SetInt("u_Bloom", 1);
-
-        m_PostProcessShader->SetFloat("u_Time", Time::GetTime());
-        m_PostProcessShader->SetFloat("u_BloomStrength", m_BloomStrength);
-
-        m_PostProcessShader->SetFloat("u_GrainAmount", m_GrainAmount);
-        m_PostProcessShader->SetFloat("u_Sharpness", m_Sharpness);
-        m_PostProcessShader->SetFloat("u_AberrationOffset", m_AberrationOffset);
-        m_PostProcessShader->SetFloat("u_VignetteAmount", m_VignetteAmount);
-        m_PostProcessShader->SetFloat("u_VignetteHardness", m_VignetteHardness);
+        graph.BindTexture(m_Scene, 0);
+        m_PostProcessShader->SetInt(LH_PROP("u_Scene"), 0);
+        graph.BindTexture(m_BloomMips[0], 1);
+        m_PostProcessShader->SetInt(LH_PROP("u_Bloom"), 1);
+
+        m_PostProcessShader->SetFloat(LH_PROP("u_Time"), Time::GetTime());
+        // Every level ends up summed into the first, keep the strength independent of the count
+        m_PostProcessShader->SetFloat(LH_PROP("u_BloomStrength"), m_BloomStrength / static_cast<float>(mipCount));
+
+        m_PostProcessShader->SetFloat(LH_PROP("u_GrainAmount"), m_GrainAmount);
+        m_PostProcessShader->SetFloat(LH_PROP("u_Sharpness"), m_Sharpness);
+        m_PostProcessShader->SetFloat(LH_PROP("u_AberrationOffset"), m_AberrationOffset);
+        m_PostProcessShader->SetFloat(LH_PROP("u_VignetteAmount"), m_VignetteAmount);
+        m_PostProcessShader->SetFloat(LH_PROP("u_VignetteHardness"), m_VignetteHardness);
         
-        m_PostProcessShader->SetInt("u_ToneMapOperator", static_cast<int>(m_ToneMapOp));
-        m_PostProcessShader->SetFloat("u_Exposure", m_Exposure);
-        m_PostProcessShader->SetFloat("u_Contrast", m_Contrast);
-        m_PostProcessShader->SetFloat("u_Saturation", m_Saturation);
+        m_PostProcessShader->SetInt(LH_PROP("u_ToneMapOperator"), static_cast<int>(m_ToneMapOp));
+        m_PostProcessShader->SetFloat(LH_PROP("u_Exposure"), m_Exposure);
+        m_PostProcessShader->SetFloat(LH_PROP("u_Contrast"), m_Contrast);
+        m_PostProcessShader->SetFloat(LH_PROP("u_Saturation"), m_Saturation);
 
-        m_PostProcessShader->SetVec3("u_ShadowBalance", m_ShadowBalance);
-        m_PostProcessShader->SetVec3("u_MidtoneBalance", m_MidtoneBalance);
-        m_PostProcessShader->SetVec3("u_HighlightBalance", m_HighlightBalance);
+        m_PostProcessShader->SetVec3(LH_PROP("u_ShadowBalance"), m_ShadowBalance);
+        m_PostProcessShader->SetVec3(LH_PROP("u_MidtoneBalance"), m_MidtoneBalance);
+        m_PostProcessShader->SetVec3(LH_PROP("u_HighlightBalance"), m_HighlightBalance);
 
-        m_OutputFBO->Bind();
+        graph.BindTarget({ m_Output });
         Renderer::DrawFullscreenQuad();
-        m_OutputFBO->Unbind();
     }
 }
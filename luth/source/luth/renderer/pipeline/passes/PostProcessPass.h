@@ -13,22 +13,20 @@ namespace Luth
         UNCHARTED2
     };
 
+    // Bloom is a mip chain: the scene is thresholded into half resolution and halved again
+    // per level with a 13-tap filter, then each level is tent filtered and added onto the
+    // next larger one. The composite reads the half resolution level and writes "Final",
+    // tone mapped and gamma encoded, so 8 bits per channel. "Final" is the only target at
+    // display resolution: the composite is also the upscale from the render scale,
+    // bilinear followed by the sharpen filter.
     class PostProcessPass : public RenderPass
     {
     public:
+        const char* GetName() const override { return "PostProcess"; }
         void Init(u32 width, u32 height) override;
-        void Resize(u32 width, u32 height) override;
-        void Execute(const RenderContext& ctx) override;
-
-        u32 GetFinalColorAttachment() const { return m_OutputFBO->GetColorAttachmentID(); }
-
-        std::vector<std::pair<std::string, u32>> GetAllAttachments() const {
-            return {
-              { "Final", m_OutputFBO->GetColorAttachmentID(0) },
-            };
-        }
-
-        std::shared_ptr<Framebuffer> GetGBuffer() const { return m_OutputFBO; }
+        void Resize(u32 width, u32 height) override {}
+        void Setup(RenderGraphBuilder& builder) override;
+        void Execute(const RenderContext& ctx, RenderGraph& graph) override;
 
         // Bloom settings
         float GetBloomThreshold() const { return m_BloomThreshold; }
@@ -37,8 +35,11 @@ namespace Luth
         float GetBloomStrength() const { return m_BloomStrength; }
         void SetBloomStrength(float s) { m_BloomStrength = s; }
 
-        int GetBloomPasses() const { return m_BloomPasses; }
-        void SetBloomPasses(int p) { m_BloomPasses = p; }
+        int GetBloomMips() const { return m_BloomMipCount; }
+        void SetBloomMips(int mips) { m_BloomMipCount = std::clamp(mips, 1, 10); }
+
+        float GetBloomRadius() const { return m_BloomRadius; }
+        void SetBloomRadius(float r) { m_BloomRadius = r; }
 
         // Grain
         float GetGrainAmount() const { return m_GrainAmount; }
@@ -83,22 +84,21 @@ namespace Luth
         }
         
     private:
-        // Intermediate bloom FBOs
-        std::shared_ptr<Framebuffer> m_BloomExtractFBO;
-        std::shared_ptr<Framebuffer> m_PingPongFBO[2];
+        RGHandle m_Scene = k_NoResource, m_Output = k_NoResource;
 
-        // Final composite FBO
-        std::shared_ptr<Framebuffer> m_OutputFBO;
+        // Bloom chain, [0] at half resolution
+        std::vector<RGHandle> m_BloomMips;
 
         // Shaders
-        std::shared_ptr<Shader> m_BloomExtractShader;
-        std::shared_ptr<Shader> m_BloomBlurShader;
+        std::shared_ptr<Shader> m_BloomDownsampleShader;
+        std::shared_ptr<Shader> m_BloomUpsampleShader;
         std::shared_ptr<Shader> m_PostProcessShader;
 
         // Bloom
         float m_BloomThreshold = 1.0f;
         float m_BloomStrength = 1.0f;
-        int   m_BloomPasses = 8;
+        int   m_BloomMipCount = 6;
+        float m_BloomRadius = 1.0f;     // Upsample tent, in texels of the smaller mip
 
         // Others
         float m_GrainAmount = 0.03f;
@@ -1,26 +1,41 @@
 #include "Luthpch.h"
 #include "luth/renderer/pipeline/passes/SSAOPass.h"
-#include "luth/renderer/pipeline/passes/GeometryPass.h"
 #include "luth/renderer/pipeline/RenderPipeline.h"
+#include "luth/renderer/ShaderKeywords.h"
+#include "luth/renderer/openGL/GLState.h"
 
 namespace Luth
 {
+    namespace
+    {
+        constexpr u32 k_KernelBinding = 2;
+        constexpr f32 k_TemporalFeedback = 0.9f;    // History weight where reprojection holds
+    }
+
+    const SSAOPass::Tier& SSAOPass::GetTier(SSAOQuality quality)
+    {
+        static const Tier tiers[] = {
+            {  8, 4, ShaderKeywords::SSAOLow   },
+            { 16, 2, 0                         },
+            { 32, 2, ShaderKeywords::SSAOHigh  },
+            { 64, 1, ShaderKeywords::SSAOUltra },
+        };
+        return tiers[static_cast<u32>(quality)];
+    }
+
     void SSAOPass::Init(u32 w, u32 h)
     {
         m_SSAOShader     = ShaderLibrary::Get("LuthSSAO");
         m_SSAOBlurShader = ShaderLibrary::Get("LuthSSAOBlur");
+        m_TemporalShader = ShaderLibrary::Get("LuthSSAOTemporal");
+        m_UpsampleShader = ShaderLibrary::Get("LuthSSAOUpsample");
 
-        m_SSAOFBO     = Framebuffer::Create({ .Width = w, .Height = h, .ColorAttachments = {{.InternalFormat = GL_R8 }} });
-        m_SSAOBlurFBO = Framebuffer::Create({ .Width = w, .Height = h, .ColorAttachments = {{.InternalFormat = GL_R8 }} });
+        m_Width = w;
+        m_Height = h;
+        CreateHistory();
 
         // build kernel & SSBO
-        m_Kernel.resize(64);
         InitKernel();
-        glGenBuffers(1, &m_KernelSSBO);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_KernelSSBO);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, m_Kernel.size() * sizeof(glm::vec3), m_Kernel.data(), GL_STATIC_READ);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_KernelSSBO);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
         // noise texture
         InitNoiseTexture();
@@ -28,53 +43,136 @@ namespace Luth
 
     void SSAOPass::Resize(u32 w, u32 h)
     {
-        m_SSAOFBO->Resize(w, h);
-        m_SSAOBlurFBO->Resize(w, h);
+        m_Width = w;
+        m_Height = h;
+        CreateHistory();
+    }
+
+    void SSAOPass::SetQuality(SSAOQuality quality)
+    {
+        if (quality == m_Quality) return;
+        m_Quality = quality;
+
+        InitKernel();
+        if (m_Width && m_Height) CreateHistory();
+    }
+
+    void SSAOPass::CreateHistory()
+    {
+        const Tier& tier = GetTier(m_Quality);
+        const u32 w = std::max(m_Width / tier.Divisor, 1u);
+        const u32 h = std::max(m_Height / tier.Divisor, 1u);
+
+        // Reprojected lookups land between texels
+        Framebuffer::Spec spec = { .Width = w, .Height = h, .ColorAttachments = {{ .InternalFormat = GL_RG16F }} };
+        m_HistoryFBO[0] = Framebuffer::Create(spec);
+        m_HistoryFBO[1] = Framebuffer::Create(spec);
+        m_HistoryValid = false;
     }
 
-    void SSAOPass::Execute(const RenderContext& ctx)
+    void SSAOPass::Setup(RenderGraphBuilder& builder)
     {
-        auto geoFBO = ctx.pipeline->GetPass<GeometryPass>()->GetGBuffer();
+        const Tier& tier = GetTier(m_Quality);
+        const u32 w = builder.GetWidth(), h = builder.GetHeight();
+        const bool upsample = tier.Divisor > 1;
 
-        // Bind G-buffer attachments
-        geoFBO->BindColorAsTexture(0, 0);   // Position
-        geoFBO->BindColorAsTexture(1, 1);   // Normal
+        m_Depth = builder.Read("Depth");
+        m_Normal = builder.Read("GBuffer Normal");
 
-        // Bind noise texture
+        // r: occlusion, g: linear view depth for the depth-aware filters
+        const RGTextureDesc low = { std::max(w / tier.Divisor, 1u), std::max(h / tier.Divisor, 1u), GL_RG16F, GL_NEAREST };
+        m_Raw = builder.Create("SSAORaw", low);
+        m_Blur = builder.Create(upsample || m_Temporal ? "SSAOBlur" : "SSAO", low);
+        m_Output = m_Blur;
+
+        if (upsample) {
+            m_Output = builder.Create("SSAO", { w, h, GL_R8 });
+        }
+        else if (m_Temporal) {
+            const auto& target = m_HistoryFBO[1 - m_HistoryIndex];
+            m_Output = builder.Import("SSAO", target->GetColorAttachmentID(), { low.Width, low.Height, GL_RG16F });
+        }
+    }
+
+    void SSAOPass::Execute(const RenderContext& ctx, RenderGraph& graph)
+    {
+        const Tier& tier = GetTier(m_Quality);
+        const RGTextureDesc& lowDesc = graph.GetDesc(m_Raw);
+
+        // 1) Occlusion at the tier's resolution
+        graph.BindTexture(m_Depth, 0);
+        graph.BindTexture(m_Normal, 1);
         m_NoiseTexture->Bind(2);
+        GLState::BindBufferBase(GL_SHADER_STORAGE_BUFFER, k_KernelBinding, m_KernelSSBO);
 
-        // Set up SSAO shader
+        // With accumulation, each frame rotates the kernel differently
+        const u32 shift = m_Temporal ? m_FrameIndex % (NOISE_SIZE * NOISE_SIZE) : 0;
+        const Vec2 noiseOffset = Vec2(shift % NOISE_SIZE, shift / NOISE_SIZE) / (f32)NOISE_SIZE;
+
+        m_SSAOShader->SetKeywords(tier.Keyword);
         m_SSAOShader->Bind();
-        m_SSAOShader->SetInt("gPosition", 0);
-        m_SSAOShader->SetInt("gNormal",   1);
-        m_SSAOShader->SetInt("u_Noise",   2);
-        m_SSAOShader->SetVec2("u_NoiseScale", { ctx.width / 4, ctx.height / 4 });
-        m_SSAOShader->SetFloat("u_Radius", m_Radius);
-        m_SSAOShader->SetFloat("u_Bias", m_Bias);
-
-        // Render into SSAO FBO
-        m_SSAOFBO->Bind();
+        m_SSAOShader->SetInt(LH_PROP("gDepth"),    0);
+        m_SSAOShader->SetInt(LH_PROP("gNormal"),   1);
+        m_SSAOShader->SetInt(LH_PROP("u_Noise"),   2);
+        m_SSAOShader->SetVec2(LH_PROP("u_NoiseScale"), Vec2(lowDesc.Width, lowDesc.Height) / (f32)NOISE_SIZE);
+        m_SSAOShader->SetVec2(LH_PROP("u_NoiseOffset"), noiseOffset);
+        m_SSAOShader->SetFloat(LH_PROP("u_Radius"), m_Radius);
+        m_SSAOShader->SetFloat(LH_PROP("u_Bias"), m_Bias);
+
+        graph.BindTarget({ m_Raw });
         Renderer::Clear(BufferBit::Color);
         Renderer::DrawFullscreenQuad();
-        m_SSAOFBO->Unbind();
 
-        // Blur
-        m_SSAOBlurFBO->Bind();
+        // 2) Depth-aware blur
+        graph.BindTarget({ m_Blur });
         Renderer::Clear(BufferBit::Color);
         m_SSAOBlurShader->Bind();
-        m_SSAOFBO->BindColorAsTexture(0, 0);
+        graph.BindTexture(m_Raw, 0);
+        m_SSAOBlurShader->SetInt(LH_PROP("ssaoInput"), 0);
         Renderer::DrawFullscreenQuad();
-        m_SSAOBlurFBO->Unbind();
-    }
 
-    void SSAOPass::SetKernelSize(u32 n)
-    {
-        m_Kernel.resize(n);
-        InitKernel();
-        // re-upload
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_KernelSSBO);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, m_Kernel.size() * sizeof(glm::vec3), m_Kernel.data(), GL_STATIC_READ);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        u32 result = graph.GetTexture(m_Blur);
+
+        // 3) Temporal accumulation, rejected where the reprojected depth disagrees
+        if (m_Temporal) {
+            auto& history = m_HistoryFBO[m_HistoryIndex];
+            auto& target = m_HistoryFBO[1 - m_HistoryIndex];
+
+            // Into the corner the graph's scaled targets are drawn in
+            target->Bind();
+            GLState::Viewport(0, 0, graph.ScaleExtent(lowDesc.Width), graph.ScaleExtent(lowDesc.Height));
+            m_TemporalShader->Bind();
+            GLState::BindTextureUnit(0, result);
+            history->BindColorAsTexture(0, 1);
+            graph.BindTexture(m_Depth, 2);
+            m_TemporalShader->SetInt(LH_PROP("u_Current"), 0);
+            m_TemporalShader->SetInt(LH_PROP("u_History"), 1);
+            m_TemporalShader->SetInt(LH_PROP("gDepth"), 2);
+            m_TemporalShader->SetMat4(LH_PROP("u_PrevView"), m_PrevView);
+            m_TemporalShader->SetMat4(LH_PROP("u_PrevProjection"), m_PrevProjection);
+            m_TemporalShader->SetVec2(LH_PROP("u_PrevRenderScale"), m_PrevUVScale);
+            m_TemporalShader->SetFloat(LH_PROP("u_Feedback"), m_HistoryValid ? k_TemporalFeedback : 0.0f);
+            Renderer::DrawFullscreenQuad();
+
+            result = target->GetColorAttachmentID();
+            m_HistoryIndex = 1 - m_HistoryIndex;
+            m_HistoryValid = true;
+        }
+        m_PrevView = ctx.view;
+        m_PrevProjection = ctx.projection;
+        m_PrevUVScale = graph.GetUVScale(m_Raw);
+        ++m_FrameIndex;
+
+        // 4) Bilateral upsample to full resolution
+        if (tier.Divisor > 1) {
+            graph.BindTarget({ m_Output });
+            m_UpsampleShader->Bind();
+            GLState::BindTextureUnit(0, result);
+            graph.BindTexture(m_Depth, 1);
+            m_UpsampleShader->SetInt(LH_PROP("u_AO"), 0);
+            m_UpsampleShader->SetInt(LH_PROP("gDepth"), 1);
+            Renderer::DrawFullscreenQuad();
+        }
     }
 
     void SSAOPass::InitKernel()
@@ -82,6 +180,7 @@ namespace Luth
         std::uniform_real_distribution<float> randomFloats(0.0f, 1.0f);
         std::default_random_engine generator;
 
+        m_Kernel.resize(GetTier(m_Quality).Samples);
         for (u32 i = 0; i < m_Kernel.size(); i++) {
             // generate a sample in the hemisphere
             glm::vec3 sample(
@@ -95,8 +194,11 @@ namespace Luth
             // Scale so more points are near the origin
             float scale = float(i) / float(m_Kernel.size());
             scale = glm::mix(0.1f, 1.0f, scale * scale);
-            m_Kernel[i] = sample * scale;
+            m_Kernel[i] = Vec4(sample * scale, 0.0f);
         }
+
+        if (!m_KernelSSBO) glCreateBuffers(1, &m_KernelSSBO);
+        glNamedBufferData(m_KernelSSBO, m_Kernel.size() * sizeof(Vec4), m_Kernel.data(), GL_STATIC_DRAW);
     }
 
     void SSAOPass::InitNoiseTexture()
@@ -4,49 +4,83 @@
 
 namespace Luth
 {
+    // Sample count and resolution of the occlusion pass
+    enum class SSAOQuality : u8 {
+        Low,        //  8 samples, quarter resolution
+        Medium,     // 16 samples, half resolution
+        High,       // 32 samples, half resolution
+        Ultra       // 64 samples, full resolution
+    };
+
+    // AO is traced at the tier's resolution into RG (occlusion, linear depth), blurred with
+    // depth-aware weights, optionally accumulated over frames by reprojecting the previous
+    // result, then upsampled to full resolution guided by the full-resolution depth.
+    // Publishes "SSAO" (occlusion in .r) plus the "SSAORaw" / "SSAOBlur" steps.
     class SSAOPass : public RenderPass
     {
     public:
+        const char* GetName() const override { return "SSAO"; }
         void Init(u32 width, u32 height) override;
         void Resize(u32 width, u32 height) override;
-        void Execute(const RenderContext& ctx) override;
-        
-        u32 GetFinalColorAttachment() const { return m_SSAOBlurFBO->GetColorAttachmentID(); }
+        void Setup(RenderGraphBuilder& builder) override;
+        void Execute(const RenderContext& ctx, RenderGraph& graph) override;
 
-        std::vector<std::pair<std::string, u32>> GetAllAttachments() const {
-            return {
-              { "SSAO",     m_SSAOFBO->GetColorAttachmentID()     },
-              { "SSAOBlur", m_SSAOBlurFBO->GetColorAttachmentID() }
-            };
-        }
-
-        std::shared_ptr<Framebuffer> GetGBuffer() const { return m_SSAOBlurFBO; }
+        // The history no longer follows the camera
+        void OnCulled() override { m_HistoryValid = false; }
 
 		float GetRadius() const { return m_Radius; }
         void SetRadius(float r) { m_Radius = r; }
 
 		float GetIntensity() const { return m_Intensity; }
 		void SetIntensity(float i) { m_Intensity = i; }
-        
+
 		float GetBias() const { return m_Bias; }
         void SetBias(float b) { m_Bias = b; }
 
-        void SetKernelSize(u32 n);
+        SSAOQuality GetQuality() const { return m_Quality; }
+        void SetQuality(SSAOQuality quality);
+
+        bool IsTemporal() const { return m_Temporal; }
+        void SetTemporal(bool enabled) { m_Temporal = enabled; m_HistoryValid = false; }
 
     private:
+        struct Tier {
+            u32 Samples;
+            u32 Divisor;    // Of the full resolution
+            u32 Keyword;
+        };
+        static const Tier& GetTier(SSAOQuality quality);
+
+        void CreateHistory();
         void InitKernel();
         void InitNoiseTexture();
 
-        std::shared_ptr<Framebuffer> m_SSAOFBO, m_SSAOBlurFBO;
-        std::shared_ptr<Shader> m_SSAOShader, m_SSAOBlurShader;
+        RGHandle m_Depth = k_NoResource, m_Normal = k_NoResource;
+        RGHandle m_Raw = k_NoResource, m_Blur = k_NoResource;
+        RGHandle m_Output = k_NoResource;   // Upsampled, or the blur / history at full resolution
+
+        // Persistent across frames, outside the graph
+        std::shared_ptr<Framebuffer> m_HistoryFBO[2];
+        std::shared_ptr<Shader> m_SSAOShader, m_SSAOBlurShader, m_TemporalShader, m_UpsampleShader;
+        u32 m_Width = 0, m_Height = 0;
 
         // SSAO parameters
         float m_Radius = 0.5f;
         float m_Intensity = 0.5f;
         float m_Bias = 0.025f;
+        SSAOQuality m_Quality = SSAOQuality::Medium;
+
+        // Temporal accumulation
+        bool m_Temporal = true;
+        bool m_HistoryValid = false;
+        u32 m_HistoryIndex = 0;
+        u32 m_FrameIndex = 0;
+        Mat4 m_PrevView = Mat4(1.0f);
+        Mat4 m_PrevProjection = Mat4(1.0f);
+        Vec2 m_PrevUVScale = Vec2(1.0f);    // History's drawn part, the render scale moves
 
-        // Kernel storage
-        std::vector<glm::vec3> m_Kernel;
+        // Kernel storage, vec4 for the std430 array stride
+        std::vector<Vec4> m_Kernel;
         u32 m_KernelSSBO = 0;
 
         // Noise texture
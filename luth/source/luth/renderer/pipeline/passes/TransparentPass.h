@@ -1,28 +1,23 @@
 #pragma once
 
 #include "luth/renderer/pipeline/RenderPass.h"
+#include "luth/renderer/pipeline/InstanceBatcher.h"
 
 namespace Luth
 {
+    // Forward lit, blended into "HDR" with the G-buffer depth attached for testing (no writes)
     class TransparentPass : public RenderPass
     {
     public:
+        const char* GetName() const override { return "Transparent"; }
         void Init(u32 width, u32 height) override;
-        void Resize(u32 width, u32 height) override;
-        void Execute(const RenderContext& ctx) override;
-
-        u32 GetFinalColorAttachment() const { return m_TransparentFBO->GetColorAttachmentID(); }
-
-        std::vector<std::pair<std::string, u32>> GetAllAttachments() const {
-            return {
-              { "No Post-Processing", m_TransparentFBO->GetColorAttachmentID() },
-            };
-        }
-
-        std::shared_ptr<Framebuffer> GetGBuffer() const { return m_TransparentFBO; }
+        void Resize(u32 width, u32 height) override {}
+        void Setup(RenderGraphBuilder& builder) override;
+        void Execute(const RenderContext& ctx, RenderGraph& graph) override;
         
     private:
-        std::shared_ptr<Framebuffer> m_TransparentFBO;
+        RGHandle m_Color = k_NoResource, m_Depth = k_NoResource;
         std::shared_ptr<Shader> m_FLightShader;
+        InstanceBatcher m_Batcher;
     };
 }
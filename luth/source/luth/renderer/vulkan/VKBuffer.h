@@ -46,6 +46,7 @@ namespace Luth
         void Bind() const override;
         void Unbind() const override;
         uint32_t GetCount() const override { return m_Count; }
+        IndexType GetIndexType() const override { return IndexType::UInt32; }
 
         VkBuffer GetBuffer() const { return m_Buffer; }
 
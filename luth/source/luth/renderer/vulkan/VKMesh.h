@@ -18,13 +18,25 @@ namespace Luth
             // Actual binding happens during command buffer recording
         }
 
-        void Draw() const override {
+        void Draw(u32 lod = 0) const override {
+            // Drawing logic is handled by the renderer
+        }
+
+        void DrawInstanced(u32 instanceCount, u32 lod = 0) const override {
+            // Drawing logic is handled by the renderer
+        }
+
+        void DrawRanges(const MeshIndexRange* ranges, u32 rangeCount) const override {
             // Drawing logic is handled by the renderer
         }
 
         VkBuffer GetVertexBuffer() const { return m_VertexBuffer->GetBuffer(); }
         VkBuffer GetIndexBuffer() const { return m_IndexBuffer ? m_IndexBuffer->GetBuffer() : VK_NULL_HANDLE; }
-        uint32_t GetIndexCount() const { return m_IndexBuffer ? m_IndexBuffer->GetCount() : 0; }
+        // LOD 0 only, coarser levels follow it in the same buffer
+        uint32_t GetIndexCount() const {
+            if (!m_IndexBuffer) return 0;
+            return m_Lods.empty() ? m_IndexBuffer->GetCount() : m_Lods[0].IndexCount;
+        }
         uint32_t GetVertexCount() const { return m_VertexBuffer->GetVertexCount(); }
 
     private:
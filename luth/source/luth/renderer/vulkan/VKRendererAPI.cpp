@@ -103,6 +103,8 @@ namespace Luth
     }
 
 
+    void VKRendererAPI::BeginFrame() {}
+
     void VKRendererAPI::BindFramebuffer(const std::shared_ptr<Framebuffer>& framebuffer) {}
 
     void VKRendererAPI::SetViewport(u32 x, u32 y, u32 width, u32 height) {}
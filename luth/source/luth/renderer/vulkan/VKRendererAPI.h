@@ -30,6 +30,8 @@ namespace Luth
         virtual void Init() override;
         virtual void Shutdown() override;
 
+        virtual void BeginFrame() override;
+
         virtual void BindFramebuffer(const std::shared_ptr<Framebuffer>& framebuffer) override;
 
         virtual void SetViewport(u32 x, u32 y, u32 width, u32 height) override;
@@ -62,6 +62,10 @@ namespace Luth
         return ProjectPath("Logs");
     }
 
+    fs::path FileSystem::CachePath(const fs::path& relative) {
+        return (s_ProjectRoot / "Cache" / relative).lexically_normal();
+    }
+
     bool FileSystem::Exists(const fs::path& path) {
         return fs::exists(path);
     }
@@ -115,6 +119,7 @@ namespace Luth
             CreateDirectories(s_ProjectRoot / "assets" / info.directory);
         }
         CreateDirectories(LogPath());
+        CreateDirectories(CachePath());
     }
 
     const std::unordered_map<ResourceType, FileSystem::ResourceTypeInfo>& FileSystem::GetTypeInfo()
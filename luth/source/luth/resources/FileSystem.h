@@ -31,6 +31,8 @@ namespace Luth
         // Platform paths
         static fs::path PlatformAssetsPath();
         static fs::path LogPath();
+        // Derived data safe to delete (program binaries, ...)
+        static fs::path CachePath(const fs::path& relative = "");
 
         // File utilities
         static bool Exists(const fs::path& path);
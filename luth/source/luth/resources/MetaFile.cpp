@@ -33,6 +33,10 @@ namespace Luth
                 settings["import_normals"] = true;
                 settings["import_tangents"] = false;
                 settings["optimize_mesh"] = true;
+                settings["quantize_vertices"] = false;
+                settings["lod_count"] = 3;
+                settings["lod_reduction"] = 0.5;
+                settings["build_meshlets"] = true;
                 break;
 
             case ResourceType::Material:
@@ -43,6 +47,7 @@ namespace Luth
             case ResourceType::Shader:
                 settings["hot_reload"] = true;
                 settings["optimization_level"] = 3;
+                settings["prewarm_variants"] = nlohmann::json::array();
                 break;
 
             case ResourceType::Directory:
@@ -9,6 +9,7 @@
 #include "luth/resources/libraries/MaterialLibrary.h"
 #include "luth/resources/libraries/ShaderLibrary.h"
 #include "luth/resources/libraries/TextureCache.h"
+#include "luth/resources/libraries/VertexAnimationLibrary.h"
 
 #include <regex>
 
@@ -44,6 +45,8 @@ namespace Luth
         }
 
         static void Shutdown() {
+            // Bakes in flight still read their models
+            VertexAnimationLibrary::Shutdown();
             ModelLibrary::Shutdown();
             MaterialLibrary::Shutdown();
             ShaderLibrary::Shutdown();
@@ -77,10 +77,7 @@ namespace Luth
         if (path.empty()) return;
 
         if (auto material = Get(materialUUID)) {
-            // Preserve runtime modifications
-            Material temp = *material;
-
-            // Reload from disk
+            // Reload from disk, Deserialize also drops the material's GPU parameter block
             std::ifstream file(path);
             nlohmann::json json;
             file >> json;
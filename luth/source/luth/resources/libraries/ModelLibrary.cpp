@@ -2,6 +2,7 @@
 #include "luth/resources/libraries/ModelLibrary.h"
 #include "luth/resources/ResourceDB.h"
 #include "luth/resources/ModelLoader.h"
+#include "luth/renderer/CpuSkinning.h"
 
 namespace Luth
 {
@@ -18,6 +19,9 @@ namespace Luth
     {
         std::unique_lock lock(s_Mutex);
         s_Models.clear();
+        lock.unlock();
+
+        SkinnedVertexCache::Clear();
         LH_CORE_INFO("Cleared Model Library");
     }
 
@@ -42,7 +46,12 @@ namespace Luth
     bool ModelLibrary::Remove(const UUID& uuid)
     {
         std::unique_lock lock(s_Mutex);
-        return s_Models.erase(uuid) > 0;
+        if (s_Models.erase(uuid) == 0) return false;
+
+        // The cache looks models up here, never hold both locks
+        lock.unlock();
+        SkinnedVertexCache::RemoveModel(uuid);
+        return true;
     }
 
     bool ModelLibrary::Contains(const UUID& uuid)
@@ -144,6 +153,9 @@ namespace Luth
             newModel->SetUUID(uuid);
             it->second = { newModel, newTime };
             LH_CORE_INFO("Successfully reloaded Model {0}", uuid.ToString());
+
+            lock.unlock();
+            SkinnedVertexCache::RemoveModel(uuid);
             return true;
         }
         catch (const std::exception& e) {
@@ -159,6 +171,7 @@ namespace Luth
 
         size_t successCount = 0;
         size_t failCount = 0;
+        std::vector<UUID> reloaded;
 
         for (auto& [uuid, record] : s_Models) {
             auto path = ResourceDB::UuidToInfo(uuid).Path;
@@ -186,6 +199,7 @@ namespace Luth
 
                 newModel->SetUUID(uuid);
                 record = { newModel, newTime };
+                reloaded.push_back(uuid);
                 successCount++;
             }
             catch (const std::exception& e) {
@@ -195,6 +209,10 @@ namespace Luth
         }
 
         LH_CORE_INFO("Reloaded Models: {0} succeeded, {1} failed", successCount, failCount);
+
+        lock.unlock();
+        for (const UUID& uuid : reloaded)
+            SkinnedVertexCache::RemoveModel(uuid);
     }
 
     bool ModelLibrary::Save(const UUID& modelUUID)
@@ -223,7 +241,11 @@ namespace Luth
                 json["type_settings"] = {
                     {"import_normals", true},
                     {"import_tangents", false},
-                    {"optimize_mesh", true}
+                    {"optimize_mesh", true},
+                    {"quantize_vertices", false},
+                    {"lod_count", 3},
+                    {"lod_reduction", 0.5},
+                    {"build_meshlets", true}
                 };
             }
 
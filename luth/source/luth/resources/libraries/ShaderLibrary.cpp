@@ -1,9 +1,40 @@
 #include "luthpch.h"
 #include "luth/resources/libraries/ShaderLibrary.h"
 #include "luth/resources/ResourceDB.h"
+#include "luth/resources/MetaFile.h"
+#include "luth/renderer/ShaderKeywords.h"
+#include "luth/renderer/ShaderPreprocessor.h"
 
 namespace Luth
 {
+    namespace
+    {
+        // Compiles the variants listed in the meta's "prewarm_variants",
+        // each entry being a list of keyword names: [ ["LH_SKINNED", "LH_NORMAL_MAP"], ... ]
+        void PrewarmVariants(Shader& shader, const fs::path& filePath, const UUID& uuid)
+        {
+            fs::path metaPath = filePath;
+            metaPath += ".meta";
+
+            MetaFile meta(uuid);
+            if (!fs::exists(metaPath) || !meta.Load(metaPath)) return;
+
+            const auto& settings = meta.GetTypeSettings();
+            auto it = settings.find("prewarm_variants");
+            if (it == settings.end() || !it->is_array()) return;
+
+            for (const auto& variant : *it) {
+                u32 keywords = 0;
+                for (const auto& name : variant) {
+                    const u32 bit = name.is_string() ? ShaderKeywords::FromName(name.get<std::string>()) : 0;
+                    if (!bit) LH_CORE_WARN("Unknown keyword {0} in {1}", name.dump(), metaPath.string());
+                    keywords |= bit;
+                }
+                shader.Prewarm(keywords);
+            }
+        }
+    }
+
     std::shared_mutex ShaderLibrary::s_Mutex;
     std::unordered_map<UUID, ShaderLibrary::ShaderRecord, UUIDHash> ShaderLibrary::s_Shaders;
     std::unordered_map<std::string, UUID> ShaderLibrary::s_NameToUuidMap;
@@ -18,6 +49,8 @@ namespace Luth
     {
         std::unique_lock lock(s_Mutex);
         s_Shaders.clear();
+        s_Dependencies.clear();
+        ShaderPreprocessor::Clear();
         LH_CORE_INFO("Cleared Shader Library");
     }
 
@@ -52,6 +85,7 @@ namespace Luth
     bool ShaderLibrary::Remove(const UUID& uuid)
     {
         std::unique_lock lock(s_Mutex);
+        UntrackDependencies(uuid);
         return s_Shaders.erase(uuid) > 0;
     }
 
@@ -114,11 +148,14 @@ namespace Luth
             return nullptr;
         }
 
-        auto modTime = fs::last_write_time(filePath);
+        PrewarmVariants(*shader, filePath, uuid);
+
+        auto modTime = NewestDependency(*shader);
         std::string name = filePath.filename().stem().string();
 
         std::unique_lock lock(s_Mutex);
         s_Shaders[uuid] = { shader, name, filePath, modTime };
+        TrackDependencies(uuid, *shader);
         shader->SetUUID(uuid);
         shader->SetName(name);
 
@@ -159,65 +196,98 @@ namespace Luth
             return false;
         }
 
-        const auto newTime = fs::last_write_time(record.SourcePath);
-        if (newTime <= record.LastModified)
+        if (NewestDependency(*record.Shader) <= record.LastModified)
             return true; // Already up-to-date
 
-        try {
-            auto newShader = Shader::Create(record.SourcePath);
-            if (!newShader)
-                throw std::runtime_error("Compilation failed");
-
-            newShader->SetUUID(uuid);
-            record.Shader = newShader;
-            record.LastModified = newTime;
-
-            LH_CORE_INFO("Successfully reloaded Shader {0}", uuid.ToString());
-            return true;
-        }
-        catch (const std::exception& e) {
-            LH_CORE_ERROR("Failed to reload Shader {0}: {1}", uuid.ToString(), e.what());
+        if (!ReloadRecord(uuid, record)) {
+            LH_CORE_ERROR("Failed to reload Shader {0}", uuid.ToString());
             return false;
         }
+
+        LH_CORE_INFO("Successfully reloaded Shader {0}", uuid.ToString());
+        return true;
     }
 
     void ShaderLibrary::ReloadAll()
     {
         std::unique_lock lock(s_Mutex);
-        LH_CORE_INFO("Reloading all shaders...");
+        LH_CORE_INFO("Reloading changed shaders...");
 
-        size_t successCount = 0;
-        size_t failCount = 0;
+        // Only files that changed since the last pass, then the shaders including them
+        std::unordered_set<UUID, UUIDHash> affected;
+        for (auto& [file, dependency] : s_Dependencies) {
+            std::error_code ec;
+            const auto time = fs::last_write_time(file, ec);
+            if (ec || time <= dependency.LastModified) continue;
 
-        for (auto& [uuid, record] : s_Shaders) {
-            if (record.SourcePath.empty()) continue;
+            dependency.LastModified = time;
+            affected.insert(dependency.Dependents.begin(), dependency.Dependents.end());
+        }
 
-            if (!fs::exists(record.SourcePath)) {
-                LH_CORE_ERROR("Shader source missing: {0}", record.SourcePath.string());
-                failCount++;
-                continue;
-            }
+        size_t successCount = 0;
+        size_t failCount = 0;
 
-            const auto newTime = fs::last_write_time(record.SourcePath);
-            if (newTime <= record.LastModified)
-                continue;
+        for (const UUID& uuid : affected) {
+            auto it = s_Shaders.find(uuid);
+            if (it == s_Shaders.end() || it->second.SourcePath.empty()) continue;
 
-            try {
-                auto newShader = Shader::Create(record.SourcePath);
-                if (!newShader)
-                    throw std::runtime_error("Compilation failed");
+            // Reload(uuid) may have picked the change up already
+            auto& record = it->second;
+            if (NewestDependency(*record.Shader) <= record.LastModified) continue;
 
-                newShader->SetUUID(uuid);
-                record.Shader = newShader;
-                record.LastModified = newTime;
+            if (ReloadRecord(uuid, record)) {
                 successCount++;
             }
-            catch (const std::exception& e) {
-                LH_CORE_ERROR("Reload failed for {0}: {1}", uuid.ToString(), e.what());
+            else {
+                LH_CORE_ERROR("Reload failed for {0}", record.SourcePath.string());
                 failCount++;
             }
         }
 
         LH_CORE_INFO("Reloaded Shaders: {0} succeeded, {1} failed", successCount, failCount);
     }
+
+    bool ShaderLibrary::ReloadRecord(const UUID& uuid, ShaderRecord& record)
+    {
+        // Stamped before compiling, a failed edit is not retried until the next save
+        record.LastModified = NewestDependency(*record.Shader);
+        if (!record.Shader->Reload()) return false;
+
+        PrewarmVariants(*record.Shader, record.SourcePath, uuid);
+        TrackDependencies(uuid, *record.Shader);
+        record.LastModified = std::max(record.LastModified, NewestDependency(*record.Shader));
+        return true;
+    }
+
+    void ShaderLibrary::TrackDependencies(const UUID& uuid, const Shader& shader)
+    {
+        UntrackDependencies(uuid);
+        for (const auto& file : shader.GetDependencies()) {
+            auto& dependency = s_Dependencies[file];
+            if (dependency.Dependents.empty()) {
+                std::error_code ec;
+                dependency.LastModified = fs::last_write_time(file, ec);
+            }
+            dependency.Dependents.insert(uuid);
+        }
+    }
+
+    void ShaderLibrary::UntrackDependencies(const UUID& uuid)
+    {
+        for (auto it = s_Dependencies.begin(); it != s_Dependencies.end(); ) {
+            it->second.Dependents.erase(uuid);
+            it = it->second.Dependents.empty() ? s_Dependencies.erase(it) : std::next(it);
+        }
+    }
+
+    fs::file_time_type ShaderLibrary::NewestDependency(const Shader& shader)
+    {
+        fs::file_time_type newest{};
+        for (const auto& file : shader.GetDependencies()) {
+            std::error_code ec;
+            const auto time = fs::last_write_time(file, ec);
+            if (!ec) newest = std::max(newest, time);
+        }
+        return newest;
+    }
 }
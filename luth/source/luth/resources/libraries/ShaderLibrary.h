@@ -5,6 +5,7 @@
 #include "luth/renderer/Shader.h"
 
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
@@ -18,7 +19,7 @@ namespace Luth
             std::shared_ptr<Shader> Shader;
             std::string Name;
             fs::path SourcePath;
-            fs::file_time_type LastModified;
+            fs::file_time_type LastModified;    // Newest of the source and its includes
         };
 
         static void Init();
@@ -38,13 +39,26 @@ namespace Luth
         static std::shared_ptr<Shader> Load(const fs::path& filePath);
         static std::shared_ptr<Shader> LoadOrGet(const fs::path& filePath);
 
-        // Reload functionality
+        // Reload functionality. ReloadAll rebuilds only the shaders whose source or
+        // includes changed since the last pass, found through the reverse dependency map
         static bool Reload(const UUID& uuid);
         static void ReloadAll();
 
     private:
+        // Source or include file -> shaders built from it
+        struct Dependency {
+            fs::file_time_type LastModified;
+            std::unordered_set<UUID, UUIDHash> Dependents;
+        };
+
+        static bool ReloadRecord(const UUID& uuid, ShaderRecord& record);
+        static void TrackDependencies(const UUID& uuid, const Shader& shader);
+        static void UntrackDependencies(const UUID& uuid);
+        static fs::file_time_type NewestDependency(const Shader& shader);
+
         static std::shared_mutex s_Mutex;
         static std::unordered_map<UUID, ShaderRecord, UUIDHash> s_Shaders;
         static std::unordered_map<std::string, UUID> s_NameToUuidMap;
+        static inline std::unordered_map<fs::path, Dependency> s_Dependencies;
     };
 }
@@ -0,0 +1,123 @@
+#include "luthpch.h"
+#include "luth/resources/libraries/VertexAnimationLibrary.h"
+#include "luth/resources/libraries/ModelLibrary.h"
+#include "luth/renderer/SkinnedModel.h"
+
+namespace Luth
+{
+    std::shared_mutex VertexAnimationLibrary::s_Mutex;
+    std::map<VertexAnimationLibrary::Key, std::shared_ptr<VertexAnimationTexture>> VertexAnimationLibrary::s_Animations;
+    std::map<VertexAnimationLibrary::Key, std::future<std::shared_ptr<VertexAnimationTexture>>> VertexAnimationLibrary::s_Pending;
+
+    void VertexAnimationLibrary::Shutdown()
+    {
+        std::unique_lock lock(s_Mutex);
+        for (auto& [key, pending] : s_Pending)
+            pending.wait();
+        s_Pending.clear();
+        s_Animations.clear();
+    }
+
+    std::shared_ptr<VertexAnimationTexture> VertexAnimationLibrary::Get(const UUID& modelUUID, i32 animationIndex)
+    {
+        const Key key{ modelUUID, animationIndex };
+        {
+            std::shared_lock lock(s_Mutex);
+            auto it = s_Animations.find(key);
+            if (it != s_Animations.end() && !s_Pending.contains(key)) return it->second;
+        }
+
+        std::unique_lock lock(s_Mutex);
+        auto it = s_Animations.find(key);
+
+        auto pending = s_Pending.find(key);
+        if (pending != s_Pending.end()) {
+            if (pending->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return it != s_Animations.end() ? it->second : nullptr;
+
+            auto vat = pending->second.get();
+            s_Pending.erase(pending);
+
+            // A failed rebake keeps the previous bake
+            auto& slot = s_Animations[key];
+            if (vat || !slot) slot = vat;
+            return slot;
+        }
+
+        if (it != s_Animations.end()) return it->second;
+
+        Schedule(key, false, 30.0f);
+        return nullptr;
+    }
+
+    void VertexAnimationLibrary::Bake(const UUID& modelUUID, i32 animationIndex, f32 frameRate)
+    {
+        const Key key{ modelUUID, animationIndex };
+
+        std::unique_lock lock(s_Mutex);
+        if (s_Pending.contains(key)) {
+            LH_CORE_WARN("Vertex animation {0} of {1} is already baking", animationIndex, modelUUID.ToString());
+            return;
+        }
+        Schedule(key, true, frameRate);
+    }
+
+    // Caller holds s_Mutex
+    void VertexAnimationLibrary::Schedule(const Key& key, bool rebake, f32 frameRate)
+    {
+        s_Pending[key] = ThreadPool::Get().Submit([key, rebake, frameRate] {
+            return LoadOrBake(key, rebake, frameRate);
+        });
+    }
+
+    std::shared_ptr<VertexAnimationTexture> VertexAnimationLibrary::LoadOrBake(const Key& key, bool rebake, f32 frameRate)
+    {
+        const auto& [modelUUID, animationIndex] = key;
+
+        // Held for the whole job, a reload swaps the library entry but not this model
+        auto model = ModelLibrary::Get(modelUUID);
+        if (!model) return nullptr;
+
+        // Cooked file is valid as long as it is newer than the source model and its
+        // import settings (mesh optimization changes the vertex order)
+        if (!rebake) {
+            const fs::path cooked = GetCookedPath(*model, animationIndex);
+            const fs::path& source = model->GetCachedModelInfo().Path;
+            fs::path meta = source;
+            meta += ".meta";
+            std::error_code ec;
+            auto sourceTime = fs::last_write_time(source, ec);
+            if (fs::exists(meta, ec)) sourceTime = std::max(sourceTime, fs::last_write_time(meta, ec));
+
+            if (fs::exists(cooked, ec) && fs::last_write_time(cooked, ec) >= sourceTime) {
+                if (auto vat = VertexAnimationTexture::Load(cooked)) return vat;
+            }
+        }
+
+        auto skinned = std::dynamic_pointer_cast<SkinnedModel>(model);
+        if (!skinned) {
+            LH_CORE_ERROR("Vertex animation bake needs a skinned model: {0}", modelUUID.ToString());
+            return nullptr;
+        }
+
+        auto vat = VertexAnimationBaker::Bake(*skinned, animationIndex, frameRate);
+        if (!vat) return nullptr;
+
+        // Rejected bakes are neither cooked nor drawn
+        const f32 error = VertexAnimationBaker::Validate(*skinned, animationIndex, *vat);
+        if (error > VertexAnimationBaker::k_Tolerance) {
+            LH_CORE_ERROR("Baked '{0}' deviates from live skinning by {1:.4f} (relative), keeping live skinning",
+                vat->GetClipName(), error);
+            return nullptr;
+        }
+
+        vat->Save(GetCookedPath(*skinned, animationIndex));
+        return vat;
+    }
+
+    fs::path VertexAnimationLibrary::GetCookedPath(const Model& model, i32 animationIndex)
+    {
+        const fs::path& source = model.GetCachedModelInfo().Path;
+        return source.parent_path() / (source.stem().string() + "_" + std::to_string(animationIndex) + ".lvat");
+    }
+}
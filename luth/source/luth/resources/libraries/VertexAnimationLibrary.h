@@ -0,0 +1,43 @@
+#pragma once
+
+#include "luth/core/UUID.h"
+#include "luth/renderer/VertexAnimation.h"
+
+#include <future>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+
+namespace Luth
+{
+    class Model;
+
+    // Baked clips, cooked next to their model as <model>_<clip>.lvat.
+    // Loading and baking run on the ThreadPool; until a clip is ready, and for good once
+    // it failed (static model, bad clip, bake outside tolerance), Get returns nullptr and
+    // the caller draws with regular skinning.
+    class VertexAnimationLibrary
+    {
+    public:
+        // Waits for in-flight bakes
+        static void Shutdown();
+
+        // Loads the cooked clip, baking (and cooking) it first if missing or stale
+        static std::shared_ptr<VertexAnimationTexture> Get(const UUID& modelUUID, i32 animationIndex);
+        // Forces a rebake and overwrites the cooked file, the previous bake serves until then
+        static void Bake(const UUID& modelUUID, i32 animationIndex, f32 frameRate = 30.0f);
+
+        static fs::path GetCookedPath(const Model& model, i32 animationIndex);
+
+    private:
+        using Key = std::pair<UUID, i32>;
+
+        static void Schedule(const Key& key, bool rebake, f32 frameRate);
+        static std::shared_ptr<VertexAnimationTexture> LoadOrBake(const Key& key, bool rebake, f32 frameRate);
+
+        static std::shared_mutex s_Mutex;
+        // nullptr entries are failed clips, not retried until an explicit Bake
+        static std::map<Key, std::shared_ptr<VertexAnimationTexture>> s_Animations;
+        static std::map<Key, std::future<std::shared_ptr<VertexAnimationTexture>>> s_Pending;
+    };
+}
@@ -0,0 +1,155 @@
+#include "Test.h"
+
+#include "luth/renderer/CpuSkinning.h"
+#include "luth/renderer/Model.h"
+#include "luth/renderer/SkinnedModel.h"
+#include "SkinningFixtures.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Luth
+{
+    using namespace Tests;
+
+    namespace
+    {
+        constexpr f32 k_Eps = 1e-4f;
+
+        VertexBoneData SingleBone(u16 bone)
+        {
+            VertexBoneData b;
+            b.BoneIDs = { bone, 0, 0, 0 };
+            b.Weights = { 65535, 0, 0, 0 };
+            return b;
+        }
+    }
+
+    LH_TEST(CpuSkinning_IdentityPaletteKeepsBindPose)
+    {
+        std::vector<Vertex> vertices = { MakeVertex({ 1, 2, 3 }, { 0, 1, 0 }, { 1, 0, 0 }),
+                                         MakeVertex({ -4, 0, 2 }, { 0, 0, 1 }, { 0, 1, 0 }) };
+        std::vector<VertexBoneData> bones = { SingleBone(0), SingleBone(1) };
+        std::vector<Mat4> palette(2, Mat4(1.0f));
+
+        SkinnedMeshCache out;
+        CpuSkinning::Skin(vertices, bones, palette, out, true);
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            LH_CHECK_VEC3_NEAR(out.Positions[i], vertices[i].Position, k_Eps);
+            LH_CHECK_VEC3_NEAR(out.Normals[i], vertices[i].Normal, k_Eps);
+            LH_CHECK_VEC3_NEAR(out.Tangents[i], vertices[i].Tangent, k_Eps);
+        }
+        LH_CHECK_VEC3_NEAR(out.BoundsMin, Vec3(-4, 0, 2), k_Eps);
+        LH_CHECK_VEC3_NEAR(out.BoundsMax, Vec3(1, 2, 3), k_Eps);
+    }
+
+    LH_TEST(CpuSkinning_BlendsTwoBones)
+    {
+        // Half on a bone moved +2 in X, half on the identity: the vertex moves +1
+        Vertex v = MakeVertex({ 0, 1, 0 }, { 0, 1, 0 }, { 1, 0, 0 });
+        VertexBoneData b;
+        b.BoneIDs = { 0, 1, 0, 0 };
+        b.Weights = { 32768, 32767, 0, 0 };
+        std::vector<Mat4> palette = { glm::translate(Mat4(1.0f), Vec3(2, 0, 0)), Mat4(1.0f) };
+
+        Vec3 p, n, t;
+        Vec3 bmin(FLOAT_MAX), bmax(-FLOAT_MAX);
+        CpuSkinning::SkinScalar(&v, &b, 0, 1, palette.data(), 2, &p, &n, &t, bmin, bmax);
+
+        LH_CHECK_VEC3_NEAR(p, Vec3(1, 1, 0), 1e-3f);
+        // Translation does not touch directions
+        LH_CHECK_VEC3_NEAR(n, Vec3(0, 1, 0), k_Eps);
+        LH_CHECK_VEC3_NEAR(t, Vec3(1, 0, 0), k_Eps);
+        LH_CHECK_VEC3_NEAR(bmin, p, k_Eps);
+        LH_CHECK_VEC3_NEAR(bmax, p, k_Eps);
+    }
+
+    LH_TEST(CpuSkinning_RotatesDirections)
+    {
+        Vertex v = MakeVertex({ 1, 0, 0 }, { 1, 0, 0 }, { 0, 0, 1 });
+        VertexBoneData b = SingleBone(0);
+        const Mat4 rot = glm::rotate(Mat4(1.0f), glm::radians(90.0f), Vec3(0, 1, 0));
+
+        Vec3 p, n, t;
+        Vec3 bmin(FLOAT_MAX), bmax(-FLOAT_MAX);
+        CpuSkinning::SkinScalar(&v, &b, 0, 1, &rot, 1, &p, &n, &t, bmin, bmax);
+
+        LH_CHECK_VEC3_NEAR(p, Vec3(0, 0, -1), k_Eps);
+        LH_CHECK_VEC3_NEAR(n, Vec3(0, 0, -1), k_Eps);
+        LH_CHECK_VEC3_NEAR(t, Vec3(1, 0, 0), k_Eps);
+    }
+
+    LH_TEST(CpuSkinning_InvalidInfluencesKeepBindPose)
+    {
+        // No weights, and a bone outside the palette: both stay in bind pose
+        Vertex v0 = MakeVertex({ 1, 2, 3 }, { 0, 1, 0 }, { 1, 0, 0 });
+        Vertex v1 = MakeVertex({ 3, 2, 1 }, { 0, 0, 1 }, { 0, 1, 0 });
+        std::vector<Vertex> vertices = { v0, v1 };
+        std::vector<VertexBoneData> bones = { VertexBoneData{}, SingleBone(7) };
+        std::vector<Mat4> palette = { glm::translate(Mat4(1.0f), Vec3(10, 0, 0)) };
+
+        SkinnedMeshCache out;
+        CpuSkinning::Skin(vertices, bones, palette, out, true);
+
+        LH_CHECK_VEC3_NEAR(out.Positions[0], v0.Position, k_Eps);
+        LH_CHECK_VEC3_NEAR(out.Positions[1], v1.Position, k_Eps);
+        LH_CHECK_VEC3_NEAR(out.Normals[1], v1.Normal, k_Eps);
+    }
+
+    LH_TEST(CpuSkinning_ParallelMatchesScalar)
+    {
+        // Large enough to split into several ThreadPool jobs
+        std::vector<Vertex> vertices;
+        std::vector<VertexBoneData> bones;
+        MakeRandomMesh(10000, 32, vertices, bones);
+        const std::vector<Mat4> palette = MakeRandomPalette(32);
+
+        std::vector<Vec3> p(vertices.size()), n(vertices.size()), t(vertices.size());
+        Vec3 bmin(FLOAT_MAX), bmax(-FLOAT_MAX);
+        CpuSkinning::SkinScalar(vertices.data(), bones.data(), 0, vertices.size(), palette.data(), 32,
+                                p.data(), n.data(), t.data(), bmin, bmax);
+
+        SkinnedMeshCache out;
+        CpuSkinning::Skin(vertices, bones, palette, out, true);
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            LH_CHECK_VEC3_NEAR(out.Positions[i], p[i], k_Eps);
+            LH_CHECK_VEC3_NEAR(out.Normals[i], n[i], k_Eps);
+        }
+        LH_CHECK_VEC3_NEAR(out.BoundsMin, bmin, k_Eps);
+        LH_CHECK_VEC3_NEAR(out.BoundsMax, bmax, k_Eps);
+    }
+
+    LH_TEST(CpuSkinning_SIMDMatchesScalar)
+    {
+        if (!CpuSkinning::HasSIMD()) {
+            LH_CORE_WARN("  AVX2 unavailable, SIMD skinning not tested");
+            return;
+        }
+
+        // Odd count to cover the SIMD tail
+        std::vector<Vertex> vertices;
+        std::vector<VertexBoneData> bones;
+        MakeRandomMesh(1027, 64, vertices, bones);
+        const std::vector<Mat4> palette = MakeRandomPalette(64);
+        const size_t count = vertices.size();
+
+        std::vector<Vec3> sp(count), sn(count), st(count);
+        std::vector<Vec3> vp(count), vn(count), vt(count);
+        Vec3 sMin(FLOAT_MAX), sMax(-FLOAT_MAX), vMin(FLOAT_MAX), vMax(-FLOAT_MAX);
+
+        CpuSkinning::SkinScalar(vertices.data(), bones.data(), 0, count, palette.data(), 64,
+                                sp.data(), sn.data(), st.data(), sMin, sMax);
+        CpuSkinning::SkinSIMD(vertices.data(), bones.data(), 0, count, palette.data(), 64,
+                              vp.data(), vn.data(), vt.data(), vMin, vMax);
+
+        // FMA changes rounding, not results
+        for (size_t i = 0; i < count; ++i) {
+            LH_CHECK_VEC3_NEAR(vp[i], sp[i], 1e-3f);
+            LH_CHECK_VEC3_NEAR(vn[i], sn[i], 1e-3f);
+            LH_CHECK_VEC3_NEAR(vt[i], st[i], 1e-3f);
+        }
+        LH_CHECK_VEC3_NEAR(vMin, sMin, 1e-3f);
+        LH_CHECK_VEC3_NEAR(vMax, sMax, 1e-3f);
+    }
+}
@@ -0,0 +1,182 @@
+#include "Test.h"
+
+#include "luth/renderer/GeometryAllocator.h"
+#include "luth/renderer/IndirectDraw.h"
+
+namespace Luth
+{
+    using namespace Tests;
+
+    LH_TEST(FreeListAllocator_FirstFitAndExhaustion)
+    {
+        FreeListAllocator allocator(100);
+
+        LH_CHECK(allocator.Allocate(40) == 0);
+        LH_CHECK(allocator.Allocate(50) == 40);
+        LH_CHECK(allocator.GetUsed() == 90);
+        LH_CHECK(allocator.Allocate(11) == FreeListAllocator::k_Invalid);
+        LH_CHECK(allocator.Allocate(0) == FreeListAllocator::k_Invalid);
+        LH_CHECK(allocator.Allocate(10) == 90);
+        LH_CHECK(allocator.GetFreeBlockCount() == 0);
+        LH_CHECK(allocator.Allocate(1) == FreeListAllocator::k_Invalid);
+    }
+
+    LH_TEST(FreeListAllocator_FreeReusesHole)
+    {
+        FreeListAllocator allocator(100);
+        const u32 a = allocator.Allocate(30);
+        const u32 b = allocator.Allocate(30);
+        allocator.Allocate(30);
+
+        allocator.Free(b);
+        LH_CHECK(allocator.GetUsed() == 60);
+        LH_CHECK(allocator.GetFreeBlockCount() == 2);
+
+        // First fit takes the hole before the tail
+        LH_CHECK(allocator.Allocate(20) == b);
+        LH_CHECK(allocator.Allocate(10) == b + 20);
+        LH_CHECK(allocator.Allocate(10) == 90);
+
+        // Unknown offsets are ignored
+        allocator.Free(a + 1);
+        LH_CHECK(allocator.GetUsed() == 100);
+    }
+
+    LH_TEST(FreeListAllocator_CoalescesBothNeighbours)
+    {
+        FreeListAllocator allocator(100);
+        const u32 a = allocator.Allocate(25);
+        const u32 b = allocator.Allocate(25);
+        const u32 c = allocator.Allocate(25);
+        const u32 d = allocator.Allocate(25);
+
+        allocator.Free(a);
+        allocator.Free(c);
+        LH_CHECK(allocator.GetFreeBlockCount() == 2);
+        LH_CHECK(allocator.GetLargestFreeBlock() == 25);
+
+        // Merges with the free block before and after it
+        allocator.Free(b);
+        LH_CHECK(allocator.GetFreeBlockCount() == 1);
+        LH_CHECK(allocator.GetLargestFreeBlock() == 75);
+        LH_CHECK(allocator.Allocate(75) == 0);
+
+        allocator.Free(0);
+        allocator.Free(d);
+        LH_CHECK(allocator.GetFreeBlockCount() == 1);
+        LH_CHECK(allocator.GetLargestFreeBlock() == 100);
+        LH_CHECK(allocator.GetUsed() == 0);
+        LH_CHECK(allocator.GetAllocationCount() == 0);
+    }
+
+    LH_TEST(FreeListAllocator_GrowOnDemand)
+    {
+        // The geometry pool starts empty and grows when an allocation does not fit
+        FreeListAllocator allocator;
+        LH_CHECK(allocator.Allocate(10) == FreeListAllocator::k_Invalid);
+
+        allocator.Grow(16);
+        LH_CHECK(allocator.Allocate(10) == 0);
+        LH_CHECK(allocator.Allocate(10) == FreeListAllocator::k_Invalid);
+
+        // The new space merges with the trailing free block
+        allocator.Grow(32);
+        LH_CHECK(allocator.GetFreeBlockCount() == 1);
+        LH_CHECK(allocator.GetLargestFreeBlock() == 22);
+        LH_CHECK(allocator.Allocate(22) == 10);
+
+        // Full buffer: the new space is a block of its own
+        allocator.Grow(40);
+        LH_CHECK(allocator.GetFreeBlockCount() == 1);
+        LH_CHECK(allocator.Allocate(8) == 32);
+
+        allocator.Grow(20);
+        LH_CHECK(allocator.GetCapacity() == 40);
+    }
+
+    LH_TEST(GeometryPool_IndexSizeFromVertexCount)
+    {
+        LH_CHECK(SelectIndexSize(3) == 2);
+        LH_CHECK(SelectIndexSize(0xFFFF) == 2);
+        LH_CHECK(SelectIndexSize(0x10000) == 4);
+        LH_CHECK(SelectIndexSize(1u << 20) == 4);
+    }
+
+    LH_TEST(IndirectDrawList_CommandsFromRanges)
+    {
+        GeometryAllocation geometry;
+        geometry.Pool = 0;
+        geometry.BaseVertex = 1000;
+        geometry.FirstIndex = 5000;
+        geometry.IndexCount = 600;
+
+        const MeshIndexRange ranges[] = { { 0, 300 }, { 300, 0 }, { 420, 180 } };
+
+        IndirectDrawList list;
+        list.Add(geometry, ranges, 3, 4, 12);
+
+        const auto& commands = list.GetCommands();
+        LH_CHECK(commands.size() == 2);    // Empty ranges are skipped
+        LH_CHECK(commands[0].Count == 300);
+        LH_CHECK(commands[0].InstanceCount == 4);
+        LH_CHECK(commands[0].FirstIndex == 5000);
+        LH_CHECK(commands[0].BaseVertex == 1000);
+        LH_CHECK(commands[0].BaseInstance == 12);
+        LH_CHECK(commands[1].Count == 180);
+        LH_CHECK(commands[1].FirstIndex == 5420);
+        LH_CHECK(commands[1].BaseVertex == 1000);
+        LH_CHECK(commands[1].BaseInstance == 12);
+
+        // Add without BeginGroup opens a default group
+        LH_CHECK(list.GetGroups().size() == 1);
+        LH_CHECK(list.GetGroups()[0].CommandCount == 2);
+
+        // No instances, no commands
+        list.Add(geometry, ranges, 1, 0, 16);
+        LH_CHECK(list.GetCommands().size() == 2);
+    }
+
+    LH_TEST(IndirectDrawList_Groups)
+    {
+        GeometryAllocation a;
+        a.Pool = 0;
+        a.BaseVertex = 0;
+        a.FirstIndex = 0;
+        GeometryAllocation b;
+        b.Pool = 0;
+        b.BaseVertex = 64;
+        b.FirstIndex = 96;
+
+        const MeshIndexRange whole = { 0, 96 };
+
+        IndirectDrawList list;
+        list.BeginGroup(7);
+        list.Add(a, &whole, 1, 1, 0);
+        list.Add(b, &whole, 1, 3, 1);
+
+        // An empty group is reused by the next BeginGroup
+        list.BeginGroup(8);
+        list.BeginGroup(9);
+        list.Add(b, &whole, 1, 2, 4);
+
+        const auto& groups = list.GetGroups();
+        LH_CHECK(groups.size() == 2);
+        LH_CHECK(groups[0].Tag == 7);
+        LH_CHECK(groups[0].FirstCommand == 0);
+        LH_CHECK(groups[0].CommandCount == 2);
+        LH_CHECK(groups[1].Tag == 9);
+        LH_CHECK(groups[1].FirstCommand == 2);
+        LH_CHECK(groups[1].CommandCount == 1);
+
+        const auto& commands = list.GetCommands();
+        LH_CHECK(commands[1].FirstIndex == 96);
+        LH_CHECK(commands[1].BaseVertex == 64);
+        LH_CHECK(commands[1].BaseInstance == 1);
+        LH_CHECK(commands[2].InstanceCount == 2);
+        LH_CHECK(commands[2].BaseInstance == 4);
+
+        list.Clear();
+        LH_CHECK(list.GetCommands().empty());
+        LH_CHECK(list.GetGroups().empty());
+    }
+}
@@ -0,0 +1,96 @@
+#include "Test.h"
+
+#include "luth/renderer/LightClusters.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+
+namespace Luth
+{
+    using namespace Tests;
+
+    namespace
+    {
+        // Lights around and inside the frustum, some behind the camera or past the far
+        // plane, a few huge or zero ranges to hit the edge cases of the slice bounds
+        std::vector<ClusterLight> MakeRandomLights(u32 count, u32 seed)
+        {
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<f32> xy(-60.0f, 60.0f);
+            std::uniform_real_distribution<f32> z(-140.0f, 20.0f);
+            std::uniform_real_distribution<f32> range(0.5f, 12.0f);
+            std::uniform_int_distribution<int> special(0, 31);
+
+            std::vector<ClusterLight> lights(count);
+            for (auto& light : lights) {
+                light.Position = Vec3(xy(rng), xy(rng), z(rng));
+                light.Range = range(rng);
+                switch (special(rng)) {
+                    case 0: light.Range = 0.0f; break;
+                    case 1: light.Range = 80.0f; break;
+                    case 2: light.Position.z = 0.05f; break;    // Straddles the near plane
+                    default: break;
+                }
+            }
+            return lights;
+        }
+
+        // Same light list per cluster, offsets into the index list may differ
+        void CheckSameClusters(const LightClusters& a, const LightClusters& b)
+        {
+            LH_CHECK(a.GetRanges().size() == LightClusters::k_ClusterCount);
+            LH_CHECK(b.GetRanges().size() == LightClusters::k_ClusterCount);
+            if (a.GetRanges().size() != b.GetRanges().size()) return;
+
+            u32 mismatches = 0;
+            for (size_t c = 0; c < a.GetRanges().size(); ++c) {
+                const ClusterRange ra = a.GetRanges()[c];
+                const ClusterRange rb = b.GetRanges()[c];
+                bool same = ra.Count == rb.Count;
+                for (u32 i = 0; same && i < ra.Count; ++i)
+                    same = a.GetIndices()[ra.Offset + i] == b.GetIndices()[rb.Offset + i];
+                if (!same && mismatches++ < 4)
+                    Fail(__FILE__, __LINE__, FMT("cluster {} differs ({} vs {} lights)", c, ra.Count, rb.Count));
+            }
+            LH_CHECK(mismatches == 0);
+        }
+
+        void CheckAgainstReference(const Mat4& projection, u32 seed)
+        {
+            const Mat4 view = glm::lookAt(Vec3(3.0f, 2.0f, 10.0f), Vec3(0.0f, 0.0f, -40.0f), Vec3(0.0f, 1.0f, 0.0f));
+
+            for (u32 count : { 0u, 1u, 37u, 512u }) {
+                const std::vector<ClusterLight> lights = MakeRandomLights(count, seed + count);
+
+                LightClusters reference, simd, scalar;
+                reference.SetProjection(projection);
+                simd.SetProjection(projection);
+                scalar.SetProjection(projection);
+
+                reference.BuildReference(view, lights.data(), count);
+                simd.Build(view, lights.data(), count);
+                scalar.Build(view, lights.data(), count, true);
+
+                CheckSameClusters(reference, simd);
+                CheckSameClusters(reference, scalar);
+            }
+        }
+    }
+
+    LH_TEST(LightClusters_PerspectiveMatchesReference)
+    {
+        CheckAgainstReference(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f), 11);
+        CheckAgainstReference(glm::perspective(glm::radians(90.0f), 4.0f / 3.0f, 0.5f, 300.0f), 23);
+    }
+
+    LH_TEST(LightClusters_OrthographicMatchesReference)
+    {
+        LightClusters clusters;
+        clusters.SetProjection(glm::ortho(-40.0f, 40.0f, -22.5f, 22.5f, 0.1f, 100.0f));
+        LH_CHECK(clusters.IsOrthographic());
+
+        CheckAgainstReference(glm::ortho(-40.0f, 40.0f, -22.5f, 22.5f, 0.1f, 100.0f), 31);
+        CheckAgainstReference(glm::ortho(-10.0f, 30.0f, -5.0f, 15.0f, -20.0f, 150.0f), 47);
+    }
+}
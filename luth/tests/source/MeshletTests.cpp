@@ -0,0 +1,239 @@
+#include "Test.h"
+
+#include "luth/renderer/Meshlet.h"
+#include "luth/renderer/Model.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <unordered_set>
+
+namespace Luth
+{
+    using namespace Tests;
+
+    namespace
+    {
+        // Closed cube of half size 1, 'n' x 'n' quads per face, counter-clockwise seen from outside.
+        // Faces have their own vertices (hard edges), so every meshlet stays on one face
+        void MakeCube(u32 n, std::vector<Vertex>& vertices, std::vector<u32>& indices)
+        {
+            const Vec3 normals[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+            for (const Vec3& normal : normals) {
+                const Vec3 u = std::abs(normal.y) > 0.5f ? Vec3(1, 0, 0) : glm::normalize(glm::cross(Vec3(0, 1, 0), normal));
+                const Vec3 v = glm::cross(normal, u);
+
+                const u32 base = static_cast<u32>(vertices.size());
+                for (u32 y = 0; y <= n; ++y) {
+                    for (u32 x = 0; x <= n; ++x) {
+                        const f32 s = 2.0f * x / n - 1.0f, t = 2.0f * y / n - 1.0f;
+                        Vertex vertex{};
+                        vertex.Position = normal + u * s + v * t;
+                        vertex.Normal = normal;
+                        vertices.push_back(vertex);
+                    }
+                }
+                for (u32 y = 0; y < n; ++y) {
+                    for (u32 x = 0; x < n; ++x) {
+                        const u32 i0 = base + y * (n + 1) + x, i1 = i0 + 1, i2 = i0 + n + 1, i3 = i2 + 1;
+                        indices.insert(indices.end(), { i0, i1, i3, i0, i3, i2 });
+                    }
+                }
+            }
+        }
+
+        // Triangles rotated to start at their smallest index (winding kept), sorted
+        std::vector<std::array<u32, 3>> TriangleSet(const std::vector<u32>& indices)
+        {
+            std::vector<std::array<u32, 3>> triangles;
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                std::array<u32, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+                std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+                triangles.push_back(t);
+            }
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        }
+
+        const Meshlet* FindFaceMeshlet(const std::vector<Meshlet>& meshlets, const Vec3& normal)
+        {
+            for (const auto& meshlet : meshlets)
+                if (meshlet.ConeCutoff <= 1.0f && glm::dot(meshlet.ConeAxis, normal) > 0.999f) return &meshlet;
+            return nullptr;
+        }
+
+        Meshlet MakeSphereMeshlet(const Vec3& center, f32 radius, u32 indexOffset, u32 indexCount)
+        {
+            Meshlet meshlet;
+            meshlet.Center = center;
+            meshlet.Radius = radius;
+            meshlet.IndexOffset = indexOffset;
+            meshlet.IndexCount = indexCount;
+            return meshlet;
+        }
+    }
+
+    LH_TEST(MeshletBuilder_LimitsAndTriangleSet)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<u32> indices;
+        MakeCube(16, vertices, indices);
+        const auto before = TriangleSet(indices);
+
+        const std::vector<Meshlet> meshlets = MeshletBuilder::Build(indices, vertices);
+        LH_CHECK(meshlets.size() > 6);
+        LH_CHECK(TriangleSet(indices) == before);
+
+        u32 offset = 0;
+        for (const auto& meshlet : meshlets) {
+            LH_CHECK(meshlet.IndexOffset == offset);
+            LH_CHECK(meshlet.IndexCount % 3 == 0);
+            LH_CHECK(meshlet.IndexCount / 3 <= MeshletBuilder::k_MaxTriangles);
+            offset += meshlet.IndexCount;
+
+            std::unordered_set<u32> unique(indices.begin() + meshlet.IndexOffset,
+                                           indices.begin() + meshlet.IndexOffset + meshlet.IndexCount);
+            LH_CHECK(unique.size() <= MeshletBuilder::k_MaxVertices);
+            LH_CHECK(unique.size() == meshlet.VertexCount);
+        }
+        LH_CHECK(offset == indices.size());
+    }
+
+    LH_TEST(MeshletBuilder_BoundsContainVertices)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<u32> indices;
+        MakeCube(16, vertices, indices);
+        const std::vector<Meshlet> meshlets = MeshletBuilder::Build(indices, vertices);
+
+        for (const auto& meshlet : meshlets) {
+            for (u32 i = 0; i < meshlet.IndexCount; ++i) {
+                const Vec3& p = vertices[indices[meshlet.IndexOffset + i]].Position;
+                LH_CHECK(glm::distance(p, meshlet.Center) <= meshlet.Radius + 1e-5f);
+            }
+        }
+
+        // Closed cube: every meshlet is planar, its cone is the face normal
+        LH_CHECK(FindFaceMeshlet(meshlets, Vec3(0, 0, 1)) != nullptr);
+        LH_CHECK(FindFaceMeshlet(meshlets, Vec3(-1, 0, 0)) != nullptr);
+    }
+
+    LH_TEST(MeshletBuilder_OpenMeshHasNoCones)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<u32> indices;
+        MakeCube(4, vertices, indices);
+        indices.resize(indices.size() / 6);     // First face only, open borders
+
+        for (const auto& meshlet : MeshletBuilder::Build(indices, vertices))
+            LH_CHECK(meshlet.ConeCutoff > 1.0f);
+    }
+
+    LH_TEST(MeshletCuller_FrustumRejection)
+    {
+        const Mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        const Vec3 eye(0.0f, 0.0f, 10.0f);
+        const Mat4 view = glm::lookAt(eye, Vec3(0.0f), Vec3(0, 1, 0));
+        const MeshletCullView cullView = MeshletCuller::MakeView(projection * view, Mat4(1.0f), eye,
+                                                                 Vec3(0, 0, -1), false, false);
+
+        LH_CHECK(!MeshletCuller::IsOutsideFrustum(MakeSphereMeshlet(Vec3(0.0f), 1.0f, 0, 3), cullView));
+        LH_CHECK(MeshletCuller::IsOutsideFrustum(MakeSphereMeshlet(Vec3(0, 0, 20), 1.0f, 0, 3), cullView));     // Behind
+        LH_CHECK(MeshletCuller::IsOutsideFrustum(MakeSphereMeshlet(Vec3(50, 0, 0), 1.0f, 0, 3), cullView));     // Right
+        LH_CHECK(MeshletCuller::IsOutsideFrustum(MakeSphereMeshlet(Vec3(0, 0, -200), 1.0f, 0, 3), cullView));   // Past far
+        // Center outside, sphere straddling the left plane
+        LH_CHECK(!MeshletCuller::IsOutsideFrustum(MakeSphereMeshlet(Vec3(-11, 0, 0), 2.0f, 0, 3), cullView));
+
+        // The model matrix moves the meshlets, planes follow into model space
+        const MeshletCullView moved = MeshletCuller::MakeView(projection * view,
+            glm::translate(Mat4(1.0f), Vec3(0, 0, 30)), eye, Vec3(0, 0, -1), false, false);
+        LH_CHECK(MeshletCuller::IsOutsideFrustum(MakeSphereMeshlet(Vec3(0.0f), 1.0f, 0, 3), moved));
+    }
+
+    LH_TEST(MeshletCuller_MergesAdjacentSurvivors)
+    {
+        const Mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+        const Vec3 eye(0.0f, 0.0f, 10.0f);
+        const MeshletCullView view = MeshletCuller::MakeView(projection * glm::lookAt(eye, Vec3(0.0f), Vec3(0, 1, 0)),
+                                                             Mat4(1.0f), eye, Vec3(0, 0, -1), false, false);
+
+        const Vec3 inside(0.0f), outside(0, 0, 50);
+        const std::vector<Meshlet> meshlets = {
+            MakeSphereMeshlet(inside, 1.0f, 0, 30),
+            MakeSphereMeshlet(inside, 1.0f, 30, 60),
+            MakeSphereMeshlet(outside, 1.0f, 90, 30),
+            MakeSphereMeshlet(inside, 1.0f, 120, 30),
+            MakeSphereMeshlet(inside, 1.0f, 150, 12),
+        };
+
+        std::vector<MeshIndexRange> ranges = { { 999, 3 } };    // Ranges of a previous draw are left alone
+        MeshletCullStats stats;
+        LH_CHECK(MeshletCuller::Cull(meshlets, view, ranges, &stats) == 4);
+
+        LH_CHECK(ranges.size() == 3);
+        LH_CHECK(ranges[0].IndexOffset == 999);
+        LH_CHECK(ranges[1].IndexOffset == 0);
+        LH_CHECK(ranges[1].IndexCount == 90);
+        LH_CHECK(ranges[2].IndexOffset == 120);
+        LH_CHECK(ranges[2].IndexCount == 42);
+        LH_CHECK(stats.Tested == 5);
+        LH_CHECK(stats.FrustumCulled == 1);
+        LH_CHECK(stats.BackfaceCulled == 0);
+
+        // Everything visible: one range over the whole built mesh
+        std::vector<Vertex> vertices;
+        std::vector<u32> indices;
+        MakeCube(16, vertices, indices);
+        const std::vector<Meshlet> cube = MeshletBuilder::Build(indices, vertices);
+
+        ranges.clear();
+        LH_CHECK(MeshletCuller::Cull(cube, view, ranges) == cube.size());
+        LH_CHECK(ranges.size() == 1);
+        LH_CHECK(ranges[0].IndexOffset == 0);
+        LH_CHECK(ranges[0].IndexCount == indices.size());
+    }
+
+    LH_TEST(MeshletCuller_NormalCone)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<u32> indices;
+        MakeCube(8, vertices, indices);
+        const std::vector<Meshlet> meshlets = MeshletBuilder::Build(indices, vertices);
+
+        const Meshlet* front = FindFaceMeshlet(meshlets, Vec3(0, 0, 1));
+        LH_CHECK(front != nullptr);
+        if (!front) return;
+
+        MeshletCullView view;
+        view.CullBackfaces = true;
+
+        // Perspective: in front, behind, and in the face's plane (edge-on)
+        view.Position = Vec3(0, 0, 5);
+        LH_CHECK(!MeshletCuller::IsBackfacing(*front, view));
+        view.Position = Vec3(0, 0, -5);
+        LH_CHECK(MeshletCuller::IsBackfacing(*front, view));
+        view.Position = Vec3(10, 0, 1);
+        LH_CHECK(!MeshletCuller::IsBackfacing(*front, view));
+
+        // Orthographic: looking at the face, from behind it, along it
+        view.Orthographic = true;
+        view.Direction = Vec3(0, 0, -1);
+        LH_CHECK(!MeshletCuller::IsBackfacing(*front, view));
+        view.Direction = Vec3(0, 0, 1);
+        LH_CHECK(MeshletCuller::IsBackfacing(*front, view));
+        view.Direction = Vec3(-1, 0, 0);
+        LH_CHECK(!MeshletCuller::IsBackfacing(*front, view));
+
+        // Cull only rejects back faces when the draw culls them too
+        view.Planes = CreateFrustumFromCamera(glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, -10.0f, 10.0f));
+        view.Direction = Vec3(0, 0, 1);
+        std::vector<MeshIndexRange> ranges;
+        MeshletCullStats stats;
+        LH_CHECK(MeshletCuller::Cull({ *front }, view, ranges, &stats) == 0);
+        LH_CHECK(stats.BackfaceCulled == 1);
+
+        view.CullBackfaces = false;
+        LH_CHECK(MeshletCuller::Cull({ *front }, view, ranges) == 1);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/renderer/Model.h"
+#include "luth/renderer/SkinnedModel.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+#include <vector>
+
+// Deterministic skinned meshes and palettes shared by the skinning and baking tests
+namespace Luth::Tests
+{
+    inline Vertex MakeVertex(const Vec3& p, const Vec3& n, const Vec3& t)
+    {
+        Vertex v{};
+        v.Position = p;
+        v.Normal = n;
+        v.Tangent = t;
+        return v;
+    }
+
+    // Random mesh with up to 4 influences per vertex summing to 65535, like the importer writes
+    inline void MakeRandomMesh(size_t count, u16 boneCount, std::vector<Vertex>& vertices, std::vector<VertexBoneData>& bones)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<f32> pos(-2.0f, 2.0f);
+        std::uniform_int_distribution<int> id(0, boneCount - 1);
+        std::uniform_int_distribution<int> influences(1, 4);
+
+        vertices.resize(count);
+        bones.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            vertices[i] = MakeVertex(Vec3(pos(rng), pos(rng), pos(rng)),
+                                     glm::normalize(Vec3(pos(rng), pos(rng), pos(rng)) + Vec3(0.0f, 0.0f, 5.0f)),
+                                     glm::normalize(Vec3(pos(rng), pos(rng), pos(rng)) + Vec3(5.0f, 0.0f, 0.0f)));
+
+            const int n = influences(rng);
+            u32 remaining = 65535;
+            for (int k = 0; k < n; ++k) {
+                const u16 w = k == n - 1 ? static_cast<u16>(remaining)
+                                         : static_cast<u16>(remaining / (n - k) + k * 97);
+                bones[i].BoneIDs[k] = static_cast<u16>(id(rng));
+                bones[i].Weights[k] = w;
+                remaining -= w;
+            }
+        }
+    }
+
+    inline std::vector<Mat4> MakeRandomPalette(u32 count)
+    {
+        std::mt19937 rng(99);
+        std::uniform_real_distribution<f32> d(-1.0f, 1.0f);
+        std::vector<Mat4> palette(count);
+        for (auto& m : palette) {
+            m = glm::translate(Mat4(1.0f), Vec3(d(rng), d(rng), d(rng)))
+              * glm::rotate(Mat4(1.0f), d(rng) * 3.0f, glm::normalize(Vec3(d(rng), d(rng), d(rng)) + Vec3(0.0f, 2.0f, 0.0f)))
+              * glm::scale(Mat4(1.0f), Vec3(1.0f + 0.25f * d(rng)));
+        }
+        return palette;
+    }
+}
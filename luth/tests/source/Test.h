@@ -0,0 +1,71 @@
+#pragma once
+
+#include "luth/core/LuthTypes.h"
+#include "luth/core/Log.h"
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal headless test harness, no GL context and no window.
+// LH_TEST registers a test at static init, LuthTests runs them all and
+// returns the number of failed tests.
+namespace Luth::Tests
+{
+    struct TestCase {
+        const char* Name;
+        std::function<void()> Fn;
+    };
+
+    inline std::vector<TestCase>& Registry()
+    {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    // Failed checks of the running test
+    inline u32& Failures()
+    {
+        static u32 failures = 0;
+        return failures;
+    }
+
+    struct Registrar {
+        Registrar(const char* name, std::function<void()> fn) { Registry().push_back({ name, std::move(fn) }); }
+    };
+
+    inline void Fail(const char* file, int line, const std::string& what)
+    {
+        LH_CORE_ERROR("  {}({}): {}", file, line, what);
+        Failures()++;
+    }
+}
+
+#define LH_TEST_CONCAT_IMPL(a, b) a##b
+#define LH_TEST_CONCAT(a, b) LH_TEST_CONCAT_IMPL(a, b)
+
+#define LH_TEST(name)                                                                   \
+    static void LH_TEST_CONCAT(LuthTest_, name)();                                      \
+    static ::Luth::Tests::Registrar LH_TEST_CONCAT(LuthTestReg_, name)(#name, &LH_TEST_CONCAT(LuthTest_, name)); \
+    static void LH_TEST_CONCAT(LuthTest_, name)()
+
+#define LH_CHECK(condition)                                                             \
+    do {                                                                                \
+        if (!(condition)) ::Luth::Tests::Fail(__FILE__, __LINE__, #condition);         \
+    } while(0)
+
+#define LH_CHECK_NEAR(a, b, eps)                                                        \
+    do {                                                                                \
+        const double lhA = static_cast<double>(a), lhB = static_cast<double>(b);        \
+        if (!(std::abs(lhA - lhB) <= (eps)))                                            \
+            ::Luth::Tests::Fail(__FILE__, __LINE__,                                     \
+                FMT("{} = {} vs {} = {}", #a, lhA, #b, lhB));                           \
+    } while(0)
+
+#define LH_CHECK_VEC3_NEAR(a, b, eps)                                                   \
+    do {                                                                                \
+        LH_CHECK_NEAR((a).x, (b).x, eps);                                               \
+        LH_CHECK_NEAR((a).y, (b).y, eps);                                               \
+        LH_CHECK_NEAR((a).z, (b).z, eps);                                               \
+    } while(0)
@@ -0,0 +1,29 @@
+#include "Test.h"
+
+int main(int argc, char** argv)
+{
+    Luth::Log::Init();
+
+    // Optional filter: only run tests whose name contains argv[1]
+    const std::string filter = argc > 1 ? argv[1] : "";
+
+    u32 run = 0, failed = 0;
+    for (const auto& test : Luth::Tests::Registry()) {
+        if (!filter.empty() && std::string(test.Name).find(filter) == std::string::npos) continue;
+
+        Luth::Tests::Failures() = 0;
+        test.Fn();
+        run++;
+
+        if (Luth::Tests::Failures() > 0) {
+            LH_CORE_ERROR("[FAIL] {} ({} checks)", test.Name, Luth::Tests::Failures());
+            failed++;
+        }
+        else {
+            LH_CORE_INFO("[ OK ] {}", test.Name);
+        }
+    }
+
+    LH_CORE_INFO("{} tests, {} failed", run, failed);
+    return static_cast<int>(failed);
+}
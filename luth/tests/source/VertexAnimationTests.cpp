@@ -0,0 +1,61 @@
+#include "Test.h"
+#include "SkinningFixtures.h"
+
+#include "luth/renderer/CpuSkinning.h"
+#include "luth/renderer/VertexAnimation.h"
+
+#include <glm/gtx/component_wise.hpp>
+
+namespace Luth
+{
+    using namespace Tests;
+
+    // Baked (half float) positions against the scalar reference skinner, with the same
+    // relative metric and tolerance the library uses to accept a bake
+    LH_TEST(VertexAnimation_BakedMatchesCpuSkinning)
+    {
+        std::vector<Vertex> vertices;
+        std::vector<VertexBoneData> bones;
+        MakeRandomMesh(4099, 48, vertices, bones);
+        const size_t count = vertices.size();
+
+        std::vector<BakedVertex> baked(count);
+        std::vector<Vec3> p(count), n(count), t(count);
+
+        // A few distinct poses stand in for frames of a clip
+        for (u32 frame = 0; frame < 4; ++frame) {
+            std::vector<Mat4> palette = MakeRandomPalette(48);
+            for (auto& m : palette)
+                m = glm::rotate(Mat4(1.0f), 0.7f * frame, Vec3(0, 1, 0)) * m;
+
+            VertexAnimationBaker::BakeFrame(vertices, bones, palette, baked.data());
+
+            Vec3 bmin(FLOAT_MAX), bmax(-FLOAT_MAX);
+            CpuSkinning::SkinScalar(vertices.data(), bones.data(), 0, count, palette.data(), 48,
+                                    p.data(), n.data(), t.data(), bmin, bmax);
+
+            f32 maxError = 0.0f;
+            for (size_t v = 0; v < count; ++v)
+                maxError = std::max(maxError, glm::length(VertexAnimationBaker::DecodePosition(baked[v]) - p[v]));
+
+            const f32 extent = std::max(glm::compMax(glm::abs(bmin)), glm::compMax(glm::abs(bmax)));
+            LH_CHECK(extent > 0.0f);
+            LH_CHECK(maxError / extent <= VertexAnimationBaker::k_Tolerance);
+        }
+    }
+
+    LH_TEST(VertexAnimation_BindPoseRoundTrips)
+    {
+        // Identity palette: the bake is the rest pose up to half precision
+        std::vector<Vertex> vertices;
+        std::vector<VertexBoneData> bones;
+        MakeRandomMesh(257, 4, vertices, bones);
+        const std::vector<Mat4> palette(4, Mat4(1.0f));
+
+        std::vector<BakedVertex> baked(vertices.size());
+        VertexAnimationBaker::BakeFrame(vertices, bones, palette, baked.data());
+
+        for (size_t v = 0; v < vertices.size(); ++v)
+            LH_CHECK_VEC3_NEAR(VertexAnimationBaker::DecodePosition(baked[v]), vertices[v].Position, 2e-3f);
+    }
+}
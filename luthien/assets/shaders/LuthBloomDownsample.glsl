@@ -0,0 +1,80 @@
+#type vertex
+#version 460 core
+
+layout(location = 0) in vec2 a_Position;
+out vec2 v_TexCoord;
+
+void main()
+{
+    gl_Position = vec4(a_Position, 0.0, 1.0);
+    v_TexCoord = a_Position * 0.5 + 0.5;
+}
+
+
+
+#type fragment
+#version 460 core
+
+// 13-tap downsample (Jimenez, "Next Generation Post Processing in Call of Duty"):
+// five overlapping 2x2 boxes, the center one weighted 0.5, the corners 0.125 each.
+// On the first level the scene is thresholded and each box is Karis averaged so
+// single bright pixels don't flicker as the camera moves.
+
+#include "LuthTransform.glslh"
+
+layout(binding = 0) uniform sampler2D u_Source;
+uniform bool u_Prefilter;
+uniform float u_Threshold;
+
+in vec2 v_TexCoord;
+out vec4 FragColor;
+
+float Luminance(vec3 c) { return dot(c, vec3(0.2126, 0.7152, 0.0722)); }
+
+vec3 Prefilter(vec3 c)
+{
+    return c * smoothstep(u_Threshold, u_Threshold + 0.1, Luminance(c));
+}
+
+vec3 Box(vec3 a, vec3 b, vec3 c, vec3 d, float weight)
+{
+    if (!u_Prefilter) return (a + b + c + d) * (0.25 * weight);
+
+    a = Prefilter(a); b = Prefilter(b); c = Prefilter(c); d = Prefilter(d);
+    float wa = 1.0 / (1.0 + Luminance(a));
+    float wb = 1.0 / (1.0 + Luminance(b));
+    float wc = 1.0 / (1.0 + Luminance(c));
+    float wd = 1.0 / (1.0 + Luminance(d));
+    return (a * wa + b * wb + c * wc + d * wd) / (wa + wb + wc + wd) * weight;
+}
+
+void main()
+{
+    vec2 size = vec2(textureSize(u_Source, 0));
+    vec2 t = 1.0 / size;
+    vec2 uv = RenderUV(v_TexCoord);
+
+    // Taps stay inside the drawn part of the source
+    vec2 lo = 0.5 * t, hi = renderScale.xy - 0.5 * t;
+    vec3 a = texture(u_Source, clamp(uv + t * vec2(-2.0,  2.0), lo, hi)).rgb;
+    vec3 b = texture(u_Source, clamp(uv + t * vec2( 0.0,  2.0), lo, hi)).rgb;
+    vec3 c = texture(u_Source, clamp(uv + t * vec2( 2.0,  2.0), lo, hi)).rgb;
+    vec3 d = texture(u_Source, clamp(uv + t * vec2(-2.0,  0.0), lo, hi)).rgb;
+    vec3 e = texture(u_Source, clamp(uv, lo, hi)).rgb;
+    vec3 f = texture(u_Source, clamp(uv + t * vec2( 2.0,  0.0), lo, hi)).rgb;
+    vec3 g = texture(u_Source, clamp(uv + t * vec2(-2.0, -2.0), lo, hi)).rgb;
+    vec3 h = texture(u_Source, clamp(uv + t * vec2( 0.0, -2.0), lo, hi)).rgb;
+    vec3 i = texture(u_Source, clamp(uv + t * vec2( 2.0, -2.0), lo, hi)).rgb;
+    vec3 j = texture(u_Source, clamp(uv + t * vec2(-1.0,  1.0), lo, hi)).rgb;
+    vec3 k = texture(u_Source, clamp(uv + t * vec2( 1.0,  1.0), lo, hi)).rgb;
+    vec3 l = texture(u_Source, clamp(uv + t * vec2(-1.0, -1.0), lo, hi)).rgb;
+    vec3 m = texture(u_Source, clamp(uv + t * vec2( 1.0, -1.0), lo, hi)).rgb;
+
+    vec3 color = Box(j, k, l, m, 0.5)
+               + Box(a, b, d, e, 0.125)
+               + Box(b, c, e, f, 0.125)
+               + Box(d, e, g, h, 0.125)
+               + Box(e, f, h, i, 0.125);
+
+    FragColor = vec4(max(color, 0.0), 1.0);
+}
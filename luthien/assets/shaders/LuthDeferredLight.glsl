@@ -20,92 +20,24 @@ void main()
 // ========== Input/Output ==========
 layout(location = 0) in vec2 v_TexCoord;
 
-// G-Buffer Inputs
-layout(binding = 0) uniform sampler2D o_Position;
+// G-Buffer Inputs (layout in LuthGBuffer.glslh)
+layout(binding = 0) uniform sampler2D o_Depth;
 layout(binding = 1) uniform sampler2D o_Normal;
 layout(binding = 2) uniform sampler2D o_Albedo;
-layout(binding = 3) uniform sampler2D o_MRO;
-layout(binding = 4) uniform sampler2D o_ET;
+layout(binding = 3) uniform sampler2D o_MRAO;
+layout(binding = 4) uniform sampler2D o_Emissive;
 layout(binding = 5) uniform sampler2D o_SSAO;
 
 layout(location = 0) out vec4 FragColor;
 
 // ========== UBO Definitions ==========
-layout(std140, binding = 0) uniform TransformUBO {
-    mat4 view;
-    mat4 projection;
-    mat4 model;
-};
-
-#define MAX_DIR_LIGHTS 4
-#define MAX_POINT_LIGHTS 16
-
-struct DirLight {
-    vec3 color;
-    float intensity;
-    vec3 direction;
-    float padding;
-};
-
-struct PointLight {
-    vec3 color;
-    float intensity;
-    vec3 position;
-    float range;
-};
-
-layout(std140, binding = 1) uniform LightsUBO {
-    int dirLightCount;
-    DirLight dirLights[MAX_DIR_LIGHTS];
-    
-    int pointLightCount;
-    PointLight pointLights[MAX_POINT_LIGHTS];
-};
+#include "LuthTransform.glslh"
+#include "LuthLights.glslh"
+#include "LuthClusters.glslh"
+#include "LuthGBuffer.glslh"
 
 // ========== PBR Functions ==========
-const float PI = 3.14159265359;
-
-float DistributionGGX(vec3 N, vec3 H, float roughness) {
-    float a = roughness*roughness;
-    float a2 = a*a;
-    float NdotH = max(dot(N, H), 0.0);
-    return a2 / (PI * pow(NdotH*NdotH*(a2 - 1.0) + 1.0, 2.0));
-}
-
-float GeometrySchlickGGX(float NdotV, float roughness) {
-    float r = (roughness + 1.0);
-    float k = (r*r) / 8.0;
-    return NdotV / (NdotV * (1.0 - k) + k);
-}
-
-float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
-    return GeometrySchlickGGX(max(dot(N, V), 0.0), roughness) * 
-           GeometrySchlickGGX(max(dot(N, L), 0.0), roughness);
-}
-
-vec3 FresnelSchlick(float cosTheta, vec3 F0) {
-    return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
-}
-
-// ========== Light Calculation ==========
-vec3 CalculateLight(vec3 L, vec3 radiance, vec3 V, vec3 N, vec3 albedo, float metallic, float roughness) {
-    vec3 H = normalize(V + L);
-    
-    vec3 F0 = mix(vec3(0.04), albedo, metallic);
-    vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
-    
-    float NDF = DistributionGGX(N, H, roughness);
-    float G = GeometrySmith(N, V, L, roughness);
-    
-    vec3 numerator = NDF * G * F;
-    float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
-    vec3 specular = numerator / denominator;
-    
-    vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
-    vec3 diffuse = kD * albedo / PI;
-    
-    return (diffuse + specular) * radiance * max(dot(N, L), 0.0);
-}
+#include "LuthBRDF.glslh"
 
 vec3 CalculateSubsurface(vec3 L, vec3 radiance, vec3 V, vec3 N, vec3 albedo, float metallic, float thickness) {
     vec3 transL = -L;
@@ -123,24 +55,28 @@ vec3 CalculateSubsurface(vec3 L, vec3 radiance, vec3 V, vec3 N, vec3 albedo, flo
 // ========== Main Shader ==========
 void main()
 {
-    // Retrieve G-Buffer data
-    vec3 WorldPos = texture(o_Position, v_TexCoord).rgb;
-    vec3 N = normalize(texture(o_Normal, v_TexCoord).rgb);
-    vec4 albedoAlpha = texture(o_Albedo, v_TexCoord);
-    vec3 MRO = texture(o_MRO, v_TexCoord).rgb;
-    vec4 ET = texture(o_ET, v_TexCoord);
-    float SSAO = texture(o_SSAO, v_TexCoord).r;
+    // Retrieve G-Buffer data, nothing to light where no geometry was drawn
+    vec2 uv = RenderUV(v_TexCoord);
+    vec4 MRAO = texture(o_MRAO, uv);
+    if ((UnpackFlags(MRAO.a) & GBUFFER_LIT) == 0u) {
+        FragColor = vec4(0.0);
+        return;
+    }
+
+    vec3 WorldPos = WorldPosFromDepth(v_TexCoord, texture(o_Depth, uv).r);
+    vec3 N = OctDecode(texture(o_Normal, uv).rg);
+    vec4 albedoThickness = texture(o_Albedo, uv);
+    float SSAO = texture(o_SSAO, uv).r;
     
-    vec3 albedo = albedoAlpha.rgb;
-    float alpha = albedoAlpha.a;
-    float metallic = MRO.r;
-    float roughness = MRO.g;
-    float ao = MRO.b * SSAO;
-    vec3 emissive = ET.rgb;
-    float thickness = ET.a;
+    vec3 albedo = albedoThickness.rgb;
+    float alpha = 1.0;
+    float metallic = MRAO.r;
+    float roughness = MRAO.g;
+    float ao = MRAO.b * SSAO;
+    vec3 emissive = texture(o_Emissive, uv).rgb;
+    float thickness = albedoThickness.a;
 
     // View direction
-    mat4 invView = inverse(view);
     vec3 viewPos = invView[3].xyz;
     vec3 V = normalize(viewPos - WorldPos);
     
@@ -160,11 +96,13 @@ void main()
         }
     }
 
-    // Point lights
-    for(int i = 0; i < pointLightCount && i < MAX_POINT_LIGHTS; i++) {
-        vec3 toLight = pointLights[i].position - WorldPos;
+    // Point lights, only those binned into this fragment's cluster
+    uvec2 cluster = ClusterLights(WorldPos);
+    for(uint i = 0u; i < cluster.y; i++) {
+        PointLight light = pointLights[u_ClusterLightIndices[cluster.x + i]];
+        vec3 toLight = light.position - WorldPos;
         float distance = length(toLight);
-        float scaledDistance = distance / pointLights[i].range;
+        float scaledDistance = distance / light.range;
         
         if(scaledDistance > 1.0) continue;
         
@@ -172,7 +110,7 @@ void main()
         float attenuation = 1.0 / (distance * distance);
         attenuation = clamp(1.0 - pow(scaledDistance, 4.0), 0.0, 1.0);
         vec3 L = normalize(toLight);
-        vec3 radiance = pointLights[i].color * pointLights[i].intensity * attenuation;
+        vec3 radiance = light.color * light.intensity * attenuation;
 
         float NdotL = dot(N, L);
     
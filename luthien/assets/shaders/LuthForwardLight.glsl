@@ -1,13 +1,20 @@
+// Variants, one program per keyword combination in use (see ShaderKeywords.h)
+#pragma multi_compile LH_SKINNED
+#pragma multi_compile LH_ALPHA_CUTOUT LH_ALPHA_BLEND LH_ALPHA_FROM_DIFFUSE
+#pragma multi_compile LH_GLOSS LH_SINGLE_CHANNEL
+#pragma multi_compile LH_DIFFUSE_MAP LH_ALPHA_MAP LH_NORMAL_MAP LH_METAL_MAP LH_ROUGH_MAP
+#pragma multi_compile LH_OCCLUSION_MAP LH_EMISSIVE_MAP LH_THICKNESS_MAP
+
 #type vertex
 #version 460 core
 
 // Vertex Attributes
-layout(location = 0) in vec3 a_Position;
+layout(location = 0) in vec4 a_Position;    // w: bitangent sign when quantized, 1 otherwise
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord0;
 layout(location = 3) in vec2 a_TexCoord1;
 layout(location = 4) in vec3 a_Tangent;
-layout(location = 5) in ivec4 a_BoneIDs;
+layout(location = 5) in uvec4 a_BoneIDs;
 layout(location = 6) in vec4 a_BoneWeights;
 
 // Outputs to Fragment Shader
@@ -21,13 +28,20 @@ layout(location = 6) flat out ivec4 v_BoneIDs;
 layout(location = 7) out vec4 v_BoneWeights;
 
 // Uniform Buffers
-layout(std140, binding = 0) uniform TransformUBO {
-    mat4 view;
-    mat4 projection;
+#include "LuthTransform.glslh"
+
+uniform mat4 u_Model;
+
+// Instanced static draws, indexed by the indirect command's base instance (see InstanceBatcher.h)
+struct InstanceData {
     mat4 model;
 };
 
-uniform mat4 u_Model;
+layout(std430, binding = 5) readonly buffer Instances {
+    InstanceData u_Instances[];
+};
+
+uniform bool u_IsInstanced;
 
 // Bone Transformations
 const int MAX_BONES = 512;
@@ -37,38 +51,69 @@ layout(std140, binding = 2) uniform BonesUBO {
     mat4 u_BoneMatrices[MAX_BONES];
 };
 
-uniform bool u_IsSkinned;
+// Quantized static vertices (see VertexQuantization.h)
+uniform bool u_VertexQuantized;
+uniform vec3 u_PosOffset;
+uniform vec3 u_PosScale;
+
+#include "LuthOctahedral.glslh"
+#include "LuthSkinnedVertices.glslh"
 
 void main()
 {
-    // Bone transform
-    mat4 boneTransform = mat4(1.0);
-    if (u_IsSkinned) {
-        boneTransform  = u_BoneMatrices[a_BoneIDs.x] * a_BoneWeights.x;
-        boneTransform += u_BoneMatrices[a_BoneIDs.y] * a_BoneWeights.y;
-        boneTransform += u_BoneMatrices[a_BoneIDs.z] * a_BoneWeights.z;
-        boneTransform += u_BoneMatrices[a_BoneIDs.w] * a_BoneWeights.w;
+    mat4 model = u_IsInstanced ? u_Instances[gl_BaseInstance + gl_InstanceID].model : u_Model;
+
+    // Vertex decode
+    vec3 position = a_Position.xyz;
+    vec3 normal = a_Normal;
+    vec3 tangent = a_Tangent;
+    float bitangentSign = 1.0;
+    if (u_VertexQuantized) {
+        position = u_PosOffset + a_Position.xyz * u_PosScale;
+        normal = OctDecode(a_Normal.xy);
+        tangent = OctDecode(a_Tangent.xy);
+        bitangentSign = a_Position.w * 2.0 - 1.0;
+    }
+
+    vec3 skinnedPos, skinnedNormal, skinnedTangent;
+    if (u_CpuSkinned) {
+        SkinnedVertex skinned = FetchSkinnedVertex();
+        skinnedPos = skinned.position.xyz;
+        skinnedNormal = skinned.normal.xyz;
+        skinnedTangent = skinned.tangent.xyz;
+    }
+    else {
+        // Bone transform
+        mat4 boneTransform = mat4(1.0);
+#ifdef LH_SKINNED
+        if (dot(a_BoneWeights, vec4(1.0)) > 0.0) {
+            boneTransform  = u_BoneMatrices[a_BoneIDs.x] * a_BoneWeights.x;
+            boneTransform += u_BoneMatrices[a_BoneIDs.y] * a_BoneWeights.y;
+            boneTransform += u_BoneMatrices[a_BoneIDs.z] * a_BoneWeights.z;
+            boneTransform += u_BoneMatrices[a_BoneIDs.w] * a_BoneWeights.w;
+        }
+#endif
+
+        mat3 boneRotation = mat3(boneTransform);
+        skinnedPos = vec3(boneTransform * vec4(position, 1.0));
+        skinnedNormal = boneRotation * normal;
+        skinnedTangent = boneRotation * tangent;
     }
 
     // Position transformation
-    vec4 skinnedPosition = boneTransform * vec4(a_Position, 1.0);
-    v_WorldPos = vec3(u_Model * skinnedPosition);
+    v_WorldPos = vec3(model * vec4(skinnedPos, 1.0));
     gl_Position = projection * view * vec4(v_WorldPos, 1.0);
     
     // Normal/tangent transformation
-    mat3 boneRotation = mat3(boneTransform);
-    vec3 skinnedNormal = boneRotation * a_Normal;
-    vec3 skinnedTangent = boneRotation * a_Tangent;
-    
-    mat3 modelNormalMatrix = transpose(inverse(mat3(u_Model)));
+    mat3 modelNormalMatrix = transpose(inverse(mat3(model)));
     v_Normal = normalize(modelNormalMatrix * skinnedNormal);
     v_Tangent = normalize(modelNormalMatrix * skinnedTangent);
-    v_Bitangent = normalize(cross(v_Normal, v_Tangent));
+    v_Bitangent = normalize(cross(v_Normal, v_Tangent)) * bitangentSign;
     
     // Pass through other data
     v_TexCoord0 = a_TexCoord0;
     v_TexCoord1 = a_TexCoord1;
-    v_BoneIDs = a_BoneIDs;
+    v_BoneIDs = ivec4(a_BoneIDs);
     v_BoneWeights = a_BoneWeights;
 }
 
@@ -91,123 +136,20 @@ layout(location = 7) in vec4 v_BoneWeights;
 layout(location = 0) out vec4 FragColor;
 
 // ========== UBO Definitions ==========
-layout(std140, binding = 0) uniform TransformUBO {
-    mat4 view;
-    mat4 projection;
-    mat4 model;
-};
-
-#define MAX_DIR_LIGHTS 4
-#define MAX_POINT_LIGHTS 16
-
-struct DirLight {
-    vec3 color;
-    float intensity;
-    vec3 direction;
-    float padding;
-};
-
-struct PointLight {
-    vec3 color;
-    float intensity;
-    vec3 position;
-    float range;
-};
-
-layout(std140, binding = 1) uniform LightsUBO {
-    int dirLightCount;
-    DirLight dirLights[MAX_DIR_LIGHTS];
-    
-    int pointLightCount;
-    PointLight pointLights[MAX_POINT_LIGHTS];
-};
+#include "LuthTransform.glslh"
+#include "LuthLights.glslh"
+#include "LuthClusters.glslh"
 
 // ========== Material Uniforms =========
-#define Diffuse   0
-#define Alpha     1
-#define Normal    2
-#define Metal     3
-#define Rough     4
-#define Specular  5
-#define Oclusion  6
-#define Emissive  7
-#define Thickness 8
-
-struct Map {
-    bool useMap;
-    bool useTexture;
-    sampler2D texture;
-    int uvIndex;
-};
-
-struct Subsurface {
-    vec3 color;
-    float strength;
-    float thicknessScale;
-};
-
-uniform Map u_Maps[9];
-
-uniform int u_RenderMode;       // 0 = Opaque, 1 = Cutout, 2 = Transparent, 3 = Fade
-uniform float u_AlphaCutoff;    // For cutout mode
-uniform int u_AlphaFromDiffuse;
-uniform int u_IsGloss;
-uniform int u_IsSingleChannel;
-
-uniform vec4 u_Color;
-uniform float u_Alpha;
-uniform float u_Metalness;
-uniform float u_Roughness;
-uniform vec3 u_Emissive;
-uniform Subsurface u_Subsurface;
+#include "LuthMaterial.glslh"
 
 // ========== PBR Functions ==========
-const float PI = 3.14159265359;
-
-float DistributionGGX(vec3 N, vec3 H, float roughness) {
-    float a = roughness*roughness;
-    float a2 = a*a;
-    float NdotH = max(dot(N, H), 0.0);
-    return a2 / (PI * pow(NdotH*NdotH*(a2 - 1.0) + 1.0, 2.0));
-}
-
-float GeometrySchlickGGX(float NdotV, float roughness) {
-    float r = (roughness + 1.0);
-    float k = (r*r) / 8.0;
-    return NdotV / (NdotV * (1.0 - k) + k);
-}
-
-float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
-    return GeometrySchlickGGX(max(dot(N, V), 0.0), roughness) * 
-           GeometrySchlickGGX(max(dot(N, L), 0.0), roughness);
-}
-
-vec3 FresnelSchlick(float cosTheta, vec3 F0) {
-    return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
-}
-
-// ========== Light Calculation ==========
-vec3 CalculateLight(vec3 L, vec3 radiance, vec3 V, vec3 N, vec3 albedo, float metallic, float roughness) {
-    vec3 H = normalize(V + L);
-    
-    vec3 F0 = mix(vec3(0.04), albedo, metallic);
-    vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
-    
-    float NDF = DistributionGGX(N, H, roughness);
-    float G = GeometrySmith(N, V, L, roughness);
-    
-    vec3 numerator = NDF * G * F;
-    float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
-    vec3 specular = numerator / denominator;
-    
-    vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
-    vec3 diffuse = kD * albedo / PI;
-    
-    return (diffuse + specular) * radiance * max(dot(N, L), 0.0);
-}
+#include "LuthBRDF.glslh"
 
 vec3 CalculateSubsurface(vec3 L, vec3 radiance, vec3 V, vec3 N, vec3 albedo, float metallic, float thickness) {
-    if (!u_Maps[Thickness].useTexture) return vec3(0.0);
+#ifndef LH_THICKNESS_MAP
+    return vec3(0.0);
+#endif
     
     vec3 transL = -L;
     float wrap = 0.5; // Wrapped lighting factor
@@ -226,73 +168,96 @@ void main()
 {
     // Diffuse color handling
     vec4 albedoRGBA = vec4(1.0);
-    if (u_Maps[Diffuse].useTexture) {
+#ifdef LH_DIFFUSE_MAP
+    {
         vec2 uv = u_Maps[Diffuse].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        albedoRGBA = texture(u_Maps[Diffuse].texture, uv);
+        albedoRGBA = texture(u_MapTextures[Diffuse], uv);
     }
+#endif
     vec3 albedo = albedoRGBA.rgb * u_Color.rgb;
 
     // Alpha handling
     float alpha = u_Alpha;
-    if (u_AlphaFromDiffuse == 1) {
-        alpha *= albedoRGBA.a;
-    } else if (u_Maps[Alpha].useTexture) {
+#if defined(LH_ALPHA_FROM_DIFFUSE)
+    alpha *= albedoRGBA.a;
+#elif defined(LH_ALPHA_MAP)
+    {
         vec2 uv = u_Maps[Alpha].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        alpha *= texture(u_Maps[Alpha].texture, uv).r;
+        alpha *= texture(u_MapTextures[Alpha], uv).r;
     }
+#endif
 
     // Normal mapping
     vec3 N;
-    if (u_Maps[Normal].useTexture) {
+#ifdef LH_NORMAL_MAP
+    {
         vec2 uv = u_Maps[Normal].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
         mat3 TBN = mat3(normalize(v_Tangent), normalize(v_Bitangent), normalize(v_Normal));
-        vec3 normalMap = texture(u_Maps[Normal].texture, uv).rgb * 2.0 - 1.0;
+        vec3 normalMap = texture(u_MapTextures[Normal], uv).rgb * 2.0 - 1.0;
         N = normalize(TBN * normalMap);
-    } else {
-        N = normalize(v_Normal);
     }
+#else
+    N = normalize(v_Normal);
+#endif
 
     // Metallic workflow
     float metallic = u_Metalness;
-    if (u_Maps[Metal].useTexture) {
+#ifdef LH_METAL_MAP
+    {
         vec2 uv = u_Maps[Metal].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        metallic = texture(u_Maps[Metal].texture, uv).r;
+        metallic = texture(u_MapTextures[Metal], uv).r;
     }
+#endif
 
     // Roughness workflow
     float roughness = u_Roughness;
-    if (u_Maps[Rough].useTexture) {
+#ifdef LH_ROUGH_MAP
+    {
         vec2 uv = u_Maps[Rough].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        roughness = texture(u_Maps[Rough].texture, uv).r;
+        roughness = texture(u_MapTextures[Rough], uv).r;
     }
-    if (u_IsGloss == 1) roughness = 1.0 - roughness;
+#endif
+#ifdef LH_GLOSS
+    roughness = 1.0 - roughness;
+#endif
 
     // Ambient occlusion
     float ao = 1.0;
-    if (u_Maps[Oclusion].useTexture) {
+#ifdef LH_OCCLUSION_MAP
+    {
         vec2 uv = u_Maps[Oclusion].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        ao = texture(u_Maps[Oclusion].texture, uv).r;
+        ao = texture(u_MapTextures[Oclusion], uv).r;
     }
+#endif
 
     // Emissive
     vec3 emissive = u_Emissive;
-    if (u_Maps[Emissive].useTexture) {
+#ifdef LH_EMISSIVE_MAP
+    {
         vec2 uv = u_Maps[Emissive].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        vec3 texEmissive = texture(u_Maps[Emissive].texture, uv).rgb;
-        if (u_IsSingleChannel == 1) texEmissive = vec3(texEmissive.r);
+        vec3 texEmissive = texture(u_MapTextures[Emissive], uv).rgb;
+#ifdef LH_SINGLE_CHANNEL
+        texEmissive = vec3(texEmissive.r);
+#endif
         emissive *= texEmissive;
     }
+#endif
 
     // Thickness
     float thickness = u_Subsurface.thicknessScale;
-    if (u_Maps[Thickness].useTexture) {
+#ifdef LH_THICKNESS_MAP
+    {
         vec2 uv = u_Maps[Thickness].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        thickness *= texture(u_Maps[Thickness].texture, uv).r;
+        thickness *= texture(u_MapTextures[Thickness], uv).r;
     }
+#endif
 
     // Handle render modes
-    if (u_RenderMode == 1 && alpha < u_AlphaCutoff) discard;
-    if (u_RenderMode == 0) alpha = 1.0;
+#if defined(LH_ALPHA_CUTOUT)
+    if (alpha < u_AlphaCutoff) discard;
+#elif !defined(LH_ALPHA_BLEND)
+    alpha = 1.0;
+#endif
 
     // View direction
     mat4 invView = inverse(view);
@@ -315,11 +280,13 @@ void main()
         }
     }
 
-    // Point lights
-    for(int i = 0; i < pointLightCount && i < MAX_POINT_LIGHTS; i++) {
-        vec3 toLight = pointLights[i].position - v_WorldPos;
+    // Point lights, only those binned into this fragment's cluster
+    uvec2 cluster = ClusterLights(v_WorldPos);
+    for(uint i = 0u; i < cluster.y; i++) {
+        PointLight light = pointLights[u_ClusterLightIndices[cluster.x + i]];
+        vec3 toLight = light.position - v_WorldPos;
         float distance = length(toLight);
-        float scaledDistance = distance / pointLights[i].range;
+        float scaledDistance = distance / light.range;
         
         if(scaledDistance > 1.0) continue;
         
@@ -327,7 +294,7 @@ void main()
         float attenuation = 1.0 / (distance * distance);
         attenuation = clamp(1.0 - pow(scaledDistance, 4.0), 0.0, 1.0);
         vec3 L = normalize(toLight);
-        vec3 radiance = pointLights[i].color * pointLights[i].intensity * attenuation;
+        vec3 radiance = light.color * light.intensity * attenuation;
 
         float NdotL = dot(N, L);
     
@@ -21,6 +21,10 @@ in vec2 v_UV;
 
 layout(location = 0) out vec4 FragColor;
 
+// Writes the display resolution "Final" from the scaled scene: the bilinear fetches
+// below followed by the sharpen filter are the upscale
+#include "LuthTransform.glslh"
+
 layout(binding = 0) uniform sampler2D u_Scene;
 layout(binding = 1) uniform sampler2D u_Bloom;
 
@@ -55,9 +59,10 @@ vec3 ApplyChromatic(vec2 uv, vec3 color) {
     float bOffset = u_AberrationOffset * -1.0;
     
     // Sample with offset per channel
-    vec2 rUV = clamp(uv + vec2(rOffset, 0.0), 0.0, 1.0);
-    vec2 gUV = clamp(uv + vec2(gOffset, 0.0), 0.0, 1.0);
-    vec2 bUV = clamp(uv + vec2(bOffset, 0.0), 0.0, 1.0);
+    vec2 size = vec2(textureSize(u_Scene, 0));
+    vec2 rUV = RenderUVClamped(uv + vec2(rOffset, 0.0), size);
+    vec2 gUV = RenderUVClamped(uv + vec2(gOffset, 0.0), size);
+    vec2 bUV = RenderUVClamped(uv + vec2(bOffset, 0.0), size);
     
     // Use the combined color but with shifted sampling
     return vec3(
@@ -164,8 +169,10 @@ vec3 ApplyColorBalance(vec3 color) {
 void main()
 {
     // [1] Sample base scene and bloom
-    vec3 col = texture(u_Scene, v_UV).rgb;
-    vec3 bloom = texture(u_Bloom, v_UV).rgb;
+    vec2 sceneSize = vec2(textureSize(u_Scene, 0));
+    vec2 sceneUV = RenderUVClamped(v_UV, sceneSize);
+    vec3 col = texture(u_Scene, sceneUV).rgb;
+    vec3 bloom = texture(u_Bloom, RenderUVClamped(v_UV, vec2(textureSize(u_Bloom, 0)))).rgb;
 
     // [2] Add bloom BEFORE tone mapping
     col += bloom * u_BloomStrength;
@@ -176,13 +183,14 @@ void main()
     // [4] Color balance (works best in LDR space)
     col = ApplyColorBalance(col);
 
-    // [5] Sharpening - BEFORE stylistic effects
-    vec2 texelSize = 1.0 / textureSize(u_Scene, 0);
+    // [5] Sharpening - BEFORE stylistic effects, taps one scene texel apart
+    vec2 texelSize = 1.0 / sceneSize;
+    vec2 lo = 0.5 * texelSize, hi = renderScale.xy - 0.5 * texelSize;
     vec3 blurred = (
-        texture(u_Scene, v_UV + vec2(texelSize.x, 0)).rgb +
-        texture(u_Scene, v_UV - vec2(texelSize.x, 0)).rgb +
-        texture(u_Scene, v_UV + vec2(0, texelSize.y)).rgb +
-        texture(u_Scene, v_UV - vec2(0, texelSize.y)).rgb
+        texture(u_Scene, clamp(sceneUV + vec2(texelSize.x, 0), lo, hi)).rgb +
+        texture(u_Scene, clamp(sceneUV - vec2(texelSize.x, 0), lo, hi)).rgb +
+        texture(u_Scene, clamp(sceneUV + vec2(0, texelSize.y), lo, hi)).rgb +
+        texture(u_Scene, clamp(sceneUV - vec2(0, texelSize.y), lo, hi)).rgb
     ) * 0.25;
     col = col + (col - blurred) * u_Sharpness;
 
@@ -15,26 +15,36 @@ void main()
 #type fragment
 #version 460 core
 
-uniform sampler2D ssaoInput;
-uniform vec2 u_BlurScale;
+#include "LuthTransform.glslh"
+
+uniform sampler2D ssaoInput;     // r: occlusion, g: linear view depth
 
 in vec2 v_TexCoord;
-out float FragColor;
+out vec2 FragColor;
+
+// Relative depth difference at which a tap's weight halves
+const float DEPTH_SHARPNESS = 0.05;
 
 void main()
 {
-    vec2 texelSize = 1.0 / vec2(textureSize(ssaoInput, 0));
+    ivec2 size = RenderExtent(textureSize(ssaoInput, 0));
+    ivec2 center = ivec2(v_TexCoord * vec2(size));
+    float depth = texelFetch(ssaoInput, center, 0).g;
+
     float result = 0.0;
+    float totalWeight = 0.0;
     
     // Bilateral blur with depth awareness
     for(int x = -2; x <= 2; ++x)
     {
         for(int y = -2; y <= 2; ++y)
         {
-            vec2 offset = vec2(x, y) * texelSize * u_BlurScale;
-            result += texture(ssaoInput, v_TexCoord + offset).r;
+            vec2 tap = texelFetch(ssaoInput, clamp(center + ivec2(x, y), ivec2(0), size - 1), 0).rg;
+            float weight = 1.0 / (1.0 + abs(tap.g - depth) / (depth * DEPTH_SHARPNESS));
+            result += tap.r * weight;
+            totalWeight += weight;
         }
     }
     
-    FragColor = result / 25.0;
+    FragColor = vec2(result / totalWeight, depth);
 }
\ No newline at end of file
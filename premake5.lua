@@ -22,6 +22,7 @@ outputdir = "%{cfg.system}-%{cfg.architecture}/%{cfg.buildcfg}"
 
 group "Luth"
    include "Luth"
+   include "luth/tests"
 group ""
 
 group "Luth/Extern"
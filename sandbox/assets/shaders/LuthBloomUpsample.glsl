@@ -0,0 +1,47 @@
+#type vertex
+#version 460 core
+
+layout(location = 0) in vec2 a_Position;
+out vec2 v_TexCoord;
+
+void main()
+{
+    gl_Position = vec4(a_Position, 0.0, 1.0);
+    v_TexCoord = a_Position * 0.5 + 0.5;
+}
+
+
+
+#type fragment
+#version 460 core
+
+// 3x3 tent filter over the smaller mip, added onto the next larger one (blend ONE, ONE)
+
+#include "LuthTransform.glslh"
+
+layout(binding = 0) uniform sampler2D u_Source;
+uniform float u_FilterRadius;   // In source texels
+
+in vec2 v_TexCoord;
+out vec4 FragColor;
+
+void main()
+{
+    vec2 size = vec2(textureSize(u_Source, 0));
+    vec2 r = u_FilterRadius / size;
+    vec2 uv = RenderUV(v_TexCoord);
+
+    // Taps stay inside the drawn part of the source
+    vec2 lo = 0.5 / size, hi = renderScale.xy - 0.5 / size;
+    vec3 color = texture(u_Source, clamp(uv, lo, hi)).rgb * 4.0;
+    color += (texture(u_Source, clamp(uv + vec2(-r.x, 0.0), lo, hi)).rgb +
+              texture(u_Source, clamp(uv + vec2( r.x, 0.0), lo, hi)).rgb +
+              texture(u_Source, clamp(uv + vec2(0.0, -r.y), lo, hi)).rgb +
+              texture(u_Source, clamp(uv + vec2(0.0,  r.y), lo, hi)).rgb) * 2.0;
+    color += texture(u_Source, clamp(uv + vec2(-r.x, -r.y), lo, hi)).rgb +
+             texture(u_Source, clamp(uv + vec2( r.x, -r.y), lo, hi)).rgb +
+             texture(u_Source, clamp(uv + vec2(-r.x,  r.y), lo, hi)).rgb +
+             texture(u_Source, clamp(uv + vec2( r.x,  r.y), lo, hi)).rgb;
+
+    FragColor = vec4(color / 16.0, 1.0);
+}
@@ -1,13 +1,21 @@
+// Variants, one program per keyword combination in use (see ShaderKeywords.h)
+#pragma multi_compile LH_SKINNED
+#pragma multi_compile LH_ALPHA_CUTOUT LH_ALPHA_BLEND LH_ALPHA_FROM_DIFFUSE
+#pragma multi_compile LH_GLOSS LH_SINGLE_CHANNEL
+#pragma multi_compile LH_DIFFUSE_MAP LH_ALPHA_MAP LH_NORMAL_MAP LH_METAL_MAP LH_ROUGH_MAP
+#pragma multi_compile LH_OCCLUSION_MAP LH_EMISSIVE_MAP LH_THICKNESS_MAP
+#pragma multi_compile LH_GBUFFER_DEBUG
+
 #type vertex
 #version 460 core
 
 // Vertex Attributes
-layout(location = 0) in vec3 a_Position;
+layout(location = 0) in vec4 a_Position;    // w: bitangent sign when quantized, 1 otherwise
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord0;
 layout(location = 3) in vec2 a_TexCoord1;
 layout(location = 4) in vec3 a_Tangent;
-layout(location = 5) in ivec4 a_BoneIDs;
+layout(location = 5) in uvec4 a_BoneIDs;
 layout(location = 6) in vec4 a_BoneWeights;
 
 // Outputs to Fragment Shader
@@ -20,14 +28,24 @@ layout(location = 5) out vec3 v_Bitangent;
 layout(location = 6) flat out ivec4 v_BoneIDs;
 layout(location = 7) out vec4 v_BoneWeights;
 
+// Matches LuthDepthPrepass.glsl bit for bit, the pre-pass' depth is tested with GL_EQUAL
+invariant gl_Position;
+
 // Uniform Buffers
-layout(std140, binding = 0) uniform TransformUBO {
-    mat4 view;
-    mat4 projection;
+#include "LuthTransform.glslh"
+
+uniform mat4 u_Model;
+
+// Instanced static draws, indexed by the indirect command's base instance (see InstanceBatcher.h)
+struct InstanceData {
     mat4 model;
 };
 
-uniform mat4 u_Model;
+layout(std430, binding = 5) readonly buffer Instances {
+    InstanceData u_Instances[];
+};
+
+uniform bool u_IsInstanced;
 
 // Bone Transformations
 const int MAX_BONES = 512;
@@ -37,38 +55,114 @@ layout(std140, binding = 2) uniform BonesUBO {
     mat4 u_BoneMatrices[MAX_BONES];
 };
 
-uniform bool u_IsSkinned;
+// Quantized static vertices (see VertexQuantization.h)
+uniform bool u_VertexQuantized;
+uniform vec3 u_PosOffset;
+uniform vec3 u_PosScale;
+
+// Baked vertex animation (instanced)
+struct BakedInstance {
+    mat4 model;
+    vec4 params;    // x: time offset, y: speed
+};
+
+layout(std430, binding = 3) readonly buffer BakedInstances {
+    BakedInstance u_BakedInstances[];
+};
+
+layout(std430, binding = 4) readonly buffer BakedFrames {
+    uvec4 u_BakedFrames[];  // half3 position, oct snorm16 normal, oct snorm16 tangent
+};
+
+uniform bool  u_IsBaked;
+uniform int   u_BakedBase;
+uniform int   u_BakedVertexCount;
+uniform int   u_BakedFrameCount;
+uniform float u_BakedFrameRate;
+uniform float u_Time;
+
+#include "LuthOctahedral.glslh"
+#include "LuthSkinnedVertices.glslh"
+
+void SampleBaked(float time, out vec3 position, out vec3 normal, out vec3 tangent)
+{
+    // Wrap into the clip, then blend the two nearest frames
+    float frame = fract(time * u_BakedFrameRate / float(u_BakedFrameCount)) * float(u_BakedFrameCount);
+    int f0 = min(int(frame), u_BakedFrameCount - 1);
+    int f1 = (f0 + 1) % u_BakedFrameCount;
+    float a = frame - float(f0);
+
+    // Pooled meshes draw with a base vertex, the tracks are indexed from the mesh's first vertex
+    int vertex = gl_VertexID - gl_BaseVertex;
+    uvec4 d0 = u_BakedFrames[f0 * u_BakedVertexCount + vertex];
+    uvec4 d1 = u_BakedFrames[f1 * u_BakedVertexCount + vertex];
+
+    position = mix(vec3(unpackHalf2x16(d0.x), unpackHalf2x16(d0.y).x),
+                   vec3(unpackHalf2x16(d1.x), unpackHalf2x16(d1.y).x), a);
+    normal   = mix(OctDecode(unpackSnorm2x16(d0.z)), OctDecode(unpackSnorm2x16(d1.z)), a);
+    tangent  = mix(OctDecode(unpackSnorm2x16(d0.w)), OctDecode(unpackSnorm2x16(d1.w)), a);
+}
 
 void main()
 {
-    // Bone transform
-    mat4 boneTransform = mat4(1.0);
-    if (u_IsSkinned) {
-        boneTransform  = u_BoneMatrices[a_BoneIDs.x] * a_BoneWeights.x;
-        boneTransform += u_BoneMatrices[a_BoneIDs.y] * a_BoneWeights.y;
-        boneTransform += u_BoneMatrices[a_BoneIDs.z] * a_BoneWeights.z;
-        boneTransform += u_BoneMatrices[a_BoneIDs.w] * a_BoneWeights.w;
+    mat4 model = u_IsInstanced ? u_Instances[gl_BaseInstance + gl_InstanceID].model : u_Model;
+    vec3 skinnedPos, skinnedNormal, skinnedTangent;
+
+    // Vertex decode
+    vec3 position = a_Position.xyz;
+    vec3 normal = a_Normal;
+    vec3 tangent = a_Tangent;
+    float bitangentSign = 1.0;
+    if (u_VertexQuantized) {
+        position = u_PosOffset + a_Position.xyz * u_PosScale;
+        normal = OctDecode(a_Normal.xy);
+        tangent = OctDecode(a_Tangent.xy);
+        bitangentSign = a_Position.w * 2.0 - 1.0;
+    }
+
+    if (u_IsBaked) {
+        BakedInstance instance = u_BakedInstances[u_BakedBase + gl_InstanceID];
+        model = instance.model;
+        SampleBaked(instance.params.x + u_Time * instance.params.y, skinnedPos, skinnedNormal, skinnedTangent);
+    }
+    else if (u_CpuSkinned) {
+        SkinnedVertex skinned = FetchSkinnedVertex();
+        skinnedPos = skinned.position.xyz;
+        skinnedNormal = skinned.normal.xyz;
+        skinnedTangent = skinned.tangent.xyz;
+    }
+    else {
+        // Bone transform
+        mat4 boneTransform = mat4(1.0);
+#ifdef LH_SKINNED
+        if (dot(a_BoneWeights, vec4(1.0)) > 0.0) {
+            boneTransform  = u_BoneMatrices[a_BoneIDs.x] * a_BoneWeights.x;
+            boneTransform += u_BoneMatrices[a_BoneIDs.y] * a_BoneWeights.y;
+            boneTransform += u_BoneMatrices[a_BoneIDs.z] * a_BoneWeights.z;
+            boneTransform += u_BoneMatrices[a_BoneIDs.w] * a_BoneWeights.w;
+        }
+#endif
+
+        mat3 boneRotation = mat3(boneTransform);
+        skinnedPos = vec3(boneTransform * vec4(position, 1.0));
+        skinnedNormal = boneRotation * normal;
+        skinnedTangent = boneRotation * tangent;
     }
 
     // Position transformation
-    vec4 skinnedPosition = boneTransform * vec4(a_Position, 1.0);
-    v_WorldPos = vec3(u_Model * skinnedPosition);
+    v_WorldPos = vec3(model * vec4(skinnedPos, 1.0));
     gl_Position = projection * view * vec4(v_WorldPos, 1.0);
     
     // Normal/tangent transformation
-    mat3 boneRotation = mat3(boneTransform);
-    vec3 skinnedNormal = boneRotation * a_Normal;
-    vec3 skinnedTangent = boneRotation * a_Tangent;
-    
-    mat3 modelNormalMatrix = transpose(inverse(mat3(u_Model)));
+    mat3 modelNormalMatrix = transpose(inverse(mat3(model)));
     v_Normal = normalize(modelNormalMatrix * skinnedNormal);
     v_Tangent = normalize(modelNormalMatrix * skinnedTangent);
-    v_Bitangent = normalize(cross(v_Normal, v_Tangent));
+    v_Bitangent = normalize(cross(v_Normal, v_Tangent)) * bitangentSign;
     
     // Pass through other data
     v_TexCoord0 = a_TexCoord0;
     v_TexCoord1 = a_TexCoord1;
-    v_BoneIDs = a_BoneIDs;
+    v_BoneIDs = ivec4(a_BoneIDs);
     v_BoneWeights = a_BoneWeights;
 }
 
@@ -87,51 +181,20 @@ layout(location = 5) in vec3 v_Bitangent;
 layout(location = 6) flat in ivec4 v_BoneIDs;
 layout(location = 7) in vec4 v_BoneWeights;
 
-layout(location = 0) out vec4 o_Position;   // world-space pos
-layout(location = 1) out vec4 o_Normal;     // world-space normal
-layout(location = 2) out vec4 o_Albedo;     // rgb=albedo, a=alpha
-layout(location = 3) out vec4 o_MRO;        // r=metallic, g=roughness, b=ao, a=0
-layout(location = 4) out vec4 o_ET;         // rgb=emissive, a=thickness
-layout(location = 5) out vec4 o_Bone;       // rgb=boneWeights, a=0
+layout(location = 0) out vec2 o_Normal;     // octahedral world-space normal
+layout(location = 1) out vec4 o_Albedo;     // rgb=albedo, a=thickness
+layout(location = 2) out vec4 o_MRAO;       // r=metallic, g=roughness, b=ao, a=flags
+layout(location = 3) out vec3 o_Emissive;
+#ifdef LH_GBUFFER_DEBUG
+layout(location = 4) out vec4 o_Position;   // world-space pos
+layout(location = 5) out vec4 o_DebugNormal;
+layout(location = 6) out vec4 o_Bone;       // rgb=boneWeights, a=0
+#endif
 
-// ========== Material Uniforms =========
-#define Diffuse   0
-#define Alpha     1
-#define Normal    2
-#define Metal     3
-#define Rough     4
-#define Specular  5
-#define Oclusion  6
-#define Emissive  7
-#define Thickness 8
-
-struct Map {
-    bool useMap;
-    bool useTexture;
-    sampler2D texture;
-    int uvIndex;
-};
+#include "LuthGBuffer.glslh"
 
-struct Subsurface {
-    vec3 color;
-    float strength;
-    float thicknessScale;
-};
-
-uniform Map u_Maps[9];
-
-uniform int u_RenderMode;       // 0 = Opaque, 1 = Cutout, 2 = Transparent, 3 = Fade
-uniform float u_AlphaCutoff;    // For cutout mode
-uniform int u_AlphaFromDiffuse;
-uniform int u_IsGloss;
-uniform int u_IsSingleChannel;
-
-uniform vec4 u_Color;
-uniform float u_Alpha;
-uniform float u_Metalness;
-uniform float u_Roughness;
-uniform vec3 u_Emissive;
-uniform Subsurface u_Subsurface;
+// ========== Material Uniforms =========
+#include "LuthMaterial.glslh"
 
 vec3 BoneIdToColor(int boneId) {
     int seed = boneId * 7919; // Large prime
@@ -146,74 +209,104 @@ void main()
 {
     // Diffuse color handling
     vec4 albedoRGBA = vec4(1.0);
-    if (u_Maps[Diffuse].useTexture) {
+#ifdef LH_DIFFUSE_MAP
+    {
         vec2 uv = u_Maps[Diffuse].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        albedoRGBA = texture(u_Maps[Diffuse].texture, uv);
+        albedoRGBA = texture(u_MapTextures[Diffuse], uv);
     }
+#endif
     vec3 albedo = albedoRGBA.rgb * u_Color.rgb;
 
     // Alpha handling
     float alpha = u_Alpha;
-    if (u_AlphaFromDiffuse == 1) {
-        alpha *= albedoRGBA.a;
-    } else if (u_Maps[Alpha].useTexture) {
+#if defined(LH_ALPHA_FROM_DIFFUSE)
+    alpha *= albedoRGBA.a;
+#elif defined(LH_ALPHA_MAP)
+    {
         vec2 uv = u_Maps[Alpha].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        alpha *= texture(u_Maps[Alpha].texture, uv).r;
+        alpha *= texture(u_MapTextures[Alpha], uv).r;
     }
+#endif
 
     // Normal mapping
     vec3 normal;
-    if (u_Maps[Normal].useTexture) {
+#ifdef LH_NORMAL_MAP
+    {
         vec2 uv = u_Maps[Normal].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
         mat3 TBN = mat3(normalize(v_Tangent), normalize(v_Bitangent), normalize(v_Normal));
-        vec3 normalMap = texture(u_Maps[Normal].texture, uv).rgb * 2.0 - 1.0;
+        vec3 normalMap = texture(u_MapTextures[Normal], uv).rgb * 2.0 - 1.0;
         normal = normalize(TBN * normalMap);
-    } else {
-        normal = normalize(v_Normal);
     }
+#else
+    normal = normalize(v_Normal);
+#endif
 
     // Metallic workflow
     float metal = u_Metalness;
-    if (u_Maps[Metal].useTexture) {
+#ifdef LH_METAL_MAP
+    {
         vec2 uv = u_Maps[Metal].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        metal = texture(u_Maps[Metal].texture, uv).r;
+        metal = texture(u_MapTextures[Metal], uv).r;
     }
+#endif
 
     // Roughness workflow
     float rough = u_Roughness;
-    if (u_Maps[Rough].useTexture) {
+#ifdef LH_ROUGH_MAP
+    {
         vec2 uv = u_Maps[Rough].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        rough = texture(u_Maps[Rough].texture, uv).r;
+        rough = texture(u_MapTextures[Rough], uv).r;
     }
-    if (u_IsGloss == 1) rough = 1.0 - rough;
+#endif
+#ifdef LH_GLOSS
+    rough = 1.0 - rough;
+#endif
 
     // Ambient occlusion
     float ao = 1.0;
-    if (u_Maps[Oclusion].useTexture) {
+#ifdef LH_OCCLUSION_MAP
+    {
         vec2 uv = u_Maps[Oclusion].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        ao = texture(u_Maps[Oclusion].texture, uv).r;
+        ao = texture(u_MapTextures[Oclusion], uv).r;
     }
+#endif
 
     // Emissive
     vec3 emissive = u_Emissive;
-    if (u_Maps[Emissive].useTexture) {
+#ifdef LH_EMISSIVE_MAP
+    {
         vec2 uv = u_Maps[Emissive].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        vec3 texEmissive = texture(u_Maps[Emissive].texture, uv).rgb;
-        if (u_IsSingleChannel == 1) texEmissive = vec3(texEmissive.r);
+        vec3 texEmissive = texture(u_MapTextures[Emissive], uv).rgb;
+#ifdef LH_SINGLE_CHANNEL
+        texEmissive = vec3(texEmissive.r);
+#endif
         emissive *= texEmissive;
     }
+#endif
 
     // Thickness
     float thickness = u_Subsurface.thicknessScale;
-    if (u_Maps[Thickness].useTexture) {
+#ifdef LH_THICKNESS_MAP
+    {
         vec2 uv = u_Maps[Thickness].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
-        thickness *= texture(u_Maps[Thickness].texture, uv).r;
+        thickness *= texture(u_MapTextures[Thickness], uv).r;
     }
+#endif
 
     // Handle render modes
-    if (u_RenderMode == 1 && alpha < u_AlphaCutoff) discard;
-    if (u_RenderMode == 0) alpha = 1.0;
+#if defined(LH_ALPHA_CUTOUT)
+    if (alpha < u_AlphaCutoff) discard;
+#elif !defined(LH_ALPHA_BLEND)
+    alpha = 1.0;
+#endif
+
+    // write G-buffer
+    o_Normal    = OctEncode(normal);
+    o_Albedo    = vec4(albedo, thickness);
+    o_MRAO      = vec4(metal, rough, ao, PackFlags(GBUFFER_LIT));
+    o_Emissive  = emissive;
 
+#ifdef LH_GBUFFER_DEBUG
     // BONE WEIGTHS
     vec3 bone = vec3(0.0);
     float totalWeight = 0.0;
@@ -238,11 +331,8 @@ void main()
         bone = vec3(1.0, 0.0, 1.0); // Magenta
     }
 
-    // write G-buffer
-    o_Position  = vec4(v_WorldPos, 1.0);
-    o_Normal    = vec4(normal, 1.0);
-    o_Albedo    = vec4(albedo, alpha);
-    o_MRO       = vec4(metal, rough, ao, 1.0);
-    o_ET        = vec4(emissive, thickness);
-    o_Bone      = vec4(bone, 1.0);
+    o_Position    = vec4(v_WorldPos, 1.0);
+    o_DebugNormal = vec4(normal, 1.0);
+    o_Bone        = vec4(bone, 1.0);
+#endif
 }
\ No newline at end of file
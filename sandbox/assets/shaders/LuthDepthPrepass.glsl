@@ -0,0 +1,162 @@
+// Depth-only pre-pass of the G-buffer (see GeometryPass.h). Positions only, the G-buffer
+// pass then shades each pixel once with GL_EQUAL. gl_Position is invariant and computed
+// exactly as in LuthDeferredGeo.glsl, any difference in the math breaks the equal test.
+// Only cutout materials read their alpha, everything else has an empty fragment stage.
+#pragma multi_compile LH_SKINNED
+#pragma multi_compile LH_ALPHA_CUTOUT
+#pragma multi_compile LH_ALPHA_FROM_DIFFUSE
+#pragma multi_compile LH_DIFFUSE_MAP LH_ALPHA_MAP
+
+#type vertex
+#version 460 core
+
+// Vertex Attributes
+layout(location = 0) in vec4 a_Position;    // w: bitangent sign when quantized, 1 otherwise
+layout(location = 2) in vec2 a_TexCoord0;
+layout(location = 3) in vec2 a_TexCoord1;
+layout(location = 5) in uvec4 a_BoneIDs;
+layout(location = 6) in vec4 a_BoneWeights;
+
+#ifdef LH_ALPHA_CUTOUT
+layout(location = 0) out vec2 v_TexCoord0;
+layout(location = 1) out vec2 v_TexCoord1;
+#endif
+
+invariant gl_Position;
+
+// Uniform Buffers
+#include "LuthTransform.glslh"
+
+uniform mat4 u_Model;
+
+// Instanced static draws, indexed by the indirect command's base instance (see InstanceBatcher.h)
+struct InstanceData {
+    mat4 model;
+};
+
+layout(std430, binding = 5) readonly buffer Instances {
+    InstanceData u_Instances[];
+};
+
+uniform bool u_IsInstanced;
+
+// Bone Transformations
+const int MAX_BONES = 512;
+
+layout(std140, binding = 2) uniform BonesUBO {
+    mat4 u_BoneMatrices[MAX_BONES];
+};
+
+// Quantized static vertices (see VertexQuantization.h)
+uniform bool u_VertexQuantized;
+uniform vec3 u_PosOffset;
+uniform vec3 u_PosScale;
+
+// Baked vertex animation (instanced)
+struct BakedInstance {
+    mat4 model;
+    vec4 params;    // x: time offset, y: speed
+};
+
+layout(std430, binding = 3) readonly buffer BakedInstances {
+    BakedInstance u_BakedInstances[];
+};
+
+layout(std430, binding = 4) readonly buffer BakedFrames {
+    uvec4 u_BakedFrames[];  // half3 position, oct snorm16 normal, oct snorm16 tangent
+};
+
+uniform bool  u_IsBaked;
+uniform int   u_BakedBase;
+uniform int   u_BakedVertexCount;
+uniform int   u_BakedFrameCount;
+uniform float u_BakedFrameRate;
+uniform float u_Time;
+
+#include "LuthSkinnedVertices.glslh"
+
+vec3 SampleBakedPosition(float time)
+{
+    float frame = fract(time * u_BakedFrameRate / float(u_BakedFrameCount)) * float(u_BakedFrameCount);
+    int f0 = min(int(frame), u_BakedFrameCount - 1);
+    int f1 = (f0 + 1) % u_BakedFrameCount;
+    float a = frame - float(f0);
+
+    int vertex = gl_VertexID - gl_BaseVertex;
+    uvec4 d0 = u_BakedFrames[f0 * u_BakedVertexCount + vertex];
+    uvec4 d1 = u_BakedFrames[f1 * u_BakedVertexCount + vertex];
+
+    return mix(vec3(unpackHalf2x16(d0.x), unpackHalf2x16(d0.y).x),
+               vec3(unpackHalf2x16(d1.x), unpackHalf2x16(d1.y).x), a);
+}
+
+void main()
+{
+    mat4 model = u_IsInstanced ? u_Instances[gl_BaseInstance + gl_InstanceID].model : u_Model;
+    vec3 skinnedPos;
+
+    vec3 position = a_Position.xyz;
+    if (u_VertexQuantized) position = u_PosOffset + a_Position.xyz * u_PosScale;
+
+    if (u_IsBaked) {
+        BakedInstance instance = u_BakedInstances[u_BakedBase + gl_InstanceID];
+        model = instance.model;
+        skinnedPos = SampleBakedPosition(instance.params.x + u_Time * instance.params.y);
+    }
+    else if (u_CpuSkinned) {
+        skinnedPos = FetchSkinnedVertex().position.xyz;
+    }
+    else {
+        mat4 boneTransform = mat4(1.0);
+#ifdef LH_SKINNED
+        if (dot(a_BoneWeights, vec4(1.0)) > 0.0) {
+            boneTransform  = u_BoneMatrices[a_BoneIDs.x] * a_BoneWeights.x;
+            boneTransform += u_BoneMatrices[a_BoneIDs.y] * a_BoneWeights.y;
+            boneTransform += u_BoneMatrices[a_BoneIDs.z] * a_BoneWeights.z;
+            boneTransform += u_BoneMatrices[a_BoneIDs.w] * a_BoneWeights.w;
+        }
+#endif
+        skinnedPos = vec3(boneTransform * vec4(position, 1.0));
+    }
+
+    vec3 worldPos = vec3(model * vec4(skinnedPos, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+
+#ifdef LH_ALPHA_CUTOUT
+    v_TexCoord0 = a_TexCoord0;
+    v_TexCoord1 = a_TexCoord1;
+#endif
+}
+
+
+
+
+#type fragment
+#version 460 core
+
+#ifdef LH_ALPHA_CUTOUT
+layout(location = 0) in vec2 v_TexCoord0;
+layout(location = 1) in vec2 v_TexCoord1;
+
+#include "LuthMaterial.glslh"
+#endif
+
+void main()
+{
+#ifdef LH_ALPHA_CUTOUT
+    // Same alpha as LuthDeferredGeo.glsl
+    float alpha = u_Alpha;
+#if defined(LH_ALPHA_FROM_DIFFUSE) && defined(LH_DIFFUSE_MAP)
+    {
+        vec2 uv = u_Maps[Diffuse].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
+        alpha *= texture(u_MapTextures[Diffuse], uv).a;
+    }
+#elif defined(LH_ALPHA_MAP) && !defined(LH_ALPHA_FROM_DIFFUSE)
+    {
+        vec2 uv = u_Maps[Alpha].uvIndex == 0 ? v_TexCoord0 : v_TexCoord1;
+        alpha *= texture(u_MapTextures[Alpha], uv).r;
+    }
+#endif
+    if (alpha < u_AlphaCutoff) discard;
+#endif
+}
@@ -1,3 +1,6 @@
+// Sample count per quality tier (see SSAOPass.h), medium without keyword
+#pragma multi_compile LH_SSAO_LOW LH_SSAO_HIGH LH_SSAO_ULTRA
+
 #type vertex
 #version 460 core
 
@@ -15,51 +18,66 @@ void main()
 #type fragment
 #version 460 core
 
+#if defined(LH_SSAO_ULTRA)
+    #define SSAO_SAMPLES 64
+#elif defined(LH_SSAO_HIGH)
+    #define SSAO_SAMPLES 32
+#elif defined(LH_SSAO_LOW)
+    #define SSAO_SAMPLES 8
+#else
+    #define SSAO_SAMPLES 16
+#endif
+
 in vec2 v_TexCoord;
-out float FragColor;
+out vec2 FragColor;     // r: occlusion, g: linear view depth
 
-layout(std140, binding = 0) uniform TransformUBO {
-    mat4 view;
-    mat4 projection;
-    mat4 model;
-};
+#include "LuthGBuffer.glslh"
 
 layout(std430, binding = 2) readonly buffer Kernel {
-    vec3 u_Samples[64];
+    vec4 u_Samples[SSAO_SAMPLES];
 };
 
-uniform sampler2D gPosition;
+uniform sampler2D gDepth;
 uniform sampler2D gNormal;
 uniform sampler2D u_Noise;
 
 uniform vec2 u_NoiseScale;
+uniform vec2 u_NoiseOffset;
 uniform float u_Radius;
 uniform float u_Bias;
 
 void main()
 {
-    vec3 fragPos = vec3(view * texture(gPosition, v_TexCoord)).rgb;
-    vec3 normal = normalize(vec3(view * texture(gNormal, v_TexCoord)).rgb);
-    vec3 randomVec = normalize(texture(u_Noise, v_TexCoord * u_NoiseScale).xyz);
+    vec2 uv = RenderUV(v_TexCoord);
+    float depth = texture(gDepth, uv).r;
+    vec3 fragPos = ViewPosFromDepth(v_TexCoord, depth);
+    if (depth >= 1.0) {
+        FragColor = vec2(1.0, -fragPos.z);
+        return;
+    }
+
+    vec3 normal = normalize(mat3(view) * OctDecode(texture(gNormal, uv).rg));
+    vec3 randomVec = normalize(texture(u_Noise, uv * u_NoiseScale + u_NoiseOffset).xyz);
+    vec2 depthSize = vec2(textureSize(gDepth, 0));
     
     vec3 tangent = normalize(randomVec - normal * dot(randomVec, normal));
     vec3 bitangent = cross(normal, tangent);
     mat3 TBN = mat3(tangent, bitangent, normal);
     
     float occlusion = 0.0;
-    for(int i = 0; i < 64; i++)
+    for(int i = 0; i < SSAO_SAMPLES; i++)
     {
-        vec3 samplePos = TBN * u_Samples[i];
+        vec3 samplePos = TBN * u_Samples[i].xyz;
         samplePos = fragPos + samplePos * u_Radius;
         
         vec4 offset = projection * vec4(samplePos, 1.0);
         offset.xyz /= offset.w;
         offset.xy = offset.xy * 0.5 + 0.5;
         
-        float sampleDepth = vec3(view * vec4(texture(gPosition, offset.xy).xyz, 1.0)).z;
+        float sampleDepth = ViewPosFromDepth(offset.xy, texture(gDepth, RenderUVClamped(offset.xy, depthSize)).r).z;
         float rangeCheck = smoothstep(0.0, 1.0, u_Radius / abs(fragPos.z - sampleDepth));
         occlusion += (sampleDepth >= samplePos.z + u_Bias ? 1.0 : 0.0) * rangeCheck;
     }
     
-    FragColor = 1.0 - (occlusion / 64.0);
-}
\ No newline at end of file
+    FragColor = vec2(1.0 - (occlusion / float(SSAO_SAMPLES)), -fragPos.z);
+}
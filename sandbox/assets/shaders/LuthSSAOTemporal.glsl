@@ -0,0 +1,55 @@
+#type vertex
+#version 460 core
+
+layout(location = 0) in vec2 a_Position;
+out vec2 v_TexCoord;
+
+void main()
+{
+    gl_Position = vec4(a_Position, 0.0, 1.0);
+    v_TexCoord = a_Position * 0.5 + 0.5;
+}
+
+
+
+#type fragment
+#version 460 core
+
+in vec2 v_TexCoord;
+out vec2 FragColor;     // r: occlusion, g: linear view depth
+
+#include "LuthGBuffer.glslh"
+
+uniform sampler2D u_Current;    // This frame, blurred
+uniform sampler2D u_History;    // Accumulated up to last frame
+uniform sampler2D gDepth;
+
+uniform mat4 u_PrevView;
+uniform mat4 u_PrevProjection;
+uniform vec2 u_PrevRenderScale;  // renderScale the history was drawn at
+uniform float u_Feedback;       // History weight, 0 to reset
+
+// Disocclusion: reprojected depth off by more than this fraction
+const float DEPTH_TOLERANCE = 0.05;
+
+void main()
+{
+    // Same resolution and corner as this target
+    vec2 current = texelFetch(u_Current, ivec2(gl_FragCoord.xy), 0).rg;
+    vec2 uv = RenderUV(v_TexCoord);
+
+    // Where this surface was on screen last frame
+    vec3 worldPos = WorldPosFromDepth(v_TexCoord, texture(gDepth, uv).r);
+    vec4 prevView = u_PrevView * vec4(worldPos, 1.0);
+    vec4 prevClip = u_PrevProjection * prevView;
+    vec2 prevUV = prevClip.xy / prevClip.w * 0.5 + 0.5;
+
+    float feedback = u_Feedback;
+    if (any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0)))) feedback = 0.0;
+
+    vec2 history = texture(u_History, prevUV * u_PrevRenderScale).rg;
+    float prevDepth = -prevView.z;
+    if (abs(history.g - prevDepth) > prevDepth * DEPTH_TOLERANCE) feedback = 0.0;
+
+    FragColor = vec2(mix(current.r, history.r, feedback), current.g);
+}
@@ -0,0 +1,52 @@
+#type vertex
+#version 460 core
+
+layout(location = 0) in vec2 a_Position;
+out vec2 v_TexCoord;
+
+void main()
+{
+    gl_Position = vec4(a_Position, 0.0, 1.0);
+    v_TexCoord = a_Position * 0.5 + 0.5;
+}
+
+
+
+#type fragment
+#version 460 core
+
+in vec2 v_TexCoord;
+out float FragColor;
+
+#include "LuthGBuffer.glslh"
+
+uniform sampler2D u_AO;         // Low resolution, r: occlusion, g: linear view depth
+uniform sampler2D gDepth;       // Full resolution
+
+// Relative depth difference at which a texel's weight halves
+const float DEPTH_SHARPNESS = 0.02;
+
+void main()
+{
+    float depth = -ViewPosFromDepth(v_TexCoord, texture(gDepth, RenderUV(v_TexCoord)).r).z;
+
+    // The four low resolution texels around this pixel, bilinear weights scaled by depth similarity
+    ivec2 size = RenderExtent(textureSize(u_AO, 0));
+    vec2 pos = v_TexCoord * vec2(size) - 0.5;
+    ivec2 base = ivec2(floor(pos));
+    vec2 f = pos - vec2(base);
+
+    float result = 0.0;
+    float totalWeight = 0.0;
+    for (int i = 0; i < 4; i++) {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        vec2 tap = texelFetch(u_AO, clamp(base + offset, ivec2(0), size - 1), 0).rg;
+
+        vec2 bilinear = mix(1.0 - f, f, vec2(offset));
+        float weight = bilinear.x * bilinear.y / (1.0 + abs(tap.g - depth) / (depth * DEPTH_SHARPNESS));
+        result += tap.r * weight;
+        totalWeight += weight;
+    }
+
+    FragColor = totalWeight > 0.0 ? result / totalWeight : 1.0;
+}